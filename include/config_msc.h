@@ -19,6 +19,10 @@
 
 #define USE_SSSE3 1
 
+#define USE_AVX2 1
+
+#define USE_AVX512 1
+
 #ifndef _M_X64
 #define USE_X86_MMX 1
 #endif
@@ -247,6 +247,33 @@ bilinear_interpolation_float (argb_t tl, argb_t tr,
     return r;
 }
 
+/*
+ * The separable convolution filter first filters each source row covered
+ * by the kernel with the x weights, and then the filtered rows with the y
+ * weights. Nothing is rounded on the way: rows are exact 32 bit sums of
+ * channel values times weights, and only the final sum, which has 32
+ * fractional bits, is rounded. Every implementation gets the same result
+ * whatever the order of its sums, and the result is the exact value of
+ * the filter rounded once.
+ */
+#define SEPARABLE_CONVOLUTION_SCALE_FLAGS				\
+    (FAST_PATH_NO_ALPHA_MAP		|				\
+     FAST_PATH_NO_ACCESSORS		|				\
+     FAST_PATH_BITS_IMAGE		|				\
+     FAST_PATH_SCALE_TRANSFORM		|				\
+     FAST_PATH_SEPARABLE_CONVOLUTION_FILTER)
+
+/* Turns the sum of filtered rows times y weights into an 8 bit channel
+ * value
+ */
+static force_inline uint32_t
+separable_convolution_reduce (int64_t sum)
+{
+    sum = (sum + ((int64_t)1 << 31)) >> 32;
+
+    return CLIP (sum, 0, 0xff);
+}
+
 /*
  * For each scanline fetched from source image with PAD repeat:
  * - calculate how many pixels need to be padded on the left side
@@ -777,6 +804,300 @@ fast_composite_scaled_nearest  ## scale_func_name (pixman_implementation_t *imp,
 
 /*****************************************************************************/
 
+/*
+ * Rotations by a multiple of 90 degrees and mirroring, with an integer
+ * translation and the nearest filter, only move pixels around. The source
+ * origin of such a composite is found the same way the nearest filter
+ * would round the transformed position of the first pixel.
+ */
+static force_inline int
+simple_transform_offset (pixman_fixed_t t)
+{
+    return pixman_fixed_to_int (t + pixman_fixed_1 / 2 - pixman_fixed_e);
+}
+
+#define SIMPLE_ROTATE_TILE_BYTES 64
+
+/*
+ * 90 and 270 degree rotations done in BLOCK x BLOCK blocks, each of which
+ * is moved by an implementation specific transpose:
+ *
+ *   block_90 (dst, dst_stride, src, src_stride)  writes the source block
+ *       turned clockwise, so that destination row k is source column
+ *       BLOCK - 1 - k;
+ *   block_270 (dst, dst_stride, src, src_stride) writes it turned
+ *       counterclockwise, so that destination row k is source column k
+ *       read upwards.
+ *
+ * The destination is walked in cache line wide vertical strips, so that
+ * the source rows read by a strip stay in the cache all the way down, and
+ * the strips start on a cache line boundary of the destination so that
+ * no line is written by two strips. The pixels left over at the edges are
+ * moved one by one.
+ */
+#define FAST_SIMPLE_ROTATE_BLOCKS(suffix, pix_type, BLOCK,		      \
+				  block_90, block_270)			      \
+									      \
+static void								      \
+blt_rotated_90_##suffix (pix_type       *dst,				      \
+			 int             dst_stride,			      \
+			 const pix_type *src,				      \
+			 int             src_stride,			      \
+			 int             w,				      \
+			 int             h)				      \
+{									      \
+    const int tile = SIMPLE_ROTATE_TILE_BYTES / sizeof (pix_type);	      \
+    int x0, x1, y1, x, y, xx, x_end;					      \
+									      \
+    x0 = ((-(uintptr_t)dst) & (SIMPLE_ROTATE_TILE_BYTES - 1)) /		      \
+	sizeof (pix_type);						      \
+    if (x0 > w)								      \
+	x0 = w;								      \
+    x1 = w - (w - x0) % BLOCK;						      \
+    y1 = h - h % BLOCK;							      \
+									      \
+    for (x = x0; x < x1; x += tile)					      \
+    {									      \
+	x_end = x + tile < x1 ? x + tile : x1;				      \
+									      \
+	for (y = 0; y < y1; y += BLOCK)					      \
+	{								      \
+	    for (xx = x; xx < x_end; xx += BLOCK)			      \
+	    {								      \
+		block_90 (dst + dst_stride * y + xx, dst_stride,	      \
+			  src + src_stride * xx + (h - y - BLOCK),	      \
+			  src_stride);					      \
+	    }								      \
+	}								      \
+    }									      \
+									      \
+    for (y = 0; y < h; y++)						      \
+    {									      \
+	const pix_type *s = src + (h - y - 1);				      \
+	pix_type *d = dst + dst_stride * y;				      \
+									      \
+	for (x = 0; x < x0; x++)					      \
+	    d[x] = s[src_stride * x];					      \
+	for (x = y < y1 ? x1 : x0; x < w; x++)				      \
+	    d[x] = s[src_stride * x];					      \
+    }									      \
+}									      \
+									      \
+static void								      \
+blt_rotated_270_##suffix (pix_type       *dst,				      \
+			  int             dst_stride,			      \
+			  const pix_type *src,				      \
+			  int             src_stride,			      \
+			  int             w,				      \
+			  int             h)				      \
+{									      \
+    const int tile = SIMPLE_ROTATE_TILE_BYTES / sizeof (pix_type);	      \
+    int x0, x1, y1, x, y, xx, x_end;					      \
+									      \
+    x0 = ((-(uintptr_t)dst) & (SIMPLE_ROTATE_TILE_BYTES - 1)) /		      \
+	sizeof (pix_type);						      \
+    if (x0 > w)								      \
+	x0 = w;								      \
+    x1 = w - (w - x0) % BLOCK;						      \
+    y1 = h - h % BLOCK;							      \
+									      \
+    for (x = x0; x < x1; x += tile)					      \
+    {									      \
+	x_end = x + tile < x1 ? x + tile : x1;				      \
+									      \
+	for (y = 0; y < y1; y += BLOCK)					      \
+	{								      \
+	    for (xx = x; xx < x_end; xx += BLOCK)			      \
+	    {								      \
+		block_270 (dst + dst_stride * y + xx, dst_stride,	      \
+			   src + src_stride * (w - xx - BLOCK) + y,	      \
+			   src_stride);					      \
+	    }								      \
+	}								      \
+    }									      \
+									      \
+    for (y = 0; y < h; y++)						      \
+    {									      \
+	const pix_type *s = src + src_stride * (w - 1) + y;		      \
+	pix_type *d = dst + dst_stride * y;				      \
+									      \
+	for (x = 0; x < x0; x++)					      \
+	    d[x] = s[-src_stride * x];					      \
+	for (x = y < y1 ? x1 : x0; x < w; x++)				      \
+	    d[x] = s[-src_stride * x];					      \
+    }									      \
+}									      \
+									      \
+static void								      \
+fast_composite_rotate_90_##suffix (pixman_implementation_t *imp,	      \
+				   pixman_composite_info_t *info)	      \
+{									      \
+    PIXMAN_COMPOSITE_ARGS (info);					      \
+    pixman_fixed_t (*t)[3] = src_image->common.transform->matrix;	      \
+    pix_type *dst_line, *src_line;					      \
+    int dst_stride, src_stride;						      \
+    int src_x_t, src_y_t;						      \
+									      \
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, pix_type,	      \
+			   dst_stride, dst_line, 1);			      \
+    src_x_t = simple_transform_offset (t[0][2]) - src_y - height;	      \
+    src_y_t = simple_transform_offset (t[1][2]) + src_x;		      \
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x_t, src_y_t, pix_type,	      \
+			   src_stride, src_line, 1);			      \
+    blt_rotated_90_##suffix (dst_line, dst_stride, src_line, src_stride,      \
+			     width, height);				      \
+}									      \
+									      \
+static void								      \
+fast_composite_rotate_270_##suffix (pixman_implementation_t *imp,	      \
+				    pixman_composite_info_t *info)	      \
+{									      \
+    PIXMAN_COMPOSITE_ARGS (info);					      \
+    pixman_fixed_t (*t)[3] = src_image->common.transform->matrix;	      \
+    pix_type *dst_line, *src_line;					      \
+    int dst_stride, src_stride;						      \
+    int src_x_t, src_y_t;						      \
+									      \
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, pix_type,	      \
+			   dst_stride, dst_line, 1);			      \
+    src_x_t = simple_transform_offset (t[0][2]) + src_y;		      \
+    src_y_t = simple_transform_offset (t[1][2]) - src_x - width;	      \
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x_t, src_y_t, pix_type,	      \
+			   src_stride, src_line, 1);			      \
+    blt_rotated_270_##suffix (dst_line, dst_stride, src_line, src_stride,     \
+			      width, height);				      \
+}
+
+/*
+ * Mirroring and 180 degree rotation. reverse_line (dst, src, w) copies w
+ * pixels from src to dst in reverse order; the vertical mirror is a plain
+ * copy of the rows in reverse order.
+ */
+#define FAST_SIMPLE_FLIP(suffix, pix_type, reverse_line)		      \
+									      \
+static void								      \
+fast_composite_flip_x_##suffix (pixman_implementation_t *imp,		      \
+				pixman_composite_info_t *info)		      \
+{									      \
+    PIXMAN_COMPOSITE_ARGS (info);					      \
+    pixman_fixed_t (*t)[3] = src_image->common.transform->matrix;	      \
+    pix_type *dst_line, *src_line;					      \
+    int dst_stride, src_stride;						      \
+    int src_x_t, src_y_t;						      \
+									      \
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, pix_type,	      \
+			   dst_stride, dst_line, 1);			      \
+    src_x_t = simple_transform_offset (t[0][2]) - src_x - width;	      \
+    src_y_t = simple_transform_offset (t[1][2]) + src_y;		      \
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x_t, src_y_t, pix_type,	      \
+			   src_stride, src_line, 1);			      \
+									      \
+    while (height--)							      \
+    {									      \
+	reverse_line (dst_line, src_line, width);			      \
+	dst_line += dst_stride;						      \
+	src_line += src_stride;						      \
+    }									      \
+}									      \
+									      \
+static void								      \
+fast_composite_flip_y_##suffix (pixman_implementation_t *imp,		      \
+				pixman_composite_info_t *info)		      \
+{									      \
+    PIXMAN_COMPOSITE_ARGS (info);					      \
+    pixman_fixed_t (*t)[3] = src_image->common.transform->matrix;	      \
+    pix_type *dst_line, *src_line;					      \
+    int dst_stride, src_stride;						      \
+    int src_x_t, src_y_t;						      \
+									      \
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, pix_type,	      \
+			   dst_stride, dst_line, 1);			      \
+    src_x_t = simple_transform_offset (t[0][2]) + src_x;		      \
+    src_y_t = simple_transform_offset (t[1][2]) - src_y - 1;		      \
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x_t, src_y_t, pix_type,	      \
+			   src_stride, src_line, 1);			      \
+									      \
+    while (height--)							      \
+    {									      \
+	memcpy (dst_line, src_line, width * sizeof (pix_type));		      \
+	dst_line += dst_stride;						      \
+	src_line -= src_stride;						      \
+    }									      \
+}									      \
+									      \
+static void								      \
+fast_composite_rotate_180_##suffix (pixman_implementation_t *imp,	      \
+				    pixman_composite_info_t *info)	      \
+{									      \
+    PIXMAN_COMPOSITE_ARGS (info);					      \
+    pixman_fixed_t (*t)[3] = src_image->common.transform->matrix;	      \
+    pix_type *dst_line, *src_line;					      \
+    int dst_stride, src_stride;						      \
+    int src_x_t, src_y_t;						      \
+									      \
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, pix_type,	      \
+			   dst_stride, dst_line, 1);			      \
+    src_x_t = simple_transform_offset (t[0][2]) - src_x - width;	      \
+    src_y_t = simple_transform_offset (t[1][2]) - src_y - 1;		      \
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x_t, src_y_t, pix_type,	      \
+			   src_stride, src_line, 1);			      \
+									      \
+    while (height--)							      \
+    {									      \
+	reverse_line (dst_line, src_line, width);			      \
+	dst_line += dst_stride;						      \
+	src_line -= src_stride;						      \
+    }									      \
+}
+
+#define SIMPLE_ROTATE_FLAGS(angle)					      \
+    (FAST_PATH_ROTATE_ ## angle ## _TRANSFORM	|			      \
+     FAST_PATH_NEAREST_FILTER			|			      \
+     FAST_PATH_SAMPLES_COVER_CLIP_NEAREST	|			      \
+     FAST_PATH_STANDARD_FLAGS)
+
+#define SIMPLE_FLIP_FLAGS(axis)						      \
+    (FAST_PATH_FLIP_ ## axis ## _TRANSFORM	|			      \
+     FAST_PATH_NEAREST_FILTER			|			      \
+     FAST_PATH_SAMPLES_COVER_CLIP_NEAREST	|			      \
+     FAST_PATH_STANDARD_FLAGS)
+
+#define SIMPLE_ROTATE_FAST_PATH(op,s,d,suffix)				      \
+    {   PIXMAN_OP_ ## op,						      \
+	PIXMAN_ ## s, SIMPLE_ROTATE_FLAGS (90),				      \
+	PIXMAN_null, 0,							      \
+	PIXMAN_ ## d, FAST_PATH_STD_DEST_FLAGS,				      \
+	fast_composite_rotate_90_##suffix,				      \
+    },									      \
+    {   PIXMAN_OP_ ## op,						      \
+	PIXMAN_ ## s, SIMPLE_ROTATE_FLAGS (270),			      \
+	PIXMAN_null, 0,							      \
+	PIXMAN_ ## d, FAST_PATH_STD_DEST_FLAGS,				      \
+	fast_composite_rotate_270_##suffix,				      \
+    }
+
+#define SIMPLE_FLIP_FAST_PATH(op,s,d,suffix)				      \
+    {   PIXMAN_OP_ ## op,						      \
+	PIXMAN_ ## s, SIMPLE_ROTATE_FLAGS (180),			      \
+	PIXMAN_null, 0,							      \
+	PIXMAN_ ## d, FAST_PATH_STD_DEST_FLAGS,				      \
+	fast_composite_rotate_180_##suffix,				      \
+    },									      \
+    {   PIXMAN_OP_ ## op,						      \
+	PIXMAN_ ## s, SIMPLE_FLIP_FLAGS (X),				      \
+	PIXMAN_null, 0,							      \
+	PIXMAN_ ## d, FAST_PATH_STD_DEST_FLAGS,				      \
+	fast_composite_flip_x_##suffix,					      \
+    },									      \
+    {   PIXMAN_OP_ ## op,						      \
+	PIXMAN_ ## s, SIMPLE_FLIP_FLAGS (Y),				      \
+	PIXMAN_null, 0,							      \
+	PIXMAN_ ## d, FAST_PATH_STD_DEST_FLAGS,				      \
+	fast_composite_flip_y_##suffix,					      \
+    }
+
+/*****************************************************************************/
+
 /*
  * Identify 5 zones in each scanline for bilinear scaling. Depending on
  * whether 2 pixels to be interpolated are fetched from the image itself,
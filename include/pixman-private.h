@@ -101,6 +101,9 @@ struct image_common
 						     * the image is used as a source
 						     */
     pixman_bool_t		dirty;
+    uint32_t			generation;	    /* Incremented when a property
+						     * changes
+						     */
     pixman_transform_t *        transform;
     pixman_repeat_t             repeat;
     pixman_filter_t             filter;
@@ -133,6 +136,20 @@ struct gradient
     image_common_t	    common;
     int                     n_stops;
     pixman_gradient_stop_t *stops;
+
+    pixman_dither_t         dither;
+    uint32_t                dither_offset_y;
+    uint32_t                dither_offset_x;
+
+    /* Premultiplied color ramp sampled at (1 << (16 - lut_shift))
+     * positions over [0, 1), for the narrow fetchers. It is built by
+     * _pixman_gradient_update_lut() for one repeat mode; lut_16 holds
+     * the same colors in 8.8 fixed point when the gradient is dithered.
+     */
+    uint32_t *              lut;
+    uint64_t *              lut_16;
+    int                     lut_shift;
+    int                     lut_repeat;	/* -1 until lut is built */
 };
 
 struct linear_gradient
@@ -169,6 +186,30 @@ struct conical_gradient
     double		 angle;
 };
 
+/* Reduced copies of a bits image. levels[i] is an a8r8g8b8 image of
+ * half the size of the one before it, with levels[0] half the size of
+ * the image itself.
+ */
+#define PIXMAN_MAX_MIPMAP_LEVELS 16
+
+typedef struct
+{
+    pixman_mipmap_t		mode;
+    pixman_bool_t		valid;		/* FALSE when the bits changed */
+    int				n_levels;	/* Levels built since then */
+
+    /* The level sampled and the weight, from 0 to 255, of the
+     * next level. Level 0 is the image itself.
+     */
+    int				level;
+    int				weight;
+
+    uint32_t			generation;	/* Of the image, when the
+						 * level transforms were set
+						 */
+    pixman_image_t *		levels[PIXMAN_MAX_MIPMAP_LEVELS];
+} mipmap_t;
+
 struct bits_image
 {
     image_common_t             common;
@@ -184,6 +225,13 @@ struct bits_image
     uint32_t                   dither_offset_y;
     uint32_t                   dither_offset_x;
 
+    mipmap_t *                 mipmap;
+
+    /* Y, U and V planes of the planar YUV formats, with strides in bytes */
+    uint8_t *                  planes[3];
+    int                        plane_strides[3];
+    pixman_yuv_matrix_t        yuv_matrix;
+
     fetch_scanline_t           fetch_scanline_32;
     fetch_pixel_32_t	       fetch_pixel_32;
     store_scanline_t           store_scanline_32;
@@ -289,6 +337,110 @@ _pixman_bits_image_src_iter_init (pixman_image_t *image, pixman_iter_t *iter);
 void
 _pixman_bits_image_dest_iter_init (pixman_image_t *image, pixman_iter_t *iter);
 
+void
+_pixman_bits_image_update_mipmap (bits_image_t *image);
+
+pixman_bool_t
+_pixman_bits_image_overlaps (bits_image_t *a, bits_image_t *b);
+
+void
+_pixman_bits_image_dither_row (bits_image_t *image,
+			       int           x,
+			       int           y,
+			       float        *factors,
+			       int           width);
+
+/* Scanlines of yuy2 and planar YUV images are converted to a8r8g8b8 by the
+ * convert kernel. Scaled images are then sampled from the converted
+ * scanlines, with the bilinear kernel for the bilinear filter.
+ */
+typedef void (* pixman_yuv_convert_t) (bits_image_t *image,
+				       int           x,
+				       int           y,
+				       int           width,
+				       uint32_t     *buffer);
+
+typedef void (* pixman_yuv_bilinear_t) (uint32_t       *buffer,
+					const uint32_t *top,
+					const uint32_t *bottom,
+					int             width,
+					int             wt,
+					int             wb,
+					pixman_fixed_t  vx,
+					pixman_fixed_t  unit_x);
+
+/* The store kernel converts an even number of pixels, starting at an
+ * even x, to YUV. It writes the luma of each pixel and adds the U and
+ * the V of each pair of pixels to chroma[0] and chroma[1], chroma[2]
+ * and chroma[3], and so on.
+ */
+typedef void (* pixman_yuv_store_t) (bits_image_t   *image,
+				     const uint32_t *pixels,
+				     int             width,
+				     uint8_t        *luma,
+				     uint16_t       *chroma);
+
+typedef struct
+{
+    pixman_yuv_convert_t	convert;
+    pixman_yuv_bilinear_t	bilinear;
+    pixman_yuv_store_t		store;
+} pixman_yuv_kernels_t;
+
+void
+_pixman_yuv_iter_init (pixman_iter_t              *iter,
+		       const pixman_iter_info_t   *iter_info,
+		       const pixman_yuv_kernels_t *kernels);
+
+void
+_pixman_yuv_dest_iter_init (pixman_iter_t              *iter,
+			    const pixman_yuv_kernels_t *kernels);
+
+/* Conversions of a YUV color space. YUV to RGB is in 16.16 fixed point
+ * on Y - y_offset, U - 128 and V - 128. RGB to YUV is in 1.15 fixed
+ * point, with the sums rounded down after adding one half.
+ */
+typedef struct
+{
+    int32_t	y_offset;
+    int32_t	y, rv, gu, gv, bu;
+
+    int16_t	yr, yg, yb;
+    int16_t	ur, ug, ub;
+    int16_t	vr, vg, vb;
+} pixman_yuv_coefficients_t;
+
+extern const pixman_yuv_coefficients_t _pixman_yuv_coefficients[];
+
+#define YUV_COEFFICIENTS(image)						\
+    (&_pixman_yuv_coefficients[(image)->yuv_matrix])
+
+/* Planar YUV access. The chroma of nv12 is interleaved, so its U and
+ * V planes are the same plane one byte apart, with a step of two bytes
+ * between samples.
+ */
+#define PIXMAN_FORMAT_PLANAR(f)						\
+    ((f) == PIXMAN_yv12 || (f) == PIXMAN_nv12 || (f) == PIXMAN_i420)
+
+#define YUV_CHROMA_STEP(image)						\
+    ((image)->format == PIXMAN_nv12 ? 2 : 1)
+
+#define YUV_Y_LINE(image, line)						\
+    ((image)->planes[0] + (image)->plane_strides[0] * (line))
+
+#define YUV_U_LINE(image, line)						\
+    ((image)->planes[1] + (image)->plane_strides[1] * ((line) >> 1))
+
+#define YUV_V_LINE(image, line)						\
+    ((image)->planes[2] + (image)->plane_strides[2] * ((line) >> 1))
+
+int
+_pixman_gradient_lut_shift (const pixman_gradient_stop_t *stops,
+			    int                           n_stops);
+
+void
+_pixman_gradient_update_lut (gradient_t *gradient);
+
 void
 _pixman_linear_gradient_iter_init (pixman_image_t *image, pixman_iter_t  *iter);
 
@@ -315,6 +467,11 @@ _pixman_image_fini (pixman_image_t *image);
 pixman_image_t *
 _pixman_image_allocate (void);
 
+pixman_image_t *
+_pixman_image_create_scratch_bits (pixman_format_code_t format,
+				   int                  width,
+				   int                  height);
+
 pixman_bool_t
 _pixman_init_gradient (gradient_t *                  gradient,
                        const pixman_gradient_stop_t *stops,
@@ -356,12 +513,25 @@ typedef struct
     pixman_repeat_t	    repeat;
 
     pixman_bool_t           need_reset;
+
+    /* Set when the narrow writers can look the color up in the
+     * gradient's ramp. Dithering needs the position of the pixel,
+     * which is found from its offset in the iterator's buffer.
+     */
+    const uint32_t *        lut;
+    const uint64_t *        lut_16;
+    int                     lut_shift;
+    pixman_dither_t         dither;
+    const uint32_t *        buffer;
+    int                     dither_x;
+    int                     dither_y;
 } pixman_gradient_walker_t;
 
 void
 _pixman_gradient_walker_init (pixman_gradient_walker_t *walker,
                               gradient_t *              gradient,
-			      pixman_repeat_t           repeat);
+			      pixman_repeat_t           repeat,
+			      pixman_iter_t *           iter);
 
 void
 _pixman_gradient_walker_reset (pixman_gradient_walker_t *walker,
@@ -400,6 +570,83 @@ _pixman_gradient_walker_fill_wide(pixman_gradient_walker_t *walker,
 				  uint32_t                 *buffer,
 				  uint32_t                 *end);
 
+/*
+ * Gradient iterators with SIMD kernels, for affine transformations
+ *
+ * The position kernels write the position of each pixel of a scanline
+ * as the gradient walker takes it, except that it is reduced to
+ * [0, 2 * pixman_fixed_1) for PIXMAN_REPEAT_NORMAL and REFLECT, and
+ * clamped to [-1, pixman_fixed_1 + 1] for PAD and NONE, so for those
+ * the kernels are only used when all stops are inside [0, 1]. Pixels
+ * that are not painted get PIXMAN_GRADIENT_CLEAR. The write kernels turn
+ * the positions into colors; the narrow one is only used when the
+ * gradient has a ramp for its repeat mode and is not dithered.
+ *
+ * The conical kernel approximates atan2() with a polynomial, which is
+ * only precise enough for 8-bit channels, so it is used for narrow
+ * iterators only.
+ */
+#define PIXMAN_GRADIENT_CLEAR INT32_MIN
+
+/* B and C of the radial gradient equation for a pixel and their
+ * differences to the next pixel, see radial_get_scanline()
+ */
+typedef struct
+{
+    pixman_fixed_32_32_t b, db;
+    pixman_fixed_32_32_t c, dc, ddc;
+} radial_step_t;
+
+typedef void (* pixman_gradient_linear_t) (int32_t         *positions,
+					   double           t,
+					   double           inc,
+					   pixman_repeat_t  repeat,
+					   int              width);
+
+typedef void (* pixman_gradient_radial_t) (int32_t                 *positions,
+					   const radial_gradient_t *radial,
+					   pixman_repeat_t          repeat,
+					   radial_step_t           *step,
+					   int                      width);
+
+typedef void (* pixman_gradient_conical_t) (int32_t *positions,
+					    double   x,
+					    double   y,
+					    double   dx,
+					    double   dy,
+					    double   angle,
+					    int      width);
+
+typedef void (* pixman_gradient_write_t) (pixman_gradient_walker_t *walker,
+					  uint32_t                 *buffer,
+					  const int32_t            *positions,
+					  int                       width);
+
+typedef struct
+{
+    pixman_gradient_linear_t	linear;
+    pixman_gradient_radial_t	radial;
+    pixman_gradient_conical_t	conical;
+    pixman_gradient_write_t	write_narrow;
+    pixman_gradient_write_t	write_wide;
+} pixman_gradient_kernels_t;
+
+void
+_pixman_gradient_iter_init (pixman_iter_t                   *iter,
+			    const pixman_gradient_kernels_t *kernels);
+
+void
+_pixman_linear_gradient_kernel_iter_init (pixman_iter_t                   *iter,
+					  const pixman_gradient_kernels_t *kernels);
+
+void
+_pixman_radial_gradient_kernel_iter_init (pixman_iter_t                   *iter,
+					  const pixman_gradient_kernels_t *kernels);
+
+void
+_pixman_conical_gradient_kernel_iter_init (pixman_iter_t                   *iter,
+					   const pixman_gradient_kernels_t *kernels);
+
 /*
  * Edges
  */
@@ -435,6 +682,7 @@ pixman_rasterize_edges_accessors (pixman_image_t *image,
  * Implementations
  */
 typedef struct pixman_implementation_t pixman_implementation_t;
+typedef struct pixman_fast_path_index_t pixman_fast_path_index_t;
 
 typedef struct
 {
@@ -484,6 +732,25 @@ typedef void (*pixman_combine_float_func_t) (pixman_implementation_t *imp,
 					     const float *	      mask,
 					     int		      n_pixels);
 
+/* Porter/Duff blend factors used by the float combiners */
+typedef enum
+{
+    ZERO,
+    ONE,
+    SRC_ALPHA,
+    DEST_ALPHA,
+    INV_SA,
+    INV_DA,
+    SA_OVER_DA,
+    DA_OVER_SA,
+    INV_SA_OVER_DA,
+    INV_DA_OVER_SA,
+    ONE_MINUS_SA_OVER_DA,
+    ONE_MINUS_DA_OVER_SA,
+    ONE_MINUS_INV_DA_OVER_SA,
+    ONE_MINUS_INV_SA_OVER_DA
+} combine_factor_t;
+
 typedef void (*pixman_composite_func_t) (pixman_implementation_t *imp,
 					 pixman_composite_info_t *info);
 typedef pixman_bool_t (*pixman_blt_func_t) (pixman_implementation_t *imp,
@@ -526,10 +793,12 @@ typedef struct
 
 struct pixman_implementation_t
 {
+    const char *		name;
     pixman_implementation_t *	toplevel;
     pixman_implementation_t *	fallback;
     const pixman_fast_path_t *	fast_paths;
     const pixman_iter_info_t *  iter_info;
+    pixman_fast_path_index_t *	fast_path_index;
 
     pixman_blt_func_t		blt;
     pixman_fill_func_t		fill;
@@ -605,6 +874,131 @@ _pixman_implementation_iter_init (pixman_implementation_t       *imp,
                                   iter_flags_t                   flags,
                                   uint32_t                       image_flags);
 
+/* Parallel compositing */
+pixman_bool_t
+_pixman_composite_parallel (pixman_implementation_t *      imp,
+			    pixman_composite_func_t        func,
+			    const pixman_composite_info_t *info,
+			    const pixman_box32_t *         boxes,
+			    int                            n_boxes,
+			    int32_t                        src_dx,
+			    int32_t                        src_dy,
+			    int32_t                        mask_dx,
+			    int32_t                        mask_dy);
+
+/* Composite statistics */
+extern int _pixman_statistics_enabled;
+
+void
+_pixman_statistics_init (void);
+
+void
+_pixman_statistics_record (pixman_implementation_t *      imp,
+			   pixman_composite_func_t        func,
+			   const pixman_composite_info_t *info,
+			   pixman_format_code_t           src_format,
+			   pixman_format_code_t           mask_format,
+			   const pixman_box32_t *         boxes,
+			   int                            n_boxes);
+
+void
+_pixman_statistics_count_lookup (pixman_bool_t hit);
+
+/* Composite traces
+ *
+ * A trace is a file of 32-bit words in the byte order of the machine
+ * that wrote it. It starts with PIXMAN_TRACE_MAGIC and
+ * PIXMAN_TRACE_VERSION. Each record that follows is a type word, a
+ * word count, and that many words of arguments. Images are written as
+ * descriptors: their type, geometry and properties, but no pixels.
+ */
+#define PIXMAN_TRACE_MAGIC	0x52545850	/* "PXTR" */
+#define PIXMAN_TRACE_VERSION	2
+
+typedef enum
+{
+    PIXMAN_TRACE_COMPOSITE = 1,
+    PIXMAN_TRACE_FILL_BOXES,
+    PIXMAN_TRACE_TRAPEZOIDS,
+    PIXMAN_TRACE_GLYPHS
+} pixman_trace_record_t;
+
+extern int _pixman_trace_enabled;
+
+void
+_pixman_trace_init (void);
+
+void
+_pixman_trace_composite (pixman_op_t      op,
+			 pixman_image_t * src,
+			 pixman_image_t * mask,
+			 pixman_image_t * dest,
+			 int32_t          src_x,
+			 int32_t          src_y,
+			 int32_t          mask_x,
+			 int32_t          mask_y,
+			 int32_t          dest_x,
+			 int32_t          dest_y,
+			 int32_t          width,
+			 int32_t          height);
+
+void
+_pixman_trace_fill_boxes (pixman_op_t           op,
+			  pixman_image_t *      dest,
+			  const pixman_color_t *color,
+			  int                   n_boxes,
+			  const pixman_box32_t *boxes);
+
+void
+_pixman_trace_trapezoids (pixman_op_t               op,
+			  pixman_image_t *          src,
+			  pixman_image_t *          dst,
+			  pixman_format_code_t      mask_format,
+			  int                       x_src,
+			  int                       y_src,
+			  int                       x_dst,
+			  int                       y_dst,
+			  int                       n_traps,
+			  const pixman_trapezoid_t *traps);
+
+void
+_pixman_trace_glyphs (pixman_op_t            op,
+		      pixman_image_t *       src,
+		      pixman_image_t *       dest,
+		      pixman_format_code_t   mask_format,
+		      int32_t                src_x,
+		      int32_t                src_y,
+		      int32_t                mask_x,
+		      int32_t                mask_y,
+		      int32_t                dest_x,
+		      int32_t                dest_y,
+		      int32_t                width,
+		      int32_t                height,
+		      int                    n_glyphs,
+		      const pixman_glyph_t * glyphs);
+
+pixman_image_t *
+_pixman_glyph_get_image (const void *glyph,
+			 int *       origin_x,
+			 int *       origin_y);
+
+/* Same as pixman_image_composite32(), but not traced. Used when pixman
+ * composites on behalf of another traced call.
+ */
+void
+_pixman_image_composite32 (pixman_op_t      op,
+			   pixman_image_t * src,
+			   pixman_image_t * mask,
+			   pixman_image_t * dest,
+			   int32_t          src_x,
+			   int32_t          src_y,
+			   int32_t          mask_x,
+			   int32_t          mask_y,
+			   int32_t          dest_x,
+			   int32_t          dest_y,
+			   int32_t          width,
+			   int32_t          height);
+
 /* Specific implementations */
 pixman_implementation_t *
 _pixman_implementation_create_general (void);
@@ -630,6 +1024,16 @@ pixman_implementation_t *
 _pixman_implementation_create_ssse3 (pixman_implementation_t *fallback);
 #endif
 
+#ifdef USE_AVX2
+pixman_implementation_t *
+_pixman_implementation_create_avx2 (pixman_implementation_t *fallback);
+#endif
+
+#ifdef USE_AVX512
+pixman_implementation_t *
+_pixman_implementation_create_avx512 (pixman_implementation_t *fallback);
+#endif
+
 #ifdef USE_ARM_SIMD
 pixman_implementation_t *
 _pixman_implementation_create_arm_simd (pixman_implementation_t *fallback);
@@ -699,6 +1103,38 @@ _pixman_iter_get_scanline_noop (pixman_iter_t *iter, const uint32_t *mask);
 void
 _pixman_iter_init_bits_stride (pixman_iter_t *iter, const pixman_iter_info_t *info);
 
+/* Separable convolution iterator for scaled images. It filters every
+ * source row it needs once with the x weights and keeps the results in
+ * a ring of rows, so that each destination row only has to filter those
+ * rows with the y weights. Implementations supply the two filters.
+ *
+ * The row filter writes the four channel sums of each destination pixel
+ * as 32 bit integers. Pixel k is filtered from src + offsets[k] with the
+ * weights in weights[k], which are padded with zeros to an even number of
+ * taps. Each weight w is split in two 16 bit halves, w >> 8 and w & 0xff,
+ * so that SIMD implementations can use 16 bit multiply-adds; for every
+ * pair of taps the two high halves come first and then the two low ones.
+ * The column filter multiplies rows by y weights in 16.16 fixed point and
+ * reduces the sums with separable_convolution_reduce().
+ */
+typedef void (* pixman_convolve_row_t) (int32_t         *dest,
+					const uint32_t  *src,
+					const int32_t   *offsets,
+					const int16_t  **weights,
+					int              n_taps,
+					int              width);
+
+typedef void (* pixman_convolve_column_t) (uint32_t              *dest,
+					   const int32_t        **rows,
+					   const pixman_fixed_t  *weights,
+					   int                    n_rows,
+					   int                    width);
+
+void
+_pixman_separable_convolution_iter_init (pixman_iter_t            *iter,
+					 pixman_convolve_row_t     convolve_row,
+					 pixman_convolve_column_t  convolve_column);
+
 /* These "formats" all have depth 0, so they
  * will never clash with any real ones
  */
@@ -738,6 +1174,11 @@ _pixman_iter_init_bits_stride (pixman_iter_t *iter, const pixman_iter_info_t *in
 #define FAST_PATH_SAMPLES_COVER_CLIP_BILINEAR	(1 << 24)
 #define FAST_PATH_BITS_IMAGE			(1 << 25)
 #define FAST_PATH_SEPARABLE_CONVOLUTION_FILTER  (1 << 26)
+#define FAST_PATH_MIPMAP			(1 << 27)
+#define FAST_PATH_FLIP_X_TRANSFORM		(1 << 28)
+#define FAST_PATH_FLIP_Y_TRANSFORM		(1 << 29)
+#define FAST_PATH_ORDERED_DITHER		(1 << 30)
+#define FAST_PATH_NO_DITHER			(1U << 31)
 
 #define FAST_PATH_PAD_REPEAT						\
     (FAST_PATH_NO_NONE_REPEAT		|				\
@@ -770,6 +1211,37 @@ _pixman_iter_init_bits_stride (pixman_iter_t *iter, const pixman_iter_info_t *in
      FAST_PATH_NO_ALPHA_MAP		|				\
      FAST_PATH_NARROW_FORMAT)
 
+#define FAST_PATH_DITHER_DEST_FLAGS					\
+    (FAST_PATH_NO_ACCESSORS		|				\
+     FAST_PATH_NO_ALPHA_MAP		|				\
+     FAST_PATH_ORDERED_DITHER)
+
+/* Dithering is done on the wide path, so a dithered destination is
+ * composited without FAST_PATH_NARROW_FORMAT, like general_composite_rect()
+ * treats it. Only the fast paths that dither themselves match it then.
+ */
+#define DEST_FLAGS(image)						\
+    (((image)->common.flags & FAST_PATH_ORDERED_DITHER) ?		\
+     (image)->common.flags & ~FAST_PATH_NARROW_FORMAT :		\
+     (image)->common.flags)
+
+/* a8r8g8b8_sRGB is a wide format, so the sRGB fast paths take the
+ * standard flags without FAST_PATH_NARROW_FORMAT, for the 8888 images
+ * too.
+ */
+#define FAST_PATH_SRGB_SOURCE_FLAGS					\
+    (FAST_PATH_NO_CONVOLUTION_FILTER	|				\
+     FAST_PATH_NO_ACCESSORS		|				\
+     FAST_PATH_NO_ALPHA_MAP		|				\
+     FAST_PATH_SAMPLES_COVER_CLIP_NEAREST |				\
+     FAST_PATH_NEAREST_FILTER		|				\
+     FAST_PATH_ID_TRANSFORM)
+
+#define FAST_PATH_SRGB_DEST_FLAGS					\
+    (FAST_PATH_NO_ACCESSORS		|				\
+     FAST_PATH_NO_ALPHA_MAP		|				\
+     FAST_PATH_NO_DITHER)
+
 #define SOURCE_FLAGS(format)						\
     (FAST_PATH_STANDARD_FLAGS |						\
      ((PIXMAN_ ## format == PIXMAN_solid) ?				\
@@ -796,6 +1268,22 @@ _pixman_iter_init_bits_stride (pixman_iter_t *iter, const pixman_iter_info_t *in
 	    dest, FAST_PATH_STD_DEST_FLAGS,				\
 	    func) }
 
+#define PIXMAN_DITHER_FAST_PATH(op, src, dest, func)			\
+    { FAST_PATH (							\
+	    op,								\
+	    src,  SOURCE_FLAGS (src),					\
+	    null, 0,							\
+	    dest, FAST_PATH_DITHER_DEST_FLAGS,				\
+	    func) }
+
+#define PIXMAN_SRGB_FAST_PATH(op, src, dest, func)			\
+    { FAST_PATH (							\
+	    op,								\
+	    src,  FAST_PATH_SRGB_SOURCE_FLAGS,				\
+	    null, 0,							\
+	    dest, FAST_PATH_SRGB_DEST_FLAGS,				\
+	    func) }
+
 #define PIXMAN_STD_FAST_PATH_CA(op, src, mask, dest, func)		\
     { FAST_PATH (							\
 	    op,								\
@@ -832,6 +1320,15 @@ pixman_malloc_abc (unsigned int a, unsigned int b, unsigned int c);
 void *
 pixman_malloc_ab_plus_c (unsigned int a, unsigned int b, unsigned int c);
 
+/* Temporary memory from a per-thread arena. Blocks must be freed with
+ * _pixman_scratch_free() before the call that allocated them returns.
+ */
+void *
+_pixman_scratch_alloc (size_t size);
+
+void
+_pixman_scratch_free (void *ptr);
+
 pixman_bool_t
 _pixman_multiply_overflows_size (size_t a, size_t b);
 
@@ -1046,6 +1543,21 @@ unorm_to_unorm (uint32_t val, int from_bits, int to_bits)
 uint16_t pixman_float_to_unorm (float f, int n_bits);
 float pixman_unorm_to_float (uint16_t u, int n_bits);
 
+/* sRGB conversions of 16 bit linear values, in pixman-srgb.c. See
+ * make-srgb.pl for the layout of the encoding table.
+ */
+extern const uint16_t _pixman_srgb_to_linear16[];
+extern const uint16_t _pixman_linear_to_srgb[];
+
+/* The sRGB level nearest to a 16 bit linear value */
+static force_inline uint32_t
+pixman_linear_to_srgb (uint32_t v)
+{
+    uint32_t e = _pixman_linear_to_srgb[v >> 4];
+
+    return (e & 0xff) + ((v & 15) >= (e >> 8));
+}
+
 /*
  * Various debugging code
  */
@@ -354,6 +354,32 @@ typedef enum
     PIXMAN_DITHER_ORDERED_BLUE_NOISE_64,
 } pixman_dither_t;
 
+/* Color spaces of the YUV formats. Limited range puts luma in [16, 235]
+ * and chroma in [16, 240]; full range uses all of [0, 255].
+ */
+typedef enum
+{
+    PIXMAN_YUV_BT601,
+    PIXMAN_YUV_BT601_FULL_RANGE,
+    PIXMAN_YUV_BT709,
+    PIXMAN_YUV_BT709_FULL_RANGE,
+} pixman_yuv_matrix_t;
+
+/* Mipmapping of downscaled bits images. The image keeps a pyramid of
+ * box filtered copies of itself, each half the size of the previous
+ * one. When a bilinear (or GOOD/BEST) filtered image is reduced by
+ * an affine transform by a factor of two or more, the best fitting
+ * level is sampled instead, or two of them blended in the TRILINEAR
+ * mode. The pyramid is built the first time it is needed and kept
+ * until the image is marked dirty.
+ */
+typedef enum
+{
+    PIXMAN_MIPMAP_NONE,
+    PIXMAN_MIPMAP_BILINEAR,
+    PIXMAN_MIPMAP_TRILINEAR
+} pixman_mipmap_t;
+
 typedef enum
 {
     PIXMAN_FILTER_FAST,
@@ -860,6 +886,8 @@ struct pixman_indexed
 #define PIXMAN_TYPE_RGBA	9
 #define PIXMAN_TYPE_ARGB_SRGB	10
 #define PIXMAN_TYPE_RGBA_FLOAT	11
+#define PIXMAN_TYPE_NV12	12
+#define PIXMAN_TYPE_I420	13
 
 #define PIXMAN_FORMAT_COLOR(f)				\
 	(PIXMAN_FORMAT_TYPE(f) == PIXMAN_TYPE_ARGB ||	\
@@ -941,7 +969,9 @@ typedef enum {
 
 /* YUV formats */
     PIXMAN_yuy2 =	 PIXMAN_FORMAT(16,PIXMAN_TYPE_YUY2,0,0,0,0),
-    PIXMAN_yv12 =	 PIXMAN_FORMAT(12,PIXMAN_TYPE_YV12,0,0,0,0)
+    PIXMAN_yv12 =	 PIXMAN_FORMAT(12,PIXMAN_TYPE_YV12,0,0,0,0),
+    PIXMAN_nv12 =	 PIXMAN_FORMAT(12,PIXMAN_TYPE_NV12,0,0,0,0),
+    PIXMAN_i420 =	 PIXMAN_FORMAT(12,PIXMAN_TYPE_I420,0,0,0,0)
 } pixman_format_code_t;
 
 /* Querying supported format values. */
@@ -989,6 +1019,19 @@ pixman_image_t *pixman_image_create_bits_no_clear    (pixman_format_code_t forma
 						      uint32_t *           bits,
 						      int                  rowstride_bytes);
 
+/* Creates a yv12, nv12 or i420 image on planes that need not be
+ * contiguous. planes and strides hold the luma plane followed by the
+ * chroma planes in the order of the format: V then U for yv12, the
+ * interleaved U and V plane for nv12 and U then V for i420. Strides are
+ * in bytes. The planes are not copied and must outlive the image.
+ */
+PIXMAN_API
+pixman_image_t *pixman_image_create_planar           (pixman_format_code_t format,
+						      int                  width,
+						      int                  height,
+						      uint8_t * const *    planes,
+						      const int *          strides);
+
 /* Destructor */
 PIXMAN_API
 pixman_image_t *pixman_image_ref                     (pixman_image_t               *image);
@@ -1026,6 +1069,9 @@ PIXMAN_API
 void            pixman_image_set_repeat              (pixman_image_t               *image,
 						      pixman_repeat_t               repeat);
 
+/* On a gradient, dithering is applied to its colors when they are
+ * fetched with 8 bits per channel.
+ */
 PIXMAN_API
 void            pixman_image_set_dither              (pixman_image_t               *image,
 						      pixman_dither_t               dither);
@@ -1035,6 +1081,27 @@ void            pixman_image_set_dither_offset       (pixman_image_t
 						      int                           offset_x,
 						      int                           offset_y);
 
+/* Sets the color space that a YUV image is read and written in. The
+ * default is PIXMAN_YUV_BT601.
+ *
+ * When a planar YUV image is a destination, each chroma sample is the
+ * average of the 2x2 pixels it covers. Pixels of the block outside the
+ * composited area count with the chroma that is already there.
+ */
+PIXMAN_API
+void            pixman_image_set_yuv_matrix          (pixman_image_t               *image,
+						      pixman_yuv_matrix_t           matrix);
+
+PIXMAN_API
+pixman_bool_t   pixman_image_set_mipmap              (pixman_image_t               *image,
+						      pixman_mipmap_t               mipmap);
+
+/* Discards the cached mipmap levels of an image after its bits have
+ * been modified other than through pixman.
+ */
+PIXMAN_API
+void            pixman_image_mark_dirty              (pixman_image_t               *image);
+
 PIXMAN_API
 pixman_bool_t   pixman_image_set_filter              (pixman_image_t               *image,
 						      pixman_filter_t               filter,
@@ -1170,6 +1237,66 @@ void          pixman_image_composite32        (pixman_op_t        op,
 					       int32_t            width,
 					       int32_t            height);
 
+/* Composites many (source, mask) pairs onto one destination with the
+ * same operator. The result is the same as calling
+ * pixman_image_composite32() for each item in order, but validation of
+ * the destination is done once and consecutive items whose images have
+ * the same formats and flags share a single fast path lookup. Without
+ * clip regions, alpha maps and transforms, consecutive items with the
+ * same source and mask also share their flags and operator.
+ */
+typedef struct pixman_composite_item pixman_composite_item_t;
+
+struct pixman_composite_item
+{
+    pixman_image_t *	src;
+    pixman_image_t *	mask;
+    int32_t		src_x, src_y;
+    int32_t		mask_x, mask_y;
+    int32_t		dest_x, dest_y;
+    int32_t		width, height;
+};
+
+PIXMAN_API
+void          pixman_composite_batch          (pixman_op_t                    op,
+					       pixman_image_t                *dest,
+					       int                            n_items,
+					       const pixman_composite_item_t *items);
+
+/* A composite plan records a pixman_image_composite32() call together
+ * with the work that only depends on the images' properties: the
+ * composite region, the image flags, the operator and the composite
+ * function. Executing the plan gives the same result as making the call
+ * again, but skips that work as long as no property of the images has
+ * changed since the plan was last executed. Changes to pixel data do
+ * not invalidate a plan.
+ *
+ * The plan holds references to the images. A plan must not be executed
+ * by several threads at once.
+ */
+typedef struct pixman_composite_plan pixman_composite_plan_t;
+
+PIXMAN_API
+pixman_composite_plan_t *
+              pixman_composite_plan_create    (pixman_op_t                    op,
+					       pixman_image_t                *src,
+					       pixman_image_t                *mask,
+					       pixman_image_t                *dest,
+					       int32_t                        src_x,
+					       int32_t                        src_y,
+					       int32_t                        mask_x,
+					       int32_t                        mask_y,
+					       int32_t                        dest_x,
+					       int32_t                        dest_y,
+					       int32_t                        width,
+					       int32_t                        height);
+
+PIXMAN_API
+void          pixman_composite_plan_execute   (pixman_composite_plan_t       *plan);
+
+PIXMAN_API
+void          pixman_composite_plan_destroy   (pixman_composite_plan_t       *plan);
+
 /* Executive Summary: This function is a no-op that only exists
  * for historical reasons.
  *
@@ -1191,6 +1318,114 @@ void          pixman_image_composite32        (pixman_op_t        op,
 PIXMAN_API
 void pixman_disable_out_of_bounds_workaround (void);
 
+/*
+ * Parallel compositing
+ *
+ * When a thread pool is set, pixman_image_composite32() splits large
+ * composites into bands of rows and runs the bands on the pool. The
+ * result is the same as compositing serially.
+ *
+ * A pool's run function must call task (task_data, i) once for each i
+ * in [0, n_tasks) and return only when all calls have finished. The
+ * calls may happen in any order and on any thread, including the
+ * calling one.
+ *
+ * The pool is global. It must not be changed while other threads are
+ * compositing.
+ */
+typedef void (* pixman_parallel_task_t)   (void                   *task_data,
+					   int                     index);
+
+typedef void (* pixman_thread_pool_run_t) (void                   *pool_data,
+					   pixman_parallel_task_t  task,
+					   void                   *task_data,
+					   int                     n_tasks);
+
+/* Use an application provided pool with n_threads threads. Passing a
+ * NULL run function or n_threads <= 1 turns parallel compositing off.
+ */
+PIXMAN_API
+void          pixman_set_thread_pool          (pixman_thread_pool_run_t  run,
+					       void                     *pool_data,
+					       int                       n_threads);
+
+/* Use pixman's own pool with n_threads threads, counting the thread that
+ * calls pixman_image_composite32(). Passing n_threads <= 1 turns parallel
+ * compositing off. Returns FALSE if the threads could not be created or
+ * pixman was built without thread support.
+ */
+PIXMAN_API
+pixman_bool_t pixman_set_threads              (int                       n_threads);
+
+/* Pixman keeps a per-thread arena for the temporary buffers it needs
+ * while compositing. The arena is trimmed automatically when it stays
+ * much larger than what is used, and, on systems with pthreads, freed
+ * when the thread exits. This frees the calling thread's arena right
+ * away. Without pthreads, as on Windows, a thread that composites must
+ * call it before it exits, or its arena is leaked; the threads of
+ * pixman's own pool do so.
+ */
+PIXMAN_API
+void          pixman_release_scratch_memory   (void);
+
+/*
+ * Composite statistics
+ *
+ * When statistics are enabled, each thread counts the composites it
+ * runs, grouped by signature: the operator, formats and flags that were
+ * used to look up a fast path, together with the implementation and
+ * function that were chosen. Composites served by the "general"
+ * implementation have no fast path and go through the slow, generic
+ * pipeline.
+ *
+ * The hits and misses of the per-thread fast path cache are counted
+ * as well.
+ *
+ * Setting the PIXMAN_STATISTICS environment variable enables statistics
+ * when pixman is loaded and prints them to stderr at exit.
+ */
+typedef struct pixman_composite_statistics pixman_composite_statistics_t;
+
+struct pixman_composite_statistics
+{
+    pixman_op_t			op;
+    pixman_format_code_t	src_format;
+    pixman_format_code_t	mask_format;
+    pixman_format_code_t	dest_format;
+
+    /* Internal image flags. Their meaning may change between releases. */
+    uint32_t			src_flags;
+    uint32_t			mask_flags;
+    uint32_t			dest_flags;
+
+    const char *		implementation;
+    const void *		function;
+
+    uint64_t			n_calls;
+    uint64_t			n_boxes;
+    uint64_t			n_pixels;
+};
+
+PIXMAN_API
+void          pixman_enable_statistics        (pixman_bool_t                  enable);
+
+/* Stores up to n_stats entries, summed over all threads and sorted by
+ * decreasing pixel count, and returns the total number of entries.
+ */
+PIXMAN_API
+int           pixman_get_statistics           (pixman_composite_statistics_t *stats,
+					       int                            n_stats);
+
+/* Returns the number of fast path lookups, summed over all threads, that
+ * were served by the per-thread cache and that missed it.
+ */
+PIXMAN_API
+void          pixman_get_cache_statistics     (uint64_t                      *n_hits,
+					       uint64_t                      *n_misses);
+
+PIXMAN_API
+void          pixman_reset_statistics         (void);
+
 /*
  * Glyphs
  */
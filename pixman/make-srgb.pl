@@ -1,20 +1,10 @@
 #!/usr/bin/perl -w
 
-use strict;
-
-sub linear_to_srgb
-{
-    my ($c) = @_;
+# Generates pixman-srgb.c:
+#
+#     perl make-srgb.pl > pixman-srgb.c
 
-    if ($c < 0.0031308)
-    {
-	return $c * 12.92;
-    }
-    else
-    {
-	return 1.055 * $c ** (1.0/2.4) - 0.055;
-    }
-}
+use strict;
 
 sub srgb_to_linear
 {
@@ -30,48 +20,77 @@ sub srgb_to_linear
     }
 }
 
-my @linear_to_srgb;
-for my $linear (0 .. 4095)
+# 16 bit linear value of each sRGB level
+my @srgb_to_linear;
+for my $srgb (0 .. 255)
 {
-    my $srgb = int(linear_to_srgb($linear / 4095.0) * 255.0 + 0.5);
-    push @linear_to_srgb, $srgb;
+    push @srgb_to_linear, int(srgb_to_linear($srgb / 255.0) * 65535.0 + 0.5);
 }
 
-my @srgb_to_linear;
-for my $srgb (0 .. 255)
+# The smallest 16 bit linear value that is closer to level $srgb + 1
+# than to level $srgb, with ties going to the lower level.
+my @thresholds;
+for my $srgb (0 .. 254)
 {
-    my $linear = int(srgb_to_linear($srgb / 255.0) * 65535.0 + 0.5);
-    push @srgb_to_linear, $linear;
+    my $mid = (srgb_to_linear($srgb / 255.0) +
+	       srgb_to_linear(($srgb + 1) / 255.0)) / 2;
+
+    push @thresholds, int($mid * 65535.0) + 1;
 }
 
-# Ensure that we have a lossless sRGB and back conversion loop.
-# some of the darkest shades need a little bias -- maximum is just
-# 5 increments out of 16. This gives us useful property with
-# least amount of error in the sRGB-to-linear table, and keeps the actual
-# table lookup in the other direction as simple as possible.
-for my $srgb (0 .. $#srgb_to_linear)
+# The encoding table has an entry for each run of 16 linear values: the
+# nearest level to the first value of the run in the low byte and, in
+# the high byte, the offset into the run from which on the level is one
+# higher, or 16 if the level is the same all through the run. Levels
+# are further apart than 16 linear values, so a run never has more than
+# one threshold in it, and a value v encodes to
+#
+#     (e & 0xff) + ((v & 15) >= (e >> 8))    with e = table[v >> 4]
+my @linear_to_srgb;
+my $srgb = 0;
+for my $run (0 .. 4095)
 {
-    my $add = 0;
-    while (1)
+    my $first = $run * 16;
+    my $offset = 16;
+
+    $srgb++ while ($srgb < 255 && $thresholds[$srgb] <= $first);
+
+    if ($srgb < 255 && $thresholds[$srgb] < $first + 16)
     {
-	my $linear = $srgb_to_linear[$srgb];
-	my $srgb_lossy = $linear_to_srgb[$linear >> 4];
-	last if $srgb == $srgb_lossy;
+	$offset = $thresholds[$srgb] - $first;
 
-	# Add slight bias to this component until it rounds correctly
-	$srgb_to_linear[$srgb] ++;
-	$add ++;
+	die "Two levels in the run at $first"
+	    if ($srgb < 254 && $thresholds[$srgb + 1] < $first + 16);
     }
-    die "Too many adds at $srgb" if $add > 5;
+
+    push @linear_to_srgb, $srgb | ($offset << 8);
+}
+
+# Both tables have one more entry than can be looked up, so that
+# 32 bit gathers of 16 bit entries stay inside them.
+push @srgb_to_linear, 0;
+push @linear_to_srgb, 0;
+
+sub print_table
+{
+    my ($type, $name, @table) = @_;
+
+    print "const $type $name\[" . @table . "] =\n";
+    print "{\n";
+    for my $i (0 .. $#table)
+    {
+	print "    " if ($i % 8) == 0;
+	print sprintf("0x%04x,", $table[$i]);
+	print(($i % 8) == 7 || $i == $#table ? "\n" : " ");
+    }
+    print "};\n";
 }
 
 print <<"PROLOG";
-/* WARNING: This file is generated by $0.
+/* WARNING: This file is generated by make-srgb.pl.
  * Please edit that file instead of this one.
  */
 
-#include <stdint.h>
-
 #ifdef HAVE_CONFIG_H
 #include <config.h>
 #endif
@@ -80,36 +99,6 @@ print <<"PROLOG";
 
 PROLOG
 
-print "const uint8_t linear_to_srgb[" . @linear_to_srgb . "] =\n";
-print "{\n";
-for my $linear (0 .. $#linear_to_srgb)
-{
-    if (($linear % 10) == 0)
-    {
-	print "\t";
-    }
-    print sprintf("%d, ", $linear_to_srgb[$linear]);
-    if (($linear % 10) == 9)
-    {
-	print "\n";
-    }
-}
-print "\n};\n";
+print_table ("uint16_t", "_pixman_srgb_to_linear16", @srgb_to_linear);
 print "\n";
-
-print "const uint16_t srgb_to_linear[" . @srgb_to_linear . "] =\n";
-print "{\n";
-for my $srgb (0 .. $#srgb_to_linear)
-{
-    if (($srgb % 10) == 0)
-    {
-	print "\t";
-    }
-    print sprintf("%d, ", $srgb_to_linear[$srgb]);
-    if (($srgb % 10) == 9)
-    {
-	print "\n";
-    }
-}
-print "\n};\n";
-
+print_table ("uint16_t", "_pixman_linear_to_srgb", @linear_to_srgb);
@@ -162,38 +162,6 @@
     while (0)
 #endif
 
-/*
- * YV12 setup and access macros
- */
-
-#define YV12_SETUP(image)                                               \
-    bits_image_t *__bits_image = (bits_image_t *)image;                 \
-    uint32_t *bits = __bits_image->bits;                                \
-    int stride = __bits_image->rowstride;                               \
-    int offset0 = stride < 0 ?                                          \
-    ((-stride) >> 1) * ((__bits_image->height - 1) >> 1) - stride :	\
-    stride * __bits_image->height;					\
-    int offset1 = stride < 0 ?                                          \
-    offset0 + ((-stride) >> 1) * ((__bits_image->height) >> 1) :	\
-	offset0 + (offset0 >> 2)
-
-/* Note no trailing semicolon on the above macro; if it's there, then
- * the typical usage of YV12_SETUP(image); will have an extra trailing ;
- * that some compilers will interpret as a statement -- and then any further
- * variable declarations will cause an error.
- */
-
-#define YV12_Y(line)                                                    \
-    ((uint8_t *) ((bits) + (stride) * (line)))
-
-#define YV12_U(line)                                                    \
-    ((uint8_t *) ((bits) + offset1 +                                    \
-                  ((stride) >> 1) * ((line) >> 1)))
-
-#define YV12_V(line)                                                    \
-    ((uint8_t *) ((bits) + offset0 +                                    \
-                  ((stride) >> 1) * ((line) >> 1)))
-
 /* Misc. helpers */
 
 static force_inline void
@@ -562,26 +530,18 @@ static const uint32_t to_linear_u[256] =
 
 static const float * const to_linear = (const float *)to_linear_u;
 
+/* Rounds to 16 bits and looks up the nearest level in the tables of
+ * pixman-srgb.c, instead of searching to_linear.
+ */
 static uint8_t
 to_srgb (float f)
 {
-    uint8_t low = 0;
-    uint8_t high = 255;
-
-    while (high - low > 1)
-    {
-	uint8_t mid = (low + high) / 2;
-
-	if (to_linear[mid] > f)
-	    high = mid;
-	else
-	    low = mid;
-    }
+    if (!(f > 0.0f))
+	return 0;
+    if (f >= 1.0f)
+	return 255;
 
-    if (to_linear[high] - f < f - to_linear[low])
-	return high;
-    else
-	return low;
+    return pixman_linear_to_srgb (f * 65535.0f + 0.5f);
 }
 
 static void
@@ -776,6 +736,26 @@ fetch_scanline_x2b10g10r10_float (bits_image_t   *image,
     }
 }
 
+/* Y, U and V are the stored bytes */
+static force_inline uint32_t
+yuv_to_8888 (const pixman_yuv_coefficients_t *c, int32_t y, int32_t u, int32_t v)
+{
+    int32_t r, g, b;
+
+    y -= c->y_offset;
+    u -= 128;
+    v -= 128;
+
+    r = c->y * y + c->rv * v;
+    g = c->y * y + c->gv * v + c->gu * u;
+    b = c->y * y + c->bu * u;
+
+    return 0xff000000 |
+	(r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
+	(g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
+	(b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+}
+
 static void
 fetch_scanline_yuy2 (bits_image_t   *image,
                      int             x,
@@ -784,66 +764,41 @@ fetch_scanline_yuy2 (bits_image_t   *image,
                      uint32_t *      buffer,
                      const uint32_t *mask)
 {
-    const uint32_t *bits = image->bits + image->rowstride * line;
+    const pixman_yuv_coefficients_t *c = YUV_COEFFICIENTS (image);
+    const uint8_t *bits = (const uint8_t *)(image->bits + image->rowstride * line);
     int i;
     
     for (i = 0; i < width; i++)
     {
-	int16_t y, u, v;
-	int32_t r, g, b;
-	
-	y = ((uint8_t *) bits)[(x + i) << 1] - 16;
-	u = ((uint8_t *) bits)[(((x + i) << 1) & - 4) + 1] - 128;
-	v = ((uint8_t *) bits)[(((x + i) << 1) & - 4) + 3] - 128;
-	
-	/* R = 1.164(Y - 16) + 1.596(V - 128) */
-	r = 0x012b27 * y + 0x019a2e * v;
-	/* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
-	g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
-	/* B = 1.164(Y - 16) + 2.018(U - 128) */
-	b = 0x012b27 * y + 0x0206a2 * u;
-	
-	*buffer++ = 0xff000000 |
-	    (r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
-	    (g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
-	    (b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+	*buffer++ = yuv_to_8888 (c,
+				 bits[(x + i) << 1],
+				 bits[(((x + i) << 1) & - 4) + 1],
+				 bits[(((x + i) << 1) & - 4) + 3]);
     }
 }
 
+/* yv12, nv12 and i420 */
 static void
-fetch_scanline_yv12 (bits_image_t   *image,
-                     int             x,
-                     int             line,
-                     int             width,
-                     uint32_t *      buffer,
-                     const uint32_t *mask)
+fetch_scanline_planar (bits_image_t   *image,
+                       int             x,
+                       int             line,
+                       int             width,
+                       uint32_t *      buffer,
+                       const uint32_t *mask)
 {
-    YV12_SETUP (image);
-    uint8_t *y_line = YV12_Y (line);
-    uint8_t *u_line = YV12_U (line);
-    uint8_t *v_line = YV12_V (line);
+    const pixman_yuv_coefficients_t *c = YUV_COEFFICIENTS (image);
+    uint8_t *y_line = YUV_Y_LINE (image, line);
+    uint8_t *u_line = YUV_U_LINE (image, line);
+    uint8_t *v_line = YUV_V_LINE (image, line);
+    int step = YUV_CHROMA_STEP (image);
     int i;
     
     for (i = 0; i < width; i++)
     {
-	int16_t y, u, v;
-	int32_t r, g, b;
-
-	y = y_line[x + i] - 16;
-	u = u_line[(x + i) >> 1] - 128;
-	v = v_line[(x + i) >> 1] - 128;
-
-	/* R = 1.164(Y - 16) + 1.596(V - 128) */
-	r = 0x012b27 * y + 0x019a2e * v;
-	/* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
-	g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
-	/* B = 1.164(Y - 16) + 2.018(U - 128) */
-	b = 0x012b27 * y + 0x0206a2 * u;
-
-	*buffer++ = 0xff000000 |
-	    (r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
-	    (g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
-	    (b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+	*buffer++ = yuv_to_8888 (c,
+				 y_line[x + i],
+				 u_line[((x + i) >> 1) * step],
+				 v_line[((x + i) >> 1) * step]);
     }
 }
 
@@ -988,54 +943,25 @@ fetch_pixel_yuy2 (bits_image_t *image,
 		  int           offset,
 		  int           line)
 {
-    const uint32_t *bits = image->bits + image->rowstride * line;
-    
-    int16_t y, u, v;
-    int32_t r, g, b;
-    
-    y = ((uint8_t *) bits)[offset << 1] - 16;
-    u = ((uint8_t *) bits)[((offset << 1) & - 4) + 1] - 128;
-    v = ((uint8_t *) bits)[((offset << 1) & - 4) + 3] - 128;
-    
-    /* R = 1.164(Y - 16) + 1.596(V - 128) */
-    r = 0x012b27 * y + 0x019a2e * v;
-    
-    /* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
-    g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
-    
-    /* B = 1.164(Y - 16) + 2.018(U - 128) */
-    b = 0x012b27 * y + 0x0206a2 * u;
-    
-    return 0xff000000 |
-	(r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
-	(g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
-	(b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+    const uint8_t *bits = (const uint8_t *)(image->bits + image->rowstride * line);
+
+    return yuv_to_8888 (YUV_COEFFICIENTS (image),
+			bits[offset << 1],
+			bits[((offset << 1) & - 4) + 1],
+			bits[((offset << 1) & - 4) + 3]);
 }
 
 static uint32_t
-fetch_pixel_yv12 (bits_image_t *image,
-		  int           offset,
-		  int           line)
+fetch_pixel_planar (bits_image_t *image,
+		    int           offset,
+		    int           line)
 {
-    YV12_SETUP (image);
-    int16_t y = YV12_Y (line)[offset] - 16;
-    int16_t u = YV12_U (line)[offset >> 1] - 128;
-    int16_t v = YV12_V (line)[offset >> 1] - 128;
-    int32_t r, g, b;
-    
-    /* R = 1.164(Y - 16) + 1.596(V - 128) */
-    r = 0x012b27 * y + 0x019a2e * v;
-    
-    /* G = 1.164(Y - 16) - 0.813(V - 128) - 0.391(U - 128) */
-    g = 0x012b27 * y - 0x00d0f2 * v - 0x00647e * u;
-    
-    /* B = 1.164(Y - 16) + 2.018(U - 128) */
-    b = 0x012b27 * y + 0x0206a2 * u;
-    
-    return 0xff000000 |
-	(r >= 0 ? r < 0x1000000 ? r         & 0xff0000 : 0xff0000 : 0) |
-	(g >= 0 ? g < 0x1000000 ? (g >> 8)  & 0x00ff00 : 0x00ff00 : 0) |
-	(b >= 0 ? b < 0x1000000 ? (b >> 16) & 0x0000ff : 0x0000ff : 0);
+    int step = YUV_CHROMA_STEP (image);
+
+    return yuv_to_8888 (YUV_COEFFICIENTS (image),
+			YUV_Y_LINE (image, line)[offset],
+			YUV_U_LINE (image, line)[(offset >> 1) * step],
+			YUV_V_LINE (image, line)[(offset >> 1) * step]);
 }
 
 /*********************************** Store ************************************/
@@ -1314,27 +1240,26 @@ store_scanline_a8r8g8b8_32_sRGB (bits_image_t   *image,
                                  const uint32_t *v)
 {
     uint32_t *bits = image->bits + image->rowstride * y;
-    uint64_t *values = (uint64_t *)v;
     uint32_t *pixel = bits + x;
-    uint64_t tmp;
+    uint32_t tmp;
     int i;
     
     for (i = 0; i < width; ++i)
     {
 	uint32_t a, r, g, b;
 
-	tmp = values[i];
+	tmp = v[i];
 
 	a = (tmp >> 24) & 0xff;
 	r = (tmp >> 16) & 0xff;
 	g = (tmp >> 8) & 0xff;
 	b = (tmp >> 0) & 0xff;
 
-	r = to_srgb (r * (1/255.0f));
-	g = to_srgb (g * (1/255.0f));
-	b = to_srgb (b * (1/255.0f));
+	r = pixman_linear_to_srgb (r * 257);
+	g = pixman_linear_to_srgb (g * 257);
+	b = pixman_linear_to_srgb (b * 257);
 	
-	WRITE (image, pixel++, a | (r << 16) | (g << 8) | (b << 0));
+	WRITE (image, pixel++, (a << 24) | (r << 16) | (g << 8) | (b << 0));
     }
 }
 
@@ -1507,8 +1432,18 @@ static const format_info_t accessors[] =
       NULL, NULL },
 
     { PIXMAN_yv12,
-      fetch_scanline_yv12, fetch_scanline_generic_float,
-      fetch_pixel_yv12, fetch_pixel_generic_float,
+      fetch_scanline_planar, fetch_scanline_generic_float,
+      fetch_pixel_planar, fetch_pixel_generic_float,
+      NULL, NULL },
+
+    { PIXMAN_nv12,
+      fetch_scanline_planar, fetch_scanline_generic_float,
+      fetch_pixel_planar, fetch_pixel_generic_float,
+      NULL, NULL },
+
+    { PIXMAN_i420,
+      fetch_scanline_planar, fetch_scanline_generic_float,
+      fetch_pixel_planar, fetch_pixel_generic_float,
       NULL, NULL },
     
     { PIXMAN_null },
@@ -0,0 +1,4238 @@
+/*
+ * Copyright © 2008 Rodrigo Kumpera
+ * Copyright © 2008 André Tupinambá
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of Red Hat not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  Red Hat makes no representations about the
+ * suitability of this software for any purpose.  It is provided "as is"
+ * without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN
+ * AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING
+ * OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+ * SOFTWARE.
+ *
+ * Based on the SSE2 implementation in pixman-sse2.c. The arithmetic is
+ * the same, only the registers are twice as wide, so the results are
+ * bit-exact with the SSE2 and C code paths. Anything not implemented
+ * here falls through to the SSE2 implementation.
+ */
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#elif defined (_MSC_VER)
+#include <config_msc.h>
+#endif
+
+#include <immintrin.h> /* for AVX2 intrinsics */
+#include "pixman-private.h"
+#include "pixman-combine32.h"
+#include "pixman-inlines.h"
+
+static __m256i mask_0080;
+static __m256i mask_00ff;
+static __m256i mask_0101;
+static __m256i mask_ff000000;
+static __m256i mask_tail_index;
+static __m256i mask_bilinear_order;
+
+static force_inline void
+unpack_256_2x256 (__m256i data, __m256i* data_lo, __m256i* data_hi)
+{
+    *data_lo = _mm256_unpacklo_epi8 (data, _mm256_setzero_si256 ());
+    *data_hi = _mm256_unpackhi_epi8 (data, _mm256_setzero_si256 ());
+}
+
+static force_inline __m256i
+pack_2x256_256 (__m256i lo, __m256i hi)
+{
+    return _mm256_packus_epi16 (lo, hi);
+}
+
+static force_inline __m256i
+create_2x128_256 (__m128i lo, __m128i hi)
+{
+    return _mm256_inserti128_si256 (_mm256_castsi128_si256 (lo), hi, 1);
+}
+
+static force_inline int
+is_opaque (__m256i x)
+{
+    __m256i ffs = _mm256_cmpeq_epi8 (x, x);
+
+    return ((uint32_t)_mm256_movemask_epi8 (
+		_mm256_cmpeq_epi8 (x, ffs)) & 0x88888888) == 0x88888888;
+}
+
+static force_inline int
+is_zero (__m256i x)
+{
+    return _mm256_testz_si256 (x, x);
+}
+
+static force_inline int
+is_transparent (__m256i x)
+{
+    return _mm256_testz_si256 (x, mask_ff000000);
+}
+
+static force_inline __m256i
+expand_alpha_256 (__m256i data)
+{
+    return _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (data,
+							   _MM_SHUFFLE (3, 3, 3, 3)),
+				   _MM_SHUFFLE (3, 3, 3, 3));
+}
+
+static force_inline __m256i
+expand_alpha_rev_256 (__m256i data)
+{
+    return _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (data,
+							   _MM_SHUFFLE (0, 0, 0, 0)),
+				   _MM_SHUFFLE (0, 0, 0, 0));
+}
+
+static force_inline __m256i
+pix_multiply_256 (__m256i data, __m256i alpha)
+{
+    return _mm256_mulhi_epu16 (_mm256_adds_epu16 (_mm256_mullo_epi16 (data, alpha),
+						  mask_0080),
+			       mask_0101);
+}
+
+static force_inline __m256i
+pix_add_multiply_256 (__m256i src,
+		      __m256i alpha_dst,
+		      __m256i dst,
+		      __m256i alpha_src)
+{
+    __m256i t1 = pix_multiply_256 (src, alpha_dst);
+    __m256i t2 = pix_multiply_256 (dst, alpha_src);
+
+    return _mm256_adds_epu8 (t1, t2);
+}
+
+static force_inline __m256i
+negate_256 (__m256i data)
+{
+    return _mm256_xor_si256 (data, mask_00ff);
+}
+
+static force_inline __m256i
+over_256 (__m256i src, __m256i alpha, __m256i dst)
+{
+    return _mm256_adds_epu8 (src, pix_multiply_256 (dst, negate_256 (alpha)));
+}
+
+static force_inline __m256i
+in_over_256 (__m256i src, __m256i alpha, __m256i mask, __m256i dst)
+{
+    return over_256 (pix_multiply_256 (src, mask),
+		     pix_multiply_256 (alpha, mask),
+		     dst);
+}
+
+/* load 8 pixels from a unaligned address */
+static force_inline __m256i
+load_256_unaligned (const __m256i* src)
+{
+    return _mm256_loadu_si256 (src);
+}
+
+/* save 8 pixels on a 32-byte boundary aligned address */
+static force_inline void
+save_256_aligned (__m256i* dst,
+                  __m256i  data)
+{
+    _mm256_store_si256 (dst, data);
+}
+
+/* save 8 pixels on a unaligned address */
+static force_inline void
+save_256_unaligned (__m256i* dst,
+                    __m256i  data)
+{
+    _mm256_storeu_si256 (dst, data);
+}
+
+/* Scanline tails are handled with masked loads and stores instead of
+ * a scalar loop. Lanes that are masked off are neither read nor
+ * written, so it is safe to use them at the end of a row.
+ */
+static force_inline __m256i
+create_tail_mask (int w)
+{
+    return _mm256_cmpgt_epi32 (_mm256_set1_epi32 (w), mask_tail_index);
+}
+
+static force_inline __m256i
+load_256_tail (const uint32_t *src, __m256i tail)
+{
+    return _mm256_maskload_epi32 ((const int *)src, tail);
+}
+
+static force_inline void
+save_256_tail (uint32_t *dst, __m256i tail, __m256i data)
+{
+    _mm256_maskstore_epi32 ((int *)dst, tail, data);
+}
+
+static force_inline uint32_t
+core_combine_over_u_pixel_avx2 (uint32_t src, uint32_t dst)
+{
+    uint32_t a = ~src >> 24;
+
+    UN8x4_MUL_UN8_ADD_UN8x4 (dst, a, src);
+
+    return dst;
+}
+
+/* Multiply eight source pixels by the alpha of the unified mask */
+static force_inline __m256i
+combine8 (__m256i s, __m256i m)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi;
+
+    if (is_transparent (m))
+	return _mm256_setzero_si256 ();
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+
+    s_lo = pix_multiply_256 (s_lo, expand_alpha_256 (m_lo));
+    s_hi = pix_multiply_256 (s_hi, expand_alpha_256 (m_hi));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+/* Unified combiners. Each core takes eight packed, already masked source
+ * pixels and eight packed destination pixels and returns the result.
+ */
+static force_inline __m256i
+core_over_u (__m256i s, __m256i d)
+{
+    __m256i s_lo, s_hi, d_lo, d_hi;
+
+    if (is_zero (s))
+	return d;
+    if (is_opaque (s))
+	return s;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    d_lo = over_256 (s_lo, expand_alpha_256 (s_lo), d_lo);
+    d_hi = over_256 (s_hi, expand_alpha_256 (s_hi), d_hi);
+
+    return pack_2x256_256 (d_lo, d_hi);
+}
+
+static force_inline __m256i
+core_over_reverse_u (__m256i s, __m256i d)
+{
+    __m256i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = over_256 (d_lo, expand_alpha_256 (d_lo), s_lo);
+    s_hi = over_256 (d_hi, expand_alpha_256 (d_hi), s_hi);
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_in_u (__m256i s, __m256i d)
+{
+    __m256i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = pix_multiply_256 (s_lo, expand_alpha_256 (d_lo));
+    s_hi = pix_multiply_256 (s_hi, expand_alpha_256 (d_hi));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_in_reverse_u (__m256i s, __m256i d)
+{
+    return core_in_u (d, s);
+}
+
+static force_inline __m256i
+core_out_u (__m256i s, __m256i d)
+{
+    __m256i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = pix_multiply_256 (s_lo, negate_256 (expand_alpha_256 (d_lo)));
+    s_hi = pix_multiply_256 (s_hi, negate_256 (expand_alpha_256 (d_hi)));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_out_reverse_u (__m256i s, __m256i d)
+{
+    return core_out_u (d, s);
+}
+
+static force_inline __m256i
+core_atop_u (__m256i s, __m256i d)
+{
+    __m256i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = pix_add_multiply_256 (s_lo, expand_alpha_256 (d_lo),
+				 d_lo, negate_256 (expand_alpha_256 (s_lo)));
+    s_hi = pix_add_multiply_256 (s_hi, expand_alpha_256 (d_hi),
+				 d_hi, negate_256 (expand_alpha_256 (s_hi)));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_atop_reverse_u (__m256i s, __m256i d)
+{
+    __m256i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = pix_add_multiply_256 (s_lo, negate_256 (expand_alpha_256 (d_lo)),
+				 d_lo, expand_alpha_256 (s_lo));
+    s_hi = pix_add_multiply_256 (s_hi, negate_256 (expand_alpha_256 (d_hi)),
+				 d_hi, expand_alpha_256 (s_hi));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_xor_u (__m256i s, __m256i d)
+{
+    __m256i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = pix_add_multiply_256 (s_lo, negate_256 (expand_alpha_256 (d_lo)),
+				 d_lo, negate_256 (expand_alpha_256 (s_lo)));
+    s_hi = pix_add_multiply_256 (s_hi, negate_256 (expand_alpha_256 (d_hi)),
+				 d_hi, negate_256 (expand_alpha_256 (s_hi)));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_add_u (__m256i s, __m256i d)
+{
+    return _mm256_adds_epu8 (s, d);
+}
+
+#define AVX2_COMBINE_U(name)						\
+static void								\
+avx2_combine_ ## name ## _u (pixman_implementation_t *imp,		\
+			     pixman_op_t              op,		\
+			     uint32_t *               pd,		\
+			     const uint32_t *         ps,		\
+			     const uint32_t *         pm,		\
+			     int                      w)		\
+{									\
+    __m256i s, d, tail;							\
+									\
+    while (w >= 8)							\
+    {									\
+	s = load_256_unaligned ((const __m256i *)ps);			\
+	if (pm)								\
+	{								\
+	    s = combine8 (s, load_256_unaligned ((const __m256i *)pm));	\
+	    pm += 8;							\
+	}								\
+	d = load_256_unaligned ((const __m256i *)pd);			\
+									\
+	save_256_unaligned ((__m256i *)pd, core_ ## name ## _u (s, d));	\
+									\
+	ps += 8;							\
+	pd += 8;							\
+	w -= 8;								\
+    }									\
+									\
+    if (w)								\
+    {									\
+	tail = create_tail_mask (w);					\
+									\
+	s = load_256_tail (ps, tail);					\
+	if (pm)								\
+	    s = combine8 (s, load_256_tail (pm, tail));			\
+	d = load_256_tail (pd, tail);					\
+									\
+	save_256_tail (pd, tail, core_ ## name ## _u (s, d));		\
+    }									\
+}
+
+AVX2_COMBINE_U (over)
+AVX2_COMBINE_U (over_reverse)
+AVX2_COMBINE_U (in)
+AVX2_COMBINE_U (in_reverse)
+AVX2_COMBINE_U (out)
+AVX2_COMBINE_U (out_reverse)
+AVX2_COMBINE_U (atop)
+AVX2_COMBINE_U (atop_reverse)
+AVX2_COMBINE_U (xor)
+AVX2_COMBINE_U (add)
+
+/* Component alpha combiners. Each core takes eight packed source, mask
+ * and destination pixels.
+ */
+static force_inline __m256i
+core_src_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+
+    return pack_2x256_256 (pix_multiply_256 (s_lo, m_lo),
+			   pix_multiply_256 (s_hi, m_hi));
+}
+
+static force_inline __m256i
+core_over_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    d_lo = in_over_256 (s_lo, expand_alpha_256 (s_lo), m_lo, d_lo);
+    d_hi = in_over_256 (s_hi, expand_alpha_256 (s_hi), m_hi, d_hi);
+
+    return pack_2x256_256 (d_lo, d_hi);
+}
+
+static force_inline __m256i
+core_over_reverse_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = over_256 (d_lo, expand_alpha_256 (d_lo), pix_multiply_256 (s_lo, m_lo));
+    s_hi = over_256 (d_hi, expand_alpha_256 (d_hi), pix_multiply_256 (s_hi, m_hi));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_in_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = pix_multiply_256 (pix_multiply_256 (s_lo, m_lo),
+			     expand_alpha_256 (d_lo));
+    s_hi = pix_multiply_256 (pix_multiply_256 (s_hi, m_hi),
+			     expand_alpha_256 (d_hi));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_in_reverse_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    d_lo = pix_multiply_256 (d_lo,
+			     pix_multiply_256 (m_lo, expand_alpha_256 (s_lo)));
+    d_hi = pix_multiply_256 (d_hi,
+			     pix_multiply_256 (m_hi, expand_alpha_256 (s_hi)));
+
+    return pack_2x256_256 (d_lo, d_hi);
+}
+
+static force_inline __m256i
+core_out_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    s_lo = pix_multiply_256 (pix_multiply_256 (s_lo, m_lo),
+			     negate_256 (expand_alpha_256 (d_lo)));
+    s_hi = pix_multiply_256 (pix_multiply_256 (s_hi, m_hi),
+			     negate_256 (expand_alpha_256 (d_hi)));
+
+    return pack_2x256_256 (s_lo, s_hi);
+}
+
+static force_inline __m256i
+core_out_reverse_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    d_lo = pix_multiply_256 (
+	d_lo, negate_256 (pix_multiply_256 (m_lo, expand_alpha_256 (s_lo))));
+    d_hi = pix_multiply_256 (
+	d_hi, negate_256 (pix_multiply_256 (m_hi, expand_alpha_256 (s_hi))));
+
+    return pack_2x256_256 (d_lo, d_hi);
+}
+
+
+static force_inline __m256i
+core_atop_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+    __m256i a_lo, a_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    a_lo = negate_256 (pix_multiply_256 (m_lo, expand_alpha_256 (s_lo)));
+    a_hi = negate_256 (pix_multiply_256 (m_hi, expand_alpha_256 (s_hi)));
+    s_lo = pix_multiply_256 (s_lo, m_lo);
+    s_hi = pix_multiply_256 (s_hi, m_hi);
+
+    d_lo = pix_add_multiply_256 (d_lo, a_lo, s_lo, expand_alpha_256 (d_lo));
+    d_hi = pix_add_multiply_256 (d_hi, a_hi, s_hi, expand_alpha_256 (d_hi));
+
+    return pack_2x256_256 (d_lo, d_hi);
+}
+
+static force_inline __m256i
+core_atop_reverse_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+    __m256i a_lo, a_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    a_lo = pix_multiply_256 (m_lo, expand_alpha_256 (s_lo));
+    a_hi = pix_multiply_256 (m_hi, expand_alpha_256 (s_hi));
+    s_lo = pix_multiply_256 (s_lo, m_lo);
+    s_hi = pix_multiply_256 (s_hi, m_hi);
+
+    d_lo = pix_add_multiply_256 (d_lo, a_lo,
+				 s_lo, negate_256 (expand_alpha_256 (d_lo)));
+    d_hi = pix_add_multiply_256 (d_hi, a_hi,
+				 s_hi, negate_256 (expand_alpha_256 (d_hi)));
+
+    return pack_2x256_256 (d_lo, d_hi);
+}
+
+static force_inline __m256i
+core_xor_ca (__m256i s, __m256i m, __m256i d)
+{
+    __m256i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+    __m256i a_lo, a_hi;
+
+    unpack_256_2x256 (s, &s_lo, &s_hi);
+    unpack_256_2x256 (m, &m_lo, &m_hi);
+    unpack_256_2x256 (d, &d_lo, &d_hi);
+
+    a_lo = negate_256 (pix_multiply_256 (m_lo, expand_alpha_256 (s_lo)));
+    a_hi = negate_256 (pix_multiply_256 (m_hi, expand_alpha_256 (s_hi)));
+    s_lo = pix_multiply_256 (s_lo, m_lo);
+    s_hi = pix_multiply_256 (s_hi, m_hi);
+
+    d_lo = pix_add_multiply_256 (d_lo, a_lo,
+				 s_lo, negate_256 (expand_alpha_256 (d_lo)));
+    d_hi = pix_add_multiply_256 (d_hi, a_hi,
+				 s_hi, negate_256 (expand_alpha_256 (d_hi)));
+
+    return pack_2x256_256 (d_lo, d_hi);
+}
+
+static force_inline __m256i
+core_add_ca (__m256i s, __m256i m, __m256i d)
+{
+    return _mm256_adds_epu8 (core_src_ca (s, m, d), d);
+}
+
+#define AVX2_COMBINE_CA(name)						\
+static void								\
+avx2_combine_ ## name ## _ca (pixman_implementation_t *imp,		\
+			      pixman_op_t              op,		\
+			      uint32_t *               pd,		\
+			      const uint32_t *         ps,		\
+			      const uint32_t *         pm,		\
+			      int                      w)		\
+{									\
+    __m256i s, m, d, tail;						\
+									\
+    while (w >= 8)							\
+    {									\
+	s = load_256_unaligned ((const __m256i *)ps);			\
+	m = load_256_unaligned ((const __m256i *)pm);			\
+	d = load_256_unaligned ((const __m256i *)pd);			\
+									\
+	save_256_unaligned ((__m256i *)pd, core_ ## name ## _ca (s, m, d)); \
+									\
+	ps += 8;							\
+	pm += 8;							\
+	pd += 8;							\
+	w -= 8;								\
+    }									\
+									\
+    if (w)								\
+    {									\
+	tail = create_tail_mask (w);					\
+									\
+	s = load_256_tail (ps, tail);					\
+	m = load_256_tail (pm, tail);					\
+	d = load_256_tail (pd, tail);					\
+									\
+	save_256_tail (pd, tail, core_ ## name ## _ca (s, m, d));	\
+    }									\
+}
+
+AVX2_COMBINE_CA (src)
+AVX2_COMBINE_CA (over)
+AVX2_COMBINE_CA (over_reverse)
+AVX2_COMBINE_CA (in)
+AVX2_COMBINE_CA (in_reverse)
+AVX2_COMBINE_CA (out)
+AVX2_COMBINE_CA (out_reverse)
+AVX2_COMBINE_CA (atop)
+AVX2_COMBINE_CA (atop_reverse)
+AVX2_COMBINE_CA (xor)
+AVX2_COMBINE_CA (add)
+
+/* -------------------------------------------------------------------
+ * Float combiners
+ *
+ * These compute exactly what the combiners in pixman-combine-float.c
+ * compute, with the same operations in the same order, so the results
+ * are bit for bit identical.  Eight pixels at a time are transposed
+ * into one register per channel.  Where the scalar code tests for a zero
+ * divisor, the divisor is replaced by one before dividing and the
+ * affected lanes are then overwritten with the special case result.
+ *
+ * The plain Porter/Duff operators are left to the C versions; the
+ * compiler already does as well as this for those.
+ */
+
+typedef __m256 (* avx2_combine_channel_t) (__m256 sa, __m256 s,
+					   __m256 da, __m256 d);
+
+/* Transpose the 4x4 blocks in each 128-bit lane */
+static force_inline void
+avx2_transpose_float_4x4 (__m256 *r0, __m256 *r1, __m256 *r2, __m256 *r3)
+{
+    __m256 t0 = _mm256_unpacklo_ps (*r0, *r1);
+    __m256 t1 = _mm256_unpacklo_ps (*r2, *r3);
+    __m256 t2 = _mm256_unpackhi_ps (*r0, *r1);
+    __m256 t3 = _mm256_unpackhi_ps (*r2, *r3);
+
+    *r0 = _mm256_shuffle_ps (t0, t1, _MM_SHUFFLE (1, 0, 1, 0));
+    *r1 = _mm256_shuffle_ps (t0, t1, _MM_SHUFFLE (3, 2, 3, 2));
+    *r2 = _mm256_shuffle_ps (t2, t3, _MM_SHUFFLE (1, 0, 1, 0));
+    *r3 = _mm256_shuffle_ps (t2, t3, _MM_SHUFFLE (3, 2, 3, 2));
+}
+
+/* Load @n_pixels (at most 8) pixels as one register per channel */
+static force_inline void
+avx2_load_float_8 (const float *p, int n_pixels,
+		   __m256 *a, __m256 *r, __m256 *g, __m256 *b)
+{
+    if (n_pixels == 8)
+    {
+	*a = _mm256_loadu_ps (p + 0);
+	*r = _mm256_loadu_ps (p + 8);
+	*g = _mm256_loadu_ps (p + 16);
+	*b = _mm256_loadu_ps (p + 24);
+    }
+    else
+    {
+	*a = _mm256_maskload_ps (p + 0, create_tail_mask (4 * n_pixels));
+	*r = _mm256_maskload_ps (p + 8, create_tail_mask (4 * n_pixels - 8));
+	*g = _mm256_maskload_ps (p + 16, create_tail_mask (4 * n_pixels - 16));
+	*b = _mm256_maskload_ps (p + 24, create_tail_mask (4 * n_pixels - 24));
+    }
+
+    avx2_transpose_float_4x4 (a, r, g, b);
+}
+
+static force_inline void
+avx2_save_float_8 (float *p, int n_pixels,
+		   __m256 a, __m256 r, __m256 g, __m256 b)
+{
+    avx2_transpose_float_4x4 (&a, &r, &g, &b);
+
+    if (n_pixels == 8)
+    {
+	_mm256_storeu_ps (p + 0, a);
+	_mm256_storeu_ps (p + 8, r);
+	_mm256_storeu_ps (p + 16, g);
+	_mm256_storeu_ps (p + 24, b);
+    }
+    else
+    {
+	_mm256_maskstore_ps (p + 0, create_tail_mask (4 * n_pixels), a);
+	_mm256_maskstore_ps (p + 8, create_tail_mask (4 * n_pixels - 8), r);
+	_mm256_maskstore_ps (p + 16, create_tail_mask (4 * n_pixels - 16), g);
+	_mm256_maskstore_ps (p + 24, create_tail_mask (4 * n_pixels - 24), b);
+    }
+}
+
+static force_inline void
+avx2_combine_float_8 (pixman_bool_t          component,
+		      float                 *dest,
+		      const float           *src,
+		      const float           *mask,
+		      int                    n_pixels,
+		      avx2_combine_channel_t combine_a,
+		      avx2_combine_channel_t combine_c)
+{
+    __m256 sa, sr, sg, sb;
+    __m256 da, dr, dg, db;
+    __m256 ma, mr, mg, mb;
+
+    avx2_load_float_8 (src, n_pixels, &sa, &sr, &sg, &sb);
+    avx2_load_float_8 (dest, n_pixels, &da, &dr, &dg, &db);
+
+    if (!mask)
+    {
+	ma = mr = mg = mb = sa;
+    }
+    else
+    {
+	avx2_load_float_8 (mask, n_pixels, &ma, &mr, &mg, &mb);
+
+	if (component)
+	{
+	    sr = _mm256_mul_ps (sr, mr);
+	    sg = _mm256_mul_ps (sg, mg);
+	    sb = _mm256_mul_ps (sb, mb);
+
+	    ma = _mm256_mul_ps (ma, sa);
+	    mr = _mm256_mul_ps (mr, sa);
+	    mg = _mm256_mul_ps (mg, sa);
+	    mb = _mm256_mul_ps (mb, sa);
+
+	    sa = ma;
+	}
+	else
+	{
+	    sa = _mm256_mul_ps (sa, ma);
+	    sr = _mm256_mul_ps (sr, ma);
+	    sg = _mm256_mul_ps (sg, ma);
+	    sb = _mm256_mul_ps (sb, ma);
+
+	    ma = mr = mg = mb = sa;
+	}
+    }
+
+    avx2_save_float_8 (dest, n_pixels,
+		       combine_a (ma, sa, da, da),
+		       combine_c (mr, sr, da, dr),
+		       combine_c (mg, sg, da, dg),
+		       combine_c (mb, sb, da, db));
+}
+
+static force_inline void
+avx2_combine_float_inner (pixman_bool_t          component,
+			  float                 *dest,
+			  const float           *src,
+			  const float           *mask,
+			  int                    n_pixels,
+			  avx2_combine_channel_t combine_a,
+			  avx2_combine_channel_t combine_c)
+{
+    while (n_pixels >= 8)
+    {
+	avx2_combine_float_8 (component, dest, src, mask, 8,
+			      combine_a, combine_c);
+
+	dest += 32;
+	src += 32;
+	if (mask)
+	    mask += 32;
+	n_pixels -= 8;
+    }
+
+    if (n_pixels)
+    {
+	avx2_combine_float_8 (component, dest, src, mask, n_pixels,
+			      combine_a, combine_c);
+    }
+}
+
+#define AVX2_MAKE_FLOAT_COMBINER(name, component, combine_a, combine_c)	\
+    static void								\
+    avx2_combine_ ## name ## _float (pixman_implementation_t *imp,	\
+				     pixman_op_t              op,	\
+				     float                   *dest,	\
+				     const float             *src,	\
+				     const float             *mask,	\
+				     int                      n_pixels)	\
+    {									\
+	avx2_combine_float_inner (component, dest, src, mask, n_pixels,	\
+				  combine_a, combine_c);		\
+    }
+
+#define AVX2_MAKE_FLOAT_COMBINERS(name, combine_a, combine_c)		\
+    AVX2_MAKE_FLOAT_COMBINER (name ## _ca, TRUE, combine_a, combine_c)	\
+    AVX2_MAKE_FLOAT_COMBINER (name ## _u, FALSE, combine_a, combine_c)
+
+static force_inline __m256
+avx2_float_is_zero (__m256 f)
+{
+    return _mm256_and_ps (
+	_mm256_cmp_ps (f, _mm256_set1_ps (-FLT_MIN), _CMP_GT_OQ),
+	_mm256_cmp_ps (f, _mm256_set1_ps (FLT_MIN), _CMP_LT_OQ));
+}
+
+static force_inline __m256
+avx2_float_select (__m256 mask, __m256 a, __m256 b)
+{
+    return _mm256_blendv_ps (b, a, mask);
+}
+
+/* a / b, where lanes with b == 0 divide by one instead */
+static force_inline __m256
+avx2_float_div (__m256 a, __m256 b, __m256 b_is_zero)
+{
+    return _mm256_div_ps (
+	a, avx2_float_select (b_is_zero, _mm256_set1_ps (1.0f), b));
+}
+
+/* CLAMP (f) from pixman-combine-float.c; NaNs pass through unchanged */
+static force_inline __m256
+avx2_float_clamp (__m256 f)
+{
+    return _mm256_max_ps (_mm256_setzero_ps (),
+			  _mm256_min_ps (_mm256_set1_ps (1.0f), f));
+}
+
+static force_inline __m256
+avx2_get_factor (combine_factor_t factor, __m256 sa, __m256 da)
+{
+    __m256 zero = _mm256_setzero_ps ();
+    __m256 one = _mm256_set1_ps (1.0f);
+    __m256 sa_zero, da_zero;
+
+    switch (factor)
+    {
+    case ZERO:
+	return zero;
+
+    case ONE:
+	return one;
+
+    case SRC_ALPHA:
+	return sa;
+
+    case DEST_ALPHA:
+	return da;
+
+    case INV_SA:
+	return _mm256_sub_ps (one, sa);
+
+    case INV_DA:
+	return _mm256_sub_ps (one, da);
+
+    case SA_OVER_DA:
+	da_zero = avx2_float_is_zero (da);
+	return avx2_float_select (
+	    da_zero, one, avx2_float_clamp (avx2_float_div (sa, da, da_zero)));
+
+    case DA_OVER_SA:
+	sa_zero = avx2_float_is_zero (sa);
+	return avx2_float_select (
+	    sa_zero, one, avx2_float_clamp (avx2_float_div (da, sa, sa_zero)));
+
+    case INV_SA_OVER_DA:
+	da_zero = avx2_float_is_zero (da);
+	return avx2_float_select (
+	    da_zero, one, avx2_float_clamp (
+		avx2_float_div (_mm256_sub_ps (one, sa), da, da_zero)));
+
+    case INV_DA_OVER_SA:
+	sa_zero = avx2_float_is_zero (sa);
+	return avx2_float_select (
+	    sa_zero, one, avx2_float_clamp (
+		avx2_float_div (_mm256_sub_ps (one, da), sa, sa_zero)));
+
+    case ONE_MINUS_SA_OVER_DA:
+	da_zero = avx2_float_is_zero (da);
+	return avx2_float_select (
+	    da_zero, zero, avx2_float_clamp (
+		_mm256_sub_ps (one, avx2_float_div (sa, da, da_zero))));
+
+    case ONE_MINUS_DA_OVER_SA:
+	sa_zero = avx2_float_is_zero (sa);
+	return avx2_float_select (
+	    sa_zero, zero, avx2_float_clamp (
+		_mm256_sub_ps (one, avx2_float_div (da, sa, sa_zero))));
+
+    case ONE_MINUS_INV_DA_OVER_SA:
+	sa_zero = avx2_float_is_zero (sa);
+	return avx2_float_select (
+	    sa_zero, zero, avx2_float_clamp (
+		_mm256_sub_ps (one, avx2_float_div (_mm256_sub_ps (one, da),
+						    sa, sa_zero))));
+
+    case ONE_MINUS_INV_SA_OVER_DA:
+	da_zero = avx2_float_is_zero (da);
+	return avx2_float_select (
+	    da_zero, zero, avx2_float_clamp (
+		_mm256_sub_ps (one, avx2_float_div (_mm256_sub_ps (one, sa),
+						    da, da_zero))));
+    }
+
+    return zero;
+}
+
+#define AVX2_MAKE_PD_COMBINER(name, a, b)				\
+    static force_inline __m256						\
+    avx2_pd_combine_ ## name (__m256 sa, __m256 s, __m256 da, __m256 d)	\
+    {									\
+	const __m256 fa = avx2_get_factor (a, sa, da);			\
+	const __m256 fb = avx2_get_factor (b, sa, da);			\
+									\
+	return _mm256_min_ps (_mm256_set1_ps (1.0f),			\
+			      _mm256_add_ps (_mm256_mul_ps (s, fa),	\
+					     _mm256_mul_ps (d, fb)));	\
+    }									\
+									\
+    AVX2_MAKE_FLOAT_COMBINERS (name,					\
+			       avx2_pd_combine_ ## name,		\
+			       avx2_pd_combine_ ## name)
+
+AVX2_MAKE_PD_COMBINER (saturate,		INV_DA_OVER_SA,			ONE)
+
+AVX2_MAKE_PD_COMBINER (disjoint_over,		ONE,				INV_SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (disjoint_over_reverse,	INV_DA_OVER_SA,			ONE)
+AVX2_MAKE_PD_COMBINER (disjoint_in,		ONE_MINUS_INV_DA_OVER_SA,	ZERO)
+AVX2_MAKE_PD_COMBINER (disjoint_in_reverse,	ZERO,				ONE_MINUS_INV_SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (disjoint_out,		INV_DA_OVER_SA,			ZERO)
+AVX2_MAKE_PD_COMBINER (disjoint_out_reverse,	ZERO,				INV_SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (disjoint_atop,		ONE_MINUS_INV_DA_OVER_SA,	INV_SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (disjoint_atop_reverse,	INV_DA_OVER_SA,			ONE_MINUS_INV_SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (disjoint_xor,		INV_DA_OVER_SA,			INV_SA_OVER_DA)
+
+AVX2_MAKE_PD_COMBINER (conjoint_over,		ONE,				ONE_MINUS_SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (conjoint_over_reverse,	ONE_MINUS_DA_OVER_SA,		ONE)
+AVX2_MAKE_PD_COMBINER (conjoint_in,		DA_OVER_SA,			ZERO)
+AVX2_MAKE_PD_COMBINER (conjoint_in_reverse,	ZERO,				SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (conjoint_out,		ONE_MINUS_DA_OVER_SA,		ZERO)
+AVX2_MAKE_PD_COMBINER (conjoint_out_reverse,	ZERO,				ONE_MINUS_SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (conjoint_atop,		DA_OVER_SA,			ONE_MINUS_SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (conjoint_atop_reverse,	ONE_MINUS_DA_OVER_SA,		SA_OVER_DA)
+AVX2_MAKE_PD_COMBINER (conjoint_xor,		ONE_MINUS_DA_OVER_SA,		ONE_MINUS_SA_OVER_DA)
+
+/* Separable PDF blend modes; see pixman-combine-float.c for the
+ * derivation of each formula.
+ */
+static force_inline __m256
+avx2_blend_multiply (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    return _mm256_mul_ps (d, s);
+}
+
+static force_inline __m256
+avx2_blend_screen (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    return _mm256_sub_ps (_mm256_add_ps (_mm256_mul_ps (d, sa),
+					 _mm256_mul_ps (s, da)),
+			  _mm256_mul_ps (s, d));
+}
+
+/* as * ad - 2 * (ad - d) * (as - s) */
+static force_inline __m256
+avx2_blend_screen_2x (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 two = _mm256_set1_ps (2.0f);
+
+    return _mm256_sub_ps (
+	_mm256_mul_ps (sa, da),
+	_mm256_mul_ps (_mm256_mul_ps (two, _mm256_sub_ps (da, d)),
+		       _mm256_sub_ps (sa, s)));
+}
+
+static force_inline __m256
+avx2_blend_overlay (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 two = _mm256_set1_ps (2.0f);
+
+    return avx2_float_select (
+	_mm256_cmp_ps (_mm256_mul_ps (two, d), da, _CMP_LT_OQ),
+	_mm256_mul_ps (_mm256_mul_ps (two, s), d),
+	avx2_blend_screen_2x (sa, s, da, d));
+}
+
+static force_inline __m256
+avx2_blend_darken (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    /* (s > d)? d : s */
+    return _mm256_min_ps (_mm256_mul_ps (d, sa), _mm256_mul_ps (s, da));
+}
+
+static force_inline __m256
+avx2_blend_lighten (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    /* (s > d)? s : d */
+    return _mm256_max_ps (_mm256_mul_ps (s, da), _mm256_mul_ps (d, sa));
+}
+
+static force_inline __m256
+avx2_blend_color_dodge (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 sada = _mm256_mul_ps (sa, da);
+    __m256 sa_s = _mm256_sub_ps (sa, s);
+    __m256 sa_s_zero = avx2_float_is_zero (sa_s);
+    __m256 r;
+
+    r = avx2_float_div (_mm256_mul_ps (_mm256_mul_ps (sa, sa), d),
+			sa_s, sa_s_zero);
+    r = avx2_float_select (
+	_mm256_or_ps (_mm256_cmp_ps (_mm256_mul_ps (d, sa),
+				     _mm256_sub_ps (sada, _mm256_mul_ps (s, da)),
+				     _CMP_GE_OQ),
+		      sa_s_zero),
+	sada, r);
+
+    return _mm256_andnot_ps (avx2_float_is_zero (d), r);
+}
+
+static force_inline __m256
+avx2_blend_color_burn (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 s_zero = avx2_float_is_zero (s);
+    __m256 sa_da_d = _mm256_mul_ps (sa, _mm256_sub_ps (da, d));
+    __m256 r;
+
+    r = _mm256_mul_ps (
+	sa, _mm256_sub_ps (da, avx2_float_div (sa_da_d, s, s_zero)));
+    r = _mm256_andnot_ps (
+	_mm256_or_ps (
+	    _mm256_cmp_ps (sa_da_d, _mm256_mul_ps (s, da), _CMP_GE_OQ),
+	    s_zero),
+	r);
+
+    return avx2_float_select (_mm256_cmp_ps (d, da, _CMP_GE_OQ),
+			      _mm256_mul_ps (sa, da), r);
+}
+
+static force_inline __m256
+avx2_blend_hard_light (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 two_s = _mm256_mul_ps (_mm256_set1_ps (2.0f), s);
+
+    return avx2_float_select (_mm256_cmp_ps (two_s, sa, _CMP_LT_OQ),
+			      _mm256_mul_ps (two_s, d),
+			      avx2_blend_screen_2x (sa, s, da, d));
+}
+
+static force_inline __m256
+avx2_blend_soft_light (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 da_zero = avx2_float_is_zero (da);
+    __m256 two_s = _mm256_mul_ps (_mm256_set1_ps (2.0f), s);
+    __m256 two_s_sa = _mm256_sub_ps (two_s, sa);
+    __m256 dsa = _mm256_mul_ps (d, sa);
+    __m256 r1, r2, r3, t;
+
+    /* d * sa - d * (da - d) * (sa - 2 * s) / da */
+    t = _mm256_mul_ps (_mm256_mul_ps (d, _mm256_sub_ps (da, d)),
+		       _mm256_sub_ps (sa, two_s));
+    r1 = _mm256_sub_ps (dsa, avx2_float_div (t, da, da_zero));
+
+    /* d * sa + (2 * s - sa) * d * ((16 * d / da - 12) * d / da + 3) */
+    t = avx2_float_div (_mm256_mul_ps (_mm256_set1_ps (16.0f), d),
+			da, da_zero);
+    t = _mm256_mul_ps (_mm256_sub_ps (t, _mm256_set1_ps (12.0f)), d);
+    t = _mm256_add_ps (avx2_float_div (t, da, da_zero),
+		       _mm256_set1_ps (3.0f));
+    r2 = _mm256_add_ps (dsa, _mm256_mul_ps (_mm256_mul_ps (two_s_sa, d), t));
+
+    /* d * sa + (sqrtf (d * da) - d) * (2 * s - sa) */
+    t = _mm256_sub_ps (_mm256_sqrt_ps (_mm256_mul_ps (d, da)), d);
+    r3 = _mm256_add_ps (dsa, _mm256_mul_ps (t, two_s_sa));
+
+    r2 = avx2_float_select (
+	_mm256_cmp_ps (_mm256_mul_ps (_mm256_set1_ps (4.0f), d), da,
+		       _CMP_LE_OQ),
+	r2, r3);
+    r1 = avx2_float_select (_mm256_cmp_ps (two_s, sa, _CMP_LE_OQ), r1, r2);
+
+    return avx2_float_select (da_zero, dsa, r1);
+}
+
+static force_inline __m256
+avx2_blend_difference (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 dsa = _mm256_mul_ps (d, sa);
+    __m256 sda = _mm256_mul_ps (s, da);
+
+    return avx2_float_select (_mm256_cmp_ps (sda, dsa, _CMP_LT_OQ),
+			      _mm256_sub_ps (dsa, sda),
+			      _mm256_sub_ps (sda, dsa));
+}
+
+static force_inline __m256
+avx2_blend_exclusion (__m256 sa, __m256 s, __m256 da, __m256 d)
+{
+    __m256 two = _mm256_set1_ps (2.0f);
+
+    return _mm256_sub_ps (_mm256_add_ps (_mm256_mul_ps (s, da),
+					 _mm256_mul_ps (d, sa)),
+			  _mm256_mul_ps (_mm256_mul_ps (two, d), s));
+}
+
+#define AVX2_MAKE_SEPARABLE_PDF_COMBINER(name)				\
+    static force_inline __m256						\
+    avx2_combine_ ## name ## _a (__m256 sa, __m256 s, __m256 da, __m256 d) \
+    {									\
+	return _mm256_sub_ps (_mm256_add_ps (da, sa),			\
+			      _mm256_mul_ps (da, sa));			\
+    }									\
+									\
+    static force_inline __m256						\
+    avx2_combine_ ## name ## _c (__m256 sa, __m256 s, __m256 da, __m256 d) \
+    {									\
+	__m256 one = _mm256_set1_ps (1.0f);				\
+	__m256 f;							\
+									\
+	f = _mm256_add_ps (_mm256_mul_ps (_mm256_sub_ps (one, sa), d),	\
+			   _mm256_mul_ps (_mm256_sub_ps (one, da), s));	\
+									\
+	return _mm256_add_ps (f, avx2_blend_ ## name (sa, s, da, d));	\
+    }									\
+									\
+    AVX2_MAKE_FLOAT_COMBINERS (name,					\
+			       avx2_combine_ ## name ## _a,		\
+			       avx2_combine_ ## name ## _c)
+
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (multiply)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (screen)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (overlay)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (darken)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (lighten)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (color_dodge)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (color_burn)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (hard_light)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (soft_light)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (difference)
+AVX2_MAKE_SEPARABLE_PDF_COMBINER (exclusion)
+
+/* Non-separable PDF blend modes.  These follow the rgb_t helpers in
+ * pixman-combine-float.c, with the branches in set_sat() and
+ * clip_color() turned into lane selects.
+ */
+typedef struct
+{
+    __m256 r, g, b;
+} avx2_rgb_t;
+
+typedef void (* avx2_blend_hsl_t) (avx2_rgb_t       *res,
+				   const avx2_rgb_t *dest, __m256 da,
+				   const avx2_rgb_t *src, __m256 sa);
+
+static force_inline __m256
+avx2_get_lum (const avx2_rgb_t *c)
+{
+    __m256 l;
+
+    l = _mm256_add_ps (_mm256_mul_ps (c->r, _mm256_set1_ps (0.3f)),
+		       _mm256_mul_ps (c->g, _mm256_set1_ps (0.59f)));
+
+    return _mm256_add_ps (l, _mm256_mul_ps (c->b, _mm256_set1_ps (0.11f)));
+}
+
+static force_inline __m256
+avx2_channel_min (const avx2_rgb_t *c)
+{
+    return _mm256_min_ps (_mm256_min_ps (c->r, c->g), c->b);
+}
+
+static force_inline __m256
+avx2_channel_max (const avx2_rgb_t *c)
+{
+    return _mm256_max_ps (_mm256_max_ps (c->r, c->g), c->b);
+}
+
+static force_inline __m256
+avx2_get_sat (const avx2_rgb_t *c)
+{
+    return _mm256_sub_ps (avx2_channel_max (c), avx2_channel_min (c));
+}
+
+static force_inline void
+avx2_clip_color (avx2_rgb_t *c, __m256 a)
+{
+    __m256 l = avx2_get_lum (c);
+    __m256 n = avx2_channel_min (c);
+    __m256 x = avx2_channel_max (c);
+    __m256 t, t_zero, clip, f;
+
+    /* if (n < 0.0f) */
+    t = _mm256_sub_ps (l, n);
+    t_zero = avx2_float_is_zero (t);
+    clip = _mm256_cmp_ps (n, _mm256_setzero_ps (), _CMP_LT_OQ);
+
+#define CLIP_LOW(ch)							\
+    f = _mm256_add_ps (							\
+	l, avx2_float_div (_mm256_mul_ps (_mm256_sub_ps (c->ch, l), l),	\
+			   t, t_zero));					\
+    c->ch = avx2_float_select (						\
+	clip, _mm256_andnot_ps (t_zero, f), c->ch)
+
+    CLIP_LOW (r);
+    CLIP_LOW (g);
+    CLIP_LOW (b);
+
+#undef CLIP_LOW
+
+    /* if (x > a) */
+    t = _mm256_sub_ps (x, l);
+    t_zero = avx2_float_is_zero (t);
+    clip = _mm256_cmp_ps (x, a, _CMP_GT_OQ);
+
+#define CLIP_HIGH(ch)							\
+    f = _mm256_add_ps (							\
+	l, avx2_float_div (_mm256_mul_ps (_mm256_sub_ps (c->ch, l),	\
+					  _mm256_sub_ps (a, l)),	\
+			   t, t_zero));					\
+    c->ch = avx2_float_select (						\
+	clip, avx2_float_select (t_zero, a, f), c->ch)
+
+    CLIP_HIGH (r);
+    CLIP_HIGH (g);
+    CLIP_HIGH (b);
+
+#undef CLIP_HIGH
+}
+
+static force_inline void
+avx2_set_lum (avx2_rgb_t *c, __m256 sa, __m256 l)
+{
+    __m256 d = _mm256_sub_ps (l, avx2_get_lum (c));
+
+    c->r = _mm256_add_ps (c->r, d);
+    c->g = _mm256_add_ps (c->g, d);
+    c->b = _mm256_add_ps (c->b, d);
+
+    avx2_clip_color (c, sa);
+}
+
+/* The scalar set_sat() decides which channel is the maximum, the middle
+ * and the minimum with three comparisons; ties are resolved the same
+ * way here so the middle value is computed from the same channel.
+ */
+static force_inline void
+avx2_set_sat (avx2_rgb_t *c, __m256 sat)
+{
+    __m256 rg = _mm256_cmp_ps (c->r, c->g, _CMP_GT_OQ);
+    __m256 rb = _mm256_cmp_ps (c->r, c->b, _CMP_GT_OQ);
+    __m256 gb = _mm256_cmp_ps (c->g, c->b, _CMP_GT_OQ);
+    __m256 all = _mm256_castsi256_ps (_mm256_set1_epi32 (-1));
+    __m256 max_r = _mm256_and_ps (rg, rb);
+    __m256 max_g = _mm256_andnot_ps (rg, _mm256_or_ps (rb, gb));
+    __m256 min_r = _mm256_xor_ps (_mm256_or_ps (rg, rb), all);
+    __m256 min_g = _mm256_andnot_ps (_mm256_and_ps (rb, gb), rg);
+    __m256 max_b = _mm256_xor_ps (_mm256_or_ps (max_r, max_g), all);
+    __m256 min_b = _mm256_xor_ps (_mm256_or_ps (min_r, min_g), all);
+    __m256 max, min, t, t_zero;
+
+    max = avx2_float_select (max_r, c->r,
+			     avx2_float_select (max_g, c->g, c->b));
+    min = avx2_float_select (min_r, c->r,
+			     avx2_float_select (min_g, c->g, c->b));
+
+    t = _mm256_sub_ps (max, min);
+    t_zero = avx2_float_is_zero (t);
+
+#define SET_SAT(ch)							\
+    c->ch = avx2_float_div (_mm256_mul_ps (_mm256_sub_ps (c->ch, min), sat),	\
+			    t, t_zero);					\
+    c->ch = avx2_float_select (max_ ## ch, sat, c->ch);			\
+    c->ch = _mm256_andnot_ps (_mm256_or_ps (min_ ## ch, t_zero), c->ch)
+
+    SET_SAT (r);
+    SET_SAT (g);
+    SET_SAT (b);
+
+#undef SET_SAT
+}
+
+static force_inline void
+avx2_blend_hsl_hue (avx2_rgb_t       *res,
+		    const avx2_rgb_t *dest, __m256 da,
+		    const avx2_rgb_t *src, __m256 sa)
+{
+    res->r = _mm256_mul_ps (src->r, da);
+    res->g = _mm256_mul_ps (src->g, da);
+    res->b = _mm256_mul_ps (src->b, da);
+
+    avx2_set_sat (res, _mm256_mul_ps (avx2_get_sat (dest), sa));
+    avx2_set_lum (res, _mm256_mul_ps (sa, da),
+		  _mm256_mul_ps (avx2_get_lum (dest), sa));
+}
+
+static force_inline void
+avx2_blend_hsl_saturation (avx2_rgb_t       *res,
+			   const avx2_rgb_t *dest, __m256 da,
+			   const avx2_rgb_t *src, __m256 sa)
+{
+    res->r = _mm256_mul_ps (dest->r, sa);
+    res->g = _mm256_mul_ps (dest->g, sa);
+    res->b = _mm256_mul_ps (dest->b, sa);
+
+    avx2_set_sat (res, _mm256_mul_ps (avx2_get_sat (src), da));
+    avx2_set_lum (res, _mm256_mul_ps (sa, da),
+		  _mm256_mul_ps (avx2_get_lum (dest), sa));
+}
+
+static force_inline void
+avx2_blend_hsl_color (avx2_rgb_t       *res,
+		      const avx2_rgb_t *dest, __m256 da,
+		      const avx2_rgb_t *src, __m256 sa)
+{
+    res->r = _mm256_mul_ps (src->r, da);
+    res->g = _mm256_mul_ps (src->g, da);
+    res->b = _mm256_mul_ps (src->b, da);
+
+    avx2_set_lum (res, _mm256_mul_ps (sa, da),
+		  _mm256_mul_ps (avx2_get_lum (dest), sa));
+}
+
+static force_inline void
+avx2_blend_hsl_luminosity (avx2_rgb_t       *res,
+			   const avx2_rgb_t *dest, __m256 da,
+			   const avx2_rgb_t *src, __m256 sa)
+{
+    res->r = _mm256_mul_ps (dest->r, sa);
+    res->g = _mm256_mul_ps (dest->g, sa);
+    res->b = _mm256_mul_ps (dest->b, sa);
+
+    avx2_set_lum (res, _mm256_mul_ps (sa, da),
+		  _mm256_mul_ps (avx2_get_lum (src), da));
+}
+
+static force_inline void
+avx2_combine_hsl_8 (float           *dest,
+		    const float     *src,
+		    const float     *mask,
+		    int              n_pixels,
+		    avx2_blend_hsl_t blend)
+{
+    __m256 one = _mm256_set1_ps (1.0f);
+    avx2_rgb_t s, d, r;
+    __m256 sa, da, ra, isa, ida;
+
+    avx2_load_float_8 (src, n_pixels, &sa, &s.r, &s.g, &s.b);
+    avx2_load_float_8 (dest, n_pixels, &da, &d.r, &d.g, &d.b);
+
+    if (mask)
+    {
+	/* Component alpha is not supported for HSL modes */
+	__m256 ma, mr, mg, mb;
+
+	avx2_load_float_8 (mask, n_pixels, &ma, &mr, &mg, &mb);
+
+	sa = _mm256_mul_ps (sa, ma);
+	s.r = _mm256_mul_ps (s.r, ma);
+	s.g = _mm256_mul_ps (s.g, ma);
+	s.b = _mm256_mul_ps (s.b, ma);
+    }
+
+    blend (&r, &d, da, &s, sa);
+
+    isa = _mm256_sub_ps (one, sa);
+    ida = _mm256_sub_ps (one, da);
+
+#define COMBINE(ch)							\
+    _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (isa, d.ch),		\
+				  _mm256_mul_ps (ida, s.ch)), r.ch)
+
+    ra = _mm256_sub_ps (_mm256_add_ps (sa, da), _mm256_mul_ps (sa, da));
+
+    avx2_save_float_8 (dest, n_pixels,
+		       ra, COMBINE (r), COMBINE (g), COMBINE (b));
+
+#undef COMBINE
+}
+
+#define AVX2_MAKE_NON_SEPARABLE_PDF_COMBINER(name)			\
+    static void								\
+    avx2_combine_ ## name ## _u_float (pixman_implementation_t *imp,	\
+				       pixman_op_t              op,	\
+				       float                   *dest,	\
+				       const float             *src,	\
+				       const float             *mask,	\
+				       int                      n_pixels) \
+    {									\
+	while (n_pixels >= 8)						\
+	{								\
+	    avx2_combine_hsl_8 (dest, src, mask, 8, avx2_blend_ ## name); \
+									\
+	    dest += 32;							\
+	    src += 32;							\
+	    if (mask)							\
+		mask += 32;						\
+	    n_pixels -= 8;						\
+	}								\
+									\
+	if (n_pixels)							\
+	{								\
+	    avx2_combine_hsl_8 (dest, src, mask, n_pixels,		\
+				avx2_blend_ ## name);			\
+	}								\
+    }
+
+AVX2_MAKE_NON_SEPARABLE_PDF_COMBINER (hsl_hue)
+AVX2_MAKE_NON_SEPARABLE_PDF_COMBINER (hsl_saturation)
+AVX2_MAKE_NON_SEPARABLE_PDF_COMBINER (hsl_color)
+AVX2_MAKE_NON_SEPARABLE_PDF_COMBINER (hsl_luminosity)
+
+static void
+avx2_setup_combiner_functions_float (pixman_implementation_t *imp)
+{
+#define AVX2_SET_FLOAT_COMBINER(op, name)				\
+    imp->combine_float[PIXMAN_OP_ ## op] = avx2_combine_ ## name ## _u_float; \
+    imp->combine_float_ca[PIXMAN_OP_ ## op] = avx2_combine_ ## name ## _ca_float
+
+    AVX2_SET_FLOAT_COMBINER (SATURATE, saturate);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_OVER, disjoint_over);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_OVER_REVERSE, disjoint_over_reverse);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_IN, disjoint_in);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_IN_REVERSE, disjoint_in_reverse);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_OUT, disjoint_out);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_OUT_REVERSE, disjoint_out_reverse);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_ATOP, disjoint_atop);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_ATOP_REVERSE, disjoint_atop_reverse);
+    AVX2_SET_FLOAT_COMBINER (DISJOINT_XOR, disjoint_xor);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_OVER, conjoint_over);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_OVER_REVERSE, conjoint_over_reverse);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_IN, conjoint_in);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_IN_REVERSE, conjoint_in_reverse);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_OUT, conjoint_out);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_OUT_REVERSE, conjoint_out_reverse);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_ATOP, conjoint_atop);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_ATOP_REVERSE, conjoint_atop_reverse);
+    AVX2_SET_FLOAT_COMBINER (CONJOINT_XOR, conjoint_xor);
+    AVX2_SET_FLOAT_COMBINER (MULTIPLY, multiply);
+    AVX2_SET_FLOAT_COMBINER (SCREEN, screen);
+    AVX2_SET_FLOAT_COMBINER (OVERLAY, overlay);
+    AVX2_SET_FLOAT_COMBINER (DARKEN, darken);
+    AVX2_SET_FLOAT_COMBINER (LIGHTEN, lighten);
+    AVX2_SET_FLOAT_COMBINER (COLOR_DODGE, color_dodge);
+    AVX2_SET_FLOAT_COMBINER (COLOR_BURN, color_burn);
+    AVX2_SET_FLOAT_COMBINER (HARD_LIGHT, hard_light);
+    AVX2_SET_FLOAT_COMBINER (SOFT_LIGHT, soft_light);
+    AVX2_SET_FLOAT_COMBINER (DIFFERENCE, difference);
+    AVX2_SET_FLOAT_COMBINER (EXCLUSION, exclusion);
+
+    imp->combine_float[PIXMAN_OP_HSL_HUE] = avx2_combine_hsl_hue_u_float;
+    imp->combine_float[PIXMAN_OP_HSL_SATURATION] =
+	avx2_combine_hsl_saturation_u_float;
+    imp->combine_float[PIXMAN_OP_HSL_COLOR] = avx2_combine_hsl_color_u_float;
+    imp->combine_float[PIXMAN_OP_HSL_LUMINOSITY] =
+	avx2_combine_hsl_luminosity_u_float;
+
+#undef AVX2_SET_FLOAT_COMBINER
+}
+
+/*
+ * Separable PDF blend modes on the 8-bit path
+ *
+ * These compute exactly what the combiners in pixman-combine32.c
+ * compute, eight pixels at a time with one register per channel and
+ * each channel value in its own 32-bit lane; see pixman-sse2.c for the
+ * details.
+ */
+
+typedef __m256i (* avx2_combine_un8_t) (__m256i d, __m256i da,
+					__m256i s, __m256i as);
+
+/* a * b for lanes holding values that fit in a signed 16-bit integer */
+static force_inline __m256i
+avx2_mul_s16 (__m256i a, __m256i b)
+{
+    return _mm256_madd_epi16 (a, _mm256_and_si256 (b,
+						   _mm256_set1_epi32 (0xffff)));
+}
+
+/* MUL_UN8 from pixman-combine32.h */
+static force_inline __m256i
+avx2_mul_un8 (__m256i a, __m256i b)
+{
+    __m256i t = _mm256_add_epi32 (_mm256_madd_epi16 (a, b),
+				  _mm256_set1_epi32 (0x80));
+
+    return _mm256_srli_epi32 (_mm256_add_epi32 (t, _mm256_srli_epi32 (t, 8)),
+			      8);
+}
+
+/* DIV_ONE_UN8 from pixman-combine32.h */
+static force_inline __m256i
+avx2_div_one_un8 (__m256i t)
+{
+    t = _mm256_add_epi32 (t, _mm256_set1_epi32 (0x80));
+
+    return _mm256_srli_epi32 (_mm256_add_epi32 (t, _mm256_srli_epi32 (t, 8)),
+			      8);
+}
+
+/* The 8-bit combiners clamp an unsigned sum, so a negative sum
+ * saturates to 255 * 255 rather than to zero.
+ */
+static force_inline __m256i
+avx2_clamp_un8x2 (__m256i t)
+{
+    __m256i max = _mm256_set1_epi32 (255 * 255);
+
+    return _mm256_blendv_epi8 (
+	t, max, _mm256_or_si256 (_mm256_cmpgt_epi32 (_mm256_setzero_si256 (), t),
+				 _mm256_cmpgt_epi32 (t, max)));
+}
+
+static force_inline __m256i
+avx2_inv_un8 (__m256i a)
+{
+    return _mm256_sub_epi32 (_mm256_set1_epi32 (0xff), a);
+}
+
+static force_inline void
+avx2_combine_un8_8 (pixman_bool_t      component,
+		    uint32_t          *pd,
+		    const uint32_t    *ps,
+		    const uint32_t    *pm,
+		    int                w,
+		    avx2_combine_un8_t combine_a,
+		    avx2_combine_un8_t combine_c)
+{
+    __m256i ff = _mm256_set1_epi32 (0xff);
+    __m256i tail = create_tail_mask (w);
+    __m256i s, d, sa, sr, sg, sb, da;
+    __m256i ma, mr, mg, mb;
+    __m256i ra, rr, rg, rb;
+
+    if (w == 8)
+    {
+	s = load_256_unaligned ((const __m256i *)ps);
+	d = load_256_unaligned ((const __m256i *)pd);
+    }
+    else
+    {
+	s = load_256_tail (ps, tail);
+	d = load_256_tail (pd, tail);
+    }
+
+    sa = _mm256_srli_epi32 (s, 24);
+    sr = _mm256_and_si256 (_mm256_srli_epi32 (s, 16), ff);
+    sg = _mm256_and_si256 (_mm256_srli_epi32 (s, 8), ff);
+    sb = _mm256_and_si256 (s, ff);
+    da = _mm256_srli_epi32 (d, 24);
+
+    if (!pm)
+    {
+	ma = mr = mg = mb = sa;
+    }
+    else
+    {
+	__m256i m;
+
+	if (w == 8)
+	    m = load_256_unaligned ((const __m256i *)pm);
+	else
+	    m = load_256_tail (pm, tail);
+
+	ma = _mm256_srli_epi32 (m, 24);
+
+	if (component)
+	{
+	    mr = _mm256_and_si256 (_mm256_srli_epi32 (m, 16), ff);
+	    mg = _mm256_and_si256 (_mm256_srli_epi32 (m, 8), ff);
+	    mb = _mm256_and_si256 (m, ff);
+
+	    sr = avx2_mul_un8 (sr, mr);
+	    sg = avx2_mul_un8 (sg, mg);
+	    sb = avx2_mul_un8 (sb, mb);
+
+	    mr = avx2_mul_un8 (mr, sa);
+	    mg = avx2_mul_un8 (mg, sa);
+	    mb = avx2_mul_un8 (mb, sa);
+
+	    sa = ma = avx2_mul_un8 (sa, ma);
+	}
+	else
+	{
+	    sa = avx2_mul_un8 (sa, ma);
+	    sr = avx2_mul_un8 (sr, ma);
+	    sg = avx2_mul_un8 (sg, ma);
+	    sb = avx2_mul_un8 (sb, ma);
+
+	    ma = mr = mg = mb = sa;
+	}
+    }
+
+    ra = combine_a (da, da, sa, ma);
+    rr = combine_c (_mm256_and_si256 (_mm256_srli_epi32 (d, 16), ff),
+		    da, sr, mr);
+    rg = combine_c (_mm256_and_si256 (_mm256_srli_epi32 (d, 8), ff),
+		    da, sg, mg);
+    rb = combine_c (_mm256_and_si256 (d, ff), da, sb, mb);
+
+    d = _mm256_or_si256 (_mm256_or_si256 (_mm256_slli_epi32 (ra, 24),
+					  _mm256_slli_epi32 (rr, 16)),
+			 _mm256_or_si256 (_mm256_slli_epi32 (rg, 8), rb));
+
+    if (w == 8)
+	save_256_unaligned ((__m256i *)pd, d);
+    else
+	save_256_tail (pd, tail, d);
+}
+
+static force_inline void
+avx2_combine_un8_inner (pixman_bool_t      component,
+			uint32_t          *pd,
+			const uint32_t    *ps,
+			const uint32_t    *pm,
+			int                w,
+			avx2_combine_un8_t combine_a,
+			avx2_combine_un8_t combine_c)
+{
+    while (w >= 8)
+    {
+	avx2_combine_un8_8 (component, pd, ps, pm, 8, combine_a, combine_c);
+
+	pd += 8;
+	ps += 8;
+	if (pm)
+	    pm += 8;
+	w -= 8;
+    }
+
+    if (w)
+	avx2_combine_un8_8 (component, pd, ps, pm, w, combine_a, combine_c);
+}
+
+#define AVX2_MAKE_UN8_COMBINERS(name, combine_a, combine_c)		\
+    static void								\
+    avx2_combine_ ## name ## _u (pixman_implementation_t *imp,		\
+				 pixman_op_t              op,		\
+				 uint32_t *               pd,		\
+				 const uint32_t *         ps,		\
+				 const uint32_t *         pm,		\
+				 int                      w)		\
+    {									\
+	avx2_combine_un8_inner (FALSE, pd, ps, pm, w,			\
+				combine_a, combine_c);			\
+    }									\
+									\
+    static void								\
+    avx2_combine_ ## name ## _ca (pixman_implementation_t *imp,	\
+				  pixman_op_t              op,		\
+				  uint32_t *               pd,		\
+				  const uint32_t *         ps,		\
+				  const uint32_t *         pm,		\
+				  int                      w)		\
+    {									\
+	avx2_combine_un8_inner (TRUE, pd, ps, pm, w,			\
+				combine_a, combine_c);			\
+    }
+
+/* s * (1 - da) + d * (1 - as) + d * s for every channel, alpha included */
+static force_inline __m256i
+avx2_combine_multiply_un8 (__m256i d, __m256i da, __m256i s, __m256i as)
+{
+    __m256i r;
+
+    r = _mm256_add_epi32 (avx2_mul_un8 (s, avx2_inv_un8 (da)),
+			  avx2_mul_un8 (d, avx2_inv_un8 (as)));
+    r = _mm256_add_epi32 (r, avx2_mul_un8 (d, s));
+
+    return _mm256_min_epi32 (r, _mm256_set1_epi32 (0xff));
+}
+
+AVX2_MAKE_UN8_COMBINERS (multiply,
+			 avx2_combine_multiply_un8, avx2_combine_multiply_un8)
+
+static force_inline __m256i
+avx2_blend_screen_un8 (__m256i d, __m256i ad, __m256i s, __m256i as)
+{
+    return _mm256_sub_epi32 (_mm256_add_epi32 (_mm256_madd_epi16 (s, ad),
+					       _mm256_madd_epi16 (d, as)),
+			     _mm256_madd_epi16 (s, d));
+}
+
+/* as * ad - 2 * (ad - d) * (as - s) */
+static force_inline __m256i
+avx2_blend_screen_2x_un8 (__m256i d, __m256i ad, __m256i s, __m256i as)
+{
+    __m256i ad_d = _mm256_sub_epi32 (ad, d);
+
+    return _mm256_sub_epi32 (_mm256_madd_epi16 (as, ad),
+			     avx2_mul_s16 (_mm256_add_epi32 (ad_d, ad_d),
+					   _mm256_sub_epi32 (as, s)));
+}
+
+static force_inline __m256i
+avx2_blend_overlay_un8 (__m256i d, __m256i ad, __m256i s, __m256i as)
+{
+    return _mm256_blendv_epi8 (
+	avx2_blend_screen_2x_un8 (d, ad, s, as),
+	_mm256_madd_epi16 (_mm256_add_epi32 (s, s), d),
+	_mm256_cmpgt_epi32 (ad, _mm256_add_epi32 (d, d)));
+}
+
+static force_inline __m256i
+avx2_blend_darken_un8 (__m256i d, __m256i ad, __m256i s, __m256i as)
+{
+    return _mm256_min_epi32 (_mm256_madd_epi16 (ad, s),
+			     _mm256_madd_epi16 (as, d));
+}
+
+static force_inline __m256i
+avx2_blend_lighten_un8 (__m256i d, __m256i ad, __m256i s, __m256i as)
+{
+    return _mm256_max_epi32 (_mm256_madd_epi16 (ad, s),
+			     _mm256_madd_epi16 (as, d));
+}
+
+static force_inline __m256i
+avx2_blend_hard_light_un8 (__m256i d, __m256i ad, __m256i s, __m256i as)
+{
+    __m256i two_s = _mm256_add_epi32 (s, s);
+
+    return _mm256_blendv_epi8 (avx2_blend_screen_2x_un8 (d, ad, s, as),
+			       _mm256_madd_epi16 (two_s, d),
+			       _mm256_cmpgt_epi32 (as, two_s));
+}
+
+static force_inline __m256i
+avx2_blend_difference_un8 (__m256i d, __m256i ad, __m256i s, __m256i as)
+{
+    return _mm256_abs_epi32 (_mm256_sub_epi32 (_mm256_madd_epi16 (d, as),
+					       _mm256_madd_epi16 (s, ad)));
+}
+
+static force_inline __m256i
+avx2_blend_exclusion_un8 (__m256i d, __m256i ad, __m256i s, __m256i as)
+{
+    __m256i r = _mm256_add_epi32 (_mm256_madd_epi16 (s, ad),
+				  _mm256_madd_epi16 (d, as));
+
+    return _mm256_sub_epi32 (r, _mm256_madd_epi16 (_mm256_add_epi32 (d, d), s));
+}
+
+/* da + sa - da * sa, which is also what every channel below gets with
+ * d * s as the blend function.
+ */
+static force_inline __m256i
+avx2_combine_pdf_alpha_un8 (__m256i d, __m256i da, __m256i s, __m256i as)
+{
+    __m256i r = _mm256_madd_epi16 (_mm256_add_epi32 (da, s),
+				   _mm256_set1_epi32 (0xff));
+
+    r = _mm256_sub_epi32 (r, _mm256_madd_epi16 (da, s));
+
+    return avx2_div_one_un8 (avx2_clamp_un8x2 (r));
+}
+
+#define AVX2_MAKE_SEPARABLE_PDF_UN8_COMBINER(name)			\
+    static force_inline __m256i						\
+    avx2_combine_ ## name ## _un8 (__m256i d, __m256i da,		\
+				   __m256i s, __m256i as)		\
+    {									\
+	__m256i r;							\
+									\
+	r = _mm256_add_epi32 (_mm256_madd_epi16 (avx2_inv_un8 (as), d),	\
+			      _mm256_madd_epi16 (avx2_inv_un8 (da), s)); \
+	r = _mm256_add_epi32 (r, avx2_blend_ ## name ## _un8 (d, da, s, as)); \
+									\
+	return avx2_div_one_un8 (avx2_clamp_un8x2 (r));			\
+    }									\
+									\
+    AVX2_MAKE_UN8_COMBINERS (name,					\
+			     avx2_combine_pdf_alpha_un8,		\
+			     avx2_combine_ ## name ## _un8)
+
+AVX2_MAKE_SEPARABLE_PDF_UN8_COMBINER (screen)
+AVX2_MAKE_SEPARABLE_PDF_UN8_COMBINER (overlay)
+AVX2_MAKE_SEPARABLE_PDF_UN8_COMBINER (darken)
+AVX2_MAKE_SEPARABLE_PDF_UN8_COMBINER (lighten)
+AVX2_MAKE_SEPARABLE_PDF_UN8_COMBINER (hard_light)
+AVX2_MAKE_SEPARABLE_PDF_UN8_COMBINER (difference)
+AVX2_MAKE_SEPARABLE_PDF_UN8_COMBINER (exclusion)
+
+static void
+avx2_setup_combiner_functions_32 (pixman_implementation_t *imp)
+{
+#define AVX2_SET_COMBINER(op, name)					\
+    imp->combine_32[PIXMAN_OP_ ## op] = avx2_combine_ ## name ## _u;	\
+    imp->combine_32_ca[PIXMAN_OP_ ## op] = avx2_combine_ ## name ## _ca
+
+    AVX2_SET_COMBINER (MULTIPLY, multiply);
+    AVX2_SET_COMBINER (SCREEN, screen);
+    AVX2_SET_COMBINER (OVERLAY, overlay);
+    AVX2_SET_COMBINER (DARKEN, darken);
+    AVX2_SET_COMBINER (LIGHTEN, lighten);
+    AVX2_SET_COMBINER (HARD_LIGHT, hard_light);
+    AVX2_SET_COMBINER (DIFFERENCE, difference);
+    AVX2_SET_COMBINER (EXCLUSION, exclusion);
+
+#undef AVX2_SET_COMBINER
+}
+
+/* -------------------------------------------------------------------
+ * composite functions
+ */
+
+static void
+avx2_composite_over_8888_8888 (pixman_implementation_t *imp,
+                               pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    int dst_stride, src_stride;
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    dst = dst_line;
+    src = src_line;
+
+    while (height--)
+    {
+	avx2_combine_over_u (imp, op, dst, src, NULL, width);
+
+	dst += dst_stride;
+	src += src_stride;
+    }
+}
+
+static void
+avx2_composite_add_8888_8888 (pixman_implementation_t *imp,
+                              pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+
+	avx2_combine_add_u (imp, op, dst, src, NULL, width);
+    }
+}
+
+static void
+avx2_composite_over_n_8_8888 (pixman_implementation_t *imp,
+                              pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t src, srca;
+    uint32_t *dst_line, *dst;
+    uint8_t *mask_line, *mask;
+    int dst_stride, mask_stride;
+    int32_t w;
+
+    __m256i ymm_src, ymm_alpha, ymm_def;
+    __m256i ymm_dst, ymm_dst_lo, ymm_dst_hi;
+    __m256i ymm_mask, ymm_mask_lo, ymm_mask_hi;
+    __m128i xmm_mask;
+
+    src = _pixman_image_get_solid (imp, src_image, dest_image->bits.format);
+
+    srca = src >> 24;
+    if (src == 0)
+	return;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	mask_image, mask_x, mask_y, uint8_t, mask_stride, mask_line, 1);
+
+    ymm_def = _mm256_set1_epi32 (src);
+    ymm_src = _mm256_unpacklo_epi8 (ymm_def, _mm256_setzero_si256 ());
+    ymm_alpha = expand_alpha_256 (ymm_src);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	mask = mask_line;
+	mask_line += mask_stride;
+	w = width;
+
+	while (w > 0)
+	{
+	    __m256i tail = create_tail_mask (w);
+
+	    if (w >= 8)
+	    {
+		xmm_mask = _mm_loadl_epi64 ((const __m128i *)mask);
+	    }
+	    else
+	    {
+		uint64_t m = 0;
+
+		memcpy (&m, mask, w);
+		xmm_mask = _mm_loadl_epi64 ((const __m128i *)&m);
+	    }
+
+	    if (srca == 0xff && w >= 8 &&
+		(_mm_movemask_epi8 (_mm_cmpeq_epi8 (
+		    xmm_mask, _mm_cmpeq_epi8 (xmm_mask, xmm_mask))) & 0xff) == 0xff)
+	    {
+		save_256_unaligned ((__m256i *)dst, ymm_def);
+	    }
+	    else if (!_mm_testz_si128 (xmm_mask, xmm_mask))
+	    {
+		ymm_dst = load_256_tail (dst, tail);
+		ymm_mask = _mm256_cvtepu8_epi32 (xmm_mask);
+
+		unpack_256_2x256 (ymm_dst, &ymm_dst_lo, &ymm_dst_hi);
+		unpack_256_2x256 (ymm_mask, &ymm_mask_lo, &ymm_mask_hi);
+
+		ymm_mask_lo = expand_alpha_rev_256 (ymm_mask_lo);
+		ymm_mask_hi = expand_alpha_rev_256 (ymm_mask_hi);
+
+		ymm_dst_lo = in_over_256 (ymm_src, ymm_alpha, ymm_mask_lo, ymm_dst_lo);
+		ymm_dst_hi = in_over_256 (ymm_src, ymm_alpha, ymm_mask_hi, ymm_dst_hi);
+
+		save_256_tail (dst, tail, pack_2x256_256 (ymm_dst_lo, ymm_dst_hi));
+	    }
+
+	    w -= 8;
+	    dst += 8;
+	    mask += 8;
+	}
+    }
+}
+
+static void
+avx2_composite_src_x888_8888 (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    int32_t w;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w >= 32)
+	{
+	    __m256i ymm_src1, ymm_src2, ymm_src3, ymm_src4;
+
+	    ymm_src1 = load_256_unaligned ((__m256i*)src + 0);
+	    ymm_src2 = load_256_unaligned ((__m256i*)src + 1);
+	    ymm_src3 = load_256_unaligned ((__m256i*)src + 2);
+	    ymm_src4 = load_256_unaligned ((__m256i*)src + 3);
+
+	    save_256_unaligned ((__m256i*)dst + 0, _mm256_or_si256 (ymm_src1, mask_ff000000));
+	    save_256_unaligned ((__m256i*)dst + 1, _mm256_or_si256 (ymm_src2, mask_ff000000));
+	    save_256_unaligned ((__m256i*)dst + 2, _mm256_or_si256 (ymm_src3, mask_ff000000));
+	    save_256_unaligned ((__m256i*)dst + 3, _mm256_or_si256 (ymm_src4, mask_ff000000));
+
+	    dst += 32;
+	    src += 32;
+	    w -= 32;
+	}
+
+	while (w >= 8)
+	{
+	    save_256_unaligned ((__m256i*)dst, _mm256_or_si256 (
+		load_256_unaligned ((__m256i*)src), mask_ff000000));
+
+	    dst += 8;
+	    src += 8;
+	    w -= 8;
+	}
+
+	if (w)
+	{
+	    __m256i tail = create_tail_mask (w);
+
+	    save_256_tail (dst, tail, _mm256_or_si256 (
+		load_256_tail (src, tail), mask_ff000000));
+	}
+    }
+}
+
+/* Ordered dithering of a8r8g8b8 to formats with fewer bits per channel,
+ * with the float arithmetic of the general path as in pixman-sse2.c,
+ * eight pixels at a time.
+ */
+#define DITHER_ROW_LENGTH	(64 + 8)
+
+static force_inline __m256
+dither_unorm_to_float (__m256i p, int shift, int n_bits)
+{
+    __m256i u = _mm256_and_si256 (_mm256_srli_epi32 (p, shift),
+				  _mm256_set1_epi32 ((1 << n_bits) - 1));
+
+    return _mm256_mul_ps (_mm256_cvtepi32_ps (u),
+			  _mm256_set1_ps (1.f / (float)((1 << n_bits) - 1)));
+}
+
+static force_inline __m256i
+dither_channel (__m256 f, __m256 d, int n_bits)
+{
+    int u_bits = n_bits > 8 ? n_bits : 8;
+    __m256i u;
+
+    f = _mm256_add_ps (f, _mm256_mul_ps (_mm256_sub_ps (d, f),
+					 _mm256_set1_ps (1.f / (float)(1 << n_bits))));
+    f = _mm256_min_ps (_mm256_max_ps (f, _mm256_setzero_ps ()), _mm256_set1_ps (1.f));
+
+    u = _mm256_cvttps_epi32 (_mm256_mul_ps (f, _mm256_set1_ps ((float)(1 << u_bits))));
+    u = _mm256_sub_epi32 (u, _mm256_srli_epi32 (u, u_bits));
+
+    return _mm256_srli_epi32 (u, u_bits - n_bits);
+}
+
+static force_inline void
+avx2_composite_dither (pixman_composite_info_t *info,
+		       pixman_bool_t            over,
+		       pixman_format_code_t     format)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    float factors[DITHER_ROW_LENGTH];
+    int nr = PIXMAN_FORMAT_R (format);
+    int ng = PIXMAN_FORMAT_G (format);
+    int nb = PIXMAN_FORMAT_B (format);
+    int bpp = PIXMAN_FORMAT_BPP (format) / 8;
+    uint32_t *src_line, *src;
+    uint8_t *dst_line, *dst;
+    int dst_stride, src_stride;
+    int x, y, n;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint8_t, dst_stride, dst_line, bpp);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    for (y = 0; y < height; ++y)
+    {
+	src = src_line;
+	dst = dst_line;
+	src_line += src_stride;
+	dst_line += dst_stride;
+
+	_pixman_bits_image_dither_row (&dest_image->bits, dest_x, dest_y + y,
+				       factors, DITHER_ROW_LENGTH);
+
+	for (x = 0; x < width; x += 8)
+	{
+	    __m256i tail, ymm_src, ymm_p;
+	    __m256 r, g, b, d;
+	    uint16_t tmp[8];
+
+	    n = MIN (width - x, 8);
+	    tail = create_tail_mask (n);
+
+	    if (n == 8)
+		ymm_src = load_256_unaligned ((__m256i *)(src + x));
+	    else
+		ymm_src = load_256_tail (src + x, tail);
+
+	    r = dither_unorm_to_float (ymm_src, 16, 8);
+	    g = dither_unorm_to_float (ymm_src, 8, 8);
+	    b = dither_unorm_to_float (ymm_src, 0, 8);
+
+	    if (over)
+	    {
+		__m256i ymm_dst;
+		__m128i xmm_dst;
+		__m256 one = _mm256_set1_ps (1.f);
+		__m256 inv_sa;
+
+		if (n == 8)
+		{
+		    xmm_dst = _mm_loadu_si128 ((__m128i *)(dst + 2 * x));
+		}
+		else
+		{
+		    memcpy (tmp, dst + 2 * x, n * 2);
+		    xmm_dst = _mm_loadu_si128 ((__m128i *)tmp);
+		}
+		ymm_dst = _mm256_cvtepu16_epi32 (xmm_dst);
+
+		inv_sa = _mm256_sub_ps (one, dither_unorm_to_float (ymm_src, 24, 8));
+
+		r = _mm256_min_ps (_mm256_add_ps (r, _mm256_mul_ps (
+		    dither_unorm_to_float (ymm_dst, nb + ng, nr), inv_sa)), one);
+		g = _mm256_min_ps (_mm256_add_ps (g, _mm256_mul_ps (
+		    dither_unorm_to_float (ymm_dst, nb, ng), inv_sa)), one);
+		b = _mm256_min_ps (_mm256_add_ps (b, _mm256_mul_ps (
+		    dither_unorm_to_float (ymm_dst, 0, nb), inv_sa)), one);
+	    }
+
+	    d = _mm256_loadu_ps (factors + (x & 63));
+
+	    ymm_p = _mm256_or_si256 (
+		_mm256_or_si256 (
+		    _mm256_slli_epi32 (dither_channel (r, d, nr), nb + ng),
+		    _mm256_slli_epi32 (dither_channel (g, d, ng), nb)),
+		dither_channel (b, d, nb));
+
+	    if (bpp == 2)
+	    {
+		__m128i xmm_p;
+
+		ymm_p = _mm256_srai_epi32 (_mm256_slli_epi32 (ymm_p, 16), 16);
+		ymm_p = _mm256_packs_epi32 (ymm_p, ymm_p);
+		xmm_p = _mm256_castsi256_si128 (
+		    _mm256_permute4x64_epi64 (ymm_p, _MM_SHUFFLE (3, 1, 2, 0)));
+
+		if (n == 8)
+		{
+		    _mm_storeu_si128 ((__m128i *)(dst + 2 * x), xmm_p);
+		}
+		else
+		{
+		    _mm_storeu_si128 ((__m128i *)tmp, xmm_p);
+		    memcpy (dst + 2 * x, tmp, n * 2);
+		}
+	    }
+	    else if (n == 8)
+	    {
+		save_256_unaligned ((__m256i *)(dst + 4 * x), ymm_p);
+	    }
+	    else
+	    {
+		save_256_tail ((uint32_t *)(dst + 4 * x), tail, ymm_p);
+	    }
+	}
+    }
+}
+
+#define AVX2_DITHER_FAST_PATH(name, over, format)			\
+    static void								\
+    avx2_composite_ ## name (pixman_implementation_t *imp,		\
+			     pixman_composite_info_t *info)		\
+    {									\
+	avx2_composite_dither (info, over, PIXMAN_ ## format);		\
+    }
+
+AVX2_DITHER_FAST_PATH (src_x888_0565_dither, FALSE, r5g6b5)
+AVX2_DITHER_FAST_PATH (src_x888_0555_dither, FALSE, x1r5g5b5)
+AVX2_DITHER_FAST_PATH (src_x888_0444_dither, FALSE, x4r4g4b4)
+AVX2_DITHER_FAST_PATH (src_x888_2101010_dither, FALSE, x2r10g10b10)
+AVX2_DITHER_FAST_PATH (over_8888_0565_dither, TRUE, r5g6b5)
+AVX2_DITHER_FAST_PATH (over_8888_0555_dither, TRUE, x1r5g5b5)
+AVX2_DITHER_FAST_PATH (over_8888_0444_dither, TRUE, x4r4g4b4)
+
+/* Compositing of sRGB images in linear light, the same as the C fast
+ * paths. Each channel is in a 32 bit lane, for the gathers from the
+ * tables of pixman-srgb.c.
+ */
+static force_inline __m256i
+srgb_expand_256 (__m256i p, int shift, pixman_bool_t srgb)
+{
+    __m256i c = _mm256_and_si256 (
+	_mm256_srl_epi32 (p, _mm_cvtsi32_si128 (shift)), _mm256_set1_epi32 (0xff));
+
+    if (srgb)
+    {
+	return _mm256_and_si256 (
+	    _mm256_i32gather_epi32 ((const int *)_pixman_srgb_to_linear16, c, 2),
+	    _mm256_set1_epi32 (0xffff));
+    }
+
+    return _mm256_or_si256 (_mm256_slli_epi32 (c, 8), c);
+}
+
+static force_inline __m256i
+srgb_contract_256 (__m256i v, pixman_bool_t srgb)
+{
+    if (srgb)
+    {
+	__m256i e, below;
+
+	e = _mm256_and_si256 (
+	    _mm256_i32gather_epi32 ((const int *)_pixman_linear_to_srgb,
+				    _mm256_srli_epi32 (v, 4), 2),
+	    _mm256_set1_epi32 (0xffff));
+	below = _mm256_cmpgt_epi32 (
+	    _mm256_srli_epi32 (e, 8), _mm256_and_si256 (v, _mm256_set1_epi32 (15)));
+
+	return _mm256_add_epi32 (
+	    _mm256_and_si256 (e, _mm256_set1_epi32 (0xff)),
+	    _mm256_add_epi32 (below, _mm256_set1_epi32 (1)));
+    }
+
+    v = _mm256_srli_epi32 (
+	_mm256_add_epi32 (_mm256_slli_epi32 (v, 8), _mm256_srli_epi32 (v, 8)), 16);
+
+    return _mm256_sub_epi32 (v, _mm256_srli_epi32 (v, 8));
+}
+
+static force_inline __m256i
+srgb_convert_256 (__m256i s, pixman_bool_t src_srgb, pixman_bool_t dest_srgb)
+{
+    __m256i result = _mm256_and_si256 (s, mask_ff000000);
+    int shift;
+
+    for (shift = 0; shift < 24; shift += 8)
+    {
+	__m256i v = srgb_expand_256 (s, shift, src_srgb);
+
+	result = _mm256_or_si256 (
+	    result, _mm256_sll_epi32 (srgb_contract_256 (v, dest_srgb),
+				      _mm_cvtsi32_si128 (shift)));
+    }
+
+    return result;
+}
+
+static force_inline __m256i
+srgb_over_256 (__m256i s, __m256i d,
+	       pixman_bool_t src_srgb, pixman_bool_t dest_srgb)
+{
+    __m256i ia = _mm256_sub_epi32 (
+	_mm256_set1_epi32 (255), _mm256_srli_epi32 (s, 24));
+    __m256i result = _mm256_setzero_si256 ();
+    int shift;
+
+    ia = _mm256_add_epi32 (_mm256_or_si256 (_mm256_slli_epi32 (ia, 8), ia),
+			   _mm256_set1_epi32 (1));
+
+    for (shift = 0; shift < 32; shift += 8)
+    {
+	pixman_bool_t alpha = shift == 24;
+	__m256i v;
+
+	v = _mm256_add_epi32 (
+	    srgb_expand_256 (s, shift, src_srgb && !alpha),
+	    _mm256_srli_epi32 (
+		_mm256_mullo_epi32 (
+		    srgb_expand_256 (d, shift, dest_srgb && !alpha), ia), 16));
+	v = _mm256_min_epu32 (v, _mm256_set1_epi32 (65535));
+
+	result = _mm256_or_si256 (
+	    result, _mm256_sll_epi32 (srgb_contract_256 (v, dest_srgb && !alpha),
+				      _mm_cvtsi32_si128 (shift)));
+    }
+
+    return result;
+}
+
+/* The transparent and opaque pixels of a block that has others come
+ * out of srgb_over_256 () the same as in the C fast paths, since the
+ * tables round trip the sRGB levels.
+ */
+static force_inline void
+avx2_composite_srgb (pixman_composite_info_t *info,
+		     pixman_bool_t            over,
+		     pixman_bool_t            src_srgb,
+		     pixman_bool_t            src_x888,
+		     pixman_bool_t            dest_srgb)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t *dst_line, *dst;
+    uint32_t *src_line, *src;
+    int dst_stride, src_stride;
+    int x, n;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+
+	for (x = 0; x < width; x += 8)
+	{
+	    __m256i tail, ymm_src, ymm_dst;
+
+	    n = MIN (width - x, 8);
+	    tail = create_tail_mask (n);
+
+	    if (n == 8)
+		ymm_src = load_256_unaligned ((__m256i *)(src + x));
+	    else
+		ymm_src = load_256_tail (src + x, tail);
+
+	    if (src_x888)
+		ymm_src = _mm256_or_si256 (ymm_src, mask_ff000000);
+
+	    if (!over || is_opaque (ymm_src))
+	    {
+		ymm_dst = srgb_convert_256 (ymm_src, src_srgb, dest_srgb);
+	    }
+	    else if (!is_zero (ymm_src))
+	    {
+		if (n == 8)
+		    ymm_dst = load_256_unaligned ((__m256i *)(dst + x));
+		else
+		    ymm_dst = load_256_tail (dst + x, tail);
+
+		ymm_dst = srgb_over_256 (ymm_src, ymm_dst, src_srgb, dest_srgb);
+	    }
+	    else
+	    {
+		continue;
+	    }
+
+	    if (n == 8)
+		save_256_unaligned ((__m256i *)(dst + x), ymm_dst);
+	    else
+		save_256_tail (dst + x, tail, ymm_dst);
+	}
+    }
+}
+
+#define AVX2_SRGB_FAST_PATH(name, over, src_srgb, src_x888, dest_srgb)	\
+    static void								\
+    avx2_composite_ ## name (pixman_implementation_t *imp,		\
+			     pixman_composite_info_t *info)		\
+    {									\
+	avx2_composite_srgb (info, over, src_srgb, src_x888, dest_srgb); \
+    }
+
+AVX2_SRGB_FAST_PATH (src_8888_srgb, FALSE, FALSE, FALSE, TRUE)
+AVX2_SRGB_FAST_PATH (src_x888_srgb, FALSE, FALSE, TRUE, TRUE)
+AVX2_SRGB_FAST_PATH (src_srgb_8888, FALSE, TRUE, FALSE, FALSE)
+AVX2_SRGB_FAST_PATH (over_8888_srgb, TRUE, FALSE, FALSE, TRUE)
+AVX2_SRGB_FAST_PATH (over_srgb_srgb, TRUE, TRUE, FALSE, TRUE)
+AVX2_SRGB_FAST_PATH (over_srgb_8888, TRUE, TRUE, FALSE, FALSE)
+
+static void
+avx2_composite_add_8_8 (pixman_implementation_t *imp,
+			pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint8_t     *dst_line, *dst;
+    uint8_t     *src_line, *src;
+    int dst_stride, src_stride;
+    int32_t w;
+    uint16_t t;
+
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint8_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint8_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	src = src_line;
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+	w = width;
+
+	while (w >= 32)
+	{
+	    save_256_unaligned ((__m256i*)dst, _mm256_adds_epu8 (
+		load_256_unaligned ((__m256i*)src),
+		load_256_unaligned ((__m256i*)dst)));
+
+	    dst += 32;
+	    src += 32;
+	    w -= 32;
+	}
+
+	/* Small tail */
+	while (w)
+	{
+	    t = (*dst) + (*src++);
+	    *dst++ = t | (0 - (t >> 8));
+	    w--;
+	}
+    }
+}
+
+static pixman_bool_t
+avx2_fill (pixman_implementation_t *imp,
+           uint32_t *               bits,
+           int                      stride,
+           int                      bpp,
+           int                      x,
+           int                      y,
+           int                      width,
+           int                      height,
+           uint32_t		    filler)
+{
+    uint32_t byte_width;
+    uint8_t *byte_line;
+
+    __m256i ymm_def;
+
+    if (bpp == 8)
+    {
+	uint32_t b;
+	uint32_t w;
+
+	stride = stride * (int) sizeof (uint32_t) / 1;
+	byte_line = (uint8_t *)(((uint8_t *)bits) + stride * y + x);
+	byte_width = width;
+	stride *= 1;
+
+	b = filler & 0xff;
+	w = (b << 8) | b;
+	filler = (w << 16) | w;
+    }
+    else if (bpp == 16)
+    {
+	stride = stride * (int) sizeof (uint32_t) / 2;
+	byte_line = (uint8_t *)(((uint16_t *)bits) + stride * y + x);
+	byte_width = 2 * width;
+	stride *= 2;
+
+        filler = (filler & 0xffff) * 0x00010001;
+    }
+    else if (bpp == 32)
+    {
+	stride = stride * (int) sizeof (uint32_t) / 4;
+	byte_line = (uint8_t *)(((uint32_t *)bits) + stride * y + x);
+	byte_width = 4 * width;
+	stride *= 4;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    ymm_def = _mm256_set1_epi32 (filler);
+
+    while (height--)
+    {
+	int w;
+	uint8_t *d = byte_line;
+	byte_line += stride;
+	w = byte_width;
+
+	if (w >= 1 && ((uintptr_t)d & 1))
+	{
+	    *(uint8_t *)d = filler;
+	    w -= 1;
+	    d += 1;
+	}
+
+	while (w >= 2 && ((uintptr_t)d & 3))
+	{
+	    *(uint16_t *)d = filler;
+	    w -= 2;
+	    d += 2;
+	}
+
+	while (w >= 4 && ((uintptr_t)d & 31))
+	{
+	    *(uint32_t *)d = filler;
+
+	    w -= 4;
+	    d += 4;
+	}
+
+	while (w >= 128)
+	{
+	    save_256_aligned ((__m256i*)(d),      ymm_def);
+	    save_256_aligned ((__m256i*)(d + 32), ymm_def);
+	    save_256_aligned ((__m256i*)(d + 64), ymm_def);
+	    save_256_aligned ((__m256i*)(d + 96), ymm_def);
+
+	    d += 128;
+	    w -= 128;
+	}
+
+	if (w >= 64)
+	{
+	    save_256_aligned ((__m256i*)(d),      ymm_def);
+	    save_256_aligned ((__m256i*)(d + 32), ymm_def);
+
+	    d += 64;
+	    w -= 64;
+	}
+
+	if (w >= 32)
+	{
+	    save_256_aligned ((__m256i*)(d), ymm_def);
+
+	    d += 32;
+	    w -= 32;
+	}
+
+	while (w >= 4)
+	{
+	    *(uint32_t *)d = filler;
+
+	    w -= 4;
+	    d += 4;
+	}
+
+	if (w >= 2)
+	{
+	    *(uint16_t *)d = filler;
+	    w -= 2;
+	    d += 2;
+	}
+
+	if (w >= 1)
+	{
+	    *(uint8_t *)d = filler;
+	    w -= 1;
+	    d += 1;
+	}
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+avx2_blt (pixman_implementation_t *imp,
+          uint32_t *               src_bits,
+          uint32_t *               dst_bits,
+          int                      src_stride,
+          int                      dst_stride,
+          int                      src_bpp,
+          int                      dst_bpp,
+          int                      src_x,
+          int                      src_y,
+          int                      dest_x,
+          int                      dest_y,
+          int                      width,
+          int                      height)
+{
+    uint8_t *   src_bytes;
+    uint8_t *   dst_bytes;
+    int byte_width;
+
+    if (src_bpp != dst_bpp)
+	return FALSE;
+
+    if (src_bpp == 16)
+    {
+	src_stride = src_stride * (int) sizeof (uint32_t) / 2;
+	dst_stride = dst_stride * (int) sizeof (uint32_t) / 2;
+	src_bytes =(uint8_t *)(((uint16_t *)src_bits) + src_stride * (src_y) + (src_x));
+	dst_bytes = (uint8_t *)(((uint16_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
+	byte_width = 2 * width;
+	src_stride *= 2;
+	dst_stride *= 2;
+    }
+    else if (src_bpp == 32)
+    {
+	src_stride = src_stride * (int) sizeof (uint32_t) / 4;
+	dst_stride = dst_stride * (int) sizeof (uint32_t) / 4;
+	src_bytes = (uint8_t *)(((uint32_t *)src_bits) + src_stride * (src_y) + (src_x));
+	dst_bytes = (uint8_t *)(((uint32_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
+	byte_width = 4 * width;
+	src_stride *= 4;
+	dst_stride *= 4;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    while (height--)
+    {
+	int w;
+	uint8_t *s = src_bytes;
+	uint8_t *d = dst_bytes;
+	src_bytes += src_stride;
+	dst_bytes += dst_stride;
+	w = byte_width;
+
+	while (w >= 2 && ((uintptr_t)d & 3))
+	{
+            memmove(d, s, 2);
+	    w -= 2;
+	    s += 2;
+	    d += 2;
+	}
+
+	while (w >= 4 && ((uintptr_t)d & 31))
+	{
+            memmove(d, s, 4);
+
+	    w -= 4;
+	    s += 4;
+	    d += 4;
+	}
+
+	while (w >= 128)
+	{
+	    __m256i ymm0, ymm1, ymm2, ymm3;
+
+	    ymm0 = load_256_unaligned ((__m256i*)(s));
+	    ymm1 = load_256_unaligned ((__m256i*)(s + 32));
+	    ymm2 = load_256_unaligned ((__m256i*)(s + 64));
+	    ymm3 = load_256_unaligned ((__m256i*)(s + 96));
+
+	    save_256_aligned ((__m256i*)(d),      ymm0);
+	    save_256_aligned ((__m256i*)(d + 32), ymm1);
+	    save_256_aligned ((__m256i*)(d + 64), ymm2);
+	    save_256_aligned ((__m256i*)(d + 96), ymm3);
+
+	    s += 128;
+	    d += 128;
+	    w -= 128;
+	}
+
+	while (w >= 32)
+	{
+	    save_256_aligned ((__m256i*)d, load_256_unaligned ((__m256i*)s) );
+
+	    w -= 32;
+	    d += 32;
+	    s += 32;
+	}
+
+	while (w >= 4)
+	{
+            memmove(d, s, 4);
+
+	    w -= 4;
+	    s += 4;
+	    d += 4;
+	}
+
+	if (w >= 2)
+	{
+            memmove(d, s, 2);
+	    w -= 2;
+	    s += 2;
+	    d += 2;
+	}
+    }
+
+    return TRUE;
+}
+
+static void
+avx2_composite_copy_area (pixman_implementation_t *imp,
+                          pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    avx2_blt (imp, src_image->bits.bits,
+	      dest_image->bits.bits,
+	      src_image->bits.rowstride,
+	      dest_image->bits.rowstride,
+	      PIXMAN_FORMAT_BPP (src_image->bits.format),
+	      PIXMAN_FORMAT_BPP (dest_image->bits.format),
+	      src_x, src_y, dest_x, dest_y, width, height);
+}
+
+static force_inline void
+transpose_8x8_32 (__m256i r[8])
+{
+    __m256i s0 = _mm256_unpacklo_epi32 (r[0], r[1]);
+    __m256i s1 = _mm256_unpackhi_epi32 (r[0], r[1]);
+    __m256i s2 = _mm256_unpacklo_epi32 (r[2], r[3]);
+    __m256i s3 = _mm256_unpackhi_epi32 (r[2], r[3]);
+    __m256i s4 = _mm256_unpacklo_epi32 (r[4], r[5]);
+    __m256i s5 = _mm256_unpackhi_epi32 (r[4], r[5]);
+    __m256i s6 = _mm256_unpacklo_epi32 (r[6], r[7]);
+    __m256i s7 = _mm256_unpackhi_epi32 (r[6], r[7]);
+
+    __m256i t0 = _mm256_unpacklo_epi64 (s0, s2);
+    __m256i t1 = _mm256_unpackhi_epi64 (s0, s2);
+    __m256i t2 = _mm256_unpacklo_epi64 (s1, s3);
+    __m256i t3 = _mm256_unpackhi_epi64 (s1, s3);
+    __m256i t4 = _mm256_unpacklo_epi64 (s4, s6);
+    __m256i t5 = _mm256_unpackhi_epi64 (s4, s6);
+    __m256i t6 = _mm256_unpacklo_epi64 (s5, s7);
+    __m256i t7 = _mm256_unpackhi_epi64 (s5, s7);
+
+    r[0] = _mm256_permute2x128_si256 (t0, t4, 0x20);
+    r[1] = _mm256_permute2x128_si256 (t1, t5, 0x20);
+    r[2] = _mm256_permute2x128_si256 (t2, t6, 0x20);
+    r[3] = _mm256_permute2x128_si256 (t3, t7, 0x20);
+    r[4] = _mm256_permute2x128_si256 (t0, t4, 0x31);
+    r[5] = _mm256_permute2x128_si256 (t1, t5, 0x31);
+    r[6] = _mm256_permute2x128_si256 (t2, t6, 0x31);
+    r[7] = _mm256_permute2x128_si256 (t3, t7, 0x31);
+}
+
+/* Rotating a block clockwise is a transpose with the columns taken from
+ * right to left; counterclockwise, the rows are reversed before the
+ * transpose.
+ */
+static force_inline void
+avx2_block_90_8888 (uint32_t *dst, int dst_stride,
+		    const uint32_t *src, int src_stride)
+{
+    __m256i r[8];
+
+    r[0] = load_256_unaligned ((const __m256i *)(src + src_stride * 0));
+    r[1] = load_256_unaligned ((const __m256i *)(src + src_stride * 1));
+    r[2] = load_256_unaligned ((const __m256i *)(src + src_stride * 2));
+    r[3] = load_256_unaligned ((const __m256i *)(src + src_stride * 3));
+    r[4] = load_256_unaligned ((const __m256i *)(src + src_stride * 4));
+    r[5] = load_256_unaligned ((const __m256i *)(src + src_stride * 5));
+    r[6] = load_256_unaligned ((const __m256i *)(src + src_stride * 6));
+    r[7] = load_256_unaligned ((const __m256i *)(src + src_stride * 7));
+
+    transpose_8x8_32 (r);
+
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 0), r[7]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 1), r[6]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 2), r[5]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 3), r[4]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 4), r[3]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 5), r[2]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 6), r[1]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 7), r[0]);
+}
+
+static force_inline void
+avx2_block_270_8888 (uint32_t *dst, int dst_stride,
+		     const uint32_t *src, int src_stride)
+{
+    __m256i r[8];
+
+    r[7] = load_256_unaligned ((const __m256i *)(src + src_stride * 0));
+    r[6] = load_256_unaligned ((const __m256i *)(src + src_stride * 1));
+    r[5] = load_256_unaligned ((const __m256i *)(src + src_stride * 2));
+    r[4] = load_256_unaligned ((const __m256i *)(src + src_stride * 3));
+    r[3] = load_256_unaligned ((const __m256i *)(src + src_stride * 4));
+    r[2] = load_256_unaligned ((const __m256i *)(src + src_stride * 5));
+    r[1] = load_256_unaligned ((const __m256i *)(src + src_stride * 6));
+    r[0] = load_256_unaligned ((const __m256i *)(src + src_stride * 7));
+
+    transpose_8x8_32 (r);
+
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 0), r[0]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 1), r[1]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 2), r[2]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 3), r[3]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 4), r[4]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 5), r[5]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 6), r[6]);
+    save_256_unaligned ((__m256i *)(dst + dst_stride * 7), r[7]);
+}
+
+FAST_SIMPLE_ROTATE_BLOCKS (avx2_8888, uint32_t, 8,
+			   avx2_block_90_8888, avx2_block_270_8888)
+
+static force_inline void
+avx2_reverse_line_8888 (uint32_t *dst, const uint32_t *src, int w)
+{
+    const __m256i reverse = _mm256_set_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+
+    src += w;
+
+    while (w >= 8)
+    {
+	__m256i s;
+
+	src -= 8;
+	s = load_256_unaligned ((const __m256i *)src);
+	save_256_unaligned ((__m256i *)dst,
+			    _mm256_permutevar8x32_epi32 (s, reverse));
+	dst += 8;
+	w -= 8;
+    }
+
+    while (w--)
+	*dst++ = *--src;
+}
+
+static force_inline void
+avx2_reverse_line_565 (uint16_t *dst, const uint16_t *src, int w)
+{
+    const __m256i reverse = _mm256_setr_epi8 (
+	14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+	14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+
+    src += w;
+
+    while (w >= 16)
+    {
+	__m256i s;
+
+	src -= 16;
+	s = load_256_unaligned ((const __m256i *)src);
+	s = _mm256_shuffle_epi8 (s, reverse);
+	save_256_unaligned ((__m256i *)dst,
+			    _mm256_permute4x64_epi64 (s, _MM_SHUFFLE (1, 0, 3, 2)));
+	dst += 16;
+	w -= 16;
+    }
+
+    while (w--)
+	*dst++ = *--src;
+}
+
+FAST_SIMPLE_FLIP (avx2_8888, uint32_t, avx2_reverse_line_8888)
+FAST_SIMPLE_FLIP (avx2_565, uint16_t, avx2_reverse_line_565)
+
+static force_inline void
+scaled_nearest_scanline_avx2_8888_8888_OVER (uint32_t*       pd,
+                                             const uint32_t* ps,
+                                             int32_t         w,
+                                             pixman_fixed_t  vx,
+                                             pixman_fixed_t  unit_x,
+                                             pixman_fixed_t  src_width_fixed,
+                                             pixman_bool_t   fully_transparent_src)
+{
+    uint32_t tmp[8];
+    __m256i s, tail;
+    int i, n;
+
+    if (fully_transparent_src)
+	return;
+
+    while (w > 0)
+    {
+	n = w < 8 ? w : 8;
+
+	for (i = 0; i < n; i++)
+	{
+	    tmp[i] = *(ps + pixman_fixed_to_int (vx));
+	    vx += unit_x;
+	    while (vx >= 0)
+		vx -= src_width_fixed;
+	}
+
+	if (n == 8)
+	{
+	    s = load_256_unaligned ((__m256i *)tmp);
+
+	    save_256_unaligned (
+		(__m256i *)pd,
+		core_over_u (s, load_256_unaligned ((__m256i *)pd)));
+	}
+	else
+	{
+	    tail = create_tail_mask (n);
+	    s = load_256_tail (tmp, tail);
+
+	    save_256_tail (pd, tail, core_over_u (s, load_256_tail (pd, tail)));
+	}
+
+	w -= 8;
+	pd += 8;
+    }
+}
+
+FAST_NEAREST_MAINLOOP (avx2_8888_8888_cover_OVER,
+		       scaled_nearest_scanline_avx2_8888_8888_OVER,
+		       uint32_t, uint32_t, COVER)
+FAST_NEAREST_MAINLOOP (avx2_8888_8888_none_OVER,
+		       scaled_nearest_scanline_avx2_8888_8888_OVER,
+		       uint32_t, uint32_t, NONE)
+FAST_NEAREST_MAINLOOP (avx2_8888_8888_pad_OVER,
+		       scaled_nearest_scanline_avx2_8888_8888_OVER,
+		       uint32_t, uint32_t, PAD)
+FAST_NEAREST_MAINLOOP (avx2_8888_8888_normal_OVER,
+		       scaled_nearest_scanline_avx2_8888_8888_OVER,
+		       uint32_t, uint32_t, NORMAL)
+
+/***********************************************************************************/
+
+/* The bilinear code is the non-PSHUFD variant from pixman-sse2.c with
+ * two pixels per register, one in each 128-bit lane. ymm_x holds the
+ * horizontal weights for vx in the low lane and for vx + unit_x in the
+ * high lane.
+ */
+# define BILINEAR_DECLARE_VARIABLES						\
+    const __m256i ymm_wt = _mm256_set1_epi16 (wt);				\
+    const __m256i ymm_wb = _mm256_set1_epi16 (wb);				\
+    const __m256i ymm_addc = _mm256_set1_epi32 (0x00000001);			\
+    const __m256i ymm_ux1 = _mm256_set1_epi32 (				\
+	((uint32_t)(uint16_t)unit_x << 16) | (uint16_t)-unit_x);		\
+    const __m256i ymm_ux2 = _mm256_set1_epi32 (				\
+	((uint32_t)(uint16_t)(unit_x * 2) << 16) | (uint16_t)(-unit_x * 2));	\
+    const __m256i ymm_zero = _mm256_setzero_si256 ();				\
+    __m256i ymm_x = create_2x128_256 (						\
+	_mm_set_epi16 (vx, -(vx + 1), vx, -(vx + 1),				\
+		       vx, -(vx + 1), vx, -(vx + 1)),				\
+	_mm_set_epi16 (vx + unit_x, -(vx + 1) - unit_x,				\
+		       vx + unit_x, -(vx + 1) - unit_x,				\
+		       vx + unit_x, -(vx + 1) - unit_x,				\
+		       vx + unit_x, -(vx + 1) - unit_x))
+
+#define BILINEAR_INTERPOLATE_TWO_PIXELS_HELPER(pix)				\
+do {										\
+    __m256i ymm_wh, ymm_a, ymm_b;						\
+    /* fetch two 2x2 pixel blocks into avx2 registers */			\
+    __m256i tltr = create_2x128_256 (						\
+	_mm_loadl_epi64 ((__m128i *)&src_top[vx >> 16]),			\
+	_mm_loadl_epi64 ((__m128i *)&src_top[(vx + unit_x) >> 16]));		\
+    __m256i blbr = create_2x128_256 (						\
+	_mm_loadl_epi64 ((__m128i *)&src_bottom[vx >> 16]),			\
+	_mm_loadl_epi64 ((__m128i *)&src_bottom[(vx + unit_x) >> 16]));	\
+    vx += unit_x * 2;								\
+    /* vertical interpolation */						\
+    ymm_a = _mm256_mullo_epi16 (_mm256_unpacklo_epi8 (tltr, ymm_zero), ymm_wt);	\
+    ymm_b = _mm256_mullo_epi16 (_mm256_unpacklo_epi8 (blbr, ymm_zero), ymm_wb);	\
+    ymm_a = _mm256_add_epi16 (ymm_a, ymm_b);					\
+    /* calculate horizontal weights */						\
+    ymm_wh = _mm256_add_epi16 (ymm_addc, _mm256_srli_epi16 (ymm_x,		\
+					16 - BILINEAR_INTERPOLATION_BITS));	\
+    ymm_x = _mm256_add_epi16 (ymm_x, ymm_ux2);					\
+    /* horizontal interpolation */						\
+    ymm_b = _mm256_unpacklo_epi64 (/* any value is fine here */ ymm_b, ymm_a);	\
+    ymm_a = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ymm_b, ymm_a), ymm_wh);	\
+    /* shift the result */							\
+    pix = _mm256_srli_epi32 (ymm_a, BILINEAR_INTERPOLATION_BITS * 2);		\
+} while (0)
+
+#define BILINEAR_INTERPOLATE_ONE_PIXEL(pix)					\
+do {										\
+    __m128i xmm_wh, xmm_a, xmm_b;						\
+    /* fetch 2x2 pixel block into sse2 registers */				\
+    __m128i tltr = _mm_loadl_epi64 ((__m128i *)&src_top[vx >> 16]);		\
+    __m128i blbr = _mm_loadl_epi64 ((__m128i *)&src_bottom[vx >> 16]);		\
+    vx += unit_x;								\
+    /* vertical interpolation */						\
+    xmm_a = _mm_mullo_epi16 (_mm_unpacklo_epi8 (tltr,				\
+						_mm256_castsi256_si128 (ymm_zero)), \
+			     _mm256_castsi256_si128 (ymm_wt));			\
+    xmm_b = _mm_mullo_epi16 (_mm_unpacklo_epi8 (blbr,				\
+						_mm256_castsi256_si128 (ymm_zero)), \
+			     _mm256_castsi256_si128 (ymm_wb));			\
+    xmm_a = _mm_add_epi16 (xmm_a, xmm_b);					\
+    /* calculate horizontal weights from the low lane */			\
+    xmm_wh = _mm_add_epi16 (_mm256_castsi256_si128 (ymm_addc),			\
+			    _mm_srli_epi16 (_mm256_castsi256_si128 (ymm_x),	\
+					    16 - BILINEAR_INTERPOLATION_BITS)); \
+    ymm_x = _mm256_add_epi16 (ymm_x, ymm_ux1);					\
+    /* horizontal interpolation */						\
+    xmm_b = _mm_unpacklo_epi64 (/* any value is fine here */ xmm_b, xmm_a);	\
+    xmm_a = _mm_madd_epi16 (_mm_unpackhi_epi16 (xmm_b, xmm_a), xmm_wh);		\
+    /* shift and pack the result */						\
+    xmm_a = _mm_srli_epi32 (xmm_a, BILINEAR_INTERPOLATION_BITS * 2);		\
+    xmm_a = _mm_packs_epi32 (xmm_a, xmm_a);					\
+    xmm_a = _mm_packus_epi16 (xmm_a, xmm_a);					\
+    pix = _mm_cvtsi128_si32 (xmm_a);						\
+} while (0)
+
+#define BILINEAR_INTERPOLATE_EIGHT_PIXELS(pix)					\
+do {										\
+    __m256i ymm_pix1, ymm_pix2, ymm_pix3, ymm_pix4;				\
+    BILINEAR_INTERPOLATE_TWO_PIXELS_HELPER (ymm_pix1);				\
+    BILINEAR_INTERPOLATE_TWO_PIXELS_HELPER (ymm_pix2);				\
+    BILINEAR_INTERPOLATE_TWO_PIXELS_HELPER (ymm_pix3);				\
+    BILINEAR_INTERPOLATE_TWO_PIXELS_HELPER (ymm_pix4);				\
+    /* the low lane now holds pixels 0, 2, 4, 6 and the high lane		\
+     * pixels 1, 3, 5, 7; put them back in order */				\
+    ymm_pix1 = _mm256_packs_epi32 (ymm_pix1, ymm_pix2);				\
+    ymm_pix3 = _mm256_packs_epi32 (ymm_pix3, ymm_pix4);				\
+    pix = _mm256_permutevar8x32_epi32 (						\
+	_mm256_packus_epi16 (ymm_pix1, ymm_pix3), mask_bilinear_order);		\
+} while (0)
+
+/***********************************************************************************/
+
+static force_inline void
+scaled_bilinear_scanline_avx2_8888_8888_SRC (uint32_t *       dst,
+					     const uint32_t * mask,
+					     const uint32_t * src_top,
+					     const uint32_t * src_bottom,
+					     int32_t          w,
+					     int              wt,
+					     int              wb,
+					     pixman_fixed_t   vx_,
+					     pixman_fixed_t   unit_x_,
+					     pixman_fixed_t   max_vx,
+					     pixman_bool_t    zero_src)
+{
+    intptr_t vx = vx_;
+    intptr_t unit_x = unit_x_;
+    BILINEAR_DECLARE_VARIABLES;
+    uint32_t pix1;
+
+    while ((w -= 8) >= 0)
+    {
+	__m256i ymm_src;
+	BILINEAR_INTERPOLATE_EIGHT_PIXELS (ymm_src);
+	save_256_unaligned ((__m256i *)dst, ymm_src);
+	dst += 8;
+    }
+
+    w += 8;
+    while (w--)
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix1);
+	*dst++ = pix1;
+    }
+}
+
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_cover_SRC,
+			       scaled_bilinear_scanline_avx2_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       COVER, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_pad_SRC,
+			       scaled_bilinear_scanline_avx2_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       PAD, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_none_SRC,
+			       scaled_bilinear_scanline_avx2_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       NONE, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_normal_SRC,
+			       scaled_bilinear_scanline_avx2_8888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       NORMAL, FLAG_NONE)
+
+static force_inline void
+scaled_bilinear_scanline_avx2_x888_8888_SRC (uint32_t *       dst,
+					     const uint32_t * mask,
+					     const uint32_t * src_top,
+					     const uint32_t * src_bottom,
+					     int32_t          w,
+					     int              wt,
+					     int              wb,
+					     pixman_fixed_t   vx_,
+					     pixman_fixed_t   unit_x_,
+					     pixman_fixed_t   max_vx,
+					     pixman_bool_t    zero_src)
+{
+    intptr_t vx = vx_;
+    intptr_t unit_x = unit_x_;
+    BILINEAR_DECLARE_VARIABLES;
+    uint32_t pix1;
+
+    while ((w -= 8) >= 0)
+    {
+	__m256i ymm_src;
+	BILINEAR_INTERPOLATE_EIGHT_PIXELS (ymm_src);
+	save_256_unaligned ((__m256i *)dst,
+			    _mm256_or_si256 (ymm_src, mask_ff000000));
+	dst += 8;
+    }
+
+    w += 8;
+    while (w--)
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix1);
+	*dst++ = pix1 | 0xFF000000;
+    }
+}
+
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_x888_8888_cover_SRC,
+			       scaled_bilinear_scanline_avx2_x888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       COVER, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_x888_8888_pad_SRC,
+			       scaled_bilinear_scanline_avx2_x888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       PAD, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_x888_8888_normal_SRC,
+			       scaled_bilinear_scanline_avx2_x888_8888_SRC,
+			       uint32_t, uint32_t, uint32_t,
+			       NORMAL, FLAG_NONE)
+
+static force_inline void
+scaled_bilinear_scanline_avx2_8888_8888_OVER (uint32_t *       dst,
+					      const uint32_t * mask,
+					      const uint32_t * src_top,
+					      const uint32_t * src_bottom,
+					      int32_t          w,
+					      int              wt,
+					      int              wb,
+					      pixman_fixed_t   vx_,
+					      pixman_fixed_t   unit_x_,
+					      pixman_fixed_t   max_vx,
+					      pixman_bool_t    zero_src)
+{
+    intptr_t vx = vx_;
+    intptr_t unit_x = unit_x_;
+    BILINEAR_DECLARE_VARIABLES;
+    uint32_t pix1;
+
+    while (w >= 8)
+    {
+	__m256i ymm_src;
+
+	BILINEAR_INTERPOLATE_EIGHT_PIXELS (ymm_src);
+
+	save_256_unaligned ((__m256i *)dst, core_over_u (
+	    ymm_src, load_256_unaligned ((__m256i *)dst)));
+
+	w -= 8;
+	dst += 8;
+    }
+
+    while (w)
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix1);
+
+	if (pix1)
+	    *dst = core_combine_over_u_pixel_avx2 (pix1, *dst);
+
+	w--;
+	dst++;
+    }
+}
+
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_cover_OVER,
+			       scaled_bilinear_scanline_avx2_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       COVER, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_pad_OVER,
+			       scaled_bilinear_scanline_avx2_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       PAD, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_none_OVER,
+			       scaled_bilinear_scanline_avx2_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       NONE, FLAG_NONE)
+FAST_BILINEAR_MAINLOOP_COMMON (avx2_8888_8888_normal_OVER,
+			       scaled_bilinear_scanline_avx2_8888_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       NORMAL, FLAG_NONE)
+
+/* YUV to RGB as in yuv_to_8888_4() of pixman-sse2.c, with each
+ * coefficient split in its high and low byte.
+ */
+typedef struct
+{
+    __m256i offset;
+    __m256i r_hi, r_lo;
+    __m256i g_hi, g_lo, gu;
+    __m256i b_hi, b_lo;
+} yuv_constants_t;
+
+/* Y coefficient in the low half, U or V coefficient in the high half */
+static force_inline __m256i
+yuv_pair (int32_t y, int32_t c)
+{
+    return _mm256_set1_epi32 ((y & 0xffff) | (uint32_t)c << 16);
+}
+
+static force_inline void
+yuv_constants_init (yuv_constants_t *k, const pixman_yuv_coefficients_t *c)
+{
+    k->offset = yuv_pair (c->y_offset, 128);
+    k->r_hi = yuv_pair (c->y >> 8, c->rv >> 8);
+    k->r_lo = yuv_pair (c->y & 0xff, c->rv & 0xff);
+    k->g_hi = yuv_pair (c->y >> 8, c->gv >> 8);
+    k->g_lo = yuv_pair (c->y & 0xff, c->gv & 0xff);
+    k->gu = yuv_pair (0, c->gu);
+    k->b_hi = yuv_pair (c->y >> 8, c->bu >> 8);
+    k->b_lo = yuv_pair (c->y & 0xff, c->bu & 0xff);
+}
+
+/* Two lanes of Y0 U0 Y1 V0 Y2 U1 Y3 V1 in 16-bit lanes */
+static force_inline __m256i
+yuv_to_8888_8 (const yuv_constants_t *k, __m256i w)
+{
+    __m256i yu, yv, r, g, b;
+
+    w = _mm256_sub_epi16 (w, k->offset);
+
+    yu = _mm256_shufflehi_epi16 (
+	_mm256_shufflelo_epi16 (w, _MM_SHUFFLE (1, 2, 1, 0)), _MM_SHUFFLE (1, 2, 1, 0));
+    yv = _mm256_shufflehi_epi16 (
+	_mm256_shufflelo_epi16 (w, _MM_SHUFFLE (3, 2, 3, 0)), _MM_SHUFFLE (3, 2, 3, 0));
+
+    r = _mm256_add_epi32 (
+	_mm256_slli_epi32 (_mm256_madd_epi16 (yv, k->r_hi), 8),
+	_mm256_madd_epi16 (yv, k->r_lo));
+    g = _mm256_add_epi32 (
+	_mm256_add_epi32 (
+	    _mm256_slli_epi32 (_mm256_madd_epi16 (yv, k->g_hi), 8),
+	    _mm256_madd_epi16 (yv, k->g_lo)),
+	_mm256_madd_epi16 (yu, k->gu));
+    b = _mm256_add_epi32 (
+	_mm256_slli_epi32 (_mm256_madd_epi16 (yu, k->b_hi), 8),
+	_mm256_madd_epi16 (yu, k->b_lo));
+
+    b = _mm256_packus_epi16 (
+	_mm256_packs_epi32 (_mm256_srai_epi32 (b, 16), _mm256_srai_epi32 (r, 16)),
+	_mm256_packs_epi32 (_mm256_srai_epi32 (g, 16), _mm256_set1_epi32 (0xff)));
+    b = _mm256_unpacklo_epi8 (b, _mm256_srli_si256 (b, 8));
+
+    return _mm256_unpacklo_epi16 (b, _mm256_srli_si256 (b, 8));
+}
+
+/* The unpacks work within lanes, so the low half holds pixels 0-3 and
+ * 8-11, and the high half pixels 4-7 and 12-15.
+ */
+static force_inline void
+yuyv_to_8888_16 (const yuv_constants_t *k, __m256i yuyv, uint32_t *buffer)
+{
+    __m256i lo = yuv_to_8888_8 (
+	k, _mm256_unpacklo_epi8 (yuyv, _mm256_setzero_si256 ()));
+    __m256i hi = yuv_to_8888_8 (
+	k, _mm256_unpackhi_epi8 (yuyv, _mm256_setzero_si256 ()));
+
+    save_256_unaligned ((__m256i *)buffer, _mm256_permute2x128_si256 (lo, hi, 0x20));
+    save_256_unaligned ((__m256i *)(buffer + 8), _mm256_permute2x128_si256 (lo, hi, 0x31));
+}
+
+static void
+avx2_convert_yuv (bits_image_t *image, int x, int y, int width, uint32_t *buffer)
+{
+    const uint8_t *yuyv = NULL, *y_line = NULL, *u_line = NULL, *v_line = NULL;
+    int step = YUV_CHROMA_STEP (image);
+    yuv_constants_t k;
+
+    yuv_constants_init (&k, YUV_COEFFICIENTS (image));
+
+    if (image->format == PIXMAN_yuy2)
+    {
+	yuyv = (const uint8_t *)(image->bits + image->rowstride * y);
+    }
+    else
+    {
+	y_line = YUV_Y_LINE (image, y);
+	u_line = YUV_U_LINE (image, y);
+	v_line = YUV_V_LINE (image, y);
+    }
+
+    while (width > 0)
+    {
+	int start = x & 1;
+	int p = x - start;
+	int n = MIN (16 - start, width);
+
+	if (n == 16)
+	{
+	    __m256i v;
+
+	    if (yuyv)
+	    {
+		v = load_256_unaligned ((const __m256i *)(yuyv + 2 * p));
+	    }
+	    else
+	    {
+		__m128i y16 = _mm_loadu_si128 ((const __m128i *)(y_line + p));
+		__m128i uv;
+
+		if (step == 2)
+		{
+		    uv = _mm_loadu_si128 ((const __m128i *)(u_line + p));
+		}
+		else
+		{
+		    uv = _mm_unpacklo_epi8 (
+			_mm_loadl_epi64 ((const __m128i *)(u_line + p / 2)),
+			_mm_loadl_epi64 ((const __m128i *)(v_line + p / 2)));
+		}
+
+		v = create_2x128_256 (_mm_unpacklo_epi8 (y16, uv),
+				      _mm_unpackhi_epi8 (y16, uv));
+	    }
+
+	    yuyv_to_8888_16 (&k, v, buffer);
+	}
+	else
+	{
+	    uint8_t tmp[32] = { 0 };
+	    uint32_t out[16];
+	    int i;
+
+	    if (yuyv)
+	    {
+		memcpy (tmp, yuyv + 2 * p, 2 * ((start + n + 1) & ~1));
+	    }
+	    else
+	    {
+		for (i = 0; i < start + n; ++i)
+		{
+		    tmp[2 * i] = y_line[p + i];
+		    tmp[2 * i + 1] = (i & 1) ?
+			v_line[((p + i) >> 1) * step] : u_line[((p + i) >> 1) * step];
+		}
+		if (i & 1)
+		    tmp[2 * i + 1] = v_line[((p + i) >> 1) * step];
+	    }
+
+	    yuyv_to_8888_16 (&k, load_256_unaligned ((__m256i *)tmp), out);
+	    memcpy (buffer, out + start, n * sizeof (uint32_t));
+	}
+
+	buffer += n;
+	x += n;
+	width -= n;
+    }
+}
+
+/* RGB to YUV as in yuv_store_8() of pixman-sse2.c */
+typedef struct
+{
+    __m256i y_rb, y_g1, y_offset;
+    __m256i u_rb, u_g1;
+    __m256i v_rb, v_g1;
+} yuv_store_constants_t;
+
+static force_inline void
+yuv_store_constants_init (yuv_store_constants_t *k,
+			  const pixman_yuv_coefficients_t *c)
+{
+    k->y_rb = _mm256_set1_epi32 ((c->yb & 0xffff) | (uint32_t)c->yr << 16);
+    k->y_g1 = _mm256_set1_epi32 ((c->yg & 0xffff) | (1 << 14) << 16);
+    k->y_offset = _mm256_set1_epi16 (c->y_offset);
+    k->u_rb = _mm256_set1_epi32 ((c->ub & 0xffff) | (uint32_t)c->ur << 16);
+    k->u_g1 = _mm256_set1_epi32 ((c->ug & 0xffff) | (1 << 14) << 16);
+    k->v_rb = _mm256_set1_epi32 ((c->vb & 0xffff) | (uint32_t)c->vr << 16);
+    k->v_g1 = _mm256_set1_epi32 ((c->vg & 0xffff) | (1 << 14) << 16);
+}
+
+static force_inline __m256i
+yuv_from_8888_8 (__m256i rb, __m256i g1, __m256i c_rb, __m256i c_g1)
+{
+    return _mm256_srai_epi32 (
+	_mm256_add_epi32 (_mm256_madd_epi16 (rb, c_rb),
+			  _mm256_madd_epi16 (g1, c_g1)), 15);
+}
+
+/* The packs work within lanes, so the 16-bit results are put back in
+ * order before the pairs are summed.
+ */
+static force_inline void
+yuv_store_16 (const yuv_store_constants_t *k,
+	      const uint32_t *pixels, uint8_t *luma, uint16_t *chroma)
+{
+    __m256i mask = _mm256_set1_epi32 (0x00ff00ff);
+    __m256i one = _mm256_set1_epi32 (0x10000);
+    __m256i p0 = load_256_unaligned ((const __m256i *)pixels);
+    __m256i p1 = load_256_unaligned ((const __m256i *)(pixels + 8));
+    __m256i rb0 = _mm256_and_si256 (p0, mask);
+    __m256i rb1 = _mm256_and_si256 (p1, mask);
+    __m256i g0 = _mm256_or_si256 (
+	_mm256_and_si256 (_mm256_srli_epi32 (p0, 8), _mm256_set1_epi32 (0xff)), one);
+    __m256i g1 = _mm256_or_si256 (
+	_mm256_and_si256 (_mm256_srli_epi32 (p1, 8), _mm256_set1_epi32 (0xff)), one);
+    __m256i y, u, v;
+
+    y = _mm256_packs_epi32 (yuv_from_8888_8 (rb0, g0, k->y_rb, k->y_g1),
+			    yuv_from_8888_8 (rb1, g1, k->y_rb, k->y_g1));
+    y = _mm256_add_epi16 (_mm256_permute4x64_epi64 (y, 0xd8), k->y_offset);
+    _mm_storeu_si128 ((__m128i *)luma,
+		      _mm_packus_epi16 (_mm256_castsi256_si128 (y),
+					_mm256_extracti128_si256 (y, 1)));
+
+    u = _mm256_packs_epi32 (yuv_from_8888_8 (rb0, g0, k->u_rb, k->u_g1),
+			    yuv_from_8888_8 (rb1, g1, k->u_rb, k->u_g1));
+    v = _mm256_packs_epi32 (yuv_from_8888_8 (rb0, g0, k->v_rb, k->v_g1),
+			    yuv_from_8888_8 (rb1, g1, k->v_rb, k->v_g1));
+    u = _mm256_add_epi16 (_mm256_permute4x64_epi64 (u, 0xd8),
+			  _mm256_set1_epi16 (128));
+    v = _mm256_add_epi16 (_mm256_permute4x64_epi64 (v, 0xd8),
+			  _mm256_set1_epi16 (128));
+    u = _mm256_max_epi16 (_mm256_min_epi16 (u, _mm256_set1_epi16 (255)),
+			  _mm256_setzero_si256 ());
+    v = _mm256_max_epi16 (_mm256_min_epi16 (v, _mm256_set1_epi16 (255)),
+			  _mm256_setzero_si256 ());
+
+    /* Sums of pairs, interleaved as U V U V */
+    u = _mm256_madd_epi16 (u, _mm256_set1_epi16 (1));
+    v = _mm256_madd_epi16 (v, _mm256_set1_epi16 (1));
+    u = _mm256_packs_epi32 (_mm256_unpacklo_epi32 (u, v),
+			    _mm256_unpackhi_epi32 (u, v));
+
+    save_256_unaligned (
+	(__m256i *)chroma,
+	_mm256_add_epi16 (load_256_unaligned ((__m256i *)chroma), u));
+}
+
+static void
+avx2_store_yuv (bits_image_t   *image,
+		const uint32_t *pixels,
+		int             width,
+		uint8_t        *luma,
+		uint16_t       *chroma)
+{
+    yuv_store_constants_t k;
+
+    yuv_store_constants_init (&k, YUV_COEFFICIENTS (image));
+
+    while (width >= 16)
+    {
+	yuv_store_16 (&k, pixels, luma, chroma);
+
+	pixels += 16;
+	luma += 16;
+	chroma += 16;
+	width -= 16;
+    }
+
+    if (width)
+    {
+	uint32_t tmp[16] = { 0 };
+	uint8_t tmp_luma[16];
+	uint16_t tmp_chroma[16] = { 0 };
+	int i;
+
+	memcpy (tmp, pixels, width * sizeof (uint32_t));
+	yuv_store_16 (&k, tmp, tmp_luma, tmp_chroma);
+
+	memcpy (luma, tmp_luma, width);
+	for (i = 0; i < width; ++i)
+	    chroma[i] += tmp_chroma[i];
+    }
+}
+
+static void
+avx2_composite_src_yuv_8888 (pixman_implementation_t *imp,
+			     pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t *dst_line;
+    int dst_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	avx2_convert_yuv (&src_image->bits, src_x, src_y++, width, dst_line);
+	dst_line += dst_stride;
+    }
+}
+
+static const pixman_fast_path_t avx2_fast_paths[] =
+{
+    /* PIXMAN_OP_OVER */
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, a8r8g8b8, avx2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, x8r8g8b8, avx2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, a8b8g8r8, avx2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, x8b8g8r8, avx2_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8r8g8b8, avx2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8r8g8b8, avx2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8b8g8r8, avx2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8b8g8r8, avx2_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, null, x8r8g8b8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, null, x8b8g8r8, avx2_composite_copy_area),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8r8g8b8, r5g6b5, avx2_composite_over_8888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8b8g8r8, b5g6r5, avx2_composite_over_8888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8r8g8b8, x1r5g5b5, avx2_composite_over_8888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8b8g8r8, x1b5g5r5, avx2_composite_over_8888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8r8g8b8, x4r4g4b4, avx2_composite_over_8888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8b8g8r8, x4b4g4r4, avx2_composite_over_8888_0444_dither),
+    PIXMAN_SRGB_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8_sRGB, avx2_composite_over_8888_srgb),
+    PIXMAN_SRGB_FAST_PATH (OVER, x8r8g8b8, a8r8g8b8_sRGB, avx2_composite_src_x888_srgb),
+    PIXMAN_SRGB_FAST_PATH (OVER, a8r8g8b8_sRGB, a8r8g8b8_sRGB, avx2_composite_over_srgb_srgb),
+    PIXMAN_SRGB_FAST_PATH (OVER, a8r8g8b8_sRGB, a8r8g8b8, avx2_composite_over_srgb_8888),
+    PIXMAN_SRGB_FAST_PATH (OVER, a8r8g8b8_sRGB, x8r8g8b8, avx2_composite_over_srgb_8888),
+
+    /* PIXMAN_OP_ADD */
+    PIXMAN_STD_FAST_PATH (ADD, a8, null, a8, avx2_composite_add_8_8),
+    PIXMAN_STD_FAST_PATH (ADD, a8r8g8b8, null, a8r8g8b8, avx2_composite_add_8888_8888),
+    PIXMAN_STD_FAST_PATH (ADD, a8b8g8r8, null, a8b8g8r8, avx2_composite_add_8888_8888),
+
+    /* PIXMAN_OP_SRC */
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, a8r8g8b8, avx2_composite_src_x888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, a8b8g8r8, avx2_composite_src_x888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, a8r8g8b8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, a8b8g8r8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, x8r8g8b8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, x8b8g8r8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, x8r8g8b8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, x8b8g8r8, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, r5g6b5, null, r5g6b5, avx2_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, b5g6r5, null, b5g6r5, avx2_composite_copy_area),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, r5g6b5, avx2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, r5g6b5, avx2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, b5g6r5, avx2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, b5g6r5, avx2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, x1r5g5b5, avx2_composite_src_x888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, x1r5g5b5, avx2_composite_src_x888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, x1b5g5r5, avx2_composite_src_x888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, x1b5g5r5, avx2_composite_src_x888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, x4r4g4b4, avx2_composite_src_x888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, x4r4g4b4, avx2_composite_src_x888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, x4b4g4r4, avx2_composite_src_x888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, x4b4g4r4, avx2_composite_src_x888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, x2r10g10b10, avx2_composite_src_x888_2101010_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, x2r10g10b10, avx2_composite_src_x888_2101010_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, x2b10g10r10, avx2_composite_src_x888_2101010_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, x2b10g10r10, avx2_composite_src_x888_2101010_dither),
+    PIXMAN_SRGB_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8_sRGB, avx2_composite_src_8888_srgb),
+    PIXMAN_SRGB_FAST_PATH (SRC, x8r8g8b8, a8r8g8b8_sRGB, avx2_composite_src_x888_srgb),
+    PIXMAN_SRGB_FAST_PATH (SRC, a8r8g8b8_sRGB, a8r8g8b8, avx2_composite_src_srgb_8888),
+    PIXMAN_SRGB_FAST_PATH (SRC, a8r8g8b8_sRGB, x8r8g8b8, avx2_composite_src_srgb_8888),
+    PIXMAN_SRGB_FAST_PATH (SRC, a8r8g8b8_sRGB, a8r8g8b8_sRGB, avx2_composite_copy_area),
+
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, avx2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, avx2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, avx2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, avx2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, avx2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, avx2_8888),
+
+    SIMPLE_FLIP_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, avx2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, avx2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, avx2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, avx2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, avx2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, avx2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, r5g6b5, r5g6b5, avx2_565),
+    SIMPLE_FLIP_FAST_PATH (SRC, b5g6r5, b5g6r5, avx2_565),
+    PIXMAN_STD_FAST_PATH (SRC, yuy2, null, a8r8g8b8, avx2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, yuy2, null, x8r8g8b8, avx2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, yv12, null, a8r8g8b8, avx2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, yv12, null, x8r8g8b8, avx2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, nv12, null, a8r8g8b8, avx2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, nv12, null, x8r8g8b8, avx2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, i420, null, a8r8g8b8, avx2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, i420, null, x8r8g8b8, avx2_composite_src_yuv_8888),
+
+    SIMPLE_NEAREST_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, avx2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, avx2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, avx2_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, avx2_8888_8888),
+
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, avx2_8888_8888),
+
+    SIMPLE_BILINEAR_FAST_PATH_COVER  (SRC, x8r8g8b8, a8r8g8b8, avx2_x888_8888),
+    SIMPLE_BILINEAR_FAST_PATH_COVER  (SRC, x8b8g8r8, a8b8g8r8, avx2_x888_8888),
+    SIMPLE_BILINEAR_FAST_PATH_PAD    (SRC, x8r8g8b8, a8r8g8b8, avx2_x888_8888),
+    SIMPLE_BILINEAR_FAST_PATH_PAD    (SRC, x8b8g8r8, a8b8g8r8, avx2_x888_8888),
+    SIMPLE_BILINEAR_FAST_PATH_NORMAL (SRC, x8r8g8b8, a8r8g8b8, avx2_x888_8888),
+    SIMPLE_BILINEAR_FAST_PATH_NORMAL (SRC, x8b8g8r8, a8b8g8r8, avx2_x888_8888),
+
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, avx2_8888_8888),
+    SIMPLE_BILINEAR_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, avx2_8888_8888),
+
+    { PIXMAN_OP_NONE },
+};
+
+/* Filters two destination pixels at a time, one in each 128 bit lane */
+static void
+avx2_convolve_row (int32_t         *dest,
+		   const uint32_t  *src,
+		   const int32_t   *offsets,
+		   const int16_t  **weights,
+		   int              n_taps,
+		   int              width)
+{
+    __m256i zero = _mm256_setzero_si256 ();
+    int i, k;
+
+    for (k = 0; k < width; k += 2)
+    {
+	int k1 = k + 1 < width ? k + 1 : k;
+	const uint32_t *s0 = src + offsets[k];
+	const uint32_t *s1 = src + offsets[k1];
+	const int16_t *w0 = weights[k];
+	const int16_t *w1 = weights[k1];
+	__m256i hi = zero;
+	__m256i lo = zero;
+	__m256i sum;
+
+	for (i = 0; i < n_taps; i += 2)
+	{
+	    /* Interleave the channels of two pixels, so that one multiply-add
+	     * applies both of their weights
+	     */
+	    __m256i p = _mm256_inserti128_si256 (
+		_mm256_castsi128_si256 (
+		    _mm_loadl_epi64 ((const __m128i *)(s0 + i))),
+		_mm_loadl_epi64 ((const __m128i *)(s1 + i)), 1);
+	    __m256i f = _mm256_inserti128_si256 (
+		_mm256_castsi128_si256 (
+		    _mm_loadl_epi64 ((const __m128i *)(w0 + 2 * i))),
+		_mm_loadl_epi64 ((const __m128i *)(w1 + 2 * i)), 1);
+
+	    p = _mm256_unpacklo_epi8 (p, zero);
+	    p = _mm256_unpacklo_epi16 (p, _mm256_srli_si256 (p, 8));
+	    hi = _mm256_add_epi32 (
+		hi, _mm256_madd_epi16 (p, _mm256_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0))));
+	    lo = _mm256_add_epi32 (
+		lo, _mm256_madd_epi16 (p, _mm256_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1))));
+	}
+
+	sum = _mm256_add_epi32 (_mm256_slli_epi32 (hi, 8), lo);
+
+	if (k1 != k)
+	    _mm256_store_si256 ((__m256i *)(dest + 4 * k), sum);
+	else
+	    _mm_store_si128 ((__m128i *)(dest + 4 * k), _mm256_castsi256_si128 (sum));
+    }
+}
+
+/* Rows times y weights are summed exactly in 64 bits, the even channels
+ * of two pixels in one register and the odd ones in another. The sums
+ * start at one half, so that their high halves are rounded like
+ * separable_convolution_reduce(). Rows are padded to a multiple of four
+ * pixels, so a last odd pixel is loaded with the one after it, which is
+ * then not stored.
+ */
+static void
+avx2_convolve_column (uint32_t              *dest,
+		      const int32_t        **rows,
+		      const pixman_fixed_t  *weights,
+		      int                    n_rows,
+		      int                    width)
+{
+    __m256i round = _mm256_set1_epi64x ((int64_t)1 << 31);
+    int i, k;
+
+    for (k = 0; k < width; k += 2)
+    {
+	__m256i even = round;
+	__m256i odd = round;
+	__m256i sum;
+	__m128i d;
+
+	for (i = 0; i < n_rows; ++i)
+	{
+	    __m256i r = _mm256_load_si256 ((const __m256i *)(rows[i] + 4 * k));
+	    __m256i w = _mm256_set1_epi64x (weights[i]);
+
+	    even = _mm256_add_epi64 (even, _mm256_mul_epi32 (r, w));
+	    odd = _mm256_add_epi64 (
+		odd, _mm256_mul_epi32 (_mm256_srli_epi64 (r, 32), w));
+	}
+
+	sum = _mm256_blend_epi32 (_mm256_srli_epi64 (even, 32), odd, 0xaa);
+	d = _mm_packs_epi32 (_mm256_castsi256_si128 (sum),
+			     _mm256_extracti128_si256 (sum, 1));
+	d = _mm_packus_epi16 (d, d);
+
+	if (k + 1 < width)
+	    _mm_storel_epi64 ((__m128i *)(dest + k), d);
+	else
+	    dest[k] = _mm_cvtsi128_si32 (d);
+    }
+}
+
+static void
+avx2_separable_convolution_iter_init (pixman_iter_t *iter,
+				      const pixman_iter_info_t *iter_info)
+{
+    _pixman_separable_convolution_iter_init (
+	iter, avx2_convolve_row, avx2_convolve_column);
+}
+
+/* Gradient kernels. Positions are computed in double precision, like
+ * in pixman-linear-gradient.c and pixman-radial-gradient.c, four pixels
+ * at a time.
+ */
+
+/* Truncates four positions to integers, as the gradient walker takes
+ * them, and reduces them as described in pixman-private.h
+ */
+static force_inline __m128i
+avx2_gradient_fold (__m256d x, pixman_repeat_t repeat)
+{
+    if (repeat == PIXMAN_REPEAT_NORMAL || repeat == PIXMAN_REPEAT_REFLECT)
+    {
+	__m256d n;
+
+	x = _mm256_round_pd (x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+	n = _mm256_floor_pd (
+	    _mm256_mul_pd (x, _mm256_set1_pd (1. / (2 * pixman_fixed_1))));
+
+	return _mm256_cvttpd_epi32 (
+	    _mm256_sub_pd (x, _mm256_mul_pd (n, _mm256_set1_pd (2. * pixman_fixed_1))));
+    }
+
+    x = _mm256_max_pd (x, _mm256_set1_pd (-1.));
+    x = _mm256_min_pd (x, _mm256_set1_pd (pixman_fixed_1 + 1.));
+
+    return _mm256_cvttpd_epi32 (x);
+}
+
+static force_inline void
+avx2_gradient_store_positions (int32_t *positions, __m128i p, int n)
+{
+    if (n == 4)
+    {
+	_mm_storeu_si128 ((__m128i *)positions, p);
+    }
+    else
+    {
+	_mm_maskstore_epi32 (
+	    positions, _mm_cmpgt_epi32 (_mm_set1_epi32 (n),
+					_mm_setr_epi32 (0, 1, 2, 3)), p);
+    }
+}
+
+static void
+avx2_gradient_linear (int32_t         *positions,
+		      double           t,
+		      double           inc,
+		      pixman_repeat_t  repeat,
+		      int              width)
+{
+    __m256d vt = _mm256_set1_pd (t);
+    __m256d vinc = _mm256_set1_pd (inc);
+    __m256d vi = _mm256_setr_pd (0., 1., 2., 3.);
+    __m256d four = _mm256_set1_pd (4.);
+    int i;
+
+    for (i = 0; i < width; i += 4)
+    {
+	/* As in linear_get_scanline(), the increment is truncated */
+	__m256d d = _mm256_round_pd (_mm256_mul_pd (vinc, vi),
+				     _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+
+	avx2_gradient_store_positions (
+	    positions + i, avx2_gradient_fold (_mm256_add_pd (vt, d), repeat),
+	    MIN (width - i, 4));
+
+	vi = _mm256_add_pd (vi, four);
+    }
+}
+
+static void
+avx2_gradient_radial (int32_t                 *positions,
+		      const radial_gradient_t *radial,
+		      pixman_repeat_t          repeat,
+		      radial_step_t           *step,
+		      int                      width)
+{
+    __m256d a = _mm256_set1_pd (radial->a);
+    __m256d inva = _mm256_set1_pd (radial->inva);
+    __m256d dr = _mm256_set1_pd (radial->delta.radius);
+    __m256d mindr = _mm256_set1_pd (radial->mindr);
+    __m256d zero = _mm256_setzero_pd ();
+    __m256d one = _mm256_set1_pd (pixman_fixed_1);
+    __m128i clear = _mm_set1_epi32 (PIXMAN_GRADIENT_CLEAR);
+    pixman_fixed_32_32_t sb = step->b, sc = step->c, sdc = step->dc;
+    pixman_fixed_32_32_t bs[4], cs[4];
+    int i, j;
+
+    for (i = 0; i < width; i += 4)
+    {
+	__m256d b, c, t, valid;
+	__m128i p, v;
+
+	/* B and C are stepped exactly, as in radial_get_scanline() */
+	for (j = 0; j < 4; ++j)
+	{
+	    bs[j] = sb;
+	    cs[j] = sc;
+
+	    sb += step->db;
+	    sc += sdc;
+	    sdc += step->ddc;
+	}
+
+	b = _mm256_setr_pd (bs[0], bs[1], bs[2], bs[3]);
+	c = _mm256_setr_pd (cs[0], cs[1], cs[2], cs[3]);
+
+	if (radial->a == 0)
+	{
+	    __m256d b_is_zero = _mm256_cmp_pd (b, zero, _CMP_EQ_OQ);
+
+	    t = _mm256_div_pd (
+		_mm256_mul_pd (_mm256_set1_pd (pixman_fixed_1 / 2), c),
+		_mm256_blendv_pd (b, one, b_is_zero));
+
+	    if (repeat == PIXMAN_REPEAT_NONE)
+	    {
+		valid = _mm256_and_pd (_mm256_cmp_pd (t, zero, _CMP_GE_OQ),
+				       _mm256_cmp_pd (t, one, _CMP_LE_OQ));
+	    }
+	    else
+	    {
+		valid = _mm256_cmp_pd (_mm256_mul_pd (t, dr), mindr, _CMP_GE_OQ);
+	    }
+
+	    valid = _mm256_andnot_pd (b_is_zero, valid);
+	}
+	else
+	{
+	    __m256d discr, sqrtdiscr, t0, t1, valid0, valid1;
+
+	    discr = _mm256_sub_pd (_mm256_mul_pd (b, b), _mm256_mul_pd (a, c));
+	    sqrtdiscr = _mm256_sqrt_pd (_mm256_max_pd (discr, zero));
+
+	    t0 = _mm256_mul_pd (_mm256_add_pd (b, sqrtdiscr), inva);
+	    t1 = _mm256_mul_pd (_mm256_sub_pd (b, sqrtdiscr), inva);
+
+	    if (repeat == PIXMAN_REPEAT_NONE)
+	    {
+		valid0 = _mm256_and_pd (_mm256_cmp_pd (t0, zero, _CMP_GE_OQ),
+					_mm256_cmp_pd (t0, one, _CMP_LE_OQ));
+		valid1 = _mm256_and_pd (_mm256_cmp_pd (t1, zero, _CMP_GE_OQ),
+					_mm256_cmp_pd (t1, one, _CMP_LE_OQ));
+	    }
+	    else
+	    {
+		valid0 = _mm256_cmp_pd (_mm256_mul_pd (t0, dr), mindr, _CMP_GE_OQ);
+		valid1 = _mm256_cmp_pd (_mm256_mul_pd (t1, dr), mindr, _CMP_GE_OQ);
+	    }
+
+	    /* The bigger root wins when both are valid */
+	    t = _mm256_blendv_pd (t1, t0, valid0);
+	    valid = _mm256_and_pd (_mm256_cmp_pd (discr, zero, _CMP_GE_OQ),
+				   _mm256_or_pd (valid0, valid1));
+	}
+
+	p = avx2_gradient_fold (t, repeat);
+
+	/* Shrink the 64-bit lane masks to 32 bits, like the positions */
+	v = _mm256_castsi256_si128 (_mm256_permutevar8x32_epi32 (
+	    _mm256_castpd_si256 (valid), _mm256_setr_epi32 (0, 2, 4, 6, 0, 0, 0, 0)));
+	p = _mm_blendv_epi8 (clear, p, v);
+
+	avx2_gradient_store_positions (positions + i, p, MIN (width - i, 4));
+    }
+
+    step->b = sb;
+    step->c = sc;
+    step->dc = sdc;
+}
+
+/* Polynomial approximation of atan2() for eight pixels, good to about
+ * 2e-6 radians, which is way below a level of an 8-bit ramp. It returns
+ * the positions in the conical gradient, as conical_get_scanline() does.
+ */
+static force_inline __m256i
+avx2_conical_positions (__m256 x, __m256 y, __m256 angle)
+{
+    const __m256 sign = _mm256_set1_ps (-0.f);
+    __m256 ax = _mm256_andnot_ps (sign, x);
+    __m256 ay = _mm256_andnot_ps (sign, y);
+    __m256 z, z2, r, u;
+
+    z = _mm256_div_ps (_mm256_min_ps (ax, ay),
+		       _mm256_max_ps (_mm256_max_ps (ax, ay),
+				      _mm256_set1_ps (FLT_MIN)));
+    z2 = _mm256_mul_ps (z, z);
+
+    r = _mm256_set1_ps (-0.01172120f);
+    r = _mm256_add_ps (_mm256_mul_ps (r, z2), _mm256_set1_ps (0.05265332f));
+    r = _mm256_add_ps (_mm256_mul_ps (r, z2), _mm256_set1_ps (-0.11643287f));
+    r = _mm256_add_ps (_mm256_mul_ps (r, z2), _mm256_set1_ps (0.19354346f));
+    r = _mm256_add_ps (_mm256_mul_ps (r, z2), _mm256_set1_ps (-0.33262347f));
+    r = _mm256_add_ps (_mm256_mul_ps (r, z2), _mm256_set1_ps (0.99997726f));
+    r = _mm256_mul_ps (r, z);
+
+    /* Back from the first octant to the whole circle */
+    r = _mm256_blendv_ps (r, _mm256_sub_ps (_mm256_set1_ps (M_PI / 2), r),
+			  _mm256_cmp_ps (ay, ax, _CMP_GT_OQ));
+    r = _mm256_xor_ps (r, _mm256_and_ps (sign, x));
+    r = _mm256_add_ps (
+	r, _mm256_and_ps (_mm256_cmp_ps (x, _mm256_setzero_ps (), _CMP_LT_OQ),
+			  _mm256_set1_ps (M_PI)));
+    r = _mm256_xor_ps (r, _mm256_and_ps (sign, y));
+
+    /* Scale to turns in [0, 1), counterclockwise */
+    u = _mm256_mul_ps (_mm256_add_ps (r, angle),
+		       _mm256_set1_ps (1 / (2 * M_PI)));
+    u = _mm256_sub_ps (_mm256_set1_ps (1.f),
+		       _mm256_sub_ps (u, _mm256_floor_ps (u)));
+
+    return _mm256_cvttps_epi32 (
+	_mm256_mul_ps (u, _mm256_set1_ps (pixman_fixed_1)));
+}
+
+static void
+avx2_gradient_conical (int32_t *positions,
+		       double   x,
+		       double   y,
+		       double   dx,
+		       double   dy,
+		       double   angle,
+		       int      width)
+{
+    __m256d vx = _mm256_set1_pd (x);
+    __m256d vy = _mm256_set1_pd (y);
+    __m256d vdx = _mm256_set1_pd (dx);
+    __m256d vdy = _mm256_set1_pd (dy);
+    __m256d vi = _mm256_setr_pd (0., 1., 2., 3.);
+    __m256d four = _mm256_set1_pd (4.);
+    __m256 vangle = _mm256_set1_ps (angle);
+    int i;
+
+    for (i = 0; i < width; i += 8)
+    {
+	__m256d vj = _mm256_add_pd (vi, four);
+	__m256 fx, fy;
+	__m256i p;
+
+	fx = _mm256_insertf128_ps (
+	    _mm256_castps128_ps256 (
+		_mm256_cvtpd_ps (_mm256_add_pd (vx, _mm256_mul_pd (vdx, vi)))),
+	    _mm256_cvtpd_ps (_mm256_add_pd (vx, _mm256_mul_pd (vdx, vj))), 1);
+	fy = _mm256_insertf128_ps (
+	    _mm256_castps128_ps256 (
+		_mm256_cvtpd_ps (_mm256_add_pd (vy, _mm256_mul_pd (vdy, vi)))),
+	    _mm256_cvtpd_ps (_mm256_add_pd (vy, _mm256_mul_pd (vdy, vj))), 1);
+
+	p = avx2_conical_positions (fx, fy, vangle);
+
+	if (i + 8 <= width)
+	{
+	    _mm256_storeu_si256 ((__m256i *)(positions + i), p);
+	}
+	else
+	{
+	    _mm256_maskstore_epi32 (
+		positions + i,
+		_mm256_cmpgt_epi32 (_mm256_set1_epi32 (width - i),
+				    mask_tail_index), p);
+	}
+
+	vi = _mm256_add_pd (vj, four);
+    }
+}
+
+/* Returns the ramp entries of eight positions, with the lanes that are
+ * transparent cleared in *valid
+ */
+static force_inline __m256i
+avx2_gradient_index (pixman_gradient_walker_t *walker,
+		     __m256i                   p,
+		     __m256i                  *valid)
+{
+    __m128i shift = _mm_cvtsi32_si128 (walker->lut_shift);
+    __m256i low = _mm256_set1_epi32 (0xffff);
+    __m256i m;
+
+    *valid = _mm256_xor_si256 (
+	_mm256_cmpeq_epi32 (p, _mm256_set1_epi32 (PIXMAN_GRADIENT_CLEAR)),
+	_mm256_set1_epi32 (-1));
+
+    switch (walker->repeat)
+    {
+    case PIXMAN_REPEAT_NORMAL:
+	break;
+
+    case PIXMAN_REPEAT_REFLECT:
+	m = _mm256_srai_epi32 (_mm256_slli_epi32 (p, 15), 31);
+	p = _mm256_xor_si256 (p, m);
+	break;
+
+    case PIXMAN_REPEAT_PAD:
+	p = _mm256_min_epi32 (_mm256_max_epi32 (p, _mm256_setzero_si256 ()), low);
+	break;
+
+    default:
+    case PIXMAN_REPEAT_NONE:
+	*valid = _mm256_andnot_si256 (
+	    _mm256_cmpgt_epi32 (_mm256_set1_epi32 (walker->stops[0].x), p),
+	    _mm256_cmpgt_epi32 (
+		_mm256_set1_epi32 (walker->stops[walker->num_stops - 1].x), p));
+	break;
+    }
+
+    return _mm256_srl_epi32 (_mm256_and_si256 (p, low), shift);
+}
+
+static void
+avx2_gradient_write_narrow (pixman_gradient_walker_t *walker,
+			    uint32_t                 *buffer,
+			    const int32_t            *positions,
+			    int                       width)
+{
+    const int *lut = (const int *)walker->lut;
+    int i, n;
+
+    for (i = 0; i < width; i += 8)
+    {
+	__m256i p, valid, index, c;
+
+	n = MIN (width - i, 8);
+
+	if (n == 8)
+	{
+	    p = _mm256_loadu_si256 ((const __m256i *)(positions + i));
+	}
+	else
+	{
+	    __m256i tail = _mm256_cmpgt_epi32 (_mm256_set1_epi32 (n),
+					       mask_tail_index);
+
+	    p = _mm256_blendv_epi8 (
+		_mm256_set1_epi32 (PIXMAN_GRADIENT_CLEAR),
+		_mm256_maskload_epi32 (positions + i, tail), tail);
+	}
+
+	index = avx2_gradient_index (walker, p, &valid);
+	c = _mm256_mask_i32gather_epi32 (
+	    _mm256_setzero_si256 (), lut, index, valid, 4);
+
+	if (n == 8)
+	{
+	    _mm256_storeu_si256 ((__m256i *)(buffer + i), c);
+	}
+	else
+	{
+	    _mm256_maskstore_epi32 (
+		(int *)(buffer + i),
+		_mm256_cmpgt_epi32 (_mm256_set1_epi32 (n), mask_tail_index), c);
+	}
+    }
+}
+
+/* Evaluates the gradient walker for two pixels per iteration, with the
+ * four channels of each in one half of the register. Pixels in another
+ * segment of the ramp than their neighbour are done one at a time.
+ */
+static void
+avx2_gradient_write_wide (pixman_gradient_walker_t *walker,
+			  uint32_t                 *buffer,
+			  const int32_t            *positions,
+			  int                       width)
+{
+    float *dest = (float *)buffer;
+    __m256 one = _mm256_setr_ps (1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f);
+    __m256 scale = _mm256_set1_ps (1.0f / 65536.0f);
+    __m256 s = _mm256_setzero_ps ();
+    __m256 b = _mm256_setzero_ps ();
+    int i = 0;
+
+    while (i < width)
+    {
+	int32_t x0 = positions[i];
+	int32_t x1 = i + 1 < width ? positions[i + 1] : x0;
+	__m256 x, f, a;
+	int n;
+
+	if (x0 == PIXMAN_GRADIENT_CLEAR)
+	{
+	    _mm_storeu_ps (dest + 4 * i, _mm_setzero_ps ());
+	    i++;
+	    continue;
+	}
+
+	if (walker->need_reset || x0 < walker->left_x || x0 >= walker->right_x)
+	{
+	    _pixman_gradient_walker_reset (walker, x0);
+
+	    s = _mm256_setr_ps (walker->a_s, walker->r_s, walker->g_s, walker->b_s,
+				walker->a_s, walker->r_s, walker->g_s, walker->b_s);
+	    b = _mm256_setr_ps (walker->a_b, walker->r_b, walker->g_b, walker->b_b,
+				walker->a_b, walker->r_b, walker->g_b, walker->b_b);
+	}
+
+	if (i + 1 < width && x1 != PIXMAN_GRADIENT_CLEAR &&
+	    x1 >= walker->left_x && x1 < walker->right_x)
+	{
+	    n = 2;
+	}
+	else
+	{
+	    n = 1;
+	    x1 = x0;
+	}
+
+	x = _mm256_mul_ps (
+	    _mm256_cvtepi32_ps (_mm256_setr_epi32 (x0, x0, x0, x0,
+						   x1, x1, x1, x1)), scale);
+	f = _mm256_add_ps (_mm256_mul_ps (s, x), b);
+
+	/* Premultiply, with 1 for the alpha channel itself */
+	a = _mm256_blend_ps (_mm256_permute_ps (f, 0), one, 0x11);
+	f = _mm256_mul_ps (f, a);
+
+	if (n == 2)
+	    _mm256_storeu_ps (dest + 4 * i, f);
+	else
+	    _mm_storeu_ps (dest + 4 * i, _mm256_castps256_ps128 (f));
+
+	i += n;
+    }
+}
+
+static const pixman_gradient_kernels_t avx2_gradient_kernels =
+{
+    avx2_gradient_linear,
+    avx2_gradient_radial,
+    avx2_gradient_conical,
+    avx2_gradient_write_narrow,
+    avx2_gradient_write_wide,
+};
+
+static void
+avx2_gradient_iter_init (pixman_iter_t *iter,
+			 const pixman_iter_info_t *iter_info)
+{
+    _pixman_gradient_iter_init (iter, &avx2_gradient_kernels);
+}
+
+static void
+avx2_yuv_bilinear (uint32_t       *buffer,
+		   const uint32_t *top,
+		   const uint32_t *bottom,
+		   int             width,
+		   int             wt,
+		   int             wb,
+		   pixman_fixed_t  vx,
+		   pixman_fixed_t  unit_x)
+{
+    scaled_bilinear_scanline_avx2_8888_8888_SRC (
+	buffer, NULL, top, bottom, width, wt, wb, vx, unit_x, 0, FALSE);
+}
+
+static const pixman_yuv_kernels_t avx2_yuv_kernels =
+{
+    avx2_convert_yuv,
+    avx2_yuv_bilinear,
+    avx2_store_yuv,
+};
+
+static void
+avx2_yuv_iter_init (pixman_iter_t *iter,
+		    const pixman_iter_info_t *iter_info)
+{
+    _pixman_yuv_iter_init (iter, iter_info, &avx2_yuv_kernels);
+}
+
+static void
+avx2_yuv_dest_iter_init (pixman_iter_t *iter,
+			 const pixman_iter_info_t *iter_info)
+{
+    _pixman_yuv_dest_iter_init (iter, &avx2_yuv_kernels);
+}
+
+#define IMAGE_FLAGS							\
+    (FAST_PATH_STANDARD_FLAGS | FAST_PATH_ID_TRANSFORM |		\
+     FAST_PATH_BITS_IMAGE | FAST_PATH_SAMPLES_COVER_CLIP_NEAREST)
+
+#define YUV_NEAREST_FLAGS						\
+    (FAST_PATH_STANDARD_FLAGS | FAST_PATH_SCALE_TRANSFORM |		\
+     FAST_PATH_NEAREST_FILTER | FAST_PATH_X_UNIT_POSITIVE |		\
+     FAST_PATH_SAMPLES_COVER_CLIP_NEAREST)
+
+#define YUV_BILINEAR_FLAGS						\
+    (FAST_PATH_STANDARD_FLAGS | FAST_PATH_SCALE_TRANSFORM |		\
+     FAST_PATH_BILINEAR_FILTER | FAST_PATH_X_UNIT_POSITIVE |		\
+     FAST_PATH_SAMPLES_COVER_CLIP_BILINEAR)
+
+#define YUV_ITERS(format)						\
+    { PIXMAN_ ## format, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,		\
+      avx2_yuv_iter_init, NULL, NULL					\
+    },									\
+    { PIXMAN_ ## format, YUV_NEAREST_FLAGS, ITER_NARROW | ITER_SRC,	\
+      avx2_yuv_iter_init, NULL, NULL					\
+    },									\
+    { PIXMAN_ ## format, YUV_BILINEAR_FLAGS, ITER_NARROW | ITER_SRC,	\
+      avx2_yuv_iter_init, NULL, NULL					\
+    }
+
+#define YUV_DEST_ITER(format)						\
+    { PIXMAN_ ## format, FAST_PATH_NO_ACCESSORS, ITER_DEST,		\
+      avx2_yuv_dest_iter_init, NULL, NULL				\
+    }
+
+static const pixman_iter_info_t avx2_iters[] =
+{
+    YUV_ITERS (yuy2),
+    YUV_ITERS (yv12),
+    YUV_ITERS (nv12),
+    YUV_ITERS (i420),
+    YUV_DEST_ITER (yv12),
+    YUV_DEST_ITER (nv12),
+    YUV_DEST_ITER (i420),
+    { PIXMAN_any, SEPARABLE_CONVOLUTION_SCALE_FLAGS, ITER_NARROW | ITER_SRC,
+      avx2_separable_convolution_iter_init, NULL, NULL
+    },
+    { PIXMAN_unknown, 0, ITER_SRC,
+      avx2_gradient_iter_init, NULL, NULL
+    },
+    { PIXMAN_null },
+};
+
+#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+pixman_implementation_t *
+_pixman_implementation_create_avx2 (pixman_implementation_t *fallback)
+{
+    pixman_implementation_t *imp = _pixman_implementation_create (fallback, avx2_fast_paths);
+
+    imp->name = "avx2";
+
+    /* AVX2 constants */
+    mask_0080 = _mm256_set1_epi16 (0x0080);
+    mask_00ff = _mm256_set1_epi16 (0x00ff);
+    mask_0101 = _mm256_set1_epi16 (0x0101);
+    mask_ff000000 = _mm256_set1_epi32 (0xff000000);
+    mask_tail_index = _mm256_set_epi32 (7, 6, 5, 4, 3, 2, 1, 0);
+    mask_bilinear_order = _mm256_set_epi32 (7, 3, 6, 2, 5, 1, 4, 0);
+
+    /* Set up function pointers */
+    imp->combine_32[PIXMAN_OP_OVER] = avx2_combine_over_u;
+    imp->combine_32[PIXMAN_OP_OVER_REVERSE] = avx2_combine_over_reverse_u;
+    imp->combine_32[PIXMAN_OP_IN] = avx2_combine_in_u;
+    imp->combine_32[PIXMAN_OP_IN_REVERSE] = avx2_combine_in_reverse_u;
+    imp->combine_32[PIXMAN_OP_OUT] = avx2_combine_out_u;
+    imp->combine_32[PIXMAN_OP_OUT_REVERSE] = avx2_combine_out_reverse_u;
+    imp->combine_32[PIXMAN_OP_ATOP] = avx2_combine_atop_u;
+    imp->combine_32[PIXMAN_OP_ATOP_REVERSE] = avx2_combine_atop_reverse_u;
+    imp->combine_32[PIXMAN_OP_XOR] = avx2_combine_xor_u;
+    imp->combine_32[PIXMAN_OP_ADD] = avx2_combine_add_u;
+
+    imp->combine_32_ca[PIXMAN_OP_SRC] = avx2_combine_src_ca;
+    imp->combine_32_ca[PIXMAN_OP_OVER] = avx2_combine_over_ca;
+    imp->combine_32_ca[PIXMAN_OP_OVER_REVERSE] = avx2_combine_over_reverse_ca;
+    imp->combine_32_ca[PIXMAN_OP_IN] = avx2_combine_in_ca;
+    imp->combine_32_ca[PIXMAN_OP_IN_REVERSE] = avx2_combine_in_reverse_ca;
+    imp->combine_32_ca[PIXMAN_OP_OUT] = avx2_combine_out_ca;
+    imp->combine_32_ca[PIXMAN_OP_OUT_REVERSE] = avx2_combine_out_reverse_ca;
+    imp->combine_32_ca[PIXMAN_OP_ATOP] = avx2_combine_atop_ca;
+    imp->combine_32_ca[PIXMAN_OP_ATOP_REVERSE] = avx2_combine_atop_reverse_ca;
+    imp->combine_32_ca[PIXMAN_OP_XOR] = avx2_combine_xor_ca;
+    imp->combine_32_ca[PIXMAN_OP_ADD] = avx2_combine_add_ca;
+
+    avx2_setup_combiner_functions_32 (imp);
+    avx2_setup_combiner_functions_float (imp);
+
+    imp->blt = avx2_blt;
+    imp->fill = avx2_fill;
+
+    imp->iter_info = avx2_iters;
+
+    return imp;
+}
@@ -0,0 +1,1182 @@
+/*
+ * Copyright © 2008 Rodrigo Kumpera
+ * Copyright © 2008 André Tupinambá
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that
+ * copyright notice and this permission notice appear in supporting
+ * documentation, and that the name of Red Hat not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  Red Hat makes no representations about the
+ * suitability of this software for any purpose.  It is provided "as is"
+ * without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS
+ * SOFTWARE, INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS, IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN
+ * AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING
+ * OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS
+ * SOFTWARE.
+ *
+ * Based on the SSE2 implementation in pixman-sse2.c, using AVX-512BW
+ * for 16 pixels per iteration. Scanline heads and tails are handled
+ * with write masks, so none of the functions here need the scalar
+ * alignment prologue or remainder loop of their SSE2 counterparts.
+ * The arithmetic is the same as in SSE2, so results are bit-exact.
+ */
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#elif defined (_MSC_VER)
+#include <config_msc.h>
+#endif
+
+#include <immintrin.h> /* for AVX-512 intrinsics */
+#include "pixman-private.h"
+#include "pixman-combine32.h"
+#include "pixman-inlines.h"
+
+static __m512i mask_0080;
+static __m512i mask_00ff;
+static __m512i mask_0101;
+static __m512i mask_ff000000;
+
+static force_inline void
+unpack_512_2x512 (__m512i data, __m512i* data_lo, __m512i* data_hi)
+{
+    *data_lo = _mm512_unpacklo_epi8 (data, _mm512_setzero_si512 ());
+    *data_hi = _mm512_unpackhi_epi8 (data, _mm512_setzero_si512 ());
+}
+
+static force_inline __m512i
+pack_2x512_512 (__m512i lo, __m512i hi)
+{
+    return _mm512_packus_epi16 (lo, hi);
+}
+
+static force_inline int
+is_opaque (__m512i x)
+{
+    return (_mm512_cmpeq_epi8_mask (x, _mm512_set1_epi32 (-1)) &
+	    0x8888888888888888ULL) == 0x8888888888888888ULL;
+}
+
+static force_inline int
+is_zero (__m512i x)
+{
+    return _mm512_test_epi32_mask (x, x) == 0;
+}
+
+static force_inline int
+is_transparent (__m512i x)
+{
+    return _mm512_test_epi32_mask (x, mask_ff000000) == 0;
+}
+
+static force_inline __m512i
+expand_alpha_512 (__m512i data)
+{
+    return _mm512_shufflehi_epi16 (_mm512_shufflelo_epi16 (data,
+							   _MM_SHUFFLE (3, 3, 3, 3)),
+				   _MM_SHUFFLE (3, 3, 3, 3));
+}
+
+static force_inline __m512i
+expand_alpha_rev_512 (__m512i data)
+{
+    return _mm512_shufflehi_epi16 (_mm512_shufflelo_epi16 (data,
+							   _MM_SHUFFLE (0, 0, 0, 0)),
+				   _MM_SHUFFLE (0, 0, 0, 0));
+}
+
+static force_inline __m512i
+pix_multiply_512 (__m512i data, __m512i alpha)
+{
+    return _mm512_mulhi_epu16 (_mm512_adds_epu16 (_mm512_mullo_epi16 (data, alpha),
+						  mask_0080),
+			       mask_0101);
+}
+
+static force_inline __m512i
+pix_add_multiply_512 (__m512i src,
+		      __m512i alpha_dst,
+		      __m512i dst,
+		      __m512i alpha_src)
+{
+    __m512i t1 = pix_multiply_512 (src, alpha_dst);
+    __m512i t2 = pix_multiply_512 (dst, alpha_src);
+
+    return _mm512_adds_epu8 (t1, t2);
+}
+
+static force_inline __m512i
+negate_512 (__m512i data)
+{
+    return _mm512_xor_si512 (data, mask_00ff);
+}
+
+static force_inline __m512i
+over_512 (__m512i src, __m512i alpha, __m512i dst)
+{
+    return _mm512_adds_epu8 (src, pix_multiply_512 (dst, negate_512 (alpha)));
+}
+
+static force_inline __m512i
+in_over_512 (__m512i src, __m512i alpha, __m512i mask, __m512i dst)
+{
+    return over_512 (pix_multiply_512 (src, mask),
+		     pix_multiply_512 (alpha, mask),
+		     dst);
+}
+
+/* Write masks covering the first n elements of a register */
+static force_inline __mmask16
+create_mask_16 (int n)
+{
+    return n >= 16 ? (__mmask16)0xffff : (__mmask16)((1U << n) - 1);
+}
+
+static force_inline __mmask64
+create_mask_64 (int n)
+{
+    return n >= 64 ? ~(__mmask64)0 : (((__mmask64)1 << n) - 1);
+}
+
+/* load up to 16 pixels; lanes outside k are zero and are not read */
+static force_inline __m512i
+load_512_masked (const uint32_t *src, __mmask16 k)
+{
+    return _mm512_maskz_loadu_epi32 (k, src);
+}
+
+/* save up to 16 pixels; lanes outside k are left untouched */
+static force_inline void
+save_512_masked (uint32_t *dst, __mmask16 k, __m512i data)
+{
+    _mm512_mask_storeu_epi32 (dst, k, data);
+}
+
+/* Multiply sixteen source pixels by the alpha of the unified mask */
+static force_inline __m512i
+combine16 (__m512i s, __m512i m)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi;
+
+    if (is_transparent (m))
+	return _mm512_setzero_si512 ();
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+
+    s_lo = pix_multiply_512 (s_lo, expand_alpha_512 (m_lo));
+    s_hi = pix_multiply_512 (s_hi, expand_alpha_512 (m_hi));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+/* Unified combiners. Each core takes sixteen packed, already masked source
+ * pixels and sixteen packed destination pixels and returns the result.
+ */
+static force_inline __m512i
+core_over_u (__m512i s, __m512i d)
+{
+    __m512i s_lo, s_hi, d_lo, d_hi;
+
+    if (is_zero (s))
+	return d;
+    if (is_opaque (s))
+	return s;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    d_lo = over_512 (s_lo, expand_alpha_512 (s_lo), d_lo);
+    d_hi = over_512 (s_hi, expand_alpha_512 (s_hi), d_hi);
+
+    return pack_2x512_512 (d_lo, d_hi);
+}
+
+static force_inline __m512i
+core_over_reverse_u (__m512i s, __m512i d)
+{
+    __m512i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = over_512 (d_lo, expand_alpha_512 (d_lo), s_lo);
+    s_hi = over_512 (d_hi, expand_alpha_512 (d_hi), s_hi);
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_in_u (__m512i s, __m512i d)
+{
+    __m512i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = pix_multiply_512 (s_lo, expand_alpha_512 (d_lo));
+    s_hi = pix_multiply_512 (s_hi, expand_alpha_512 (d_hi));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_in_reverse_u (__m512i s, __m512i d)
+{
+    return core_in_u (d, s);
+}
+
+static force_inline __m512i
+core_out_u (__m512i s, __m512i d)
+{
+    __m512i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = pix_multiply_512 (s_lo, negate_512 (expand_alpha_512 (d_lo)));
+    s_hi = pix_multiply_512 (s_hi, negate_512 (expand_alpha_512 (d_hi)));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_out_reverse_u (__m512i s, __m512i d)
+{
+    return core_out_u (d, s);
+}
+
+static force_inline __m512i
+core_atop_u (__m512i s, __m512i d)
+{
+    __m512i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = pix_add_multiply_512 (s_lo, expand_alpha_512 (d_lo),
+				 d_lo, negate_512 (expand_alpha_512 (s_lo)));
+    s_hi = pix_add_multiply_512 (s_hi, expand_alpha_512 (d_hi),
+				 d_hi, negate_512 (expand_alpha_512 (s_hi)));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_atop_reverse_u (__m512i s, __m512i d)
+{
+    __m512i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = pix_add_multiply_512 (s_lo, negate_512 (expand_alpha_512 (d_lo)),
+				 d_lo, expand_alpha_512 (s_lo));
+    s_hi = pix_add_multiply_512 (s_hi, negate_512 (expand_alpha_512 (d_hi)),
+				 d_hi, expand_alpha_512 (s_hi));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_xor_u (__m512i s, __m512i d)
+{
+    __m512i s_lo, s_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = pix_add_multiply_512 (s_lo, negate_512 (expand_alpha_512 (d_lo)),
+				 d_lo, negate_512 (expand_alpha_512 (s_lo)));
+    s_hi = pix_add_multiply_512 (s_hi, negate_512 (expand_alpha_512 (d_hi)),
+				 d_hi, negate_512 (expand_alpha_512 (s_hi)));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_add_u (__m512i s, __m512i d)
+{
+    return _mm512_adds_epu8 (s, d);
+}
+
+#define AVX512_COMBINE_U(name)						\
+static void								\
+avx512_combine_ ## name ## _u (pixman_implementation_t *imp,		\
+			       pixman_op_t              op,		\
+			       uint32_t *               pd,		\
+			       const uint32_t *         ps,		\
+			       const uint32_t *         pm,		\
+			       int                      w)		\
+{									\
+    while (w > 0)							\
+    {									\
+	__mmask16 k = create_mask_16 (w);				\
+	__m512i s, d;							\
+									\
+	s = load_512_masked (ps, k);					\
+	if (pm)								\
+	{								\
+	    s = combine16 (s, load_512_masked (pm, k));			\
+	    pm += 16;							\
+	}								\
+	d = load_512_masked (pd, k);					\
+									\
+	save_512_masked (pd, k, core_ ## name ## _u (s, d));		\
+									\
+	ps += 16;							\
+	pd += 16;							\
+	w -= 16;							\
+    }									\
+}
+
+AVX512_COMBINE_U (over)
+AVX512_COMBINE_U (over_reverse)
+AVX512_COMBINE_U (in)
+AVX512_COMBINE_U (in_reverse)
+AVX512_COMBINE_U (out)
+AVX512_COMBINE_U (out_reverse)
+AVX512_COMBINE_U (atop)
+AVX512_COMBINE_U (atop_reverse)
+AVX512_COMBINE_U (xor)
+AVX512_COMBINE_U (add)
+
+/* Component alpha combiners. Each core takes sixteen packed source, mask
+ * and destination pixels.
+ */
+static force_inline __m512i
+core_src_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+
+    return pack_2x512_512 (pix_multiply_512 (s_lo, m_lo),
+			   pix_multiply_512 (s_hi, m_hi));
+}
+
+static force_inline __m512i
+core_over_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    d_lo = in_over_512 (s_lo, expand_alpha_512 (s_lo), m_lo, d_lo);
+    d_hi = in_over_512 (s_hi, expand_alpha_512 (s_hi), m_hi, d_hi);
+
+    return pack_2x512_512 (d_lo, d_hi);
+}
+
+static force_inline __m512i
+core_over_reverse_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = over_512 (d_lo, expand_alpha_512 (d_lo), pix_multiply_512 (s_lo, m_lo));
+    s_hi = over_512 (d_hi, expand_alpha_512 (d_hi), pix_multiply_512 (s_hi, m_hi));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_in_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = pix_multiply_512 (pix_multiply_512 (s_lo, m_lo),
+			     expand_alpha_512 (d_lo));
+    s_hi = pix_multiply_512 (pix_multiply_512 (s_hi, m_hi),
+			     expand_alpha_512 (d_hi));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_in_reverse_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    d_lo = pix_multiply_512 (d_lo,
+			     pix_multiply_512 (m_lo, expand_alpha_512 (s_lo)));
+    d_hi = pix_multiply_512 (d_hi,
+			     pix_multiply_512 (m_hi, expand_alpha_512 (s_hi)));
+
+    return pack_2x512_512 (d_lo, d_hi);
+}
+
+static force_inline __m512i
+core_out_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    s_lo = pix_multiply_512 (pix_multiply_512 (s_lo, m_lo),
+			     negate_512 (expand_alpha_512 (d_lo)));
+    s_hi = pix_multiply_512 (pix_multiply_512 (s_hi, m_hi),
+			     negate_512 (expand_alpha_512 (d_hi)));
+
+    return pack_2x512_512 (s_lo, s_hi);
+}
+
+static force_inline __m512i
+core_out_reverse_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    d_lo = pix_multiply_512 (
+	d_lo, negate_512 (pix_multiply_512 (m_lo, expand_alpha_512 (s_lo))));
+    d_hi = pix_multiply_512 (
+	d_hi, negate_512 (pix_multiply_512 (m_hi, expand_alpha_512 (s_hi))));
+
+    return pack_2x512_512 (d_lo, d_hi);
+}
+
+static force_inline __m512i
+core_atop_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+    __m512i a_lo, a_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    a_lo = negate_512 (pix_multiply_512 (m_lo, expand_alpha_512 (s_lo)));
+    a_hi = negate_512 (pix_multiply_512 (m_hi, expand_alpha_512 (s_hi)));
+    s_lo = pix_multiply_512 (s_lo, m_lo);
+    s_hi = pix_multiply_512 (s_hi, m_hi);
+
+    d_lo = pix_add_multiply_512 (d_lo, a_lo, s_lo, expand_alpha_512 (d_lo));
+    d_hi = pix_add_multiply_512 (d_hi, a_hi, s_hi, expand_alpha_512 (d_hi));
+
+    return pack_2x512_512 (d_lo, d_hi);
+}
+
+static force_inline __m512i
+core_atop_reverse_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+    __m512i a_lo, a_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    a_lo = pix_multiply_512 (m_lo, expand_alpha_512 (s_lo));
+    a_hi = pix_multiply_512 (m_hi, expand_alpha_512 (s_hi));
+    s_lo = pix_multiply_512 (s_lo, m_lo);
+    s_hi = pix_multiply_512 (s_hi, m_hi);
+
+    d_lo = pix_add_multiply_512 (d_lo, a_lo,
+				 s_lo, negate_512 (expand_alpha_512 (d_lo)));
+    d_hi = pix_add_multiply_512 (d_hi, a_hi,
+				 s_hi, negate_512 (expand_alpha_512 (d_hi)));
+
+    return pack_2x512_512 (d_lo, d_hi);
+}
+
+static force_inline __m512i
+core_xor_ca (__m512i s, __m512i m, __m512i d)
+{
+    __m512i s_lo, s_hi, m_lo, m_hi, d_lo, d_hi;
+    __m512i a_lo, a_hi;
+
+    unpack_512_2x512 (s, &s_lo, &s_hi);
+    unpack_512_2x512 (m, &m_lo, &m_hi);
+    unpack_512_2x512 (d, &d_lo, &d_hi);
+
+    a_lo = negate_512 (pix_multiply_512 (m_lo, expand_alpha_512 (s_lo)));
+    a_hi = negate_512 (pix_multiply_512 (m_hi, expand_alpha_512 (s_hi)));
+    s_lo = pix_multiply_512 (s_lo, m_lo);
+    s_hi = pix_multiply_512 (s_hi, m_hi);
+
+    d_lo = pix_add_multiply_512 (d_lo, a_lo,
+				 s_lo, negate_512 (expand_alpha_512 (d_lo)));
+    d_hi = pix_add_multiply_512 (d_hi, a_hi,
+				 s_hi, negate_512 (expand_alpha_512 (d_hi)));
+
+    return pack_2x512_512 (d_lo, d_hi);
+}
+
+static force_inline __m512i
+core_add_ca (__m512i s, __m512i m, __m512i d)
+{
+    return _mm512_adds_epu8 (core_src_ca (s, m, d), d);
+}
+
+#define AVX512_COMBINE_CA(name)						\
+static void								\
+avx512_combine_ ## name ## _ca (pixman_implementation_t *imp,		\
+				pixman_op_t              op,		\
+				uint32_t *               pd,		\
+				const uint32_t *         ps,		\
+				const uint32_t *         pm,		\
+				int                      w)		\
+{									\
+    while (w > 0)							\
+    {									\
+	__mmask16 k = create_mask_16 (w);				\
+	__m512i s, m, d;						\
+									\
+	s = load_512_masked (ps, k);					\
+	m = load_512_masked (pm, k);					\
+	d = load_512_masked (pd, k);					\
+									\
+	save_512_masked (pd, k, core_ ## name ## _ca (s, m, d));	\
+									\
+	ps += 16;							\
+	pm += 16;							\
+	pd += 16;							\
+	w -= 16;							\
+    }									\
+}
+
+AVX512_COMBINE_CA (src)
+AVX512_COMBINE_CA (over)
+AVX512_COMBINE_CA (over_reverse)
+AVX512_COMBINE_CA (in)
+AVX512_COMBINE_CA (in_reverse)
+AVX512_COMBINE_CA (out)
+AVX512_COMBINE_CA (out_reverse)
+AVX512_COMBINE_CA (atop)
+AVX512_COMBINE_CA (atop_reverse)
+AVX512_COMBINE_CA (xor)
+AVX512_COMBINE_CA (add)
+
+/* -------------------------------------------------------------------
+ * composite functions
+ */
+
+static void
+avx512_composite_over_8888_8888 (pixman_implementation_t *imp,
+                                 pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    int dst_stride, src_stride;
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    dst = dst_line;
+    src = src_line;
+
+    while (height--)
+    {
+	avx512_combine_over_u (imp, op, dst, src, NULL, width);
+
+	dst += dst_stride;
+	src += src_stride;
+    }
+}
+
+static void
+avx512_composite_add_8888_8888 (pixman_implementation_t *imp,
+                                pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+
+	avx512_combine_add_u (imp, op, dst, src, NULL, width);
+    }
+}
+
+static void
+avx512_composite_over_n_8888 (pixman_implementation_t *imp,
+			      pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t src;
+    uint32_t    *dst_line, *dst;
+    int32_t w;
+    int dst_stride;
+
+    __m512i zmm_src, zmm_alpha;
+    __m512i zmm_dst, zmm_dst_lo, zmm_dst_hi;
+
+    src = _pixman_image_get_solid (imp, src_image, dest_image->bits.format);
+
+    if (src == 0)
+	return;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    zmm_src = _mm512_unpacklo_epi8 (_mm512_set1_epi32 (src),
+				    _mm512_setzero_si512 ());
+    zmm_alpha = expand_alpha_512 (zmm_src);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	w = width;
+
+	while (w > 0)
+	{
+	    __mmask16 k = create_mask_16 (w);
+
+	    zmm_dst = load_512_masked (dst, k);
+
+	    unpack_512_2x512 (zmm_dst, &zmm_dst_lo, &zmm_dst_hi);
+
+	    zmm_dst_lo = over_512 (zmm_src, zmm_alpha, zmm_dst_lo);
+	    zmm_dst_hi = over_512 (zmm_src, zmm_alpha, zmm_dst_hi);
+
+	    save_512_masked (dst, k, pack_2x512_512 (zmm_dst_lo, zmm_dst_hi));
+
+	    w -= 16;
+	    dst += 16;
+	}
+    }
+}
+
+static void
+avx512_composite_over_n_8_8888 (pixman_implementation_t *imp,
+                                pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t src, srca;
+    uint32_t *dst_line, *dst;
+    uint8_t *mask_line, *mask;
+    int dst_stride, mask_stride;
+    int32_t w;
+
+    __m512i zmm_src, zmm_alpha, zmm_def;
+    __m512i zmm_dst, zmm_dst_lo, zmm_dst_hi;
+    __m512i zmm_mask, zmm_mask_lo, zmm_mask_hi;
+    __m128i xmm_mask;
+
+    src = _pixman_image_get_solid (imp, src_image, dest_image->bits.format);
+
+    srca = src >> 24;
+    if (src == 0)
+	return;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	mask_image, mask_x, mask_y, uint8_t, mask_stride, mask_line, 1);
+
+    zmm_def = _mm512_set1_epi32 (src);
+    zmm_src = _mm512_unpacklo_epi8 (zmm_def, _mm512_setzero_si512 ());
+    zmm_alpha = expand_alpha_512 (zmm_src);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	mask = mask_line;
+	mask_line += mask_stride;
+	w = width;
+
+	while (w > 0)
+	{
+	    __mmask16 k = create_mask_16 (w);
+	    __mmask16 m_set, m_full;
+
+	    xmm_mask = _mm_maskz_loadu_epi8 (k, mask);
+
+	    m_set = _mm_test_epi8_mask (xmm_mask, xmm_mask);
+	    m_full = _mm_cmpeq_epi8_mask (xmm_mask, _mm_set1_epi8 (-1));
+
+	    if (srca == 0xff && m_full == k)
+	    {
+		save_512_masked (dst, k, zmm_def);
+	    }
+	    else if (m_set)
+	    {
+		/* Only touch the pixels with a non-zero mask */
+		zmm_dst = load_512_masked (dst, m_set);
+		zmm_mask = _mm512_cvtepu8_epi32 (xmm_mask);
+
+		unpack_512_2x512 (zmm_dst, &zmm_dst_lo, &zmm_dst_hi);
+		unpack_512_2x512 (zmm_mask, &zmm_mask_lo, &zmm_mask_hi);
+
+		zmm_mask_lo = expand_alpha_rev_512 (zmm_mask_lo);
+		zmm_mask_hi = expand_alpha_rev_512 (zmm_mask_hi);
+
+		zmm_dst_lo = in_over_512 (zmm_src, zmm_alpha, zmm_mask_lo, zmm_dst_lo);
+		zmm_dst_hi = in_over_512 (zmm_src, zmm_alpha, zmm_mask_hi, zmm_dst_hi);
+
+		save_512_masked (dst, m_set, pack_2x512_512 (zmm_dst_lo, zmm_dst_hi));
+	    }
+
+	    w -= 16;
+	    dst += 16;
+	    mask += 16;
+	}
+    }
+}
+
+static void
+avx512_composite_src_x888_8888 (pixman_implementation_t *imp,
+				pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src;
+    int32_t w;
+    int dst_stride, src_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w > 0)
+	{
+	    __mmask16 k = create_mask_16 (w);
+
+	    save_512_masked (dst, k, _mm512_or_si512 (
+		load_512_masked (src, k), mask_ff000000));
+
+	    dst += 16;
+	    src += 16;
+	    w -= 16;
+	}
+    }
+}
+
+static void
+avx512_composite_add_8_8 (pixman_implementation_t *imp,
+			  pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint8_t     *dst_line, *dst;
+    uint8_t     *src_line, *src;
+    int dst_stride, src_stride;
+    int32_t w;
+
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint8_t, src_stride, src_line, 1);
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint8_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	src = src_line;
+
+	dst_line += dst_stride;
+	src_line += src_stride;
+	w = width;
+
+	while (w > 0)
+	{
+	    __mmask64 k = create_mask_64 (w);
+
+	    _mm512_mask_storeu_epi8 (dst, k, _mm512_adds_epu8 (
+		_mm512_maskz_loadu_epi8 (k, src),
+		_mm512_maskz_loadu_epi8 (k, dst)));
+
+	    dst += 64;
+	    src += 64;
+	    w -= 64;
+	}
+    }
+}
+
+static pixman_bool_t
+avx512_fill (pixman_implementation_t *imp,
+             uint32_t *               bits,
+             int                      stride,
+             int                      bpp,
+             int                      x,
+             int                      y,
+             int                      width,
+             int                      height,
+             uint32_t		      filler)
+{
+    uint32_t byte_width;
+    uint8_t *byte_line;
+
+    __m512i zmm_def;
+
+    if (bpp == 8)
+    {
+	uint32_t b;
+	uint32_t w;
+
+	stride = stride * (int) sizeof (uint32_t) / 1;
+	byte_line = (uint8_t *)(((uint8_t *)bits) + stride * y + x);
+	byte_width = width;
+	stride *= 1;
+
+	b = filler & 0xff;
+	w = (b << 8) | b;
+	filler = (w << 16) | w;
+    }
+    else if (bpp == 16)
+    {
+	stride = stride * (int) sizeof (uint32_t) / 2;
+	byte_line = (uint8_t *)(((uint16_t *)bits) + stride * y + x);
+	byte_width = 2 * width;
+	stride *= 2;
+
+        filler = (filler & 0xffff) * 0x00010001;
+    }
+    else if (bpp == 32)
+    {
+	stride = stride * (int) sizeof (uint32_t) / 4;
+	byte_line = (uint8_t *)(((uint32_t *)bits) + stride * y + x);
+	byte_width = 4 * width;
+	stride *= 4;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    zmm_def = _mm512_set1_epi32 (filler);
+
+    while (height--)
+    {
+	int w, head;
+	uint8_t *d = byte_line;
+	byte_line += stride;
+	w = byte_width;
+
+	/* Head: a masked store up to the next 64-byte boundary */
+	head = (64 - ((uintptr_t)d & 63)) & 63;
+	if (head > w)
+	    head = w;
+	if (head)
+	{
+	    _mm512_mask_storeu_epi8 (d, create_mask_64 (head), zmm_def);
+	    d += head;
+	    w -= head;
+	}
+
+	while (w >= 64)
+	{
+	    _mm512_store_si512 (d, zmm_def);
+	    d += 64;
+	    w -= 64;
+	}
+
+	/* Tail */
+	if (w)
+	    _mm512_mask_storeu_epi8 (d, create_mask_64 (w), zmm_def);
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+avx512_blt (pixman_implementation_t *imp,
+            uint32_t *               src_bits,
+            uint32_t *               dst_bits,
+            int                      src_stride,
+            int                      dst_stride,
+            int                      src_bpp,
+            int                      dst_bpp,
+            int                      src_x,
+            int                      src_y,
+            int                      dest_x,
+            int                      dest_y,
+            int                      width,
+            int                      height)
+{
+    uint8_t *   src_bytes;
+    uint8_t *   dst_bytes;
+    int byte_width;
+
+    if (src_bpp != dst_bpp)
+	return FALSE;
+
+    if (src_bpp == 16)
+    {
+	src_stride = src_stride * (int) sizeof (uint32_t) / 2;
+	dst_stride = dst_stride * (int) sizeof (uint32_t) / 2;
+	src_bytes =(uint8_t *)(((uint16_t *)src_bits) + src_stride * (src_y) + (src_x));
+	dst_bytes = (uint8_t *)(((uint16_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
+	byte_width = 2 * width;
+	src_stride *= 2;
+	dst_stride *= 2;
+    }
+    else if (src_bpp == 32)
+    {
+	src_stride = src_stride * (int) sizeof (uint32_t) / 4;
+	dst_stride = dst_stride * (int) sizeof (uint32_t) / 4;
+	src_bytes = (uint8_t *)(((uint32_t *)src_bits) + src_stride * (src_y) + (src_x));
+	dst_bytes = (uint8_t *)(((uint32_t *)dst_bits) + dst_stride * (dest_y) + (dest_x));
+	byte_width = 4 * width;
+	src_stride *= 4;
+	dst_stride *= 4;
+    }
+    else
+    {
+	return FALSE;
+    }
+
+    while (height--)
+    {
+	int w, head;
+	uint8_t *s = src_bytes;
+	uint8_t *d = dst_bytes;
+	src_bytes += src_stride;
+	dst_bytes += dst_stride;
+	w = byte_width;
+
+	/* Head: a masked copy up to the next 64-byte boundary of d */
+	head = (64 - ((uintptr_t)d & 63)) & 63;
+	if (head > w)
+	    head = w;
+	if (head)
+	{
+	    __mmask64 k = create_mask_64 (head);
+
+	    _mm512_mask_storeu_epi8 (d, k, _mm512_maskz_loadu_epi8 (k, s));
+	    s += head;
+	    d += head;
+	    w -= head;
+	}
+
+	while (w >= 256)
+	{
+	    __m512i zmm0, zmm1, zmm2, zmm3;
+
+	    zmm0 = _mm512_loadu_si512 (s);
+	    zmm1 = _mm512_loadu_si512 (s + 64);
+	    zmm2 = _mm512_loadu_si512 (s + 128);
+	    zmm3 = _mm512_loadu_si512 (s + 192);
+
+	    _mm512_store_si512 (d,       zmm0);
+	    _mm512_store_si512 (d + 64,  zmm1);
+	    _mm512_store_si512 (d + 128, zmm2);
+	    _mm512_store_si512 (d + 192, zmm3);
+
+	    s += 256;
+	    d += 256;
+	    w -= 256;
+	}
+
+	while (w >= 64)
+	{
+	    _mm512_store_si512 (d, _mm512_loadu_si512 (s));
+
+	    w -= 64;
+	    d += 64;
+	    s += 64;
+	}
+
+	/* Tail */
+	if (w)
+	{
+	    __mmask64 k = create_mask_64 (w);
+
+	    _mm512_mask_storeu_epi8 (d, k, _mm512_maskz_loadu_epi8 (k, s));
+	}
+    }
+
+    return TRUE;
+}
+
+static void
+avx512_composite_copy_area (pixman_implementation_t *imp,
+                            pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    avx512_blt (imp, src_image->bits.bits,
+		dest_image->bits.bits,
+		src_image->bits.rowstride,
+		dest_image->bits.rowstride,
+		PIXMAN_FORMAT_BPP (src_image->bits.format),
+		PIXMAN_FORMAT_BPP (dest_image->bits.format),
+		src_x, src_y, dest_x, dest_y, width, height);
+}
+
+static force_inline void
+scaled_nearest_scanline_avx512_8888_8888_OVER (uint32_t*       pd,
+                                               const uint32_t* ps,
+                                               int32_t         w,
+                                               pixman_fixed_t  vx,
+                                               pixman_fixed_t  unit_x,
+                                               pixman_fixed_t  src_width_fixed,
+                                               pixman_bool_t   fully_transparent_src)
+{
+    uint32_t tmp[16];
+    __m512i s;
+    int i, n;
+
+    if (fully_transparent_src)
+	return;
+
+    while (w > 0)
+    {
+	__mmask16 k = create_mask_16 (w);
+
+	n = w < 16 ? w : 16;
+
+	for (i = 0; i < n; i++)
+	{
+	    tmp[i] = *(ps + pixman_fixed_to_int (vx));
+	    vx += unit_x;
+	    while (vx >= 0)
+		vx -= src_width_fixed;
+	}
+
+	s = load_512_masked (tmp, k);
+	save_512_masked (pd, k, core_over_u (s, load_512_masked (pd, k)));
+
+	w -= 16;
+	pd += 16;
+    }
+}
+
+FAST_NEAREST_MAINLOOP (avx512_8888_8888_cover_OVER,
+		       scaled_nearest_scanline_avx512_8888_8888_OVER,
+		       uint32_t, uint32_t, COVER)
+FAST_NEAREST_MAINLOOP (avx512_8888_8888_none_OVER,
+		       scaled_nearest_scanline_avx512_8888_8888_OVER,
+		       uint32_t, uint32_t, NONE)
+FAST_NEAREST_MAINLOOP (avx512_8888_8888_pad_OVER,
+		       scaled_nearest_scanline_avx512_8888_8888_OVER,
+		       uint32_t, uint32_t, PAD)
+FAST_NEAREST_MAINLOOP (avx512_8888_8888_normal_OVER,
+		       scaled_nearest_scanline_avx512_8888_8888_OVER,
+		       uint32_t, uint32_t, NORMAL)
+
+static const pixman_fast_path_t avx512_fast_paths[] =
+{
+    /* PIXMAN_OP_OVER */
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, a8r8g8b8, avx512_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, x8r8g8b8, avx512_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, a8b8g8r8, avx512_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, null, x8b8g8r8, avx512_composite_over_n_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, a8r8g8b8, avx512_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8r8g8b8, null, x8r8g8b8, avx512_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, a8b8g8r8, avx512_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, a8b8g8r8, null, x8b8g8r8, avx512_composite_over_8888_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8r8g8b8, avx512_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8r8g8b8, avx512_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, a8b8g8r8, avx512_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, solid, a8, x8b8g8r8, avx512_composite_over_n_8_8888),
+    PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, null, x8r8g8b8, avx512_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, null, x8b8g8r8, avx512_composite_copy_area),
+
+    /* PIXMAN_OP_ADD */
+    PIXMAN_STD_FAST_PATH (ADD, a8, null, a8, avx512_composite_add_8_8),
+    PIXMAN_STD_FAST_PATH (ADD, a8r8g8b8, null, a8r8g8b8, avx512_composite_add_8888_8888),
+    PIXMAN_STD_FAST_PATH (ADD, a8b8g8r8, null, a8b8g8r8, avx512_composite_add_8888_8888),
+
+    /* PIXMAN_OP_SRC */
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, a8r8g8b8, avx512_composite_src_x888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, a8b8g8r8, avx512_composite_src_x888_8888),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, a8r8g8b8, avx512_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, a8b8g8r8, avx512_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8r8g8b8, null, x8r8g8b8, avx512_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, a8b8g8r8, null, x8b8g8r8, avx512_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, x8r8g8b8, null, x8r8g8b8, avx512_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, x8b8g8r8, null, x8b8g8r8, avx512_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, r5g6b5, null, r5g6b5, avx512_composite_copy_area),
+    PIXMAN_STD_FAST_PATH (SRC, b5g6r5, null, b5g6r5, avx512_composite_copy_area),
+
+    SIMPLE_NEAREST_FAST_PATH (OVER, a8r8g8b8, x8r8g8b8, avx512_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH (OVER, a8b8g8r8, x8b8g8r8, avx512_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8, avx512_8888_8888),
+    SIMPLE_NEAREST_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8, avx512_8888_8888),
+
+    { PIXMAN_OP_NONE },
+};
+
+#if defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+pixman_implementation_t *
+_pixman_implementation_create_avx512 (pixman_implementation_t *fallback)
+{
+    pixman_implementation_t *imp = _pixman_implementation_create (fallback, avx512_fast_paths);
+
+    imp->name = "avx512";
+
+    /* AVX-512 constants */
+    mask_0080 = _mm512_set1_epi16 (0x0080);
+    mask_00ff = _mm512_set1_epi16 (0x00ff);
+    mask_0101 = _mm512_set1_epi16 (0x0101);
+    mask_ff000000 = _mm512_set1_epi32 (0xff000000);
+
+    /* Set up function pointers */
+    imp->combine_32[PIXMAN_OP_OVER] = avx512_combine_over_u;
+    imp->combine_32[PIXMAN_OP_OVER_REVERSE] = avx512_combine_over_reverse_u;
+    imp->combine_32[PIXMAN_OP_IN] = avx512_combine_in_u;
+    imp->combine_32[PIXMAN_OP_IN_REVERSE] = avx512_combine_in_reverse_u;
+    imp->combine_32[PIXMAN_OP_OUT] = avx512_combine_out_u;
+    imp->combine_32[PIXMAN_OP_OUT_REVERSE] = avx512_combine_out_reverse_u;
+    imp->combine_32[PIXMAN_OP_ATOP] = avx512_combine_atop_u;
+    imp->combine_32[PIXMAN_OP_ATOP_REVERSE] = avx512_combine_atop_reverse_u;
+    imp->combine_32[PIXMAN_OP_XOR] = avx512_combine_xor_u;
+    imp->combine_32[PIXMAN_OP_ADD] = avx512_combine_add_u;
+
+    imp->combine_32_ca[PIXMAN_OP_SRC] = avx512_combine_src_ca;
+    imp->combine_32_ca[PIXMAN_OP_OVER] = avx512_combine_over_ca;
+    imp->combine_32_ca[PIXMAN_OP_OVER_REVERSE] = avx512_combine_over_reverse_ca;
+    imp->combine_32_ca[PIXMAN_OP_IN] = avx512_combine_in_ca;
+    imp->combine_32_ca[PIXMAN_OP_IN_REVERSE] = avx512_combine_in_reverse_ca;
+    imp->combine_32_ca[PIXMAN_OP_OUT] = avx512_combine_out_ca;
+    imp->combine_32_ca[PIXMAN_OP_OUT_REVERSE] = avx512_combine_out_reverse_ca;
+    imp->combine_32_ca[PIXMAN_OP_ATOP] = avx512_combine_atop_ca;
+    imp->combine_32_ca[PIXMAN_OP_ATOP_REVERSE] = avx512_combine_atop_reverse_ca;
+    imp->combine_32_ca[PIXMAN_OP_XOR] = avx512_combine_xor_ca;
+    imp->combine_32_ca[PIXMAN_OP_ADD] = avx512_combine_add_ca;
+
+    imp->blt = avx512_blt;
+    imp->fill = avx512_fill;
+
+    return imp;
+}
@@ -412,6 +412,102 @@ bits_image_fetch_pixel_separable_convolution (bits_image_t  *image,
     reduce(satot, srtot, sgtot, sbtot, out);
 }
 
+/* The narrow variant filters row by row and rounds only the final sums,
+ * like the separable convolution iterators, so that it gives exactly the
+ * same results.
+ */
+static void
+bits_image_fetch_pixel_separable_convolution_32 (bits_image_t  *image,
+						 pixman_fixed_t x,
+						 pixman_fixed_t y,
+						 get_pixel_t    get_pixel,
+						 void	       *out)
+{
+    pixman_fixed_t *params = image->common.filter_params;
+    pixman_repeat_t repeat_mode = image->common.repeat;
+    int width = image->width;
+    int height = image->height;
+    int cwidth = pixman_fixed_to_int (params[0]);
+    int cheight = pixman_fixed_to_int (params[1]);
+    int x_phase_bits = pixman_fixed_to_int (params[2]);
+    int y_phase_bits = pixman_fixed_to_int (params[3]);
+    int x_phase_shift = 16 - x_phase_bits;
+    int y_phase_shift = 16 - y_phase_bits;
+    int x_off = ((cwidth << 16) - pixman_fixed_1) >> 1;
+    int y_off = ((cheight << 16) - pixman_fixed_1) >> 1;
+    pixman_fixed_t *y_params;
+    int64_t srtot, sgtot, sbtot, satot;
+    uint32_t *ret = out;
+    int32_t x1, x2, y1, y2;
+    int32_t px, py;
+    int i, j;
+
+    x = ((x >> x_phase_shift) << x_phase_shift) + ((1 << x_phase_shift) >> 1);
+    y = ((y >> y_phase_shift) << y_phase_shift) + ((1 << y_phase_shift) >> 1);
+
+    px = (x & 0xffff) >> x_phase_shift;
+    py = (y & 0xffff) >> y_phase_shift;
+
+    y_params = params + 4 + (1 << x_phase_bits) * cwidth + py * cheight;
+
+    x1 = pixman_fixed_to_int (x - pixman_fixed_e - x_off);
+    y1 = pixman_fixed_to_int (y - pixman_fixed_e - y_off);
+    x2 = x1 + cwidth;
+    y2 = y1 + cheight;
+
+    srtot = sgtot = sbtot = satot = 0;
+
+    for (i = y1; i < y2; ++i)
+    {
+	pixman_fixed_t fy = *y_params++;
+	pixman_fixed_t *x_params = params + 4 + px * cwidth;
+	uint32_t sr, sg, sb, sa;
+
+	if (!fy)
+	    continue;
+
+	sr = sg = sb = sa = 0;
+
+	for (j = x1; j < x2; ++j)
+	{
+	    pixman_fixed_t fx = *x_params++;
+	    int rx = j;
+	    int ry = i;
+	    uint32_t pixel;
+
+	    if (!fx)
+		continue;
+
+	    if (repeat_mode != PIXMAN_REPEAT_NONE)
+	    {
+		repeat (repeat_mode, &rx, width);
+		repeat (repeat_mode, &ry, height);
+
+		get_pixel (image, rx, ry, FALSE, &pixel);
+	    }
+	    else
+	    {
+		get_pixel (image, rx, ry, TRUE, &pixel);
+	    }
+
+	    sr += RED_8 (pixel) * (uint32_t)fx;
+	    sg += GREEN_8 (pixel) * (uint32_t)fx;
+	    sb += BLUE_8 (pixel) * (uint32_t)fx;
+	    sa += ALPHA_8 (pixel) * (uint32_t)fx;
+	}
+
+	srtot += (int64_t)(int32_t)sr * fy;
+	sgtot += (int64_t)(int32_t)sg * fy;
+	sbtot += (int64_t)(int32_t)sb * fy;
+	satot += (int64_t)(int32_t)sa * fy;
+    }
+
+    *ret = ((separable_convolution_reduce (satot) << 24)	|
+	    (separable_convolution_reduce (srtot) << 16)	|
+	    (separable_convolution_reduce (sgtot) << 8)		|
+	    (separable_convolution_reduce (sbtot)));
+}
+
 static force_inline void
 bits_image_fetch_pixel_filtered (bits_image_t  *image,
 				 pixman_bool_t  wide,
@@ -462,9 +558,8 @@ bits_image_fetch_pixel_filtered (bits_image_t  *image,
 	}
 	else
 	{
-	    bits_image_fetch_pixel_separable_convolution (image, x, y,
-							  get_pixel, out,
-							  accum_32, reduce_32);
+	    bits_image_fetch_pixel_separable_convolution_32 (image, x, y,
+							     get_pixel, out);
 	}
         break;
 
@@ -717,6 +812,168 @@ bits_image_fetch_general_float (pixman_iter_t  *iter,
     return __bits_image_fetch_general(iter, TRUE, mask);
 }
 
+/* Mipmap fetcher */
+static force_inline void
+fetch_pixel_mipmap_level (bits_image_t *image,
+			  int x, int y, pixman_bool_t check_bounds,
+			  void *out)
+{
+    uint32_t *ret = out;
+
+    if (check_bounds &&
+	(x < 0 || x >= image->width || y < 0 || y >= image->height))
+	*ret = 0;
+    else
+	*ret = image->bits[y * image->rowstride + x];
+}
+
+/* The levels are a8r8g8b8 images without alpha maps or accessors, so
+ * they are read directly.
+ */
+static void
+bits_image_fetch_mipmap_level_32 (pixman_iter_t  *iter,
+				  const uint32_t *mask)
+{
+    bits_image_t *image = &iter->image->bits;
+    uint32_t *buffer = iter->buffer;
+    pixman_fixed_t x, y, ux, uy;
+    pixman_vector_t v;
+    int i;
+
+    v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (iter->y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    if (image->common.transform)
+    {
+	if (!pixman_transform_point_3d (image->common.transform, &v))
+	    return;
+
+	ux = image->common.transform->matrix[0][0];
+	uy = image->common.transform->matrix[1][0];
+    }
+    else
+    {
+	ux = pixman_fixed_1;
+	uy = 0;
+    }
+
+    x = v.vector[0];
+    y = v.vector[1];
+
+    for (i = 0; i < iter->width; ++i)
+    {
+	if (!mask || mask[i])
+	{
+	    bits_image_fetch_pixel_bilinear_32 (
+		image, x, y, fetch_pixel_mipmap_level, buffer + i);
+	}
+
+	x += ux;
+	y += uy;
+    }
+}
+
+static uint32_t *
+__bits_image_fetch_mipmap (pixman_iter_t  *iter,
+			   pixman_bool_t   wide,
+			   const uint32_t *mask)
+{
+    pixman_image_t *image = iter->image;
+    mipmap_t *mipmap = image->bits.mipmap;
+    int level = mipmap->level;
+    int weight = mipmap->weight;
+    pixman_iter_t level_iter = *iter;
+    uint32_t *next;
+    int i;
+
+    /* The image itself is sampled when the levels were not set up
+     * for the current bits and transform.
+     */
+    if (!mipmap->valid					||
+	mipmap->generation != image->common.generation	||
+	mipmap->n_levels < level + (weight != 0))
+    {
+	level = weight = 0;
+    }
+
+    if (level > 0)
+    {
+	level_iter.image = mipmap->levels[level - 1];
+
+	if (wide)
+	    __bits_image_fetch_affine_no_alpha (&level_iter, wide, mask);
+	else
+	    bits_image_fetch_mipmap_level_32 (&level_iter, mask);
+    }
+    else
+    {
+	__bits_image_fetch_affine_no_alpha (&level_iter, wide, mask);
+    }
+
+    if (weight)
+    {
+	next = _pixman_scratch_alloc (
+	    iter->width * (wide ? sizeof (argb_t) : sizeof (uint32_t)));
+
+	if (next)
+	{
+	    level_iter.image = mipmap->levels[level];
+	    level_iter.y = iter->y;
+	    level_iter.buffer = next;
+
+	    if (wide)
+		__bits_image_fetch_affine_no_alpha (&level_iter, wide, mask);
+	    else
+		bits_image_fetch_mipmap_level_32 (&level_iter, mask);
+
+	    if (wide)
+	    {
+		argb_t *dest = (argb_t *)iter->buffer;
+		argb_t *src = (argb_t *)next;
+		float w = weight / 255.f;
+
+		for (i = 0; i < iter->width; ++i)
+		{
+		    dest[i].a += (src[i].a - dest[i].a) * w;
+		    dest[i].r += (src[i].r - dest[i].r) * w;
+		    dest[i].g += (src[i].g - dest[i].g) * w;
+		    dest[i].b += (src[i].b - dest[i].b) * w;
+		}
+	    }
+	    else
+	    {
+		uint32_t *dest = iter->buffer;
+
+		for (i = 0; i < iter->width; ++i)
+		{
+		    UN8x4_MUL_UN8_ADD_UN8x4_MUL_UN8 (
+			dest[i], 255 - weight, next[i], weight);
+		}
+	    }
+
+	    _pixman_scratch_free (next);
+	}
+    }
+
+    iter->y++;
+    return iter->buffer;
+}
+
+static uint32_t *
+bits_image_fetch_mipmap_32 (pixman_iter_t  *iter,
+			    const uint32_t *mask)
+{
+    return __bits_image_fetch_mipmap (iter, FALSE, mask);
+}
+
+static uint32_t *
+bits_image_fetch_mipmap_float (pixman_iter_t  *iter,
+			       const uint32_t *mask)
+{
+    return __bits_image_fetch_mipmap (iter, TRUE, mask);
+}
+
 static void
 replicate_pixel_32 (bits_image_t *   bits,
 		    int              x,
@@ -902,6 +1159,12 @@ typedef struct
 
 static const fetcher_info_t fetcher_info[] =
 {
+    { PIXMAN_any,
+      FAST_PATH_MIPMAP,
+      bits_image_fetch_mipmap_32,
+      bits_image_fetch_mipmap_float
+    },
+
     { PIXMAN_any,
       (FAST_PATH_NO_ALPHA_MAP			|
        FAST_PATH_ID_TRANSFORM			|
@@ -963,107 +1226,716 @@ _pixman_bits_image_src_iter_init (pixman_image_t *image, pixman_iter_t *iter)
     iter->get_scanline = _pixman_iter_get_scanline_noop;
 }
 
-static uint32_t *
-dest_get_scanline_narrow (pixman_iter_t *iter, const uint32_t *mask)
+/* YUV source iterators for the SIMD implementations. Scaled images are sampled
+ * from converted scanlines, of which the last two are kept since
+ * consecutive destination scanlines usually need the same ones.
+ */
+typedef struct
 {
-    pixman_image_t *image  = iter->image;
-    int             x      = iter->x;
-    int             y      = iter->y;
-    int             width  = iter->width;
-    uint32_t *	    buffer = iter->buffer;
+    int		y;
+    uint32_t *	buffer;
+} yuv_line_t;
 
-    image->bits.fetch_scanline_32 (&image->bits, x, y, width, buffer, mask);
-    if (image->common.alpha_map)
-    {
-	uint32_t *alpha;
+typedef struct
+{
+    const pixman_yuv_kernels_t *kernels;
+    yuv_line_t			lines[2];
+    pixman_fixed_t		x, y;
+    int				x0, n;
+    uint32_t			data[1];
+} yuv_info_t;
 
-	if ((alpha = malloc (width * sizeof (uint32_t))))
-	{
-	    int i;
+static uint32_t *
+yuv_get_scanline_untransformed (pixman_iter_t *iter, const uint32_t *mask)
+{
+    const pixman_yuv_kernels_t *kernels = iter->data;
 
-	    x -= image->common.alpha_origin_x;
-	    y -= image->common.alpha_origin_y;
+    kernels->convert (&iter->image->bits,
+		      iter->x, iter->y++, iter->width, iter->buffer);
 
-	    image->common.alpha_map->fetch_scanline_32 (
-		image->common.alpha_map, x, y, width, alpha, mask);
+    return iter->buffer;
+}
 
-	    for (i = 0; i < width; ++i)
-	    {
-		buffer[i] &= ~0xff000000;
-		buffer[i] |= (alpha[i] & 0xff000000);
-	    }
+static const uint32_t *
+yuv_fetch_line (pixman_iter_t *iter, int y)
+{
+    yuv_info_t *info = iter->data;
+    yuv_line_t *line = &info->lines[y & 1];
 
-	    free (alpha);
-	}
+    if (line->y != y)
+    {
+	info->kernels->convert (&iter->image->bits,
+				info->x0, y, info->n, line->buffer);
+
+	/* The bilinear kernel may read one pixel past the last one, with
+	 * a weight of zero
+	 */
+	line->buffer[info->n] = line->buffer[info->n - 1];
+	line->y = y;
     }
 
-    return iter->buffer;
+    return line->buffer;
 }
 
 static uint32_t *
-dest_get_scanline_wide (pixman_iter_t *iter, const uint32_t *mask)
+yuv_get_scanline_nearest (pixman_iter_t *iter, const uint32_t *mask)
 {
-    bits_image_t *  image  = &iter->image->bits;
-    int             x      = iter->x;
-    int             y      = iter->y;
-    int             width  = iter->width;
-    argb_t *	    buffer = (argb_t *)iter->buffer;
+    yuv_info_t *info = iter->data;
+    pixman_fixed_t ux = iter->image->common.transform->matrix[0][0];
+    pixman_fixed_t x = info->x - pixman_int_to_fixed (info->x0);
+    const uint32_t *line = yuv_fetch_line (iter, pixman_fixed_to_int (info->y));
+    int i;
 
-    image->fetch_scanline_float (
-	image, x, y, width, (uint32_t *)buffer, mask);
-    if (image->common.alpha_map)
+    for (i = 0; i < iter->width; ++i)
     {
-	argb_t *alpha;
+	iter->buffer[i] = line[pixman_fixed_to_int (x)];
+	x += ux;
+    }
 
-	if ((alpha = malloc (width * sizeof (argb_t))))
-	{
-	    int i;
+    info->y += iter->image->common.transform->matrix[1][1];
 
-	    x -= image->common.alpha_origin_x;
-	    y -= image->common.alpha_origin_y;
+    return iter->buffer;
+}
 
-	    image->common.alpha_map->fetch_scanline_float (
-		image->common.alpha_map, x, y, width, (uint32_t *)alpha, mask);
+static uint32_t *
+yuv_get_scanline_bilinear (pixman_iter_t *iter, const uint32_t *mask)
+{
+    yuv_info_t *info = iter->data;
+    pixman_fixed_t ux = iter->image->common.transform->matrix[0][0];
+    const uint32_t *top, *bottom;
+    int y1, y2, wt, wb;
+
+    y1 = pixman_fixed_to_int (info->y);
+    wb = pixman_fixed_to_bilinear_weight (info->y);
+    if (wb)
+    {
+	y2 = y1 + 1;
+	wt = BILINEAR_INTERPOLATION_RANGE - wb;
+    }
+    else
+    {
+	y2 = y1;
+	wt = wb = BILINEAR_INTERPOLATION_RANGE / 2;
+    }
 
-	    for (i = 0; i < width; ++i)
-		buffer[i].a = alpha[i].a;
+    top = yuv_fetch_line (iter, y1);
+    bottom = yuv_fetch_line (iter, y2);
 
-	    free (alpha);
-	}
-    }
+    info->kernels->bilinear (iter->buffer, top, bottom, iter->width, wt, wb,
+			     info->x - pixman_int_to_fixed (info->x0), ux);
+
+    info->y += iter->image->common.transform->matrix[1][1];
 
     return iter->buffer;
 }
 
 static void
-dest_write_back_narrow (pixman_iter_t *iter)
+yuv_iter_fini (pixman_iter_t *iter)
 {
-    bits_image_t *  image  = &iter->image->bits;
-    int             x      = iter->x;
-    int             y      = iter->y;
-    int             width  = iter->width;
-    const uint32_t *buffer = iter->buffer;
+    _pixman_scratch_free (iter->data);
+}
 
-    image->store_scanline_32 (image, x, y, width, buffer);
+/* Sets up an iterator for an untransformed or scaled yuy2 or planar YUV
+ * image. The image flags of iter_info tell which filter to use; the
+ * scaled cases require FAST_PATH_X_UNIT_POSITIVE and the matching
+ * FAST_PATH_SAMPLES_COVER_CLIP flag.
+ */
+void
+_pixman_yuv_iter_init (pixman_iter_t              *iter,
+		       const pixman_iter_info_t   *iter_info,
+		       const pixman_yuv_kernels_t *kernels)
+{
+    pixman_image_t *image = iter->image;
+    pixman_bool_t bilinear = iter_info->image_flags & FAST_PATH_BILINEAR_FILTER;
+    pixman_fixed_t ux, last_x;
+    pixman_vector_t v;
+    yuv_info_t *info;
+    int x0, n;
 
-    if (image->common.alpha_map)
+    if (!(iter_info->image_flags & FAST_PATH_SCALE_TRANSFORM))
     {
-	x -= image->common.alpha_origin_x;
-	y -= image->common.alpha_origin_y;
-
-	image->common.alpha_map->store_scanline_32 (
-	    image->common.alpha_map, x, y, width, buffer);
+	iter->data = (void *)kernels;
+	iter->get_scanline = yuv_get_scanline_untransformed;
+	return;
     }
 
-    iter->y++;
-}
+    /* Reference point is the center of the pixel */
+    v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (iter->y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
 
-static float
-dither_factor_blue_noise_64 (int x, int y)
-{
-    float m = dither_blue_noise_64x64[((y & 0x3f) << 6) | (x & 0x3f)];
-    return m * (1. / 4096.f) + (1. / 8192.f);
-}
+    if (!pixman_transform_point_3d (image->common.transform, &v))
+	goto fail;
+
+    if (bilinear)
+    {
+	v.vector[0] -= pixman_fixed_1 / 2;
+	v.vector[1] -= pixman_fixed_1 / 2;
+    }
+    else
+    {
+	v.vector[0] -= pixman_fixed_e;
+	v.vector[1] -= pixman_fixed_e;
+    }
+
+    ux = image->common.transform->matrix[0][0];
+    last_x = v.vector[0] + (iter->width - 1) * (int64_t)ux;
+
+    x0 = pixman_fixed_to_int (v.vector[0]);
+    n = pixman_fixed_to_int (last_x) - x0 + 1;
+    if (bilinear && x0 + n < image->bits.width)
+	n++;
+
+    info = _pixman_scratch_alloc (
+	sizeof (*info) + (2 * (n + 1) - 1) * sizeof (uint32_t));
+    if (!info)
+	goto fail;
+
+    info->kernels = kernels;
+    info->x = v.vector[0];
+    info->y = v.vector[1];
+    info->x0 = x0;
+    info->n = n;
+
+    /* The cover flags ensure that lines are in [0, height) */
+    info->lines[0].y = -1;
+    info->lines[0].buffer = info->data;
+    info->lines[1].y = -1;
+    info->lines[1].buffer = info->data + n + 1;
+
+    iter->data = info;
+    iter->fini = yuv_iter_fini;
+
+    if (bilinear)
+	iter->get_scanline = yuv_get_scanline_bilinear;
+    else
+	iter->get_scanline = yuv_get_scanline_nearest;
+
+    return;
+
+fail:
+    /* Something went wrong, either a bad matrix or OOM; in such cases,
+     * we don't guarantee any particular rendering.
+     */
+    _pixman_log_error (
+	FUNC, "Allocation failure or bad matrix, skipping rendering\n");
+
+    iter->get_scanline = _pixman_iter_get_scanline_noop;
+    iter->fini = NULL;
+}
+
+/* BT.601 limited range keeps the YUV to RGB coefficients that pixman
+ * has always used.
+ */
+const pixman_yuv_coefficients_t _pixman_yuv_coefficients[] =
+{
+    /* PIXMAN_YUV_BT601 */
+    { 16, 0x012b27, 0x019a2e, -0x00647e, -0x00d0f2, 0x0206a2,
+      8414, 16520, 3208, -4857, -9535, 14392, 14392, -12051, -2341 },
+    /* PIXMAN_YUV_BT601_FULL_RANGE */
+    { 0, 65536, 91881, -22553, -46802, 116130,
+      9798, 19234, 3736, -5529, -10855, 16384, 16384, -13720, -2664 },
+    /* PIXMAN_YUV_BT709 */
+    { 16, 76309, 117489, -13975, -34925, 138438,
+      5983, 20127, 2032, -3298, -11094, 14392, 14392, -13072, -1320 },
+    /* PIXMAN_YUV_BT709_FULL_RANGE */
+    { 0, 65536, 103206, -12276, -30679, 121609,
+      6966, 23436, 2366, -3754, -12630, 16384, 16384, -14882, -1502 },
+};
+
+static force_inline int
+yuv_from_8888 (int cr, int cg, int cb, int offset, uint32_t p)
+{
+    int32_t v = cr * (int32_t)((p >> 16) & 0xff) +
+		cg * (int32_t)((p >> 8) & 0xff) +
+		cb * (int32_t)(p & 0xff);
+
+    v = ((v + (1 << 14)) >> 15) + offset;
+
+    return CLIP (v, 0, 255);
+}
+
+/* The planes of a destination go through the accessors, if any */
+static force_inline uint8_t
+yuv_plane_read (bits_image_t *image, const uint8_t *p)
+{
+    return image->read_func ? image->read_func (p, 1) : *p;
+}
+
+static force_inline void
+yuv_plane_write (bits_image_t *image, uint8_t *p, uint8_t v)
+{
+    if (image->write_func)
+	image->write_func (p, v, 1);
+    else
+	*p = v;
+}
+
+/* Writes the luma of p and adds its U and V to chroma[0] and chroma[1] */
+static force_inline void
+yuv_store_pixel (bits_image_t *image, const pixman_yuv_coefficients_t *c,
+		 uint32_t p, uint8_t *luma, uint16_t *chroma)
+{
+    yuv_plane_write (image, luma,
+		     yuv_from_8888 (c->yr, c->yg, c->yb, c->y_offset, p));
+    chroma[0] += yuv_from_8888 (c->ur, c->ug, c->ub, 128, p);
+    chroma[1] += yuv_from_8888 (c->vr, c->vg, c->vb, 128, p);
+}
+
+static void
+yuv_convert_general (bits_image_t *image, int x, int y, int width, uint32_t *buffer)
+{
+    image->fetch_scanline_32 (image, x, y, width, buffer, NULL);
+}
+
+static void
+yuv_store_general (bits_image_t   *image,
+		   const uint32_t *pixels,
+		   int             width,
+		   uint8_t        *luma,
+		   uint16_t       *chroma)
+{
+    const pixman_yuv_coefficients_t *c = YUV_COEFFICIENTS (image);
+    int i;
+
+    for (i = 0; i < width; ++i)
+	yuv_store_pixel (image, c, pixels[i], luma + i, chroma + (i & ~1));
+}
+
+static const pixman_yuv_kernels_t general_yuv_kernels =
+{
+    yuv_convert_general,
+    NULL,
+    yuv_store_general,
+};
+
+/* Destination iterator for planar YUV. Luma is written with each row,
+ * while the chroma of a pair of rows is summed and written with the
+ * second one. Pixels of a chroma block outside of the iterator count
+ * with the chroma that is already stored, and pixels outside of the
+ * image are replaced by their neighbours, so every sum has four terms.
+ */
+typedef struct
+{
+    const pixman_yuv_kernels_t *kernels;
+    int				y0, y_end;
+    int				c0, n;
+    uint16_t *			chroma;
+    uint32_t			pixels[1];
+} yuv_dest_info_t;
+
+static uint32_t *
+yuv_dest_get_scanline (pixman_iter_t *iter, const uint32_t *mask)
+{
+    yuv_dest_info_t *info = iter->data;
+
+    if (iter->iter_flags & ITER_WIDE)
+    {
+	info->kernels->convert (&iter->image->bits, iter->x, iter->y,
+				iter->width, info->pixels);
+	pixman_expand_to_float ((argb_t *)iter->buffer, info->pixels,
+				PIXMAN_a8r8g8b8, iter->width);
+    }
+    else
+    {
+	info->kernels->convert (&iter->image->bits, iter->x, iter->y,
+				iter->width, iter->buffer);
+    }
+
+    return iter->buffer;
+}
+
+/* Adds the stored chroma of columns c0 to c0 + n - 1, times weight */
+static void
+yuv_dest_add_stored (bits_image_t *image, int y, int c0, int n,
+		     int weight, uint16_t *chroma)
+{
+    const uint8_t *u_line = YUV_U_LINE (image, y);
+    const uint8_t *v_line = YUV_V_LINE (image, y);
+    int step = YUV_CHROMA_STEP (image);
+    int i;
+
+    for (i = 0; i < n; ++i)
+    {
+	int offset = (c0 + i) * step;
+
+	chroma[2 * i] += weight * yuv_plane_read (image, u_line + offset);
+	chroma[2 * i + 1] += weight * yuv_plane_read (image, v_line + offset);
+    }
+}
+
+static void
+yuv_dest_write_back (pixman_iter_t *iter)
+{
+    yuv_dest_info_t *info = iter->data;
+    bits_image_t *image = &iter->image->bits;
+    const pixman_yuv_coefficients_t *c = YUV_COEFFICIENTS (image);
+    const uint32_t *pixels = iter->buffer;
+    int x = iter->x;
+    int y = iter->y;
+    int x_end = x + iter->width;
+    uint8_t *luma = YUV_Y_LINE (image, y);
+    uint16_t *chroma = info->chroma;
+    int i, n;
+
+    if (iter->iter_flags & ITER_WIDE)
+    {
+	pixman_contract_from_float (
+	    info->pixels, (argb_t *)iter->buffer, iter->width);
+	pixels = info->pixels;
+    }
+
+    if (!(y & 1) || y == info->y0)
+	memset (chroma, 0, 2 * info->n * sizeof (uint16_t));
+
+    if ((y & 1) && y == info->y0)
+	yuv_dest_add_stored (image, y, info->c0, info->n, 2, chroma);
+
+    if (x & 1)
+    {
+	yuv_store_pixel (image, c, *pixels++, luma + x, chroma);
+	yuv_dest_add_stored (image, y, x >> 1, 1, 1, chroma);
+	chroma += 2;
+	x++;
+    }
+
+    n = (x_end - x) & ~1;
+    if (n)
+    {
+	info->kernels->store (image, pixels, n, luma + x, chroma);
+	pixels += n;
+	chroma += n;
+	x += n;
+    }
+
+    if (x < x_end)
+    {
+	yuv_store_pixel (image, c, *pixels, luma + x, chroma);
+	if (x + 1 < image->width)
+	    yuv_dest_add_stored (image, y, x >> 1, 1, 1, chroma);
+	else
+	    yuv_store_pixel (image, c, *pixels, luma + x, chroma);
+    }
+
+    if ((y & 1) || y + 1 == info->y_end || y + 1 == image->height)
+    {
+	uint8_t *u_line = YUV_U_LINE (image, y);
+	uint8_t *v_line = YUV_V_LINE (image, y);
+	int step = YUV_CHROMA_STEP (image);
+
+	chroma = info->chroma;
+
+	if (!(y & 1))
+	{
+	    if (y + 1 < image->height)
+	    {
+		yuv_dest_add_stored (image, y, info->c0, info->n, 2, chroma);
+	    }
+	    else
+	    {
+		for (i = 0; i < 2 * info->n; ++i)
+		    chroma[i] *= 2;
+	    }
+	}
+
+	for (i = 0; i < info->n; ++i)
+	{
+	    yuv_plane_write (image, u_line + (info->c0 + i) * step,
+			     (chroma[2 * i] + 2) >> 2);
+	    yuv_plane_write (image, v_line + (info->c0 + i) * step,
+			     (chroma[2 * i + 1] + 2) >> 2);
+	}
+    }
+
+    iter->y++;
+}
+
+static void
+yuv_dest_write_back_noop (pixman_iter_t *iter)
+{
+    iter->y++;
+}
+
+void
+_pixman_yuv_dest_iter_init (pixman_iter_t              *iter,
+			    const pixman_yuv_kernels_t *kernels)
+{
+    int c0 = iter->x >> 1;
+    int n = ((iter->x + iter->width + 1) >> 1) - c0;
+    int n_pixels = (iter->iter_flags & ITER_WIDE) ? iter->width : 0;
+    yuv_dest_info_t *info;
+
+    info = _pixman_scratch_alloc (sizeof (*info) +
+				  n_pixels * sizeof (uint32_t) +
+				  2 * n * sizeof (uint16_t));
+    if (!info)
+    {
+	_pixman_log_error (FUNC, "Allocation failure, skipping rendering\n");
+
+	iter->get_scanline = _pixman_iter_get_scanline_noop;
+	iter->write_back = yuv_dest_write_back_noop;
+	iter->fini = NULL;
+	return;
+    }
+
+    info->kernels = kernels;
+    info->y0 = iter->y;
+    info->y_end = iter->y + iter->height;
+    info->c0 = c0;
+    info->n = n;
+    info->chroma = (uint16_t *)(info->pixels + n_pixels);
+
+    iter->data = info;
+    iter->fini = yuv_iter_fini;
+    iter->write_back = yuv_dest_write_back;
+
+    if ((iter->iter_flags & (ITER_IGNORE_RGB | ITER_IGNORE_ALPHA)) ==
+	(ITER_IGNORE_RGB | ITER_IGNORE_ALPHA))
+    {
+	iter->get_scanline = _pixman_iter_get_scanline_noop;
+    }
+    else
+    {
+	iter->get_scanline = yuv_dest_get_scanline;
+    }
+}
+
+/* Builds a mipmap level from the previous one. Each pixel is the average
+ * of the 2x2 pixels it covers, or of 3 rows or columns at the end of odd
+ * sized ones.
+ */
+static pixman_bool_t
+mipmap_reduce (bits_image_t *src, bits_image_t *dest)
+{
+    int src_width = src->width;
+    uint32_t *rows, *d;
+    int x, y, i, j;
+
+    rows = _pixman_scratch_alloc (3 * src_width * sizeof (uint32_t));
+    if (!rows)
+	return FALSE;
+
+    for (y = 0; y < dest->height; ++y)
+    {
+	int n_rows = (y == dest->height - 1) ? src->height - 2 * y : 2;
+
+	for (j = 0; j < n_rows; ++j)
+	{
+	    src->fetch_scanline_32 (
+		src, 0, 2 * y + j, src_width, rows + j * src_width, NULL);
+	}
+
+	d = dest->bits + y * dest->rowstride;
+
+	for (x = 0; x < dest->width; ++x)
+	{
+	    int n_cols = (x == dest->width - 1) ? src_width - 2 * x : 2;
+	    int n = n_rows * n_cols;
+	    uint32_t a = 0, r = 0, g = 0, b = 0;
+
+	    for (j = 0; j < n_rows; ++j)
+	    {
+		const uint32_t *p = rows + j * src_width + 2 * x;
+
+		for (i = 0; i < n_cols; ++i)
+		{
+		    a += p[i] >> 24;
+		    r += (p[i] >> 16) & 0xff;
+		    g += (p[i] >> 8) & 0xff;
+		    b += p[i] & 0xff;
+		}
+	    }
+
+	    d[x] = (((a + n / 2) / n) << 24)	|
+		   (((r + n / 2) / n) << 16)	|
+		   (((g + n / 2) / n) << 8)	|
+		   (((b + n / 2) / n));
+	}
+    }
+
+    _pixman_scratch_free (rows);
+
+    return TRUE;
+}
+
+/* Builds the mipmap levels that are missing for the level and weight
+ * chosen by compute_image_info(), and makes their transforms map the
+ * destination to them the way the image transform maps it to the
+ * image. This must be called before the image is composited.
+ */
+void
+_pixman_bits_image_update_mipmap (bits_image_t *image)
+{
+    mipmap_t *mipmap = image->mipmap;
+    int n_needed = mipmap->level + (mipmap->weight != 0);
+    pixman_transform_t scale, transform;
+    pixman_bool_t changed = FALSE;
+    bits_image_t *src;
+    int i;
+
+    if (!mipmap->valid)
+    {
+	mipmap->n_levels = 0;
+	mipmap->valid = TRUE;
+    }
+
+    while (mipmap->n_levels < n_needed)
+    {
+	i = mipmap->n_levels;
+	src = i == 0 ? image : &mipmap->levels[i - 1]->bits;
+
+	if (!mipmap->levels[i])
+	{
+	    mipmap->levels[i] = pixman_image_create_bits_no_clear (
+		PIXMAN_a8r8g8b8,
+		MAX (src->width / 2, 1), MAX (src->height / 2, 1), NULL, 0);
+
+	    if (!mipmap->levels[i])
+		goto fail;
+
+	    pixman_image_set_filter (
+		mipmap->levels[i], PIXMAN_FILTER_BILINEAR, NULL, 0);
+	    _pixman_image_validate (mipmap->levels[i]);
+	}
+
+	if (!mipmap_reduce (src, &mipmap->levels[i]->bits))
+	    goto fail;
+
+	mipmap->n_levels++;
+	changed = TRUE;
+    }
+
+    if (!changed && mipmap->generation == image->common.generation)
+	return;
+
+    for (i = MAX (mipmap->level - 1, 0); i < n_needed; ++i)
+    {
+	pixman_image_t *level = mipmap->levels[i];
+
+	pixman_transform_init_scale (
+	    &scale,
+	    pixman_double_to_fixed ((double)level->bits.width / image->width),
+	    pixman_double_to_fixed ((double)level->bits.height / image->height));
+
+	if (!pixman_transform_multiply (
+		&transform, &scale, image->common.transform))
+	{
+	    goto fail;
+	}
+
+	pixman_image_set_transform (level, &transform);
+	pixman_image_set_repeat (level, image->common.repeat);
+	_pixman_image_validate (level);
+    }
+
+    mipmap->generation = image->common.generation;
+    return;
+
+fail:
+    mipmap->valid = FALSE;
+}
+
+static uint32_t *
+dest_get_scanline_narrow (pixman_iter_t *iter, const uint32_t *mask)
+{
+    pixman_image_t *image  = iter->image;
+    int             x      = iter->x;
+    int             y      = iter->y;
+    int             width  = iter->width;
+    uint32_t *	    buffer = iter->buffer;
+
+    image->bits.fetch_scanline_32 (&image->bits, x, y, width, buffer, mask);
+    if (image->common.alpha_map)
+    {
+	uint32_t *alpha;
+
+	if ((alpha = _pixman_scratch_alloc (width * sizeof (uint32_t))))
+	{
+	    int i;
+
+	    x -= image->common.alpha_origin_x;
+	    y -= image->common.alpha_origin_y;
+
+	    image->common.alpha_map->fetch_scanline_32 (
+		image->common.alpha_map, x, y, width, alpha, mask);
+
+	    for (i = 0; i < width; ++i)
+	    {
+		buffer[i] &= ~0xff000000;
+		buffer[i] |= (alpha[i] & 0xff000000);
+	    }
+
+	    _pixman_scratch_free (alpha);
+	}
+    }
+
+    return iter->buffer;
+}
+
+static uint32_t *
+dest_get_scanline_wide (pixman_iter_t *iter, const uint32_t *mask)
+{
+    bits_image_t *  image  = &iter->image->bits;
+    int             x      = iter->x;
+    int             y      = iter->y;
+    int             width  = iter->width;
+    argb_t *	    buffer = (argb_t *)iter->buffer;
+
+    image->fetch_scanline_float (
+	image, x, y, width, (uint32_t *)buffer, mask);
+    if (image->common.alpha_map)
+    {
+	argb_t *alpha;
+
+	if ((alpha = _pixman_scratch_alloc (width * sizeof (argb_t))))
+	{
+	    int i;
+
+	    x -= image->common.alpha_origin_x;
+	    y -= image->common.alpha_origin_y;
+
+	    image->common.alpha_map->fetch_scanline_float (
+		image->common.alpha_map, x, y, width, (uint32_t *)alpha, mask);
+
+	    for (i = 0; i < width; ++i)
+		buffer[i].a = alpha[i].a;
+
+	    _pixman_scratch_free (alpha);
+	}
+    }
+
+    return iter->buffer;
+}
+
+static void
+dest_write_back_narrow (pixman_iter_t *iter)
+{
+    bits_image_t *  image  = &iter->image->bits;
+    int             x      = iter->x;
+    int             y      = iter->y;
+    int             width  = iter->width;
+    const uint32_t *buffer = iter->buffer;
+
+    image->store_scanline_32 (image, x, y, width, buffer);
+
+    if (image->common.alpha_map)
+    {
+	x -= image->common.alpha_origin_x;
+	y -= image->common.alpha_origin_y;
+
+	image->common.alpha_map->store_scanline_32 (
+	    image->common.alpha_map, x, y, width, buffer);
+    }
+
+    iter->y++;
+}
+
+static float
+dither_factor_blue_noise_64 (int x, int y)
+{
+    float m = dither_blue_noise_64x64[((y & 0x3f) << 6) | (x & 0x3f)];
+    return m * (1. / 4096.f) + (1. / 8192.f);
+}
 
 static float
 dither_factor_bayer_8 (int x, int y)
@@ -1171,6 +2043,41 @@ dither_apply_ordered (pixman_iter_t *iter, dither_factor_t factor)
     return iter->buffer;
 }
 
+/* Stores the factors of dither_apply_ordered() for the pixels x to
+ * x + width - 1 of scanline y, for the fast paths that dither themselves.
+ */
+void
+_pixman_bits_image_dither_row (bits_image_t *image,
+			       int           x,
+			       int           y,
+			       float        *factors,
+			       int           width)
+{
+    dither_factor_t factor;
+    int i;
+
+    x += image->dither_offset_x;
+    y += image->dither_offset_y;
+
+    switch (image->dither)
+    {
+    case PIXMAN_DITHER_FAST:
+    case PIXMAN_DITHER_ORDERED_BAYER_8:
+	factor = dither_factor_bayer_8;
+	break;
+
+    case PIXMAN_DITHER_GOOD:
+    case PIXMAN_DITHER_BEST:
+    case PIXMAN_DITHER_ORDERED_BLUE_NOISE_64:
+    default:
+	factor = dither_factor_blue_noise_64;
+	break;
+    }
+
+    for (i = 0; i < width; ++i)
+	factors[i] = factor (x + i, y);
+}
+
 static void
 dest_write_back_wide (pixman_iter_t *iter)
 {
@@ -1214,6 +2121,12 @@ dest_write_back_wide (pixman_iter_t *iter)
 void
 _pixman_bits_image_dest_iter_init (pixman_image_t *image, pixman_iter_t *iter)
 {
+    if (PIXMAN_FORMAT_PLANAR (image->bits.format))
+    {
+	_pixman_yuv_dest_iter_init (iter, &general_yuv_kernels);
+	return;
+    }
+
     if (iter->iter_flags & ITER_NARROW)
     {
 	if ((iter->iter_flags & (ITER_IGNORE_RGB | ITER_IGNORE_ALPHA)) ==
@@ -1235,15 +2148,14 @@ _pixman_bits_image_dest_iter_init (pixman_image_t *image, pixman_iter_t *iter)
     }
 }
 
-static uint32_t *
-create_bits (pixman_format_code_t format,
-             int                  width,
-             int                  height,
-             int *		  rowstride_bytes,
-	     pixman_bool_t	  clear)
+static pixman_bool_t
+compute_bits_size (pixman_format_code_t format,
+		   int                  width,
+		   int                  height,
+		   int *		rowstride_bytes,
+		   size_t *		buf_size)
 {
     int stride;
-    size_t buf_size;
     int bpp;
 
     /* what follows is a long-winded way, avoiding any possibility of integer
@@ -1251,13 +2163,33 @@ create_bits (pixman_format_code_t format,
      * stride = ((width * bpp + 0x1f) >> 5) * sizeof (uint32_t);
      */
 
+    /* Planar YUV formats have 8-bit luma rows followed by half as many
+     * rows of chroma. Rows are a multiple of 8 bytes so that the chroma
+     * rows of yv12 are a whole number of uint32_t's.
+     */
+    if (PIXMAN_FORMAT_PLANAR (format))
+    {
+	if (_pixman_addition_overflows_int (width, 7))
+	    return FALSE;
+
+	stride = (width + 7) & ~7;
+
+	if (_pixman_multiply_overflows_size (height + (height + 1) / 2, stride))
+	    return FALSE;
+
+	*buf_size = (size_t)(height + (height + 1) / 2) * stride;
+	*rowstride_bytes = stride;
+
+	return TRUE;
+    }
+
     bpp = PIXMAN_FORMAT_BPP (format);
     if (_pixman_multiply_overflows_int (width, bpp))
-	return NULL;
+	return FALSE;
 
     stride = width * bpp;
     if (_pixman_addition_overflows_int (stride, 0x1f))
-	return NULL;
+	return FALSE;
 
     stride += 0x1f;
     stride >>= 5;
@@ -1265,12 +2197,25 @@ create_bits (pixman_format_code_t format,
     stride *= sizeof (uint32_t);
 
     if (_pixman_multiply_overflows_size (height, stride))
-	return NULL;
+	return FALSE;
 
-    buf_size = (size_t)height * stride;
+    *buf_size = (size_t)height * stride;
+    *rowstride_bytes = stride;
 
-    if (rowstride_bytes)
-	*rowstride_bytes = stride;
+    return TRUE;
+}
+
+static uint32_t *
+create_bits (pixman_format_code_t format,
+             int                  width,
+             int                  height,
+             int *		  rowstride_bytes,
+	     pixman_bool_t	  clear)
+{
+    size_t buf_size;
+
+    if (!compute_bits_size (format, width, height, rowstride_bytes, &buf_size))
+	return NULL;
 
     if (clear)
 	return calloc (buf_size, 1);
@@ -1278,6 +2223,108 @@ create_bits (pixman_format_code_t format,
 	return malloc (buf_size);
 }
 
+/* Locates the planes of a planar YUV image whose planes follow each
+ * other in bits. yv12 keeps its historical layout.
+ */
+static void
+setup_planes (bits_image_t *image)
+{
+    uint8_t *bits = (uint8_t *)image->bits;
+    int stride = image->rowstride * (int) sizeof (uint32_t);
+    int height = image->height;
+
+    image->planes[0] = bits;
+    image->plane_strides[0] = stride;
+
+    if (image->format == PIXMAN_yv12)
+    {
+	int rowstride = image->rowstride;
+	int offset0 = rowstride < 0 ?
+	    ((-rowstride) >> 1) * ((height - 1) >> 1) - rowstride :
+	    rowstride * height;
+	int offset1 = rowstride < 0 ?
+	    offset0 + ((-rowstride) >> 1) * (height >> 1) :
+	    offset0 + (offset0 >> 2);
+
+	image->planes[1] = (uint8_t *)(image->bits + offset1);
+	image->planes[2] = (uint8_t *)(image->bits + offset0);
+	image->plane_strides[1] = (rowstride >> 1) * (int) sizeof (uint32_t);
+	image->plane_strides[2] = image->plane_strides[1];
+    }
+    else if (image->format == PIXMAN_nv12)
+    {
+	image->planes[1] = bits + stride * height;
+	image->planes[2] = image->planes[1] + 1;
+	image->plane_strides[1] = stride;
+	image->plane_strides[2] = stride;
+    }
+    else
+    {
+	image->planes[1] = bits + stride * height;
+	image->planes[2] = image->planes[1] + (stride / 2) * ((height + 1) / 2);
+	image->plane_strides[1] = stride / 2;
+	image->plane_strides[2] = stride / 2;
+    }
+}
+
+/* Extends [*start, *end) by the memory of rows of stride bytes, which
+ * may be negative, from first on.
+ */
+static void
+extend_range (uint8_t **start, uint8_t **end,
+	      uint8_t *first, int stride, int row_bytes, int rows)
+{
+    uint8_t *last, *lo, *hi;
+
+    if (rows <= 0)
+	return;
+
+    last = first + (ptrdiff_t)stride * (rows - 1);
+    lo = MIN (first, last);
+    hi = MAX (first, last) + MAX (abs (stride), row_bytes);
+
+    if (!*start || lo < *start)
+	*start = lo;
+    if (!*end || hi > *end)
+	*end = hi;
+}
+
+static void
+bits_image_range (bits_image_t *image, uint8_t **start, uint8_t **end)
+{
+    int row_bytes = (image->width * PIXMAN_FORMAT_BPP (image->format) + 7) / 8;
+    int i;
+
+    *start = *end = NULL;
+
+    if (PIXMAN_FORMAT_PLANAR (image->format))
+    {
+	for (i = 0; i < 3; ++i)
+	{
+	    extend_range (start, end, image->planes[i],
+			  image->plane_strides[i], image->width,
+			  i ? (image->height + 1) / 2 : image->height);
+	}
+    }
+    else
+    {
+	extend_range (start, end, (uint8_t *)image->bits,
+		      image->rowstride * 4, row_bytes, image->height);
+    }
+}
+
+/* Whether the pixels of two images share any memory */
+pixman_bool_t
+_pixman_bits_image_overlaps (bits_image_t *a, bits_image_t *b)
+{
+    uint8_t *a_start, *a_end, *b_start, *b_end;
+
+    bits_image_range (a, &a_start, &a_end);
+    bits_image_range (b, &b_start, &b_end);
+
+    return a_start < b_end && b_start < a_end;
+}
+
 pixman_bool_t
 _pixman_bits_image_init (pixman_image_t *     image,
                          pixman_format_code_t format,
@@ -1315,10 +2362,15 @@ _pixman_bits_image_init (pixman_image_t *     image,
     image->bits.dither = PIXMAN_DITHER_NONE;
     image->bits.dither_offset_x = 0;
     image->bits.dither_offset_y = 0;
+    image->bits.mipmap = NULL;
     image->bits.read_func = NULL;
     image->bits.write_func = NULL;
     image->bits.rowstride = rowstride;
     image->bits.indexed = NULL;
+    image->bits.yuv_matrix = PIXMAN_YUV_BT601;
+
+    if (PIXMAN_FORMAT_PLANAR (format) && bits)
+	setup_planes (&image->bits);
 
     image->common.property_changed = bits_image_property_changed;
 
@@ -1360,6 +2412,50 @@ create_bits_image_internal (pixman_format_code_t format,
     return image;
 }
 
+static void
+free_scratch_bits (pixman_image_t *image, void *data)
+{
+    _pixman_scratch_free (data);
+}
+
+/* Creates a cleared image whose bits come from the per-thread scratch
+ * arena. The image must be unreffed before the calling function returns.
+ */
+pixman_image_t *
+_pixman_image_create_scratch_bits (pixman_format_code_t format,
+				   int                  width,
+				   int                  height)
+{
+    pixman_image_t *image;
+    int rowstride_bytes;
+    size_t buf_size;
+    uint32_t *bits;
+
+    if (!width || !height)
+	return create_bits_image_internal (format, width, height, NULL, -1, TRUE);
+
+    if (!compute_bits_size (format, width, height, &rowstride_bytes, &buf_size))
+	return NULL;
+
+    if (!(bits = _pixman_scratch_alloc (buf_size)))
+	return NULL;
+
+    memset (bits, 0, buf_size);
+
+    image = create_bits_image_internal (
+	format, width, height, bits, rowstride_bytes, FALSE);
+
+    if (!image)
+    {
+	_pixman_scratch_free (bits);
+	return NULL;
+    }
+
+    pixman_image_set_destroy_function (image, free_scratch_bits, bits);
+
+    return image;
+}
+
 /* If bits is NULL, a buffer will be allocated and initialized to 0 */
 PIXMAN_EXPORT pixman_image_t *
 pixman_image_create_bits (pixman_format_code_t format,
@@ -1384,3 +2480,57 @@ pixman_image_create_bits_no_clear (pixman_format_code_t format,
     return create_bits_image_internal (
 	format, width, height, bits, rowstride_bytes, FALSE);
 }
+
+PIXMAN_EXPORT pixman_image_t *
+pixman_image_create_planar (pixman_format_code_t format,
+			    int                  width,
+			    int                  height,
+			    uint8_t * const *    planes,
+			    const int *          strides)
+{
+    pixman_image_t *image;
+    bits_image_t *bits;
+
+    return_val_if_fail (PIXMAN_FORMAT_PLANAR (format), NULL);
+    return_val_if_fail (
+	planes[0] && planes[1] && (format == PIXMAN_nv12 || planes[2]), NULL);
+
+    image = _pixman_image_allocate ();
+
+    if (!image)
+	return NULL;
+
+    /* The bits and rowstride only describe the luma plane. The planes
+     * that the initialization derives from them are replaced below.
+     */
+    if (!_pixman_bits_image_init (image, format, width, height,
+				  (uint32_t *)planes[0],
+				  strides[0] / (int) sizeof (uint32_t), FALSE))
+    {
+	free (image);
+	return NULL;
+    }
+
+    bits = &image->bits;
+    bits->planes[0] = planes[0];
+    bits->plane_strides[0] = strides[0];
+
+    if (format == PIXMAN_nv12)
+    {
+	bits->planes[1] = planes[1];
+	bits->planes[2] = planes[1] + 1;
+	bits->plane_strides[1] = strides[1];
+	bits->plane_strides[2] = strides[1];
+    }
+    else
+    {
+	int u = format == PIXMAN_yv12 ? 2 : 1;
+
+	bits->planes[1] = planes[u];
+	bits->planes[2] = planes[3 - u];
+	bits->plane_strides[1] = strides[u];
+	bits->plane_strides[2] = strides[3 - u];
+    }
+
+    return image;
+}
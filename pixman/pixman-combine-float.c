@@ -150,23 +150,6 @@ combine_inner (pixman_bool_t component,
 /*
  * Porter/Duff operators
  */
-typedef enum
-{
-    ZERO,
-    ONE,
-    SRC_ALPHA,
-    DEST_ALPHA,
-    INV_SA,
-    INV_DA,
-    SA_OVER_DA,
-    DA_OVER_SA,
-    INV_SA_OVER_DA,
-    INV_DA_OVER_SA,
-    ONE_MINUS_SA_OVER_DA,
-    ONE_MINUS_DA_OVER_SA,
-    ONE_MINUS_INV_DA_OVER_SA,
-    ONE_MINUS_INV_SA_OVER_DA
-} combine_factor_t;
 
 #define CLAMP(f)					\
     (((f) < 0)? 0 : (((f) > 1.0) ? 1.0 : (f)))
@@ -1013,7 +996,7 @@ blend_hsl_luminosity (rgb_t *res,
 		sa *= ma;						\
 		sc.r *= ma;						\
 		sc.g *= ma;						\
-		sc.g *= ma;						\
+		sc.b *= ma;						\
 	    }								\
 									\
 	    blend_ ## name (&rc, &dc, da, &sc, sa);			\
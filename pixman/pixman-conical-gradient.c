@@ -76,7 +76,8 @@ conical_get_scanline (pixman_iter_t                 *iter,
     double ry = y + 0.5;
     double rz = 1.;
 
-    _pixman_gradient_walker_init (&walker, gradient, image->common.repeat);
+    _pixman_gradient_walker_init (&walker, gradient,
+				  image->common.repeat, iter);
 
     if (image->common.transform)
     {
@@ -181,6 +182,61 @@ conical_get_scanline_wide (pixman_iter_t *iter, const uint32_t *mask)
 				 _pixman_gradient_walker_write_wide);
 }
 
+/* Narrow scanlines of affine gradients, with the positions computed by
+ * a kernel of an implementation and looked up in the color ramp
+ */
+static uint32_t *
+conical_get_scanline_kernels (pixman_iter_t *iter, const uint32_t *mask)
+{
+    const pixman_gradient_kernels_t *kernels = iter->data;
+    pixman_image_t *image = iter->image;
+    conical_gradient_t *conical = (conical_gradient_t *)image;
+    int32_t *positions = (int32_t *)iter->buffer;
+    pixman_gradient_walker_t walker;
+    double cx = 1.;
+    double cy = 0.;
+    double rx = iter->x + 0.5;
+    double ry = iter->y + 0.5;
+
+    if (image->common.transform)
+    {
+	pixman_vector_t v;
+
+	v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+	v.vector[1] = pixman_int_to_fixed (iter->y) + pixman_fixed_1 / 2;
+	v.vector[2] = pixman_fixed_1;
+
+	if (!pixman_transform_point_3d (image->common.transform, &v))
+	    return iter->buffer;
+
+	cx = image->common.transform->matrix[0][0] / 65536.;
+	cy = image->common.transform->matrix[1][0] / 65536.;
+
+	rx = v.vector[0] / 65536.;
+	ry = v.vector[1] / 65536.;
+    }
+
+    rx -= conical->center.x / 65536.;
+    ry -= conical->center.y / 65536.;
+
+    kernels->conical (positions, rx, ry, cx, cy, conical->angle, iter->width);
+
+    _pixman_gradient_walker_init (&walker, &image->gradient,
+				  image->common.repeat, iter);
+    kernels->write_narrow (&walker, iter->buffer, positions, iter->width);
+
+    iter->y++;
+    return iter->buffer;
+}
+
+void
+_pixman_conical_gradient_kernel_iter_init (pixman_iter_t                   *iter,
+					   const pixman_gradient_kernels_t *kernels)
+{
+    iter->data = (void *)kernels;
+    iter->get_scanline = conical_get_scanline_kernels;
+}
+
 void
 _pixman_conical_gradient_iter_init (pixman_image_t *image, pixman_iter_t *iter)
 {
@@ -377,6 +377,8 @@ pixman_rasterize_edges (pixman_image_t *image,
 {
     return_if_fail (image->type == BITS);
     return_if_fail (PIXMAN_FORMAT_TYPE (image->bits.format) == PIXMAN_TYPE_A);
+
+    pixman_image_mark_dirty (image);
     
     if (image->bits.read_func || image->bits.write_func)
 	pixman_rasterize_edges_accessors (image, l, r, t, b);
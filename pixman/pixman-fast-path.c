@@ -1185,6 +1185,121 @@ fast_composite_src_memcpy (pixman_implementation_t *imp,
     }
 }
 
+/* Compositing of sRGB images in linear light. The channels are 16 bit
+ * linear values in between instead of the floats of the wide path,
+ * which is enough for the sRGB levels to round trip. Alpha and the
+ * channels of 8888 images are linear already.
+ */
+static force_inline uint32_t
+srgb_expand (uint32_t c, pixman_bool_t srgb)
+{
+    return srgb ? _pixman_srgb_to_linear16[c] : c * 257;
+}
+
+/* An 8888 channel is rounded down, as by pixman_float_to_unorm () */
+static force_inline uint32_t
+srgb_contract (uint32_t v, pixman_bool_t srgb)
+{
+    if (srgb)
+	return pixman_linear_to_srgb (v);
+
+    v = ((v << 8) + (v >> 8)) >> 16;
+
+    return v - (v >> 8);
+}
+
+static force_inline uint32_t
+srgb_convert (uint32_t s, pixman_bool_t src_srgb, pixman_bool_t dest_srgb)
+{
+    uint32_t result = s & 0xff000000;
+    int shift;
+
+    for (shift = 0; shift < 24; shift += 8)
+    {
+	uint32_t v = srgb_expand ((s >> shift) & 0xff, src_srgb);
+
+	result |= srgb_contract (v, dest_srgb) << shift;
+    }
+
+    return result;
+}
+
+static force_inline uint32_t
+srgb_over (uint32_t s, uint32_t d,
+	   pixman_bool_t src_srgb, pixman_bool_t dest_srgb)
+{
+    uint32_t ia = (255 - (s >> 24)) * 257 + 1;
+    uint32_t result = 0;
+    int shift;
+
+    for (shift = 0; shift < 32; shift += 8)
+    {
+	pixman_bool_t alpha = shift == 24;
+	uint32_t v;
+
+	v = srgb_expand ((s >> shift) & 0xff, src_srgb && !alpha) +
+	    ((srgb_expand ((d >> shift) & 0xff, dest_srgb && !alpha) * ia) >> 16);
+
+	result |= srgb_contract (MIN (v, 65535), dest_srgb && !alpha) << shift;
+    }
+
+    return result;
+}
+
+static force_inline void
+srgb_composite (pixman_composite_info_t *info,
+		pixman_bool_t            over,
+		pixman_bool_t            src_srgb,
+		pixman_bool_t            src_x888,
+		pixman_bool_t            dest_srgb)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t    *dst_line, *dst;
+    uint32_t    *src_line, *src, s;
+    int dst_stride, src_stride;
+    int32_t w;
+
+    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+    PIXMAN_IMAGE_GET_LINE (src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    while (height--)
+    {
+	dst = dst_line;
+	dst_line += dst_stride;
+	src = src_line;
+	src_line += src_stride;
+	w = width;
+
+	while (w--)
+	{
+	    s = *src++;
+	    if (src_x888)
+		s |= 0xff000000;
+
+	    if (!over || (s >> 24) == 0xff)
+		*dst = srgb_convert (s, src_srgb, dest_srgb);
+	    else if (s)
+		*dst = srgb_over (s, *dst, src_srgb, dest_srgb);
+	    dst++;
+	}
+    }
+}
+
+#define SRGB_FAST_PATH(name, over, src_srgb, src_x888, dest_srgb)	\
+    static void								\
+    fast_composite_ ## name (pixman_implementation_t *imp,		\
+			     pixman_composite_info_t *info)		\
+    {									\
+	srgb_composite (info, over, src_srgb, src_x888, dest_srgb);	\
+    }
+
+SRGB_FAST_PATH (src_8888_srgb, FALSE, FALSE, FALSE, TRUE)
+SRGB_FAST_PATH (src_x888_srgb, FALSE, FALSE, TRUE, TRUE)
+SRGB_FAST_PATH (src_srgb_8888, FALSE, TRUE, FALSE, FALSE)
+SRGB_FAST_PATH (over_8888_srgb, TRUE, FALSE, FALSE, TRUE)
+SRGB_FAST_PATH (over_srgb_srgb, TRUE, TRUE, FALSE, TRUE)
+SRGB_FAST_PATH (over_srgb_8888, TRUE, TRUE, FALSE, FALSE)
+
 FAST_NEAREST (8888_8888_cover, 8888, 8888, uint32_t, uint32_t, SRC, COVER)
 FAST_NEAREST (8888_8888_none, 8888, 8888, uint32_t, uint32_t, SRC, NONE)
 FAST_NEAREST (8888_8888_pad, 8888, 8888, uint32_t, uint32_t, SRC, PAD)
@@ -1569,252 +1684,73 @@ fast_composite_scaled_nearest (pixman_implementation_t *imp,
     }
 }
 
-#define CACHE_LINE_SIZE 64
-
-#define FAST_SIMPLE_ROTATE(suffix, pix_type)                                  \
-                                                                              \
-static void                                                                   \
-blt_rotated_90_trivial_##suffix (pix_type       *dst,                         \
-				 int             dst_stride,                  \
-				 const pix_type *src,                         \
-				 int             src_stride,                  \
-				 int             w,                           \
-				 int             h)                           \
-{                                                                             \
-    int x, y;                                                                 \
-    for (y = 0; y < h; y++)                                                   \
-    {                                                                         \
-	const pix_type *s = src + (h - y - 1);                                \
-	pix_type *d = dst + dst_stride * y;                                   \
-	for (x = 0; x < w; x++)                                               \
-	{                                                                     \
-	    *d++ = *s;                                                        \
-	    s += src_stride;                                                  \
-	}                                                                     \
-    }                                                                         \
-}                                                                             \
-                                                                              \
-static void                                                                   \
-blt_rotated_270_trivial_##suffix (pix_type       *dst,                        \
-				  int             dst_stride,                 \
-				  const pix_type *src,                        \
-				  int             src_stride,                 \
-				  int             w,                          \
-				  int             h)                          \
-{                                                                             \
-    int x, y;                                                                 \
-    for (y = 0; y < h; y++)                                                   \
-    {                                                                         \
-	const pix_type *s = src + src_stride * (w - 1) + y;                   \
-	pix_type *d = dst + dst_stride * y;                                   \
-	for (x = 0; x < w; x++)                                               \
-	{                                                                     \
-	    *d++ = *s;                                                        \
-	    s -= src_stride;                                                  \
-	}                                                                     \
-    }                                                                         \
-}                                                                             \
-                                                                              \
-static void                                                                   \
-blt_rotated_90_##suffix (pix_type       *dst,                                 \
-			 int             dst_stride,                          \
-			 const pix_type *src,                                 \
-			 int             src_stride,                          \
-			 int             W,                                   \
-			 int             H)                                   \
-{                                                                             \
-    int x;                                                                    \
-    int leading_pixels = 0, trailing_pixels = 0;                              \
-    const int TILE_SIZE = CACHE_LINE_SIZE / sizeof(pix_type);                 \
-                                                                              \
-    /*                                                                        \
-     * split processing into handling destination as TILE_SIZExH cache line   \
-     * aligned vertical stripes (optimistically assuming that destination     \
-     * stride is a multiple of cache line, if not - it will be just a bit     \
-     * slower)                                                                \
-     */                                                                       \
-                                                                              \
-    if ((uintptr_t)dst & (CACHE_LINE_SIZE - 1))                               \
-    {                                                                         \
-	leading_pixels = TILE_SIZE - (((uintptr_t)dst &                       \
-			    (CACHE_LINE_SIZE - 1)) / sizeof(pix_type));       \
-	if (leading_pixels > W)                                               \
-	    leading_pixels = W;                                               \
-                                                                              \
-	/* unaligned leading part NxH (where N < TILE_SIZE) */                \
-	blt_rotated_90_trivial_##suffix (                                     \
-	    dst,                                                              \
-	    dst_stride,                                                       \
-	    src,                                                              \
-	    src_stride,                                                       \
-	    leading_pixels,                                                   \
-	    H);                                                               \
-	                                                                      \
-	dst += leading_pixels;                                                \
-	src += leading_pixels * src_stride;                                   \
-	W -= leading_pixels;                                                  \
-    }                                                                         \
-                                                                              \
-    if ((uintptr_t)(dst + W) & (CACHE_LINE_SIZE - 1))                         \
-    {                                                                         \
-	trailing_pixels = (((uintptr_t)(dst + W) &                            \
-			    (CACHE_LINE_SIZE - 1)) / sizeof(pix_type));       \
-	if (trailing_pixels > W)                                              \
-	    trailing_pixels = W;                                              \
-	W -= trailing_pixels;                                                 \
-    }                                                                         \
-                                                                              \
-    for (x = 0; x < W; x += TILE_SIZE)                                        \
-    {                                                                         \
-	/* aligned middle part TILE_SIZExH */                                 \
-	blt_rotated_90_trivial_##suffix (                                     \
-	    dst + x,                                                          \
-	    dst_stride,                                                       \
-	    src + src_stride * x,                                             \
-	    src_stride,                                                       \
-	    TILE_SIZE,                                                        \
-	    H);                                                               \
-    }                                                                         \
-                                                                              \
-    if (trailing_pixels)                                                      \
-    {                                                                         \
-	/* unaligned trailing part NxH (where N < TILE_SIZE) */               \
-	blt_rotated_90_trivial_##suffix (                                     \
-	    dst + W,                                                          \
-	    dst_stride,                                                       \
-	    src + W * src_stride,                                             \
-	    src_stride,                                                       \
-	    trailing_pixels,                                                  \
-	    H);                                                               \
-    }                                                                         \
-}                                                                             \
-                                                                              \
-static void                                                                   \
-blt_rotated_270_##suffix (pix_type       *dst,                                \
-			  int             dst_stride,                         \
-			  const pix_type *src,                                \
-			  int             src_stride,                         \
-			  int             W,                                  \
-			  int             H)                                  \
-{                                                                             \
-    int x;                                                                    \
-    int leading_pixels = 0, trailing_pixels = 0;                              \
-    const int TILE_SIZE = CACHE_LINE_SIZE / sizeof(pix_type);                 \
-                                                                              \
-    /*                                                                        \
-     * split processing into handling destination as TILE_SIZExH cache line   \
-     * aligned vertical stripes (optimistically assuming that destination     \
-     * stride is a multiple of cache line, if not - it will be just a bit     \
-     * slower)                                                                \
-     */                                                                       \
-                                                                              \
-    if ((uintptr_t)dst & (CACHE_LINE_SIZE - 1))                               \
-    {                                                                         \
-	leading_pixels = TILE_SIZE - (((uintptr_t)dst &                       \
-			    (CACHE_LINE_SIZE - 1)) / sizeof(pix_type));       \
-	if (leading_pixels > W)                                               \
-	    leading_pixels = W;                                               \
-                                                                              \
-	/* unaligned leading part NxH (where N < TILE_SIZE) */                \
-	blt_rotated_270_trivial_##suffix (                                    \
-	    dst,                                                              \
-	    dst_stride,                                                       \
-	    src + src_stride * (W - leading_pixels),                          \
-	    src_stride,                                                       \
-	    leading_pixels,                                                   \
-	    H);                                                               \
-	                                                                      \
-	dst += leading_pixels;                                                \
-	W -= leading_pixels;                                                  \
-    }                                                                         \
-                                                                              \
-    if ((uintptr_t)(dst + W) & (CACHE_LINE_SIZE - 1))                         \
-    {                                                                         \
-	trailing_pixels = (((uintptr_t)(dst + W) &                            \
-			    (CACHE_LINE_SIZE - 1)) / sizeof(pix_type));       \
-	if (trailing_pixels > W)                                              \
-	    trailing_pixels = W;                                              \
-	W -= trailing_pixels;                                                 \
-	src += trailing_pixels * src_stride;                                  \
-    }                                                                         \
-                                                                              \
-    for (x = 0; x < W; x += TILE_SIZE)                                        \
-    {                                                                         \
-	/* aligned middle part TILE_SIZExH */                                 \
-	blt_rotated_270_trivial_##suffix (                                    \
-	    dst + x,                                                          \
-	    dst_stride,                                                       \
-	    src + src_stride * (W - x - TILE_SIZE),                           \
-	    src_stride,                                                       \
-	    TILE_SIZE,                                                        \
-	    H);                                                               \
-    }                                                                         \
-                                                                              \
-    if (trailing_pixels)                                                      \
-    {                                                                         \
-	/* unaligned trailing part NxH (where N < TILE_SIZE) */               \
-	blt_rotated_270_trivial_##suffix (                                    \
-	    dst + W,                                                          \
-	    dst_stride,                                                       \
-	    src - trailing_pixels * src_stride,                               \
-	    src_stride,                                                       \
-	    trailing_pixels,                                                  \
-	    H);                                                               \
-    }                                                                         \
-}                                                                             \
-                                                                              \
-static void                                                                   \
-fast_composite_rotate_90_##suffix (pixman_implementation_t *imp,              \
-				   pixman_composite_info_t *info)	      \
+/* Moves a block of SIMPLE_ROTATE_BLOCK x SIMPLE_ROTATE_BLOCK pixels for
+ * FAST_SIMPLE_ROTATE_BLOCKS() in pixman-inlines.h, one pixel at a time.
+ */
+#define SIMPLE_ROTATE_BLOCK 8
+
+#define FAST_SIMPLE_ROTATE(suffix, pix_type)				      \
+									      \
+static force_inline void						      \
+block_90_##suffix (pix_type       *dst,					      \
+		   int             dst_stride,				      \
+		   const pix_type *src,					      \
+		   int             src_stride)				      \
 {									      \
-    PIXMAN_COMPOSITE_ARGS (info);					      \
-    pix_type       *dst_line;						      \
-    pix_type       *src_line;                                                 \
-    int             dst_stride, src_stride;                                   \
-    int             src_x_t, src_y_t;                                         \
-                                                                              \
-    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, pix_type,              \
-			   dst_stride, dst_line, 1);                          \
-    src_x_t = -src_y + pixman_fixed_to_int (                                  \
-				src_image->common.transform->matrix[0][2] +   \
-				pixman_fixed_1 / 2 - pixman_fixed_e) - height;\
-    src_y_t = src_x + pixman_fixed_to_int (                                   \
-				src_image->common.transform->matrix[1][2] +   \
-				pixman_fixed_1 / 2 - pixman_fixed_e);         \
-    PIXMAN_IMAGE_GET_LINE (src_image, src_x_t, src_y_t, pix_type,             \
-			   src_stride, src_line, 1);                          \
-    blt_rotated_90_##suffix (dst_line, dst_stride, src_line, src_stride,      \
-			     width, height);                                  \
-}                                                                             \
-                                                                              \
-static void                                                                   \
-fast_composite_rotate_270_##suffix (pixman_implementation_t *imp,             \
-				    pixman_composite_info_t *info)            \
-{                                                                             \
-    PIXMAN_COMPOSITE_ARGS (info);					      \
-    pix_type       *dst_line;						      \
-    pix_type       *src_line;                                                 \
-    int             dst_stride, src_stride;                                   \
-    int             src_x_t, src_y_t;                                         \
-                                                                              \
-    PIXMAN_IMAGE_GET_LINE (dest_image, dest_x, dest_y, pix_type,              \
-			   dst_stride, dst_line, 1);                          \
-    src_x_t = src_y + pixman_fixed_to_int (                                   \
-				src_image->common.transform->matrix[0][2] +   \
-				pixman_fixed_1 / 2 - pixman_fixed_e);         \
-    src_y_t = -src_x + pixman_fixed_to_int (                                  \
-				src_image->common.transform->matrix[1][2] +   \
-				pixman_fixed_1 / 2 - pixman_fixed_e) - width; \
-    PIXMAN_IMAGE_GET_LINE (src_image, src_x_t, src_y_t, pix_type,             \
-			   src_stride, src_line, 1);                          \
-    blt_rotated_270_##suffix (dst_line, dst_stride, src_line, src_stride,     \
-			      width, height);                                 \
-}
+    int x, y;								      \
+									      \
+    for (y = 0; y < SIMPLE_ROTATE_BLOCK; y++)				      \
+    {									      \
+	for (x = 0; x < SIMPLE_ROTATE_BLOCK; x++)			      \
+	{								      \
+	    dst[dst_stride * y + x] =					      \
+		src[src_stride * x + SIMPLE_ROTATE_BLOCK - 1 - y];	      \
+	}								      \
+    }									      \
+}									      \
+									      \
+static force_inline void						      \
+block_270_##suffix (pix_type       *dst,				      \
+		    int             dst_stride,				      \
+		    const pix_type *src,				      \
+		    int             src_stride)				      \
+{									      \
+    int x, y;								      \
+									      \
+    for (y = 0; y < SIMPLE_ROTATE_BLOCK; y++)				      \
+    {									      \
+	for (x = 0; x < SIMPLE_ROTATE_BLOCK; x++)			      \
+	{								      \
+	    dst[dst_stride * y + x] =					      \
+		src[src_stride * (SIMPLE_ROTATE_BLOCK - 1 - x) + y];	      \
+	}								      \
+    }									      \
+}									      \
+									      \
+FAST_SIMPLE_ROTATE_BLOCKS (suffix, pix_type, SIMPLE_ROTATE_BLOCK,	      \
+			   block_90_##suffix, block_270_##suffix)
 
 FAST_SIMPLE_ROTATE (8, uint8_t)
 FAST_SIMPLE_ROTATE (565, uint16_t)
 FAST_SIMPLE_ROTATE (8888, uint32_t)
 
+#define FAST_REVERSE_LINE(suffix, pix_type)				\
+static force_inline void						\
+reverse_line_##suffix (pix_type *dst, const pix_type *src, int w)	\
+{									\
+    src += w;								\
+    while (w--)								\
+	*dst++ = *--src;						\
+}
+
+FAST_REVERSE_LINE (8, uint8_t)
+FAST_REVERSE_LINE (565, uint16_t)
+FAST_REVERSE_LINE (8888, uint32_t)
+
+FAST_SIMPLE_FLIP (8, uint8_t, reverse_line_8)
+FAST_SIMPLE_FLIP (565, uint16_t, reverse_line_565)
+FAST_SIMPLE_FLIP (8888, uint32_t, reverse_line_8888)
+
 static const pixman_fast_path_t c_fast_paths[] =
 {
     PIXMAN_STD_FAST_PATH (OVER, solid, a8, r5g6b5, fast_composite_over_n_8_0565),
@@ -1882,6 +1818,26 @@ static const pixman_fast_path_t c_fast_paths[] =
     PIXMAN_STD_FAST_PATH (SRC, a8, null, a8, fast_composite_src_memcpy),
     PIXMAN_STD_FAST_PATH (IN, a8, null, a8, fast_composite_in_8_8),
     PIXMAN_STD_FAST_PATH (IN, solid, a8, a8, fast_composite_in_n_8_8),
+    PIXMAN_SRGB_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8_sRGB, fast_composite_src_8888_srgb),
+    PIXMAN_SRGB_FAST_PATH (SRC, x8r8g8b8, a8r8g8b8_sRGB, fast_composite_src_x888_srgb),
+    PIXMAN_SRGB_FAST_PATH (SRC, a8r8g8b8_sRGB, a8r8g8b8, fast_composite_src_srgb_8888),
+    PIXMAN_SRGB_FAST_PATH (SRC, a8r8g8b8_sRGB, x8r8g8b8, fast_composite_src_srgb_8888),
+    PIXMAN_SRGB_FAST_PATH (SRC, a8r8g8b8_sRGB, a8r8g8b8_sRGB, fast_composite_src_memcpy),
+    PIXMAN_SRGB_FAST_PATH (OVER, a8r8g8b8, a8r8g8b8_sRGB, fast_composite_over_8888_srgb),
+    PIXMAN_SRGB_FAST_PATH (OVER, x8r8g8b8, a8r8g8b8_sRGB, fast_composite_src_x888_srgb),
+    PIXMAN_SRGB_FAST_PATH (OVER, a8r8g8b8_sRGB, a8r8g8b8_sRGB, fast_composite_over_srgb_srgb),
+    PIXMAN_SRGB_FAST_PATH (OVER, a8r8g8b8_sRGB, a8r8g8b8, fast_composite_over_srgb_8888),
+    PIXMAN_SRGB_FAST_PATH (OVER, a8r8g8b8_sRGB, x8r8g8b8, fast_composite_over_srgb_8888),
+
+    SIMPLE_FLIP_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, 8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, 8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, 8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, 8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, 8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, 8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, r5g6b5, r5g6b5, 565),
+    SIMPLE_FLIP_FAST_PATH (SRC, b5g6r5, b5g6r5, 565),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8, a8, 8),
 
     SIMPLE_NEAREST_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, 8888_8888),
     SIMPLE_NEAREST_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, 8888_8888),
@@ -1938,30 +1894,14 @@ static const pixman_fast_path_t c_fast_paths[] =
     NEAREST_FAST_PATH (OVER, x8b8g8r8, a8b8g8r8),
     NEAREST_FAST_PATH (OVER, a8b8g8r8, a8b8g8r8),
 
-#define SIMPLE_ROTATE_FLAGS(angle)					  \
-    (FAST_PATH_ROTATE_ ## angle ## _TRANSFORM	|			  \
-     FAST_PATH_NEAREST_FILTER			|			  \
-     FAST_PATH_SAMPLES_COVER_CLIP_NEAREST	|			  \
-     FAST_PATH_STANDARD_FLAGS)
-
-#define SIMPLE_ROTATE_FAST_PATH(op,s,d,suffix)				  \
-    {   PIXMAN_OP_ ## op,						  \
-	PIXMAN_ ## s, SIMPLE_ROTATE_FLAGS (90),				  \
-	PIXMAN_null, 0,							  \
-	PIXMAN_ ## d, FAST_PATH_STD_DEST_FLAGS,				  \
-	fast_composite_rotate_90_##suffix,				  \
-    },									  \
-    {   PIXMAN_OP_ ## op,						  \
-	PIXMAN_ ## s, SIMPLE_ROTATE_FLAGS (270),			  \
-	PIXMAN_null, 0,							  \
-	PIXMAN_ ## d, FAST_PATH_STD_DEST_FLAGS,				  \
-	fast_composite_rotate_270_##suffix,				  \
-    }
-
     SIMPLE_ROTATE_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, 8888),
     SIMPLE_ROTATE_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, 8888),
     SIMPLE_ROTATE_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, 8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, 8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, 8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, 8888),
     SIMPLE_ROTATE_FAST_PATH (SRC, r5g6b5, r5g6b5, 565),
+    SIMPLE_ROTATE_FAST_PATH (SRC, b5g6r5, b5g6r5, 565),
     SIMPLE_ROTATE_FAST_PATH (SRC, a8, a8, 8),
 
     /* Simple repeat fast path entry. */
@@ -2435,7 +2375,7 @@ fast_fetch_bilinear_cover (pixman_iter_t *iter, const uint32_t *mask)
 static void
 bilinear_cover_iter_fini (pixman_iter_t *iter)
 {
-    free (iter->data);
+    _pixman_scratch_free (iter->data);
 }
 
 static void
@@ -2453,7 +2393,8 @@ fast_bilinear_cover_iter_init (pixman_iter_t *iter, const pixman_iter_info_t *it
     if (!pixman_transform_point_3d (iter->image->common.transform, &v))
 	goto fail;
 
-    info = malloc (sizeof (*info) + (2 * width - 1) * sizeof (uint64_t));
+    info = _pixman_scratch_alloc (
+	sizeof (*info) + (2 * width - 1) * sizeof (uint64_t));
     if (!info)
 	goto fail;
 
@@ -2747,7 +2688,7 @@ bits_image_fetch_separable_convolution_affine (pixman_image_t * image,
     for (k = 0; k < width; ++k)
     {
 	pixman_fixed_t *y_params;
-	int satot, srtot, sgtot, sbtot;
+	int64_t satot, srtot, sgtot, sbtot;
 	pixman_fixed_t x, y;
 	int32_t x1, x2, y1, y2;
 	int32_t px, py;
@@ -2783,6 +2724,9 @@ bits_image_fetch_separable_convolution_affine (pixman_image_t * image,
 	    if (fy)
 	    {
 		pixman_fixed_t *x_params = params + 4 + px * cwidth;
+		uint32_t sa, sr, sg, sb;
+
+		sa = sr = sg = sb = 0;
 
 		for (j = x1; j < x2; ++j)
 		{
@@ -2792,7 +2736,6 @@ bits_image_fetch_separable_convolution_affine (pixman_image_t * image,
 		    
 		    if (fx)
 		    {
-			pixman_fixed_t f;
 			uint32_t pixel, mask;
 			uint8_t *row;
 
@@ -2819,27 +2762,24 @@ bits_image_fetch_separable_convolution_affine (pixman_image_t * image,
 			    }
 			}
 
-			f = ((pixman_fixed_32_32_t)fx * fy + 0x8000) >> 16;
-			srtot += (int)RED_8 (pixel) * f;
-			sgtot += (int)GREEN_8 (pixel) * f;
-			sbtot += (int)BLUE_8 (pixel) * f;
-			satot += (int)ALPHA_8 (pixel) * f;
+			sr += RED_8 (pixel) * (uint32_t)fx;
+			sg += GREEN_8 (pixel) * (uint32_t)fx;
+			sb += BLUE_8 (pixel) * (uint32_t)fx;
+			sa += ALPHA_8 (pixel) * (uint32_t)fx;
 		    }
 		}
+
+		srtot += (int64_t)(int32_t)sr * fy;
+		sgtot += (int64_t)(int32_t)sg * fy;
+		sbtot += (int64_t)(int32_t)sb * fy;
+		satot += (int64_t)(int32_t)sa * fy;
 	    }
 	}
 
-	satot = (satot + 0x8000) >> 16;
-	srtot = (srtot + 0x8000) >> 16;
-	sgtot = (sgtot + 0x8000) >> 16;
-	sbtot = (sbtot + 0x8000) >> 16;
-
-	satot = CLIP (satot, 0, 0xff);
-	srtot = CLIP (srtot, 0, 0xff);
-	sgtot = CLIP (sgtot, 0, 0xff);
-	sbtot = CLIP (sbtot, 0, 0xff);
-
-	buffer[k] = (satot << 24) | (srtot << 16) | (sgtot << 8) | (sbtot << 0);
+	buffer[k] = ((separable_convolution_reduce (satot) << 24)	|
+		     (separable_convolution_reduce (srtot) << 16)	|
+		     (separable_convolution_reduce (sgtot) << 8)	|
+		     (separable_convolution_reduce (sbtot)));
 
     next:
 	vx += ux;
@@ -3167,6 +3107,461 @@ MAKE_FETCHERS (none_r5g6b5,      r5g6b5,   PIXMAN_REPEAT_NONE)
 MAKE_FETCHERS (reflect_r5g6b5,   r5g6b5,   PIXMAN_REPEAT_REFLECT)
 MAKE_FETCHERS (normal_r5g6b5,    r5g6b5,   PIXMAN_REPEAT_NORMAL)
 
+/* Separable convolution of scaled images */
+
+typedef struct
+{
+    pixman_convolve_row_t	convolve_row;
+    pixman_convolve_column_t	convolve_column;
+
+    int			n_taps;		/* cwidth rounded up to even */
+    int			cheight;
+    int			y_phase_bits;
+    pixman_fixed_t	y_off;
+    const pixman_fixed_t *y_weights;
+
+    /* Source pixels needed by a row, and where they come from */
+    int			span_x;
+    int			span_width;
+    const int32_t *	span_map;	/* Source column, or -1 for zero */
+    int			fetch_x;
+    int			fetch_width;
+    uint32_t *		fetch_buffer;
+    uint32_t *		span;
+    pixman_bool_t	direct;
+
+    const int32_t *	offsets;
+    const int16_t **	x_weights;
+
+    /* Ring of filtered source rows */
+    int			row_stride;
+    int32_t *		rows;
+    int *		row_y;
+
+    const int32_t **	active_rows;
+    pixman_fixed_t *	active_weights;
+} convolution_info_t;
+
+#define CONVOLUTION_ALIGN(p)						\
+    ((void *)((((uintptr_t)(p)) + 31) & ~(uintptr_t)31))
+
+static const int32_t *
+convolution_get_row (pixman_iter_t *iter, convolution_info_t *info, int y)
+{
+    bits_image_t *image = &iter->image->bits;
+    int slot = y % info->cheight;
+    int32_t *row;
+    const uint32_t *span;
+    int i;
+
+    if (slot < 0)
+	slot += info->cheight;
+
+    row = info->rows + slot * info->row_stride;
+
+    if (info->row_y[slot] == y)
+	return row;
+
+    info->row_y[slot] = y;
+
+    if (image->common.repeat == PIXMAN_REPEAT_NONE)
+    {
+	if (y < 0 || y >= image->height)
+	{
+	    memset (row, 0, info->row_stride * sizeof (int32_t));
+	    return row;
+	}
+    }
+    else
+    {
+	repeat (image->common.repeat, &y, image->height);
+    }
+
+    if (info->direct)
+    {
+	span = image->bits + y * image->rowstride + info->span_x;
+    }
+    else
+    {
+	if (info->fetch_width)
+	{
+	    image->fetch_scanline_32 (image, info->fetch_x, y, info->fetch_width,
+				      info->fetch_buffer, NULL);
+	}
+
+	for (i = 0; i < info->span_width; ++i)
+	{
+	    int32_t x = info->span_map[i];
+
+	    info->span[i] = x < 0 ? 0 : info->fetch_buffer[x - info->fetch_x];
+	}
+
+	span = info->span;
+    }
+
+    info->convolve_row (row, span, info->offsets, info->x_weights,
+			info->n_taps, iter->width);
+
+    return row;
+}
+
+static uint32_t *
+fetch_separable_convolution (pixman_iter_t *iter, const uint32_t *mask)
+{
+    convolution_info_t *info = iter->data;
+    const pixman_fixed_t *y_weights;
+    int y_phase_shift = 16 - info->y_phase_bits;
+    pixman_vector_t v;
+    pixman_fixed_t y;
+    int y1, py, i, n;
+
+    v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (iter->y++) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    if (!pixman_transform_point_3d (iter->image->common.transform, &v))
+	return iter->buffer;
+
+    y = v.vector[1];
+    y = ((y >> y_phase_shift) << y_phase_shift) + ((1 << y_phase_shift) >> 1);
+    py = (y & 0xffff) >> y_phase_shift;
+    y1 = pixman_fixed_to_int (y - pixman_fixed_e - info->y_off);
+
+    y_weights = info->y_weights + py * info->cheight;
+
+    /* Rows with a zero weight contribute nothing, so they are not
+     * filtered at all
+     */
+    n = 0;
+    for (i = 0; i < info->cheight; ++i)
+    {
+	if (y_weights[i])
+	{
+	    info->active_rows[n] = convolution_get_row (iter, info, y1 + i);
+	    info->active_weights[n] = y_weights[i];
+	    n++;
+	}
+    }
+
+    info->convolve_column (iter->buffer, info->active_rows,
+			   info->active_weights, n, iter->width);
+
+    return iter->buffer;
+}
+
+/* Returns the first source column of the kernel at x, after rounding x
+ * to the middle of its phase like the other separable convolution code
+ */
+static force_inline int
+convolution_first_column (pixman_fixed_t x, int phase_shift, int off)
+{
+    x = ((x >> phase_shift) << phase_shift) + ((1 << phase_shift) >> 1);
+
+    return pixman_fixed_to_int (x - pixman_fixed_e - off);
+}
+
+/* Returns the source column that supplies pixel x of a row, or -1 if
+ * the pixel is zero
+ */
+static force_inline int
+convolution_source_column (bits_image_t *image, int x)
+{
+    if (image->common.repeat == PIXMAN_REPEAT_NONE)
+	return (x < 0 || x >= image->width) ? -1 : x;
+
+    repeat (image->common.repeat, &x, image->width);
+
+    return x;
+}
+
+/* The SIMD filters split x weights in 16 bit halves and sum columns in
+ * doubles. Both are exact as long as the weights of each phase add up to
+ * less than 64 in absolute value, which keeps row sums below 2^30 and
+ * column sums below 2^52.
+ */
+static pixman_bool_t
+convolution_weights_fit (const pixman_fixed_t *weights, int n_phases, int n)
+{
+    int i, j;
+
+    for (i = 0; i < n_phases; ++i)
+    {
+	int64_t sum = 0;
+
+	for (j = 0; j < n; ++j)
+	{
+	    int64_t w = *weights++;
+
+	    sum += w < 0 ? -w : w;
+	}
+
+	if (sum >= pixman_int_to_fixed (64))
+	    return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void
+separable_convolution_iter_fini (pixman_iter_t *iter)
+{
+    _pixman_scratch_free (iter->data);
+}
+
+void
+_pixman_separable_convolution_iter_init (pixman_iter_t            *iter,
+					 pixman_convolve_row_t     convolve_row,
+					 pixman_convolve_column_t  convolve_column)
+{
+    bits_image_t *image = &iter->image->bits;
+    pixman_fixed_t *params = image->common.filter_params;
+    int cwidth = pixman_fixed_to_int (params[0]);
+    int cheight = pixman_fixed_to_int (params[1]);
+    int x_phase_bits = pixman_fixed_to_int (params[2]);
+    int y_phase_bits = pixman_fixed_to_int (params[3]);
+    int x_phase_shift = 16 - x_phase_bits;
+    int x_off = ((cwidth << 16) - pixman_fixed_1) >> 1;
+    int n_taps = (cwidth + 1) & ~1;
+    int width = iter->width;
+    const pixman_fixed_t *y_params =
+	params + 4 + (1 << x_phase_bits) * cwidth;
+    convolution_info_t *info;
+    int16_t *x_weights;
+    int32_t *offsets, *span_map;
+    int x_min, x_max, fetch_x, fetch_max, fetch_width;
+    int span_width, row_stride;
+    size_t size;
+    pixman_vector_t v;
+    pixman_fixed_t vx, ux;
+    uint8_t *p;
+    int i, j, k;
+
+    v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (iter->y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    if (width <= 0 || !pixman_transform_point_3d (image->common.transform, &v))
+	goto fallback;
+
+    if (!convolution_weights_fit (params + 4, 1 << x_phase_bits, cwidth) ||
+	!convolution_weights_fit (y_params, 1 << y_phase_bits, cheight))
+    {
+	goto fallback;
+    }
+
+    ux = image->common.transform->matrix[0][0];
+
+    /* The scale is constant, so the first and the last pixel cover the
+     * ends of the span of source columns
+     */
+    x_min = convolution_first_column (
+	v.vector[0], x_phase_shift, x_off);
+    x_max = convolution_first_column (
+	v.vector[0] + (width - 1) * ux, x_phase_shift, x_off);
+
+    if (x_min > x_max)
+    {
+	int t = x_min;
+
+	x_min = x_max;
+	x_max = t;
+    }
+
+    span_width = x_max - x_min + n_taps;
+
+    fetch_x = image->width;
+    fetch_max = -1;
+    for (i = 0; i < span_width; ++i)
+    {
+	int x = convolution_source_column (image, x_min + i);
+
+	if (x >= 0 && x < fetch_x)
+	    fetch_x = x;
+	if (x > fetch_max)
+	    fetch_max = x;
+    }
+
+    fetch_width = fetch_max >= fetch_x ? fetch_max - fetch_x + 1 : 0;
+    row_stride = ((width + 3) & ~3) * 4;
+
+    size = 32 * 11 +
+	sizeof (convolution_info_t) +
+	(1 << x_phase_bits) * 2 * n_taps * sizeof (int16_t) +
+	width * (sizeof (int32_t) + sizeof (int16_t *)) +
+	(size_t)span_width * (sizeof (int32_t) + sizeof (uint32_t)) +
+	(size_t)fetch_width * sizeof (uint32_t) +
+	(size_t)cheight * (row_stride * sizeof (int32_t) + sizeof (int) +
+			   sizeof (int32_t *) + sizeof (pixman_fixed_t));
+
+    if (!(info = _pixman_scratch_alloc (size)))
+	goto fallback;
+
+    info->convolve_row = convolve_row;
+    info->convolve_column = convolve_column;
+    info->n_taps = n_taps;
+    info->cheight = cheight;
+    info->y_phase_bits = y_phase_bits;
+    info->y_off = ((cheight << 16) - pixman_fixed_1) >> 1;
+    info->y_weights = y_params;
+    info->span_x = x_min;
+    info->span_width = span_width;
+    info->fetch_x = fetch_x;
+    info->fetch_width = fetch_width;
+    info->row_stride = row_stride;
+
+    p = (uint8_t *)(info + 1);
+
+    info->rows = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(info->rows + cheight * row_stride);
+
+    x_weights = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(x_weights + (1 << x_phase_bits) * 2 * n_taps);
+
+    info->offsets = offsets = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(offsets + width);
+
+    info->x_weights = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(info->x_weights + width);
+
+    info->span_map = span_map = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(span_map + span_width);
+
+    info->span = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(info->span + span_width);
+
+    info->fetch_buffer = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(info->fetch_buffer + fetch_width);
+
+    info->row_y = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(info->row_y + cheight);
+
+    info->active_rows = CONVOLUTION_ALIGN (p);
+    p = (uint8_t *)(info->active_rows + cheight);
+
+    info->active_weights = CONVOLUTION_ALIGN (p);
+
+    for (i = 0; i < (1 << x_phase_bits); ++i)
+    {
+	int16_t *w = x_weights + i * 2 * n_taps;
+
+	for (j = 0; j < n_taps; ++j)
+	{
+	    pixman_fixed_t f = j < cwidth ? params[4 + i * cwidth + j] : 0;
+
+	    w[2 * (j & ~1) + (j & 1)] = f >> 8;
+	    w[2 * (j & ~1) + (j & 1) + 2] = f & 0xff;
+	}
+    }
+
+    vx = v.vector[0];
+    for (k = 0; k < width; ++k)
+    {
+	int px = (vx & 0xffff) >> x_phase_shift;
+
+	offsets[k] = convolution_first_column (vx, x_phase_shift, x_off) - x_min;
+	info->x_weights[k] = x_weights + px * 2 * n_taps;
+
+	vx += ux;
+    }
+
+    for (i = 0; i < span_width; ++i)
+	span_map[i] = convolution_source_column (image, x_min + i);
+
+    /* When the span is inside an a8r8g8b8 image, rows are filtered
+     * straight from the image
+     */
+    info->direct = (image->format == PIXMAN_a8r8g8b8	&&
+		    x_min >= 0					&&
+		    x_max + n_taps <= image->width);
+
+    for (i = 0; i < cheight; ++i)
+	info->row_y[i] = INT32_MIN;
+
+    iter->data = info;
+    iter->get_scanline = fetch_separable_convolution;
+    iter->fini = separable_convolution_iter_fini;
+    return;
+
+fallback:
+    _pixman_bits_image_src_iter_init (iter->image, iter);
+}
+
+static void
+convolve_row (int32_t         *dest,
+	      const uint32_t  *src,
+	      const int32_t   *offsets,
+	      const int16_t  **weights,
+	      int              n_taps,
+	      int              width)
+{
+    int i, k;
+
+    for (k = 0; k < width; ++k)
+    {
+	const uint32_t *s = src + offsets[k];
+	const int16_t *w = weights[k];
+	int32_t s0, s1, s2, s3;
+
+	s0 = s1 = s2 = s3 = 0;
+
+	for (i = 0; i < n_taps; ++i)
+	{
+	    const int16_t *h = w + 2 * (i & ~1) + (i & 1);
+	    int32_t f = h[0] * 256 + h[2];
+	    uint32_t p = s[i];
+
+	    s0 += (int32_t)(p & 0xff) * f;
+	    s1 += (int32_t)((p >> 8) & 0xff) * f;
+	    s2 += (int32_t)((p >> 16) & 0xff) * f;
+	    s3 += (int32_t)(p >> 24) * f;
+	}
+
+	dest[4 * k + 0] = s0;
+	dest[4 * k + 1] = s1;
+	dest[4 * k + 2] = s2;
+	dest[4 * k + 3] = s3;
+    }
+}
+
+static void
+convolve_column (uint32_t              *dest,
+		 const int32_t        **rows,
+		 const pixman_fixed_t  *weights,
+		 int                    n_rows,
+		 int                    width)
+{
+    int i, k;
+
+    for (k = 0; k < 4 * width; k += 4)
+    {
+	int64_t s0, s1, s2, s3;
+
+	s0 = s1 = s2 = s3 = 0;
+
+	for (i = 0; i < n_rows; ++i)
+	{
+	    const int32_t *r = rows[i] + k;
+
+	    s0 += (int64_t)r[0] * weights[i];
+	    s1 += (int64_t)r[1] * weights[i];
+	    s2 += (int64_t)r[2] * weights[i];
+	    s3 += (int64_t)r[3] * weights[i];
+	}
+
+	*dest++ = ((separable_convolution_reduce (s0))		|
+		   (separable_convolution_reduce (s1) << 8)	|
+		   (separable_convolution_reduce (s2) << 16)	|
+		   (separable_convolution_reduce (s3) << 24));
+    }
+}
+
+static void
+fast_separable_convolution_iter_init (pixman_iter_t *iter,
+				      const pixman_iter_info_t *iter_info)
+{
+    _pixman_separable_convolution_iter_init (iter, convolve_row, convolve_column);
+}
+
 #define IMAGE_FLAGS							\
     (FAST_PATH_STANDARD_FLAGS | FAST_PATH_ID_TRANSFORM |		\
      FAST_PATH_BITS_IMAGE | FAST_PATH_SAMPLES_COVER_CLIP_NEAREST)
@@ -3196,6 +3591,13 @@ static const pixman_iter_info_t fast_iters[] =
       NULL, NULL
     },
 
+    { PIXMAN_any,
+      SEPARABLE_CONVOLUTION_SCALE_FLAGS,
+      ITER_NARROW | ITER_SRC,
+      fast_separable_convolution_iter_init,
+      NULL, NULL
+    },
+
 #define FAST_BILINEAR_FLAGS						\
     (FAST_PATH_NO_ALPHA_MAP		|				\
      FAST_PATH_NO_ACCESSORS		|				\
@@ -3290,6 +3692,8 @@ _pixman_implementation_create_fast_path (pixman_implementation_t *fallback)
 {
     pixman_implementation_t *imp = _pixman_implementation_create (fallback, c_fast_paths);
 
+    imp->name = "fast";
+
     imp->fill = fast_path_fill;
     imp->iter_info = fast_iters;
 
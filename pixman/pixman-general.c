@@ -126,6 +126,29 @@ operator_needs_division (pixman_op_t op)
     return needs_division[op];
 }
 
+/* When the transform of a source maps a destination row across several
+ * source rows, as a rotation does, running each row for the full width
+ * touches a new set of cache lines on every scanline. For those sources
+ * the rectangle is composited in square tiles instead, so that the
+ * source pixels of a tile stay in the cache.
+ */
+#define TILE_SIZE 64
+
+static pixman_bool_t
+crosses_rows (pixman_image_t *image, uint32_t flags)
+{
+    return image &&
+	(flags & (FAST_PATH_BITS_IMAGE | FAST_PATH_Y_UNIT_ZERO)) ==
+	FAST_PATH_BITS_IMAGE;
+}
+
+static pixman_bool_t
+overlaps_dest (pixman_image_t *image, pixman_image_t *dest_image)
+{
+    return image && image->type == BITS &&
+	_pixman_bits_image_overlaps (&image->bits, &dest_image->bits);
+}
+
 static void
 general_composite_rect  (pixman_implementation_t *imp,
                          pixman_composite_info_t *info)
@@ -137,7 +160,8 @@ general_composite_rect  (pixman_implementation_t *imp,
     pixman_iter_t src_iter, mask_iter, dest_iter;
     pixman_combine_32_func_t compose;
     pixman_bool_t component_alpha;
-    iter_flags_t width_flag, src_iter_flags;
+    iter_flags_t width_flag, src_iter_flags, mask_iter_flags;
+    int tile_width, tile_height, x, y, w, h;
     int Bpp;
     int i;
 
@@ -162,41 +186,40 @@ general_composite_rect  (pixman_implementation_t *imp,
     if (width <= 0 || _pixman_multiply_overflows_int (width, Bpp * 3))
 	return;
 
-    if (width * Bpp * 3 > sizeof (stack_scanline_buffer) - 15 * 3)
+    tile_width = width;
+    tile_height = height;
+
+    /* Tiles are not used when the source or mask shares memory with
+     * the destination, because a tile could read pixels that the tile to
+     * its left has already written. Nor are they for planar YUV
+     * destinations, where a chroma sample covers two rows and two
+     * columns, which must be written by the same iterator.
+     */
+    if ((crosses_rows (src_image, info->src_flags)	||
+	 crosses_rows (mask_image, info->mask_flags))	&&
+	!overlaps_dest (src_image, dest_image)		&&
+	!overlaps_dest (mask_image, dest_image)		&&
+	!PIXMAN_FORMAT_PLANAR (dest_image->bits.format))
+    {
+	tile_width = MIN (width, TILE_SIZE);
+	tile_height = TILE_SIZE;
+    }
+
+    if (tile_width * Bpp * 3 > sizeof (stack_scanline_buffer) - 15 * 3)
     {
-	scanline_buffer = pixman_malloc_ab_plus_c (width, Bpp * 3, 15 * 3);
+	scanline_buffer = _pixman_scratch_alloc (
+	    (size_t)tile_width * Bpp * 3 + 15 * 3);
 
 	if (!scanline_buffer)
 	    return;
-
-	memset (scanline_buffer, 0, width * Bpp * 3 + 15 * 3);
-    }
-    else
-    {
-	memset (stack_scanline_buffer, 0, sizeof (stack_scanline_buffer));
     }
 
     src_buffer = ALIGN (scanline_buffer);
-    mask_buffer = ALIGN (src_buffer + width * Bpp);
-    dest_buffer = ALIGN (mask_buffer + width * Bpp);
+    mask_buffer = ALIGN (src_buffer + tile_width * Bpp);
+    dest_buffer = ALIGN (mask_buffer + tile_width * Bpp);
 
-    if (width_flag == ITER_WIDE)
-    {
-	/* To make sure there aren't any NANs in the buffers */
-	memset (src_buffer, 0, width * Bpp);
-	memset (mask_buffer, 0, width * Bpp);
-	memset (dest_buffer, 0, width * Bpp);
-    }
-    
-    /* src iter */
     src_iter_flags = width_flag | op_flags[op].src | ITER_SRC;
 
-    _pixman_implementation_iter_init (imp->toplevel, &src_iter, src_image,
-                                      src_x, src_y, width, height,
-                                      src_buffer, src_iter_flags,
-                                      info->src_flags);
-
-    /* mask iter */
     if ((src_iter_flags & (ITER_IGNORE_ALPHA | ITER_IGNORE_RGB)) ==
 	(ITER_IGNORE_ALPHA | ITER_IGNORE_RGB))
     {
@@ -206,44 +229,84 @@ general_composite_rect  (pixman_implementation_t *imp,
 	mask_image = NULL;
     }
 
-    component_alpha = mask_image && mask_image->common.component_alpha;
+    /* Fetchers skip the pixels where the mask is zero, and iterators
+     * whose values don't matter leave their buffer alone. Those pixels
+     * still go through the combiner, so their buffers are cleared once,
+     * which for wide formats makes sure there aren't any NANs in them.
+     * Other buffers are completely written before each use.
+     */
+    if (mask_image ||
+	(src_iter_flags & (ITER_IGNORE_ALPHA | ITER_IGNORE_RGB)) ==
+	(ITER_IGNORE_ALPHA | ITER_IGNORE_RGB))
+    {
+	memset (src_buffer, 0, tile_width * Bpp);
+    }
+
+    if ((op_flags[op].dst & (ITER_IGNORE_ALPHA | ITER_IGNORE_RGB)) ==
+	(ITER_IGNORE_ALPHA | ITER_IGNORE_RGB))
+    {
+	memset (dest_buffer, 0, tile_width * Bpp);
+    }
 
-    _pixman_implementation_iter_init (
-	imp->toplevel, &mask_iter,
-	mask_image, mask_x, mask_y, width, height, mask_buffer,
-	ITER_SRC | width_flag | (component_alpha? 0 : ITER_IGNORE_RGB),
-	info->mask_flags);
+    component_alpha = mask_image && mask_image->common.component_alpha;
 
-    /* dest iter */
-    _pixman_implementation_iter_init (
-	imp->toplevel, &dest_iter, dest_image, dest_x, dest_y, width, height,
-	dest_buffer, ITER_DEST | width_flag | op_flags[op].dst, info->dest_flags);
+    mask_iter_flags =
+	ITER_SRC | width_flag | (component_alpha? 0 : ITER_IGNORE_RGB);
 
     compose = _pixman_implementation_lookup_combiner (
 	imp->toplevel, op, component_alpha, width_flag != ITER_WIDE);
 
-    for (i = 0; i < height; ++i)
+    for (y = 0; y < height; y += tile_height)
     {
-	uint32_t *s, *m, *d;
-
-	m = mask_iter.get_scanline (&mask_iter, NULL);
-	s = src_iter.get_scanline (&src_iter, m);
-	d = dest_iter.get_scanline (&dest_iter, NULL);
-
-	compose (imp->toplevel, op, d, s, m, width);
-
-	dest_iter.write_back (&dest_iter);
+	h = height - y;
+	if (h > tile_height)
+	    h = tile_height;
+
+	for (x = 0; x < width; x += tile_width)
+	{
+	    w = width - x;
+	    if (w > tile_width)
+		w = tile_width;
+
+	    _pixman_implementation_iter_init (
+		imp->toplevel, &src_iter, src_image,
+		src_x + x, src_y + y, w, h, src_buffer, src_iter_flags,
+		info->src_flags);
+
+	    _pixman_implementation_iter_init (
+		imp->toplevel, &mask_iter, mask_image,
+		mask_x + x, mask_y + y, w, h, mask_buffer, mask_iter_flags,
+		info->mask_flags);
+
+	    _pixman_implementation_iter_init (
+		imp->toplevel, &dest_iter, dest_image,
+		dest_x + x, dest_y + y, w, h, dest_buffer,
+		ITER_DEST | width_flag | op_flags[op].dst, info->dest_flags);
+
+	    for (i = 0; i < h; ++i)
+	    {
+		uint32_t *s, *m, *d;
+
+		m = mask_iter.get_scanline (&mask_iter, NULL);
+		s = src_iter.get_scanline (&src_iter, m);
+		d = dest_iter.get_scanline (&dest_iter, NULL);
+
+		compose (imp->toplevel, op, d, s, m, w);
+
+		dest_iter.write_back (&dest_iter);
+	    }
+
+	    if (src_iter.fini)
+		src_iter.fini (&src_iter);
+	    if (mask_iter.fini)
+		mask_iter.fini (&mask_iter);
+	    if (dest_iter.fini)
+		dest_iter.fini (&dest_iter);
+	}
     }
 
-    if (src_iter.fini)
-	src_iter.fini (&src_iter);
-    if (mask_iter.fini)
-	mask_iter.fini (&mask_iter);
-    if (dest_iter.fini)
-	dest_iter.fini (&dest_iter);
-    
     if (scanline_buffer != (uint8_t *) stack_scanline_buffer)
-	free (scanline_buffer);
+	_pixman_scratch_free (scanline_buffer);
 }
 
 static const pixman_fast_path_t general_fast_path[] =
@@ -257,6 +320,8 @@ _pixman_implementation_create_general (void)
 {
     pixman_implementation_t *imp = _pixman_implementation_create (NULL, general_fast_path);
 
+    imp->name = "general";
+
     _pixman_setup_combiner_functions_32 (imp);
     _pixman_setup_combiner_functions_float (imp);
 
@@ -286,9 +286,9 @@ pixman_glyph_cache_insert (pixman_glyph_cache_t  *cache,
 	return NULL;
     }
 
-    pixman_image_composite32 (PIXMAN_OP_SRC,
-			      image, NULL, glyph->image, 0, 0, 0, 0, 0, 0,
-			      width, height);
+    _pixman_image_composite32 (PIXMAN_OP_SRC,
+			       image, NULL, glyph->image, 0, 0, 0, 0, 0, 0,
+			       width, height);
 
     if (PIXMAN_FORMAT_A   (glyph->image->bits.format) != 0	&&
 	PIXMAN_FORMAT_RGB (glyph->image->bits.format) != 0)
@@ -319,6 +319,19 @@ pixman_glyph_cache_remove (pixman_glyph_cache_t  *cache,
     }
 }
 
+pixman_image_t *
+_pixman_glyph_get_image (const void *glyph,
+			 int *       origin_x,
+			 int *       origin_y)
+{
+    const glyph_t *g = glyph;
+
+    *origin_x = g->origin_x;
+    *origin_y = g->origin_y;
+
+    return g->image;
+}
+
 PIXMAN_EXPORT void
 pixman_glyph_get_extents (pixman_glyph_cache_t *cache,
 			  int                   n_glyphs,
@@ -419,11 +432,21 @@ pixman_composite_glyphs_no_mask (pixman_op_t            op,
     pixman_composite_info_t info;
     int i;
 
+    if (_pixman_trace_enabled)
+    {
+	_pixman_trace_glyphs (op, src, dest, PIXMAN_null,
+			      src_x, src_y, 0, 0, dest_x, dest_y, 0, 0,
+			      n_glyphs, glyphs);
+    }
+
     _pixman_image_validate (src);
     _pixman_image_validate (dest);
+
+    if (src->common.flags & FAST_PATH_MIPMAP)
+	_pixman_bits_image_update_mipmap (&src->bits);
     
     dest_format = dest->common.extended_format_code;
-    dest_flags = dest->common.flags;
+    dest_flags = DEST_FLAGS (dest);
     
     pixman_region32_init (&region);
     if (!_pixman_compute_composite_region32 (
@@ -439,7 +462,7 @@ pixman_composite_glyphs_no_mask (pixman_op_t            op,
     info.src_image = src;
     info.dest_image = dest;
     info.src_flags = src->common.flags;
-    info.dest_flags = dest->common.flags;
+    info.dest_flags = dest_flags;
 
     for (i = 0; i < n_glyphs; ++i)
     {
@@ -497,6 +520,8 @@ pixman_composite_glyphs_no_mask (pixman_op_t            op,
 	pixman_list_move_to_front (&cache->mru, &glyph->mru_link);
     }
 
+    pixman_image_mark_dirty (dest);
+
 out:
     pixman_region32_fini (&region);
 }
@@ -522,7 +547,7 @@ add_glyphs (pixman_glyph_cache_t *cache,
     _pixman_image_validate (dest);
 
     dest_format = dest->common.extended_format_code;
-    dest_flags = dest->common.flags;
+    dest_flags = DEST_FLAGS (dest);
 
     info.op = PIXMAN_OP_ADD;
     info.dest_image = dest;
@@ -658,7 +683,15 @@ pixman_composite_glyphs (pixman_op_t            op,
 {
     pixman_image_t *mask;
 
-    if (!(mask = pixman_image_create_bits (mask_format, width, height, NULL, -1)))
+    if (_pixman_trace_enabled)
+    {
+	_pixman_trace_glyphs (op, src, dest, mask_format,
+			      src_x, src_y, mask_x, mask_y,
+			      dest_x, dest_y, width, height,
+			      n_glyphs, glyphs);
+    }
+
+    if (!(mask = _pixman_image_create_scratch_bits (mask_format, width, height)))
 	return;
 
     if (PIXMAN_FORMAT_A   (mask_format) != 0 &&
@@ -669,11 +702,11 @@ pixman_composite_glyphs (pixman_op_t            op,
 
     add_glyphs (cache, mask, - mask_x, - mask_y, n_glyphs, glyphs);
 
-    pixman_image_composite32 (op, src, mask, dest,
-			      src_x, src_y,
-			      0, 0,
-			      dest_x, dest_y,
-			      width, height);
+    _pixman_image_composite32 (op, src, mask, dest,
+			       src_x, src_y,
+			       0, 0,
+			       dest_x, dest_y,
+			       width, height);
 
     pixman_image_unref (mask);
 }
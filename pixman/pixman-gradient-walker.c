@@ -29,12 +29,15 @@
 #include <config_msc.h>
 #endif
 
+#include <stdlib.h>
 #include "pixman-private.h"
+#include "dither/blue-noise-64x64.h"
 
 void
 _pixman_gradient_walker_init (pixman_gradient_walker_t *walker,
                               gradient_t *              gradient,
-                              pixman_repeat_t		repeat)
+                              pixman_repeat_t		repeat,
+                              pixman_iter_t *		iter)
 {
     walker->num_stops = gradient->n_stops;
     walker->stops     = gradient->stops;
@@ -51,11 +54,32 @@ _pixman_gradient_walker_init (pixman_gradient_walker_t *walker,
     walker->repeat    = repeat;
 
     walker->need_reset = TRUE;
+
+    walker->lut       = NULL;
+    walker->lut_16    = NULL;
+    walker->lut_shift = gradient->lut_shift;
+    walker->dither    = PIXMAN_DITHER_NONE;
+
+    if (!iter || !gradient->lut || gradient->lut_repeat != (int)repeat)
+	return;
+
+    if (gradient->dither == PIXMAN_DITHER_NONE)
+    {
+	walker->lut = gradient->lut;
+    }
+    else if (gradient->lut_16)
+    {
+	walker->lut_16   = gradient->lut_16;
+	walker->dither   = gradient->dither;
+	walker->buffer   = iter->buffer;
+	walker->dither_x = iter->x + gradient->dither_offset_x;
+	walker->dither_y = iter->y + gradient->dither_offset_y;
+    }
 }
 
-static void
-gradient_walker_reset (pixman_gradient_walker_t *walker,
-		       pixman_fixed_48_16_t      pos)
+void
+_pixman_gradient_walker_reset (pixman_gradient_walker_t *walker,
+			       pixman_fixed_48_16_t      pos)
 {
     int64_t x, left_x, right_x;
     pixman_color_t *left_c, *right_c;
@@ -179,7 +203,7 @@ pixman_gradient_walker_pixel_float (pixman_gradient_walker_t *walker,
     float y;
 
     if (walker->need_reset || x < walker->left_x || x >= walker->right_x)
-	gradient_walker_reset (walker, x);
+	_pixman_gradient_walker_reset (walker, x);
 
     y = x * (1.0f / 65536.0f);
 
@@ -199,7 +223,7 @@ pixman_gradient_walker_pixel_32 (pixman_gradient_walker_t *walker,
     float y;
 
     if (walker->need_reset || x < walker->left_x || x >= walker->right_x)
-	gradient_walker_reset (walker, x);
+	_pixman_gradient_walker_reset (walker, x);
 
     y = x * (1.0f / 65536.0f);
 
@@ -222,12 +246,110 @@ pixman_gradient_walker_pixel_32 (pixman_gradient_walker_t *walker,
            (((uint32_t)(f.b + .5f) >>  0) & 0x000000ff);
 }
 
+/* Returns the entry of the ramp for position x, or -1 where the
+ * gradient is transparent.
+ */
+static force_inline int
+gradient_walker_lut_index (pixman_gradient_walker_t *walker,
+			   pixman_fixed_48_16_t      x)
+{
+    int shift = walker->lut_shift;
+
+    switch (walker->repeat)
+    {
+    case PIXMAN_REPEAT_NORMAL:
+	return ((int32_t)x & 0xffff) >> shift;
+
+    case PIXMAN_REPEAT_REFLECT:
+	if ((int32_t)x & 0x10000)
+	    return (~(int32_t)x & 0xffff) >> shift;
+	return ((int32_t)x & 0xffff) >> shift;
+
+    case PIXMAN_REPEAT_PAD:
+	if (x < 0)
+	    return 0;
+	if (x > 0xffff)
+	    return 0xffff >> shift;
+	return x >> shift;
+
+    default:
+    case PIXMAN_REPEAT_NONE:
+	/* Compared with the stops rather than with the entries, so the
+	 * edges stay as sharp as in _pixman_gradient_walker_reset().
+	 */
+	if (x < walker->stops[0].x ||
+	    x >= walker->stops[walker->num_stops - 1].x)
+	    return -1;
+	return x >> shift;
+    }
+}
+
+/* The ordered dither threshold of the pixel at buffer, from 0 to 255,
+ * replicated in the four 16-bit channels of a lut_16 entry.
+ */
+static force_inline uint64_t
+gradient_walker_dither (pixman_gradient_walker_t *walker,
+			const uint32_t           *buffer)
+{
+    int x = walker->dither_x + (int)(buffer - walker->buffer);
+    int y = walker->dither_y;
+    uint32_t d;
+
+    switch (walker->dither)
+    {
+    case PIXMAN_DITHER_GOOD:
+    case PIXMAN_DITHER_BEST:
+    case PIXMAN_DITHER_ORDERED_BLUE_NOISE_64:
+	d = dither_blue_noise_64x64[((y & 0x3f) << 6) | (x & 0x3f)] >> 4;
+	break;
+
+    default:
+	/* See dither_factor_bayer_8() in pixman-bits-image.c */
+	y ^= x;
+	d = ((y & 0x1) << 5) | ((x & 0x1) << 4) |
+	    ((y & 0x2) << 2) | ((x & 0x2) << 1) |
+	    ((y & 0x4) >> 1) | ((x & 0x4) >> 2);
+	d = (d << 2) + 2;
+	break;
+    }
+
+    return d * 0x0001000100010001ULL;
+}
+
+static force_inline uint32_t
+gradient_walker_lookup_32 (pixman_gradient_walker_t *walker,
+			   pixman_fixed_48_16_t      x,
+			   const uint32_t           *buffer)
+{
+    int i = gradient_walker_lut_index (walker, x);
+    uint64_t c;
+
+    if (i < 0)
+	return 0;
+
+    if (walker->lut)
+	return walker->lut[i];
+
+    /* The channels are in 8.8 fixed point, so adding a threshold
+     * below 256 and truncating leaves exact values unchanged and
+     * never carries into the next channel.
+     */
+    c = ((walker->lut_16[i] + gradient_walker_dither (walker, buffer)) >> 8) &
+	0x00ff00ff00ff00ffULL;
+    c |= c >> 8;
+
+    return (uint32_t)((c & 0xffff) | ((c >> 16) & 0xffff0000));
+}
+
 void
 _pixman_gradient_walker_write_narrow (pixman_gradient_walker_t *walker,
 				      pixman_fixed_48_16_t      x,
 				      uint32_t                 *buffer)
 {
-    *buffer = pixman_gradient_walker_pixel_32 (walker, x);
+    if (walker->lut || walker->lut_16)
+	*buffer = gradient_walker_lookup_32 (walker, x, buffer);
+    else
+	*buffer = pixman_gradient_walker_pixel_32 (walker, x);
 }
 
 void
@@ -246,7 +368,20 @@ _pixman_gradient_walker_fill_narrow (pixman_gradient_walker_t *walker,
 {
     register uint32_t color;
 
-    color = pixman_gradient_walker_pixel_32 (walker, x);
+    if (walker->lut_16)
+    {
+	while (buffer < end)
+	{
+	    *buffer = gradient_walker_lookup_32 (walker, x, buffer);
+	    buffer++;
+	}
+	return;
+    }
+
+    if (walker->lut)
+	color = gradient_walker_lookup_32 (walker, x, buffer);
+    else
+	color = pixman_gradient_walker_pixel_32 (walker, x);
     while (buffer < end)
 	*buffer++ = color;
 }
@@ -265,3 +400,160 @@ _pixman_gradient_walker_fill_wide (pixman_gradient_walker_t *walker,
     while (buffer_wide < end_wide)
 	*buffer_wide++ = color;
 }
+
+/* The number of ramp entries is chosen so that, between two stops,
+ * the color changes by at most half a level of an 8-bit channel from
+ * one entry to the next. Returns log2 of the width of an entry in
+ * 16.16 positions.
+ */
+int
+_pixman_gradient_lut_shift (const pixman_gradient_stop_t *stops,
+			    int                           n_stops)
+{
+    double levels = 0;
+    int shift = 8;
+    int i;
+
+    for (i = 0; i < n_stops; ++i)
+    {
+	const pixman_gradient_stop_t *s0 = &stops[i];
+	const pixman_gradient_stop_t *s1 = &stops[(i + 1) % n_stops];
+	int64_t dx = (int64_t)s1->x - s0->x;
+	int da, dc;
+
+	/* The last segment is the one that wraps around for
+	 * PIXMAN_REPEAT_NORMAL.
+	 */
+	if (i == n_stops - 1)
+	    dx += pixman_fixed_1;
+
+	if (dx <= 0)
+	    continue;
+
+	da = abs (s1->color.alpha - s0->color.alpha);
+	dc = MAX (abs (s1->color.red - s0->color.red),
+		  MAX (abs (s1->color.green - s0->color.green),
+		       abs (s1->color.blue - s0->color.blue)));
+
+	levels = MAX (levels, (da + dc) / 257.0 * pixman_fixed_1 / dx);
+    }
+
+    while (shift > 4 && (1 << (16 - shift)) < 2 * levels)
+	shift--;
+
+    return shift;
+}
+
+/* Outside of [0, 1] the ramp and the SIMD fetchers use the end colors
+ * or transparent, which is only right if the stops are inside.
+ */
+static pixman_bool_t
+gradient_stops_inside (gradient_t *gradient)
+{
+    pixman_repeat_t repeat = gradient->common.repeat;
+    pixman_gradient_stop_t *stops = gradient->stops;
+
+    if (repeat != PIXMAN_REPEAT_NONE && repeat != PIXMAN_REPEAT_PAD)
+	return TRUE;
+
+    return stops[0].x >= 0 &&
+	stops[gradient->n_stops - 1].x <= pixman_fixed_1;
+}
+
+void
+_pixman_gradient_update_lut (gradient_t *gradient)
+{
+    pixman_repeat_t repeat = gradient->common.repeat;
+    pixman_bool_t dither = gradient->dither != PIXMAN_DITHER_NONE;
+    int n_entries = 1 << (16 - gradient->lut_shift);
+    pixman_gradient_walker_t walker;
+    int i;
+
+    if (gradient->lut && gradient->lut_repeat == (int)repeat &&
+	(!dither || gradient->lut_16))
+    {
+	return;
+    }
+
+    if (!gradient_stops_inside (gradient))
+	return;
+
+    if (!gradient->lut)
+	gradient->lut = pixman_malloc_ab (n_entries, sizeof (uint32_t));
+    if (dither && !gradient->lut_16)
+	gradient->lut_16 = pixman_malloc_ab (n_entries, sizeof (uint64_t));
+
+    gradient->lut_repeat = -1;
+
+    if (!gradient->lut || (dither && !gradient->lut_16))
+	return;
+
+    _pixman_gradient_walker_init (&walker, gradient, repeat, NULL);
+
+    /* Each entry is sampled in the middle of the positions it covers */
+    for (i = 0; i < n_entries; ++i)
+    {
+	pixman_fixed_48_16_t x =
+	    ((pixman_fixed_48_16_t)i << gradient->lut_shift) +
+	    ((1 << gradient->lut_shift) >> 1);
+	argb_t f;
+
+	gradient->lut[i] = pixman_gradient_walker_pixel_32 (&walker, x);
+
+	if (gradient->lut_16)
+	{
+	    f = pixman_gradient_walker_pixel_float (&walker, x);
+
+	    gradient->lut_16[i] =
+		((uint64_t)(f.a * (255.f * 256.f) + .5f) << 48) |
+		((uint64_t)(f.r * (255.f * 256.f) + .5f) << 32) |
+		((uint64_t)(f.g * (255.f * 256.f) + .5f) << 16) |
+		((uint64_t)(f.b * (255.f * 256.f) + .5f) <<  0);
+	}
+    }
+
+    gradient->lut_repeat = repeat;
+}
+
+void
+_pixman_gradient_iter_init (pixman_iter_t                   *iter,
+			    const pixman_gradient_kernels_t *kernels)
+{
+    pixman_image_t *image = iter->image;
+    gradient_t *gradient = &image->gradient;
+    pixman_bool_t use_kernels =
+	(iter->image_flags & FAST_PATH_AFFINE_TRANSFORM) &&
+	gradient_stops_inside (gradient);
+
+    /* The narrow kernels only look colors up in the ramp */
+    if (iter->iter_flags & ITER_NARROW)
+    {
+	use_kernels = use_kernels && gradient->lut &&
+	    gradient->lut_repeat == (int)image->common.repeat &&
+	    gradient->dither == PIXMAN_DITHER_NONE;
+    }
+
+    switch (image->type)
+    {
+    case LINEAR:
+	if (use_kernels && kernels->linear)
+	    _pixman_linear_gradient_kernel_iter_init (iter, kernels);
+	else
+	    _pixman_linear_gradient_iter_init (image, iter);
+	break;
+
+    case RADIAL:
+	if (use_kernels && kernels->radial)
+	    _pixman_radial_gradient_kernel_iter_init (iter, kernels);
+	else
+	    _pixman_radial_gradient_iter_init (image, iter);
+	break;
+
+    default:
+	if (use_kernels && kernels->conical && (iter->iter_flags & ITER_NARROW))
+	    _pixman_conical_gradient_kernel_iter_init (iter, kernels);
+	else
+	    _pixman_conical_gradient_iter_init (image, iter);
+	break;
+    }
+}
@@ -30,11 +30,26 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <math.h>
 
 #include "pixman-private.h"
 
 static const pixman_color_t transparent_black = { 0, 0, 0, 0 };
 
+static void
+free_mipmap (mipmap_t *mipmap)
+{
+    int i;
+
+    for (i = 0; i < PIXMAN_MAX_MIPMAP_LEVELS; ++i)
+    {
+	if (mipmap->levels[i])
+	    pixman_image_unref (mipmap->levels[i]);
+    }
+
+    free (mipmap);
+}
+
 static void
 gradient_property_changed (pixman_image_t *image)
 {
@@ -103,6 +118,15 @@ _pixman_init_gradient (gradient_t *                  gradient,
     memcpy (gradient->stops, stops, n_stops * sizeof (pixman_gradient_stop_t));
     gradient->n_stops = n_stops;
 
+    gradient->dither = PIXMAN_DITHER_NONE;
+    gradient->dither_offset_x = 0;
+    gradient->dither_offset_y = 0;
+
+    gradient->lut = NULL;
+    gradient->lut_16 = NULL;
+    gradient->lut_shift = _pixman_gradient_lut_shift (stops, n_stops);
+    gradient->lut_repeat = -1;
+
     gradient->common.property_changed = gradient_property_changed;
 
     return TRUE;
@@ -131,6 +155,7 @@ _pixman_image_init (pixman_image_t *image)
     common->destroy_func = NULL;
     common->destroy_data = NULL;
     common->dirty = TRUE;
+    common->generation = 0;
 }
 
 pixman_bool_t
@@ -163,6 +188,9 @@ _pixman_image_fini (pixman_image_t *image)
 		free (image->gradient.stops - 1);
 	    }
 
+	    free (image->gradient.lut);
+	    free (image->gradient.lut_16);
+
 	    /* This will trigger if someone adds a property_changed
 	     * method to the linear/radial/conical gradient overwriting
 	     * the general one.
@@ -174,6 +202,9 @@ _pixman_image_fini (pixman_image_t *image)
 	if (image->type == BITS && image->bits.free_me)
 	    free (image->bits.free_me);
 
+	if (image->type == BITS && image->bits.mipmap)
+	    free_mipmap (image->bits.mipmap);
+
 	return TRUE;
     }
 
@@ -195,6 +226,7 @@ static void
 image_property_changed (pixman_image_t *image)
 {
     image->common.dirty = TRUE;
+    image->common.generation++;
 }
 
 /* Ref Counting */
@@ -263,6 +295,53 @@ pixman_disable_out_of_bounds_workaround (void)
 {
 }
 
+/* Picks the mipmap level that reduces the image by a factor below two
+ * for the affine transform of the image, and for the trilinear mode
+ * the weight of the next level. Returns FALSE if the transform does
+ * not reduce the image enough for the mipmap to be used.
+ */
+static pixman_bool_t
+compute_mipmap_level (pixman_image_t *image)
+{
+    pixman_fixed_t (*t)[3] = image->common.transform->matrix;
+    mipmap_t *mipmap = image->bits.mipmap;
+    int width = image->bits.width;
+    int height = image->bits.height;
+    double dx, dy, rho;
+    int level = 0;
+    int weight = 0;
+
+    /* The lengths, in source pixels, of destination pixel steps */
+    dx = pixman_fixed_to_double (t[0][0]) * pixman_fixed_to_double (t[0][0]) +
+	 pixman_fixed_to_double (t[1][0]) * pixman_fixed_to_double (t[1][0]);
+    dy = pixman_fixed_to_double (t[0][1]) * pixman_fixed_to_double (t[0][1]) +
+	 pixman_fixed_to_double (t[1][1]) * pixman_fixed_to_double (t[1][1]);
+
+    rho = sqrt (MAX (dx, dy));
+
+    while (rho >= 2.0 && (width > 1 || height > 1) &&
+	   level < PIXMAN_MAX_MIPMAP_LEVELS)
+    {
+	width = MAX (width / 2, 1);
+	height = MAX (height / 2, 1);
+	rho /= 2.0;
+	level++;
+    }
+
+    if (mipmap->mode == PIXMAN_MIPMAP_TRILINEAR	&&
+	(width > 1 || height > 1)		&&
+	level < PIXMAN_MAX_MIPMAP_LEVELS	&&
+	rho > 1.0)
+    {
+	weight = (int)(log (rho) / log (2.0) * 255 + 0.5);
+    }
+
+    mipmap->level = level;
+    mipmap->weight = weight;
+
+    return level > 0 || weight > 0;
+}
+
 static void
 compute_image_info (pixman_image_t *image)
 {
@@ -290,11 +369,15 @@ compute_image_info (pixman_image_t *image)
 	    if (image->common.transform->matrix[0][1] == 0 &&
 		image->common.transform->matrix[1][0] == 0)
 	    {
-		if (image->common.transform->matrix[0][0] == -pixman_fixed_1 &&
-		    image->common.transform->matrix[1][1] == -pixman_fixed_1)
-		{
+		pixman_fixed_t m00 = image->common.transform->matrix[0][0];
+		pixman_fixed_t m11 = image->common.transform->matrix[1][1];
+
+		if (m00 == -pixman_fixed_1 && m11 == -pixman_fixed_1)
 		    flags |= FAST_PATH_ROTATE_180_TRANSFORM;
-		}
+		else if (m00 == -pixman_fixed_1 && m11 == pixman_fixed_1)
+		    flags |= FAST_PATH_FLIP_X_TRANSFORM;
+		else if (m00 == pixman_fixed_1 && m11 == -pixman_fixed_1)
+		    flags |= FAST_PATH_FLIP_Y_TRANSFORM;
 		flags |= FAST_PATH_SCALE_TRANSFORM;
 	    }
 	    else if (image->common.transform->matrix[0][0] == 0 &&
@@ -472,6 +555,15 @@ compute_image_info (pixman_image_t *image)
 
 	if (PIXMAN_FORMAT_IS_WIDE (image->bits.format))
 	    flags &= ~FAST_PATH_NARROW_FORMAT;
+
+	/* Dithering only matters to destinations, which drop
+	 * FAST_PATH_NARROW_FORMAT when they are dithered (see DEST_FLAGS).
+	 * A dithered source is composited like any other image.
+	 */
+	if (image->bits.dither != PIXMAN_DITHER_NONE)
+	    flags |= FAST_PATH_ORDERED_DITHER;
+	else
+	    flags |= FAST_PATH_NO_DITHER;
 	break;
 
     case RADIAL:
@@ -527,6 +619,23 @@ compute_image_info (pixman_image_t *image)
 	    flags &= ~FAST_PATH_NARROW_FORMAT;
     }
 
+    /* A mipmapped image is only sampled by the general fetchers, so the
+     * filter flags are removed to keep it away from the fast paths.
+     */
+#define MIPMAP_FLAGS							\
+    (FAST_PATH_HAS_TRANSFORM | FAST_PATH_AFFINE_TRANSFORM |		\
+     FAST_PATH_BILINEAR_FILTER | FAST_PATH_NARROW_FORMAT |		\
+     FAST_PATH_NO_ALPHA_MAP | FAST_PATH_BITS_IMAGE)
+
+    if (image->type == BITS				&&
+	image->bits.mipmap				&&
+	(flags & MIPMAP_FLAGS) == MIPMAP_FLAGS		&&
+	compute_mipmap_level (image))
+    {
+	flags &= ~(FAST_PATH_NEAREST_FILTER | FAST_PATH_BILINEAR_FILTER);
+	flags |= FAST_PATH_MIPMAP;
+    }
+
     /* Both alpha maps and convolution filters can introduce
      * non-opaqueness in otherwise opaque images. Also
      * an image with component alpha turned on is only opaque
@@ -697,6 +806,17 @@ pixman_image_set_dither (pixman_image_t *image,
 
 	image->bits.dither = dither;
 
+	image_property_changed (image);
+    }
+    else if (image->type == LINEAR ||
+	     image->type == RADIAL ||
+	     image->type == CONICAL)
+    {
+	if (image->gradient.dither == dither)
+	    return;
+
+	image->gradient.dither = dither;
+
 	image_property_changed (image);
     }
 }
@@ -719,6 +839,78 @@ pixman_image_set_dither_offset (pixman_image_t *image,
 
 	image_property_changed (image);
     }
+    else if (image->type == LINEAR ||
+	     image->type == RADIAL ||
+	     image->type == CONICAL)
+    {
+	if (image->gradient.dither_offset_x == offset_x &&
+	    image->gradient.dither_offset_y == offset_y)
+	{
+	    return;
+	}
+
+	image->gradient.dither_offset_x = offset_x;
+	image->gradient.dither_offset_y = offset_y;
+
+	image_property_changed (image);
+    }
+}
+
+PIXMAN_EXPORT void
+pixman_image_set_yuv_matrix (pixman_image_t     *image,
+			     pixman_yuv_matrix_t matrix)
+{
+    if (image->type == BITS)
+    {
+	if (image->bits.yuv_matrix == matrix)
+	    return;
+
+	image->bits.yuv_matrix = matrix;
+
+	image_property_changed (image);
+    }
+}
+
+PIXMAN_EXPORT pixman_bool_t
+pixman_image_set_mipmap (pixman_image_t *image,
+			 pixman_mipmap_t mipmap)
+{
+    if (image->type != BITS)
+	return FALSE;
+
+    if (mipmap == PIXMAN_MIPMAP_NONE)
+    {
+	if (!image->bits.mipmap)
+	    return TRUE;
+
+	free_mipmap (image->bits.mipmap);
+	image->bits.mipmap = NULL;
+    }
+    else if (!image->bits.mipmap)
+    {
+	if (!(image->bits.mipmap = calloc (1, sizeof (mipmap_t))))
+	    return FALSE;
+
+	image->bits.mipmap->mode = mipmap;
+    }
+    else
+    {
+	if (image->bits.mipmap->mode == mipmap)
+	    return TRUE;
+
+	image->bits.mipmap->mode = mipmap;
+    }
+
+    image_property_changed (image);
+
+    return TRUE;
+}
+
+PIXMAN_EXPORT void
+pixman_image_mark_dirty (pixman_image_t *image)
+{
+    if (image->type == BITS && image->bits.mipmap)
+	image->bits.mipmap->valid = FALSE;
 }
 
 PIXMAN_EXPORT pixman_bool_t
@@ -59,19 +59,291 @@ _pixman_implementation_create (pixman_implementation_t *fallback,
     return imp;
 }
 
-#define N_CACHED_FAST_PATHS 8
+/* The per-thread cache is 2-way set associative. Each signature maps
+ * to one set, and the most recently used entry of a set is kept in
+ * the first way.
+ */
+#define N_CACHE_SETS	64
+#define N_CACHE_WAYS	2
 
 typedef struct
 {
-    struct
-    {
-	pixman_implementation_t *	imp;
-	pixman_fast_path_t		fast_path;
-    } cache [N_CACHED_FAST_PATHS];
+    pixman_implementation_t *	imp;
+    pixman_fast_path_t		fast_path;
+} cache_entry_t;
+
+typedef struct
+{
+    cache_entry_t cache [N_CACHE_SETS][N_CACHE_WAYS];
 } cache_t;
 
 PIXMAN_DEFINE_THREAD_LOCAL (cache_t, fast_path_cache)
 
+/* The fast path index holds every fast path of an implementation chain,
+ * grouped by their (op, src format, mask format, dest format) key.
+ * Within a group the fast paths stay in chain order, and each one
+ * remembers its position in the chain, so a lookup can find the same
+ * fast path the linear walk of the chain would have found.
+ *
+ * A fast path can use PIXMAN_OP_any and PIXMAN_any in its key, so the
+ * key of a query is looked up once for each combination of wildcards
+ * that occurs in the chain. There are at most 16 such combinations.
+ */
+typedef struct
+{
+    pixman_implementation_t *	imp;
+    const pixman_fast_path_t *	fast_path;
+    int				position;
+} index_entry_t;
+
+typedef struct
+{
+    uint32_t			op;
+    pixman_format_code_t	src_format;
+    pixman_format_code_t	mask_format;
+    pixman_format_code_t	dest_format;
+    int				first;
+    int				n_entries;
+} index_bucket_t;
+
+struct pixman_fast_path_index_t
+{
+    uint32_t		wildcards;
+    uint32_t		bucket_mask;
+    index_bucket_t *	buckets;
+    index_entry_t *	entries;
+};
+
+#define WILDCARD_OP	(1 << 0)
+#define WILDCARD_SRC	(1 << 1)
+#define WILDCARD_MASK	(1 << 2)
+#define WILDCARD_DEST	(1 << 3)
+
+static force_inline uint32_t
+hash_key (uint32_t op,
+	  pixman_format_code_t src_format,
+	  pixman_format_code_t mask_format,
+	  pixman_format_code_t dest_format)
+{
+    uint32_t h = op * 0x9e3779b1u;
+
+    h = (h ^ src_format) * 0x85ebca6bu;
+    h = (h ^ mask_format) * 0xc2b2ae35u;
+    h = (h ^ dest_format) * 0x27d4eb2fu;
+
+    return h ^ (h >> 15);
+}
+
+static index_bucket_t *
+find_bucket (const pixman_fast_path_index_t *index,
+	     uint32_t                        op,
+	     pixman_format_code_t            src_format,
+	     pixman_format_code_t            mask_format,
+	     pixman_format_code_t            dest_format,
+	     pixman_bool_t                   insert)
+{
+    uint32_t i = hash_key (op, src_format, mask_format, dest_format);
+
+    for (;;)
+    {
+	index_bucket_t *bucket = &index->buckets[i & index->bucket_mask];
+
+	if (bucket->n_entries == 0)
+	{
+	    if (!insert)
+		return NULL;
+
+	    bucket->op = op;
+	    bucket->src_format = src_format;
+	    bucket->mask_format = mask_format;
+	    bucket->dest_format = dest_format;
+
+	    return bucket;
+	}
+
+	if (bucket->op == op			&&
+	    bucket->src_format == src_format	&&
+	    bucket->mask_format == mask_format	&&
+	    bucket->dest_format == dest_format)
+	{
+	    return bucket;
+	}
+
+	i++;
+    }
+}
+
+static uint32_t
+get_wildcards (const pixman_fast_path_t *info)
+{
+    uint32_t wildcards = 0;
+
+    if (info->op == PIXMAN_OP_any)
+	wildcards |= WILDCARD_OP;
+    if (info->src_format == PIXMAN_any)
+	wildcards |= WILDCARD_SRC;
+    if (info->mask_format == PIXMAN_any)
+	wildcards |= WILDCARD_MASK;
+    if (info->dest_format == PIXMAN_any)
+	wildcards |= WILDCARD_DEST;
+
+    return wildcards;
+}
+
+static pixman_fast_path_index_t *
+build_fast_path_index (pixman_implementation_t *toplevel)
+{
+    pixman_fast_path_index_t *index;
+    pixman_implementation_t *imp;
+    const pixman_fast_path_t *info;
+    index_bucket_t *bucket;
+    uint32_t n_buckets;
+    int n_entries = 0;
+    int *filled;
+    int i, first;
+
+    for (imp = toplevel; imp != NULL; imp = imp->fallback)
+    {
+	for (info = imp->fast_paths; info->op != PIXMAN_OP_NONE; ++info)
+	    n_entries++;
+    }
+
+    /* Keep the table at most half full */
+    n_buckets = 16;
+    while (n_buckets < 2 * (uint32_t)n_entries)
+	n_buckets *= 2;
+
+    if (!(index = calloc (1, sizeof (pixman_fast_path_index_t))))
+	return NULL;
+
+    index->bucket_mask = n_buckets - 1;
+    index->buckets = calloc (n_buckets, sizeof (index_bucket_t));
+    index->entries = pixman_malloc_ab (n_entries + 1, sizeof (index_entry_t));
+
+    if (!index->buckets || !index->entries)
+    {
+	free (index->buckets);
+	free (index->entries);
+	free (index);
+	return NULL;
+    }
+
+    /* Count the fast paths that share each key */
+    for (imp = toplevel; imp != NULL; imp = imp->fallback)
+    {
+	for (info = imp->fast_paths; info->op != PIXMAN_OP_NONE; ++info)
+	{
+	    bucket = find_bucket (index, info->op, info->src_format,
+				  info->mask_format, info->dest_format, TRUE);
+	    bucket->n_entries++;
+
+	    index->wildcards |= 1 << get_wildcards (info);
+	}
+    }
+
+    first = 0;
+    for (i = 0; i < (int)n_buckets; ++i)
+    {
+	index->buckets[i].first = first;
+	first += index->buckets[i].n_entries;
+    }
+
+    /* Fill in the groups in chain order */
+    if (!(filled = calloc (n_buckets, sizeof (int))))
+    {
+	free (index->buckets);
+	free (index->entries);
+	free (index);
+	return NULL;
+    }
+
+    n_entries = 0;
+    for (imp = toplevel; imp != NULL; imp = imp->fallback)
+    {
+	for (info = imp->fast_paths; info->op != PIXMAN_OP_NONE; ++info)
+	{
+	    index_entry_t *entry;
+
+	    bucket = find_bucket (index, info->op, info->src_format,
+				  info->mask_format, info->dest_format, FALSE);
+
+	    entry = &index->entries[
+		bucket->first + filled[bucket - index->buckets]++];
+	    entry->imp = imp;
+	    entry->fast_path = info;
+	    entry->position = n_entries++;
+	}
+    }
+
+    free (filled);
+
+    return index;
+}
+
+static force_inline pixman_bool_t
+flags_match (const pixman_fast_path_t *info,
+	     uint32_t                  src_flags,
+	     uint32_t                  mask_flags,
+	     uint32_t                  dest_flags)
+{
+    return (info->src_flags & src_flags) == info->src_flags	&&
+	   (info->mask_flags & mask_flags) == info->mask_flags	&&
+	   (info->dest_flags & dest_flags) == info->dest_flags;
+}
+
+static const index_entry_t *
+lookup_index (const pixman_fast_path_index_t *index,
+	      pixman_op_t                     op,
+	      pixman_format_code_t            src_format,
+	      uint32_t                        src_flags,
+	      pixman_format_code_t            mask_format,
+	      uint32_t                        mask_flags,
+	      pixman_format_code_t            dest_format,
+	      uint32_t                        dest_flags)
+{
+    const index_entry_t *best = NULL;
+    uint32_t wildcards;
+
+    for (wildcards = 0; wildcards < 16; ++wildcards)
+    {
+	const index_bucket_t *bucket;
+	int i;
+
+	if (!(index->wildcards & (1 << wildcards)))
+	    continue;
+
+	bucket = find_bucket (
+	    index,
+	    (wildcards & WILDCARD_OP)?   PIXMAN_OP_any : op,
+	    (wildcards & WILDCARD_SRC)?  PIXMAN_any : src_format,
+	    (wildcards & WILDCARD_MASK)? PIXMAN_any : mask_format,
+	    (wildcards & WILDCARD_DEST)? PIXMAN_any : dest_format,
+	    FALSE);
+
+	if (!bucket)
+	    continue;
+
+	for (i = 0; i < bucket->n_entries; ++i)
+	{
+	    const index_entry_t *entry = &index->entries[bucket->first + i];
+
+	    /* Only a fast path earlier in the chain can replace the best
+	     * one found so far, and the group is in chain order.
+	     */
+	    if (best && entry->position > best->position)
+		break;
+
+	    if (flags_match (entry->fast_path, src_flags, mask_flags, dest_flags))
+	    {
+		best = entry;
+		break;
+	    }
+	}
+    }
+
+    return best;
+}
+
 static void
 dummy_composite_rect (pixman_implementation_t *imp,
 		      pixman_composite_info_t *info)
@@ -92,14 +364,20 @@ _pixman_implementation_lookup_composite (pixman_implementation_t  *toplevel,
 {
     pixman_implementation_t *imp;
     cache_t *cache;
+    cache_entry_t *set;
     int i;
 
     /* Check cache for fast paths */
     cache = PIXMAN_GET_THREAD_LOCAL (fast_path_cache);
 
-    for (i = 0; i < N_CACHED_FAST_PATHS; ++i)
+    set = cache->cache[
+	(hash_key (op, src_format, mask_format, dest_format) ^
+	 src_flags ^ (mask_flags << 7) ^ (dest_flags << 13)) &
+	(N_CACHE_SETS - 1)];
+
+    for (i = 0; i < N_CACHE_WAYS; ++i)
     {
-	const pixman_fast_path_t *info = &(cache->cache[i].fast_path);
+	const pixman_fast_path_t *info = &(set[i].fast_path);
 
 	/* Note that we check for equality here, not whether
 	 * the cached fast path matches. This is to prevent
@@ -115,44 +393,72 @@ _pixman_implementation_lookup_composite (pixman_implementation_t  *toplevel,
 	    info->dest_flags == dest_flags	&&
 	    info->func)
 	{
-	    *out_imp = cache->cache[i].imp;
-	    *out_func = cache->cache[i].fast_path.func;
+	    *out_imp = set[i].imp;
+	    *out_func = set[i].fast_path.func;
+
+	    if (_pixman_statistics_enabled)
+		_pixman_statistics_count_lookup (TRUE);
 
 	    goto update_cache;
 	}
     }
 
-    for (imp = toplevel; imp != NULL; imp = imp->fallback)
+    if (_pixman_statistics_enabled)
+	_pixman_statistics_count_lookup (FALSE);
+
+    if (toplevel->fast_path_index)
     {
-	const pixman_fast_path_t *info = imp->fast_paths;
+	const index_entry_t *entry = lookup_index (
+	    toplevel->fast_path_index, op,
+	    src_format, src_flags,
+	    mask_format, mask_flags,
+	    dest_format, dest_flags);
 
-	while (info->op != PIXMAN_OP_NONE)
+	if (entry)
 	{
-	    if ((info->op == op || info->op == PIXMAN_OP_any)		&&
-		/* Formats */
-		((info->src_format == src_format) ||
-		 (info->src_format == PIXMAN_any))			&&
-		((info->mask_format == mask_format) ||
-		 (info->mask_format == PIXMAN_any))			&&
-		((info->dest_format == dest_format) ||
-		 (info->dest_format == PIXMAN_any))			&&
-		/* Flags */
-		(info->src_flags & src_flags) == info->src_flags	&&
-		(info->mask_flags & mask_flags) == info->mask_flags	&&
-		(info->dest_flags & dest_flags) == info->dest_flags)
-	    {
-		*out_imp = imp;
-		*out_func = info->func;
+	    *out_imp = entry->imp;
+	    *out_func = entry->fast_path->func;
 
-		/* Set i to the last spot in the cache so that the
-		 * move-to-front code below will work
-		 */
-		i = N_CACHED_FAST_PATHS - 1;
+	    /* Set i to the last way so that the
+	     * move-to-front code below will work
+	     */
+	    i = N_CACHE_WAYS - 1;
 
-		goto update_cache;
-	    }
+	    goto update_cache;
+	}
+    }
+    else
+    {
+	for (imp = toplevel; imp != NULL; imp = imp->fallback)
+	{
+	    const pixman_fast_path_t *info = imp->fast_paths;
 
-	    ++info;
+	    while (info->op != PIXMAN_OP_NONE)
+	    {
+		if ((info->op == op || info->op == PIXMAN_OP_any)		&&
+		    /* Formats */
+		    ((info->src_format == src_format) ||
+		     (info->src_format == PIXMAN_any))			&&
+		    ((info->mask_format == mask_format) ||
+		     (info->mask_format == PIXMAN_any))			&&
+		    ((info->dest_format == dest_format) ||
+		     (info->dest_format == PIXMAN_any))			&&
+		    /* Flags */
+		    flags_match (info, src_flags, mask_flags, dest_flags))
+		{
+		    *out_imp = imp;
+		    *out_func = info->func;
+
+		    /* Set i to the last way so that the
+		     * move-to-front code below will work
+		     */
+		    i = N_CACHE_WAYS - 1;
+
+		    goto update_cache;
+		}
+
+		++info;
+	    }
 	}
     }
 
@@ -172,17 +478,17 @@ update_cache:
     if (i)
     {
 	while (i--)
-	    cache->cache[i + 1] = cache->cache[i];
-
-	cache->cache[0].imp = *out_imp;
-	cache->cache[0].fast_path.op = op;
-	cache->cache[0].fast_path.src_format = src_format;
-	cache->cache[0].fast_path.src_flags = src_flags;
-	cache->cache[0].fast_path.mask_format = mask_format;
-	cache->cache[0].fast_path.mask_flags = mask_flags;
-	cache->cache[0].fast_path.dest_format = dest_format;
-	cache->cache[0].fast_path.dest_flags = dest_flags;
-	cache->cache[0].fast_path.func = *out_func;
+	    set[i + 1] = set[i];
+
+	set[0].imp = *out_imp;
+	set[0].fast_path.op = op;
+	set[0].fast_path.src_format = src_format;
+	set[0].fast_path.src_flags = src_flags;
+	set[0].fast_path.mask_format = mask_format;
+	set[0].fast_path.mask_flags = mask_flags;
+	set[0].fast_path.dest_format = dest_format;
+	set[0].fast_path.dest_flags = dest_flags;
+	set[0].fast_path.func = *out_func;
     }
 }
 
@@ -420,5 +726,11 @@ _pixman_choose_implementation (void)
             cur->fast_paths = empty_fast_path;
     }
 
+    /* Without an index, lookups fall back to walking the chain */
+    imp->fast_path_index = build_fast_path_index (imp);
+
+    _pixman_statistics_init ();
+    _pixman_trace_init ();
+
     return imp;
 }
@@ -91,6 +91,42 @@ linear_gradient_is_horizontal (pixman_image_t *image,
     return FALSE;
 }
 
+/* Computes the position of v in the gradient and its increment per
+ * step of unit, when unit does not change the projective coordinate.
+ */
+static void
+linear_affine_start (linear_gradient_t     *linear,
+		     const pixman_vector_t *v,
+		     const pixman_vector_t *unit,
+		     pixman_fixed_32_32_t  *t,
+		     double                *inc)
+{
+    pixman_fixed_32_32_t l;
+    pixman_fixed_48_16_t dx, dy;
+
+    dx = linear->p2.x - linear->p1.x;
+    dy = linear->p2.y - linear->p1.y;
+
+    l = dx * dx + dy * dy;
+
+    if (l == 0 || v->vector[2] == 0)
+    {
+	*t = 0;
+	*inc = 0;
+    }
+    else
+    {
+	double invden, v2;
+
+	invden = pixman_fixed_1 * (double) pixman_fixed_1 /
+	    (l * (double) v->vector[2]);
+	v2 = v->vector[2] * (1. / pixman_fixed_1);
+	*t = ((dx * v->vector[0] + dy * v->vector[1]) -
+	      (dx * linear->p1.x + dy * linear->p1.y) * v2) * invden;
+	*inc = (dx * unit->vector[0] + dy * unit->vector[1]) * invden;
+    }
+}
+
 static uint32_t *
 linear_get_scanline (pixman_iter_t                 *iter,
 		     const uint32_t                *mask,
@@ -112,7 +148,8 @@ linear_get_scanline (pixman_iter_t                 *iter,
     uint32_t *end = buffer + width * (Bpp / 4);
     pixman_gradient_walker_t walker;
 
-    _pixman_gradient_walker_init (&walker, gradient, image->common.repeat);
+    _pixman_gradient_walker_init (&walker, gradient,
+				  image->common.repeat, iter);
 
     /* reference point is the center of the pixel */
     v.vector[0] = pixman_int_to_fixed (x) + pixman_fixed_1 / 2;
@@ -146,22 +183,7 @@ linear_get_scanline (pixman_iter_t                 *iter,
 	pixman_fixed_32_32_t t, next_inc;
 	double inc;
 
-	if (l == 0 || v.vector[2] == 0)
-	{
-	    t = 0;
-	    inc = 0;
-	}
-	else
-	{
-	    double invden, v2;
-
-	    invden = pixman_fixed_1 * (double) pixman_fixed_1 /
-		(l * (double) v.vector[2]);
-	    v2 = v.vector[2] * (1. / pixman_fixed_1);
-	    t = ((dx * v.vector[0] + dy * v.vector[1]) -
-		 (dx * linear->p1.x + dy * linear->p1.y) * v2) * invden;
-	    inc = (dx * unit.vector[0] + dy * unit.vector[1]) * invden;
-	}
+	linear_affine_start (linear, &v, &unit, &t, &inc);
 	next_inc = 0;
 
 	if (((pixman_fixed_32_32_t )(inc * width)) == 0)
@@ -241,10 +263,78 @@ linear_get_scanline_wide (pixman_iter_t *iter, const uint32_t *mask)
 				_pixman_gradient_walker_fill_wide);
 }
 
+/* Scanlines of affine gradients, with the positions computed and turned
+ * into colors by the kernels of an implementation
+ */
+static uint32_t *
+linear_get_scanline_kernels (pixman_iter_t *iter, const uint32_t *mask)
+{
+    const pixman_gradient_kernels_t *kernels = iter->data;
+    pixman_image_t *image = iter->image;
+    linear_gradient_t *linear = (linear_gradient_t *)image;
+    pixman_bool_t narrow = iter->iter_flags & ITER_NARROW;
+    int width = iter->width;
+    int32_t *positions = (int32_t *)iter->buffer + (narrow ? 0 : 3 * width);
+    pixman_gradient_walker_t walker;
+    pixman_vector_t v, unit;
+    pixman_fixed_32_32_t t;
+    double inc;
+
+    v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (iter->y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    unit.vector[0] = pixman_fixed_1;
+    unit.vector[1] = 0;
+    unit.vector[2] = 0;
+
+    if (image->common.transform)
+    {
+	if (!pixman_transform_point_3d (image->common.transform, &v))
+	    return iter->buffer;
+
+	unit.vector[0] = image->common.transform->matrix[0][0];
+	unit.vector[1] = image->common.transform->matrix[1][0];
+    }
+
+    linear_affine_start (linear, &v, &unit, &t, &inc);
+
+    kernels->linear (positions, t, inc, image->common.repeat, width);
+
+    _pixman_gradient_walker_init (&walker, &image->gradient,
+				  image->common.repeat, iter);
+
+    if (narrow)
+	kernels->write_narrow (&walker, iter->buffer, positions, width);
+    else
+	kernels->write_wide (&walker, iter->buffer, positions, width);
+
+    iter->y++;
+
+    return iter->buffer;
+}
+
+void
+_pixman_linear_gradient_kernel_iter_init (pixman_iter_t                   *iter,
+					  const pixman_gradient_kernels_t *kernels)
+{
+    _pixman_linear_gradient_iter_init (iter->image, iter);
+
+    if (iter->get_scanline != _pixman_iter_get_scanline_noop)
+    {
+	iter->data = (void *)kernels;
+	iter->get_scanline = linear_get_scanline_kernels;
+    }
+}
+
 void
 _pixman_linear_gradient_iter_init (pixman_image_t *image, pixman_iter_t  *iter)
 {
-    if (linear_gradient_is_horizontal (
+    /* A dithered scanline depends on y, so it can't be reused */
+    pixman_bool_t dithered = (iter->iter_flags & ITER_NARROW) &&
+	image->gradient.dither != PIXMAN_DITHER_NONE;
+
+    if (!dithered && linear_gradient_is_horizontal (
 	    iter->image, iter->x, iter->y, iter->width, iter->height))
     {
 	if (iter->iter_flags & ITER_NARROW)
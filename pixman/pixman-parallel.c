@@ -0,0 +1,495 @@
+/*
+ * Copyright © 2024 Pixman contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#elif defined (_MSC_VER)
+#include <config_msc.h>
+#endif
+
+#include <stdlib.h>
+#include "pixman-private.h"
+
+#ifdef HAVE_PTHREADS
+# include <pthread.h>
+# define HAVE_BUILTIN_THREAD_POOL
+#elif defined (_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+# define HAVE_BUILTIN_THREAD_POOL
+#endif
+
+/* Composites smaller than this many pixels are not worth handing to
+ * other threads.
+ */
+#define PARALLEL_MIN_PIXELS	(128 * 128)
+
+/* Each band gets at least this many rows so that the fixed cost of a
+ * composite function call stays small compared to the work done.
+ */
+#define PARALLEL_MIN_ROWS	8
+
+/* Cut the composite into a few more bands than there are threads so
+ * that an uneven load (for example a clip region that is dense at the
+ * top) still spreads across all of them.
+ */
+#define PARALLEL_BANDS_PER_THREAD	2
+
+static pixman_thread_pool_run_t	pool_run;
+static void *			pool_data;
+static int			pool_n_threads = 1;
+
+#ifdef HAVE_BUILTIN_THREAD_POOL
+
+#ifdef HAVE_PTHREADS
+
+typedef pthread_mutex_t		pool_mutex_t;
+typedef pthread_cond_t		pool_cond_t;
+typedef pthread_t		pool_thread_t;
+
+# define pool_mutex_init(m)	pthread_mutex_init ((m), NULL)
+# define pool_mutex_fini(m)	pthread_mutex_destroy (m)
+# define pool_mutex_lock(m)	pthread_mutex_lock (m)
+# define pool_mutex_unlock(m)	pthread_mutex_unlock (m)
+# define pool_cond_init(c)	pthread_cond_init ((c), NULL)
+# define pool_cond_fini(c)	pthread_cond_destroy (c)
+# define pool_cond_wait(c, m)	pthread_cond_wait ((c), (m))
+# define pool_cond_signal(c)	pthread_cond_signal (c)
+# define pool_cond_broadcast(c)	pthread_cond_broadcast (c)
+
+#define POOL_WORKER_RETURN	void *
+#define POOL_WORKER_EXIT	NULL
+
+#else /* _WIN32 */
+
+typedef CRITICAL_SECTION	pool_mutex_t;
+typedef CONDITION_VARIABLE	pool_cond_t;
+typedef HANDLE			pool_thread_t;
+
+# define pool_mutex_init(m)	InitializeCriticalSection (m)
+# define pool_mutex_fini(m)	DeleteCriticalSection (m)
+# define pool_mutex_lock(m)	EnterCriticalSection (m)
+# define pool_mutex_unlock(m)	LeaveCriticalSection (m)
+# define pool_cond_init(c)	InitializeConditionVariable (c)
+# define pool_cond_fini(c)	((void)0)
+# define pool_cond_wait(c, m)	SleepConditionVariableCS ((c), (m), INFINITE)
+# define pool_cond_signal(c)	WakeConditionVariable (c)
+# define pool_cond_broadcast(c)	WakeAllConditionVariable (c)
+
+#define POOL_WORKER_RETURN	DWORD WINAPI
+#define POOL_WORKER_EXIT	0
+
+#endif
+
+/* The built-in pool runs one job at a time. The thread that submits a
+ * job takes tasks from it along with the workers, and a second thread
+ * that submits a job while the pool is busy simply runs its own tasks
+ * serially instead of waiting.
+ */
+typedef struct
+{
+    pool_mutex_t		mutex;
+    pool_cond_t			work_cond;
+    pool_cond_t			done_cond;
+
+    int				n_workers;
+    pool_thread_t *		workers;
+
+    pixman_bool_t		quit;
+    pixman_bool_t		busy;
+
+    pixman_parallel_task_t	task;
+    void *			task_data;
+    int				n_tasks;
+    int				next_task;
+    int				n_pending;
+} builtin_pool_t;
+
+static builtin_pool_t *builtin_pool;
+
+static POOL_WORKER_RETURN
+builtin_pool_worker (void *data)
+{
+    builtin_pool_t *pool = data;
+
+    pool_mutex_lock (&pool->mutex);
+
+    for (;;)
+    {
+	int index;
+
+	while (!pool->quit && pool->next_task >= pool->n_tasks)
+	    pool_cond_wait (&pool->work_cond, &pool->mutex);
+
+	if (pool->quit)
+	    break;
+
+	index = pool->next_task++;
+	pool_mutex_unlock (&pool->mutex);
+
+	pool->task (pool->task_data, index);
+
+	pool_mutex_lock (&pool->mutex);
+	if (--pool->n_pending == 0)
+	    pool_cond_signal (&pool->done_cond);
+    }
+
+    pool_mutex_unlock (&pool->mutex);
+
+    /* Without pthreads, nothing frees the arena when the thread exits */
+    pixman_release_scratch_memory ();
+
+    return POOL_WORKER_EXIT;
+}
+
+static void
+builtin_pool_run (void                   *data,
+		  pixman_parallel_task_t  task,
+		  void                   *task_data,
+		  int                     n_tasks)
+{
+    builtin_pool_t *pool = data;
+    int i;
+
+    pool_mutex_lock (&pool->mutex);
+
+    if (pool->busy)
+    {
+	pool_mutex_unlock (&pool->mutex);
+
+	for (i = 0; i < n_tasks; ++i)
+	    task (task_data, i);
+
+	return;
+    }
+
+    pool->busy = TRUE;
+    pool->task = task;
+    pool->task_data = task_data;
+    pool->n_tasks = n_tasks;
+    pool->next_task = 0;
+    pool->n_pending = n_tasks;
+
+    pool_cond_broadcast (&pool->work_cond);
+
+    while (pool->next_task < pool->n_tasks)
+    {
+	i = pool->next_task++;
+	pool_mutex_unlock (&pool->mutex);
+
+	task (task_data, i);
+
+	pool_mutex_lock (&pool->mutex);
+	pool->n_pending--;
+    }
+
+    while (pool->n_pending > 0)
+	pool_cond_wait (&pool->done_cond, &pool->mutex);
+
+    pool->n_tasks = 0;
+    pool->next_task = 0;
+    pool->busy = FALSE;
+
+    pool_mutex_unlock (&pool->mutex);
+}
+
+static void
+builtin_pool_destroy (builtin_pool_t *pool)
+{
+    int i;
+
+    pool_mutex_lock (&pool->mutex);
+    pool->quit = TRUE;
+    pool_cond_broadcast (&pool->work_cond);
+    pool_mutex_unlock (&pool->mutex);
+
+    for (i = 0; i < pool->n_workers; ++i)
+    {
+#ifdef HAVE_PTHREADS
+	pthread_join (pool->workers[i], NULL);
+#else
+	WaitForSingleObject (pool->workers[i], INFINITE);
+	CloseHandle (pool->workers[i]);
+#endif
+    }
+
+    pool_cond_fini (&pool->done_cond);
+    pool_cond_fini (&pool->work_cond);
+    pool_mutex_fini (&pool->mutex);
+
+    free (pool->workers);
+    free (pool);
+}
+
+static builtin_pool_t *
+builtin_pool_create (int n_workers)
+{
+    builtin_pool_t *pool;
+
+    if (!(pool = calloc (1, sizeof (builtin_pool_t))))
+	return NULL;
+
+    if (!(pool->workers = pixman_malloc_ab (n_workers, sizeof (pool_thread_t))))
+    {
+	free (pool);
+	return NULL;
+    }
+
+    pool_mutex_init (&pool->mutex);
+    pool_cond_init (&pool->work_cond);
+    pool_cond_init (&pool->done_cond);
+
+    for (pool->n_workers = 0; pool->n_workers < n_workers; pool->n_workers++)
+    {
+	pool_thread_t *thread = &pool->workers[pool->n_workers];
+
+#ifdef HAVE_PTHREADS
+	if (pthread_create (thread, NULL, builtin_pool_worker, pool) != 0)
+	    break;
+#else
+	if (!(*thread = CreateThread (NULL, 0, builtin_pool_worker, pool, 0, NULL)))
+	    break;
+#endif
+    }
+
+    if (pool->n_workers != n_workers)
+    {
+	builtin_pool_destroy (pool);
+	return NULL;
+    }
+
+    return pool;
+}
+
+#endif /* HAVE_BUILTIN_THREAD_POOL */
+
+static void
+release_builtin_pool (void)
+{
+#ifdef HAVE_BUILTIN_THREAD_POOL
+    if (builtin_pool)
+    {
+	builtin_pool_destroy (builtin_pool);
+	builtin_pool = NULL;
+    }
+#endif
+}
+
+PIXMAN_EXPORT void
+pixman_set_thread_pool (pixman_thread_pool_run_t  run,
+			void                     *data,
+			int                       n_threads)
+{
+    release_builtin_pool ();
+
+    if (!run || n_threads <= 1)
+    {
+	run = NULL;
+	data = NULL;
+	n_threads = 1;
+    }
+
+    pool_run = run;
+    pool_data = data;
+    pool_n_threads = n_threads;
+}
+
+PIXMAN_EXPORT pixman_bool_t
+pixman_set_threads (int n_threads)
+{
+    if (n_threads <= 1)
+    {
+	pixman_set_thread_pool (NULL, NULL, 1);
+	return TRUE;
+    }
+
+#ifdef HAVE_BUILTIN_THREAD_POOL
+    if (builtin_pool && builtin_pool->n_workers == n_threads - 1)
+	return TRUE;
+
+    pixman_set_thread_pool (NULL, NULL, 1);
+
+    /* The calling thread does its share of the work */
+    if (!(builtin_pool = builtin_pool_create (n_threads - 1)))
+	return FALSE;
+
+    pool_run = builtin_pool_run;
+    pool_data = builtin_pool;
+    pool_n_threads = n_threads;
+
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+typedef struct
+{
+    pixman_implementation_t *	    imp;
+    pixman_composite_func_t	    func;
+    const pixman_composite_info_t * info;
+    const pixman_box32_t *	    boxes;
+    int				    n_boxes;
+    int32_t			    src_dx, src_dy;
+    int32_t			    mask_dx, mask_dy;
+    int32_t			    y;
+    int32_t			    band_height;
+} band_job_t;
+
+static void
+composite_band (void *data, int index)
+{
+    const band_job_t *job = data;
+    pixman_composite_info_t info = *job->info;
+    const pixman_box32_t *pbox = job->boxes;
+    int32_t y1 = job->y + index * job->band_height;
+    int32_t y2 = y1 + job->band_height;
+    int n = job->n_boxes;
+
+    /* The boxes of a region are sorted by y1, so nothing past the first
+     * box starting below the band can intersect it.
+     */
+    while (n-- && pbox->y1 < y2)
+    {
+	int32_t top = MAX (pbox->y1, y1);
+	int32_t bottom = MIN (pbox->y2, y2);
+
+	if (top < bottom)
+	{
+	    info.src_x = pbox->x1 + job->src_dx;
+	    info.src_y = top + job->src_dy;
+	    info.mask_x = pbox->x1 + job->mask_dx;
+	    info.mask_y = top + job->mask_dy;
+	    info.dest_x = pbox->x1;
+	    info.dest_y = top;
+	    info.width = pbox->x2 - pbox->x1;
+	    info.height = bottom - top;
+
+	    job->func (job->imp, &info);
+	}
+
+	pbox++;
+    }
+}
+
+/* Checks an image against the destination, or only for accessors when
+ * dest is NULL.
+ */
+static pixman_bool_t
+image_is_band_safe (pixman_image_t *image, pixman_image_t *dest)
+{
+    if (!image)
+	return TRUE;
+
+    /* User supplied read/write functions are not known to be reentrant */
+    if (!(image->common.flags & FAST_PATH_NO_ACCESSORS))
+	return FALSE;
+
+    /* Another band may be writing the pixels this one reads, also when
+     * the source is the destination or shares memory with it.
+     */
+    if (dest && image->type == BITS &&
+	_pixman_bits_image_overlaps (&image->bits, &dest->bits))
+    {
+	return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Splits the boxes into horizontal bands and runs func on them through
+ * the registered thread pool. Returns FALSE without compositing anything
+ * if the operation should be done serially by the caller instead.
+ */
+pixman_bool_t
+_pixman_composite_parallel (pixman_implementation_t *      imp,
+			    pixman_composite_func_t        func,
+			    const pixman_composite_info_t *info,
+			    const pixman_box32_t *         boxes,
+			    int                            n_boxes,
+			    int32_t                        src_dx,
+			    int32_t                        src_dy,
+			    int32_t                        mask_dx,
+			    int32_t                        mask_dy)
+{
+    band_job_t job;
+    uint64_t n_pixels = 0;
+    int32_t height;
+    int n_bands, i;
+
+    if (!pool_run || n_boxes <= 0)
+	return FALSE;
+
+    for (i = 0; i < n_boxes; ++i)
+    {
+	n_pixels += (uint64_t)(boxes[i].x2 - boxes[i].x1) *
+	    (boxes[i].y2 - boxes[i].y1);
+    }
+
+    if (n_pixels < PARALLEL_MIN_PIXELS)
+	return FALSE;
+
+    if (!image_is_band_safe (info->src_image, info->dest_image)	||
+	!image_is_band_safe (info->mask_image, info->dest_image)	||
+	!image_is_band_safe (info->dest_image, NULL))
+    {
+	return FALSE;
+    }
+
+    job.y = boxes[0].y1;
+
+    /* Bands of a planar YUV destination start on even rows, so that no
+     * two of them write the same chroma row.
+     */
+    if (PIXMAN_FORMAT_PLANAR (info->dest_image->bits.format))
+	job.y &= ~1;
+
+    height = boxes[n_boxes - 1].y2 - job.y;
+
+    n_bands = pool_n_threads * PARALLEL_BANDS_PER_THREAD;
+    if (n_bands > height / PARALLEL_MIN_ROWS)
+	n_bands = height / PARALLEL_MIN_ROWS;
+
+    if (n_bands <= 1)
+	return FALSE;
+
+    job.band_height = (height + n_bands - 1) / n_bands;
+    if (PIXMAN_FORMAT_PLANAR (info->dest_image->bits.format))
+	job.band_height = (job.band_height + 1) & ~1;
+    n_bands = (height + job.band_height - 1) / job.band_height;
+
+    job.imp = imp;
+    job.func = func;
+    job.info = info;
+    job.boxes = boxes;
+    job.n_boxes = n_boxes;
+    job.src_dx = src_dx;
+    job.src_dy = src_dy;
+    job.mask_dx = mask_dx;
+    job.mask_dy = mask_dy;
+
+    pool_run (pool_data, composite_band, &job, n_bands);
+
+    return TRUE;
+}
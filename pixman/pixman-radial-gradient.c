@@ -184,6 +184,46 @@ radial_write_color (double                         a,
     return;
 }
 
+/* Computes B and C for the point v and their differences along unit,
+ * for an affine transformation. See radial_get_scanline().
+ */
+static void
+radial_affine_start (radial_gradient_t     *radial,
+		     const pixman_vector_t *point,
+		     const pixman_vector_t *unit,
+		     radial_step_t         *step)
+{
+    pixman_vector_t v = *point;
+
+    /* warning: this computation may overflow */
+    v.vector[0] -= radial->c1.x;
+    v.vector[1] -= radial->c1.y;
+
+    /*
+     * B and C are computed and updated exactly.
+     * If fdot was used instead of dot, in the worst case it would
+     * lose 11 bits of precision in each of the multiplication and
+     * summing up would zero out all the bit that were preserved,
+     * thus making the result 0 instead of the correct one.
+     * This would mean a worst case of unbound relative error or
+     * about 2^10 absolute error
+     */
+    step->b = dot (v.vector[0], v.vector[1], radial->c1.radius,
+		   radial->delta.x, radial->delta.y, radial->delta.radius);
+    step->db = dot (unit->vector[0], unit->vector[1], 0,
+		    radial->delta.x, radial->delta.y, 0);
+
+    step->c = dot (v.vector[0], v.vector[1],
+		   -((pixman_fixed_48_16_t) radial->c1.radius),
+		   v.vector[0], v.vector[1], radial->c1.radius);
+    step->dc = dot (2 * (pixman_fixed_48_16_t) v.vector[0] + unit->vector[0],
+		    2 * (pixman_fixed_48_16_t) v.vector[1] + unit->vector[1],
+		    0,
+		    unit->vector[0], unit->vector[1], 0);
+    step->ddc = 2 * dot (unit->vector[0], unit->vector[1], 0,
+			 unit->vector[0], unit->vector[1], 0);
+}
+
 static uint32_t *
 radial_get_scanline (pixman_iter_t                 *iter,
 		     const uint32_t                *mask,
@@ -288,7 +328,8 @@ radial_get_scanline (pixman_iter_t                 *iter,
     v.vector[1] = pixman_int_to_fixed (y) + pixman_fixed_1 / 2;
     v.vector[2] = pixman_fixed_1;
 
-    _pixman_gradient_walker_init (&walker, gradient, image->common.repeat);
+    _pixman_gradient_walker_init (&walker, gradient,
+				  image->common.repeat, iter);
 
     if (image->common.transform)
     {
@@ -328,41 +369,15 @@ radial_get_scanline (pixman_iter_t                 *iter,
 	 *
 	 * we can then express B, C and det through multiple differentiation.
 	 */
-	pixman_fixed_32_32_t b, db, c, dc, ddc;
+	radial_step_t step;
 
-	/* warning: this computation may overflow */
-	v.vector[0] -= radial->c1.x;
-	v.vector[1] -= radial->c1.y;
-
-	/*
-	 * B and C are computed and updated exactly.
-	 * If fdot was used instead of dot, in the worst case it would
-	 * lose 11 bits of precision in each of the multiplication and
-	 * summing up would zero out all the bit that were preserved,
-	 * thus making the result 0 instead of the correct one.
-	 * This would mean a worst case of unbound relative error or
-	 * about 2^10 absolute error
-	 */
-	b = dot (v.vector[0], v.vector[1], radial->c1.radius,
-		 radial->delta.x, radial->delta.y, radial->delta.radius);
-	db = dot (unit.vector[0], unit.vector[1], 0,
-		  radial->delta.x, radial->delta.y, 0);
-
-	c = dot (v.vector[0], v.vector[1],
-		 -((pixman_fixed_48_16_t) radial->c1.radius),
-		 v.vector[0], v.vector[1], radial->c1.radius);
-	dc = dot (2 * (pixman_fixed_48_16_t) v.vector[0] + unit.vector[0],
-		  2 * (pixman_fixed_48_16_t) v.vector[1] + unit.vector[1],
-		  0,
-		  unit.vector[0], unit.vector[1], 0);
-	ddc = 2 * dot (unit.vector[0], unit.vector[1], 0,
-		       unit.vector[0], unit.vector[1], 0);
+	radial_affine_start (radial, &v, &unit, &step);
 
 	while (buffer < end)
 	{
 	    if (!mask || *mask++)
 	    {
-		radial_write_color (radial->a, b, c,
+		radial_write_color (radial->a, step.b, step.c,
 				    radial->inva,
 				    radial->delta.radius,
 				    radial->mindr,
@@ -373,9 +388,9 @@ radial_get_scanline (pixman_iter_t                 *iter,
 				    buffer);
 	    }
 
-	    b += db;
-	    c += dc;
-	    dc += ddc;
+	    step.b += step.db;
+	    step.c += step.dc;
+	    step.dc += step.ddc;
 	    buffer += (Bpp / 4);
 	}
     }
@@ -452,6 +467,64 @@ radial_get_scanline_wide (pixman_iter_t *iter, const uint32_t *mask)
 				_pixman_gradient_walker_write_wide);
 }
 
+/* Scanlines of affine gradients, with the positions computed and turned
+ * into colors by the kernels of an implementation
+ */
+static uint32_t *
+radial_get_scanline_kernels (pixman_iter_t *iter, const uint32_t *mask)
+{
+    const pixman_gradient_kernels_t *kernels = iter->data;
+    pixman_image_t *image = iter->image;
+    radial_gradient_t *radial = (radial_gradient_t *)image;
+    pixman_bool_t narrow = iter->iter_flags & ITER_NARROW;
+    int width = iter->width;
+    int32_t *positions = (int32_t *)iter->buffer + (narrow ? 0 : 3 * width);
+    pixman_gradient_walker_t walker;
+    pixman_vector_t v, unit;
+    radial_step_t step;
+
+    v.vector[0] = pixman_int_to_fixed (iter->x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (iter->y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    unit.vector[0] = pixman_fixed_1;
+    unit.vector[1] = 0;
+    unit.vector[2] = 0;
+
+    if (image->common.transform)
+    {
+	if (!pixman_transform_point_3d (image->common.transform, &v))
+	    return iter->buffer;
+
+	unit.vector[0] = image->common.transform->matrix[0][0];
+	unit.vector[1] = image->common.transform->matrix[1][0];
+    }
+
+    radial_affine_start (radial, &v, &unit, &step);
+
+    kernels->radial (positions, radial, image->common.repeat, &step, width);
+
+    _pixman_gradient_walker_init (&walker, &image->gradient,
+				  image->common.repeat, iter);
+
+    if (narrow)
+	kernels->write_narrow (&walker, iter->buffer, positions, width);
+    else
+	kernels->write_wide (&walker, iter->buffer, positions, width);
+
+    iter->y++;
+
+    return iter->buffer;
+}
+
+void
+_pixman_radial_gradient_kernel_iter_init (pixman_iter_t                   *iter,
+					  const pixman_gradient_kernels_t *kernels)
+{
+    iter->data = (void *)kernels;
+    iter->get_scanline = radial_get_scanline_kernels;
+}
+
 void
 _pixman_radial_gradient_iter_init (pixman_image_t *image, pixman_iter_t *iter)
 {
@@ -0,0 +1,563 @@
+/* WARNING: This file is generated by make-srgb.pl.
+ * Please edit that file instead of this one.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "pixman-private.h"
+
+const uint16_t _pixman_srgb_to_linear16[257] =
+{
+    0x0000, 0x0014, 0x0028, 0x003c, 0x0050, 0x0063, 0x0077, 0x008b,
+    0x009f, 0x00b3, 0x00c7, 0x00db, 0x00f1, 0x0108, 0x0120, 0x0139,
+    0x0154, 0x016f, 0x018c, 0x01ab, 0x01ca, 0x01eb, 0x020e, 0x0232,
+    0x0257, 0x027d, 0x02a5, 0x02ce, 0x02f9, 0x0325, 0x0353, 0x0382,
+    0x03b3, 0x03e5, 0x0418, 0x044d, 0x0484, 0x04bc, 0x04f6, 0x0532,
+    0x056f, 0x05ad, 0x05ed, 0x062f, 0x0673, 0x06b8, 0x06fe, 0x0747,
+    0x0791, 0x07dd, 0x082a, 0x087a, 0x08ca, 0x091d, 0x0972, 0x09c8,
+    0x0a20, 0x0a79, 0x0ad5, 0x0b32, 0x0b91, 0x0bf2, 0x0c55, 0x0cba,
+    0x0d20, 0x0d88, 0x0df2, 0x0e5e, 0x0ecc, 0x0f3c, 0x0fae, 0x1021,
+    0x1097, 0x110e, 0x1188, 0x1203, 0x1280, 0x1300, 0x1381, 0x1404,
+    0x1489, 0x1510, 0x159a, 0x1625, 0x16b2, 0x1741, 0x17d3, 0x1866,
+    0x18fb, 0x1993, 0x1a2c, 0x1ac8, 0x1b66, 0x1c06, 0x1ca7, 0x1d4c,
+    0x1df2, 0x1e9a, 0x1f44, 0x1ff1, 0x20a0, 0x2150, 0x2204, 0x22b9,
+    0x2370, 0x242a, 0x24e5, 0x25a3, 0x2664, 0x2726, 0x27eb, 0x28b1,
+    0x297b, 0x2a46, 0x2b14, 0x2be3, 0x2cb6, 0x2d8a, 0x2e61, 0x2f3a,
+    0x3015, 0x30f2, 0x31d2, 0x32b4, 0x3399, 0x3480, 0x3569, 0x3655,
+    0x3742, 0x3833, 0x3925, 0x3a1a, 0x3b12, 0x3c0b, 0x3d07, 0x3e06,
+    0x3f07, 0x400a, 0x4110, 0x4218, 0x4323, 0x4430, 0x453f, 0x4651,
+    0x4765, 0x487c, 0x4995, 0x4ab1, 0x4bcf, 0x4cf0, 0x4e13, 0x4f39,
+    0x5061, 0x518c, 0x52b9, 0x53e9, 0x551b, 0x5650, 0x5787, 0x58c1,
+    0x59fe, 0x5b3d, 0x5c7e, 0x5dc2, 0x5f09, 0x6052, 0x619e, 0x62ed,
+    0x643e, 0x6591, 0x66e8, 0x6840, 0x699c, 0x6afa, 0x6c5b, 0x6dbe,
+    0x6f24, 0x708d, 0x71f8, 0x7366, 0x74d7, 0x764a, 0x77c0, 0x7939,
+    0x7ab4, 0x7c32, 0x7db3, 0x7f37, 0x80bd, 0x8246, 0x83d1, 0x855f,
+    0x86f0, 0x8884, 0x8a1b, 0x8bb4, 0x8d50, 0x8eef, 0x9090, 0x9235,
+    0x93dc, 0x9586, 0x9732, 0x98e2, 0x9a94, 0x9c49, 0x9e01, 0x9fbb,
+    0xa179, 0xa339, 0xa4fc, 0xa6c2, 0xa88b, 0xaa56, 0xac25, 0xadf6,
+    0xafca, 0xb1a1, 0xb37b, 0xb557, 0xb737, 0xb919, 0xbaff, 0xbce7,
+    0xbed2, 0xc0c0, 0xc2b1, 0xc4a5, 0xc69c, 0xc895, 0xca92, 0xcc91,
+    0xce94, 0xd099, 0xd2a1, 0xd4ad, 0xd6bb, 0xd8cc, 0xdae0, 0xdcf7,
+    0xdf11, 0xe12e, 0xe34e, 0xe571, 0xe797, 0xe9c0, 0xebec, 0xee1b,
+    0xf04d, 0xf282, 0xf4ba, 0xf6f5, 0xf933, 0xfb74, 0xfdb8, 0xffff,
+    0x0000,
+};
+
+const uint16_t _pixman_linear_to_srgb[4097] =
+{
+    0x0a00, 0x0e01, 0x1002, 0x0202, 0x0603, 0x0a04, 0x0e05, 0x1006,
+    0x0206, 0x0607, 0x0a08, 0x0d09, 0x100a, 0x020a, 0x070b, 0x0d0c,
+    0x100d, 0x040d, 0x0d0e, 0x100f, 0x070f, 0x1010, 0x0210, 0x0e11,
+    0x1012, 0x0c12, 0x1013, 0x0b13, 0x1014, 0x0b14, 0x1015, 0x0d15,
+    0x1016, 0x1016, 0x1017, 0x1017, 0x0517, 0x1018, 0x0a18, 0x1019,
+    0x1019, 0x0219, 0x101a, 0x0a1a, 0x101b, 0x101b, 0x041b, 0x101c,
+    0x101c, 0x101d, 0x101d, 0x0d1d, 0x101e, 0x101e, 0x0b1e, 0x101f,
+    0x101f, 0x0b1f, 0x1020, 0x1020, 0x0c20, 0x1021, 0x1021, 0x0f21,
+    0x1022, 0x1022, 0x1022, 0x0322, 0x1023, 0x1023, 0x0923, 0x1024,
+    0x1024, 0x1024, 0x0124, 0x1025, 0x1025, 0x0a25, 0x1026, 0x1026,
+    0x1026, 0x0426, 0x1027, 0x1027, 0x1027, 0x0127, 0x1028, 0x1028,
+    0x0e28, 0x1029, 0x1029, 0x1029, 0x0e29, 0x102a, 0x102a, 0x102a,
+    0x0f2a, 0x102b, 0x102b, 0x102b, 0x102b, 0x012b, 0x102c, 0x102c,
+    0x102c, 0x062c, 0x102d, 0x102d, 0x102d, 0x0c2d, 0x102e, 0x102e,
+    0x102e, 0x102e, 0x032e, 0x102f, 0x102f, 0x102f, 0x0c2f, 0x1030,
+    0x1030, 0x1030, 0x1030, 0x0730, 0x1031, 0x1031, 0x1031, 0x1031,
+    0x0431, 0x1032, 0x1032, 0x1032, 0x1032, 0x0232, 0x1033, 0x1033,
+    0x1033, 0x1033, 0x0233, 0x1034, 0x1034, 0x1034, 0x1034, 0x0434,
+    0x1035, 0x1035, 0x1035, 0x1035, 0x0835, 0x1036, 0x1036, 0x1036,
+    0x1036, 0x0d36, 0x1037, 0x1037, 0x1037, 0x1037, 0x1037, 0x0437,
+    0x1038, 0x1038, 0x1038, 0x1038, 0x0d38, 0x1039, 0x1039, 0x1039,
+    0x1039, 0x1039, 0x0839, 0x103a, 0x103a, 0x103a, 0x103a, 0x103a,
+    0x043a, 0x103b, 0x103b, 0x103b, 0x103b, 0x103b, 0x023b, 0x103c,
+    0x103c, 0x103c, 0x103c, 0x103c, 0x023c, 0x103d, 0x103d, 0x103d,
+    0x103d, 0x103d, 0x043d, 0x103e, 0x103e, 0x103e, 0x103e, 0x103e,
+    0x083e, 0x103f, 0x103f, 0x103f, 0x103f, 0x103f, 0x0d3f, 0x1040,
+    0x1040, 0x1040, 0x1040, 0x1040, 0x1040, 0x0540, 0x1041, 0x1041,
+    0x1041, 0x1041, 0x1041, 0x0e41, 0x1042, 0x1042, 0x1042, 0x1042,
+    0x1042, 0x1042, 0x0942, 0x1043, 0x1043, 0x1043, 0x1043, 0x1043,
+    0x1043, 0x0643, 0x1044, 0x1044, 0x1044, 0x1044, 0x1044, 0x1044,
+    0x0544, 0x1045, 0x1045, 0x1045, 0x1045, 0x1045, 0x1045, 0x0545,
+    0x1046, 0x1046, 0x1046, 0x1046, 0x1046, 0x1046, 0x0846, 0x1047,
+    0x1047, 0x1047, 0x1047, 0x1047, 0x1047, 0x0d47, 0x1048, 0x1048,
+    0x1048, 0x1048, 0x1048, 0x1048, 0x1048, 0x0348, 0x1049, 0x1049,
+    0x1049, 0x1049, 0x1049, 0x1049, 0x0c49, 0x104a, 0x104a, 0x104a,
+    0x104a, 0x104a, 0x104a, 0x104a, 0x064a, 0x104b, 0x104b, 0x104b,
+    0x104b, 0x104b, 0x104b, 0x104b, 0x024b, 0x104c, 0x104c, 0x104c,
+    0x104c, 0x104c, 0x104c, 0x104c, 0x104d, 0x104d, 0x104d, 0x104d,
+    0x104d, 0x104d, 0x104d, 0x104d, 0x014d, 0x104e, 0x104e, 0x104e,
+    0x104e, 0x104e, 0x104e, 0x104e, 0x034e, 0x104f, 0x104f, 0x104f,
+    0x104f, 0x104f, 0x104f, 0x104f, 0x074f, 0x1050, 0x1050, 0x1050,
+    0x1050, 0x1050, 0x1050, 0x1050, 0x0d50, 0x1051, 0x1051, 0x1051,
+    0x1051, 0x1051, 0x1051, 0x1051, 0x1051, 0x0551, 0x1052, 0x1052,
+    0x1052, 0x1052, 0x1052, 0x1052, 0x1052, 0x1052, 0x1053, 0x1053,
+    0x1053, 0x1053, 0x1053, 0x1053, 0x1053, 0x1053, 0x0c53, 0x1054,
+    0x1054, 0x1054, 0x1054, 0x1054, 0x1054, 0x1054, 0x1054, 0x0a54,
+    0x1055, 0x1055, 0x1055, 0x1055, 0x1055, 0x1055, 0x1055, 0x1055,
+    0x0a55, 0x1056, 0x1056, 0x1056, 0x1056, 0x1056, 0x1056, 0x1056,
+    0x1056, 0x0d56, 0x1057, 0x1057, 0x1057, 0x1057, 0x1057, 0x1057,
+    0x1057, 0x1057, 0x1057, 0x0157, 0x1058, 0x1058, 0x1058, 0x1058,
+    0x1058, 0x1058, 0x1058, 0x1058, 0x0858, 0x1059, 0x1059, 0x1059,
+    0x1059, 0x1059, 0x1059, 0x1059, 0x1059, 0x1059, 0x105a, 0x105a,
+    0x105a, 0x105a, 0x105a, 0x105a, 0x105a, 0x105a, 0x105a, 0x0b5a,
+    0x105b, 0x105b, 0x105b, 0x105b, 0x105b, 0x105b, 0x105b, 0x105b,
+    0x105b, 0x075b, 0x105c, 0x105c, 0x105c, 0x105c, 0x105c, 0x105c,
+    0x105c, 0x105c, 0x105c, 0x065c, 0x105d, 0x105d, 0x105d, 0x105d,
+    0x105d, 0x105d, 0x105d, 0x105d, 0x105d, 0x075d, 0x105e, 0x105e,
+    0x105e, 0x105e, 0x105e, 0x105e, 0x105e, 0x105e, 0x105e, 0x0a5e,
+    0x105f, 0x105f, 0x105f, 0x105f, 0x105f, 0x105f, 0x105f, 0x105f,
+    0x105f, 0x0f5f, 0x1060, 0x1060, 0x1060, 0x1060, 0x1060, 0x1060,
+    0x1060, 0x1060, 0x1060, 0x1060, 0x0660, 0x1061, 0x1061, 0x1061,
+    0x1061, 0x1061, 0x1061, 0x1061, 0x1061, 0x1061, 0x1061, 0x1062,
+    0x1062, 0x1062, 0x1062, 0x1062, 0x1062, 0x1062, 0x1062, 0x1062,
+    0x1062, 0x0b62, 0x1063, 0x1063, 0x1063, 0x1063, 0x1063, 0x1063,
+    0x1063, 0x1063, 0x1063, 0x1063, 0x0963, 0x1064, 0x1064, 0x1064,
+    0x1064, 0x1064, 0x1064, 0x1064, 0x1064, 0x1064, 0x1064, 0x0964,
+    0x1065, 0x1065, 0x1065, 0x1065, 0x1065, 0x1065, 0x1065, 0x1065,
+    0x1065, 0x1065, 0x0b65, 0x1066, 0x1066, 0x1066, 0x1066, 0x1066,
+    0x1066, 0x1066, 0x1066, 0x1066, 0x1066, 0x0f66, 0x1067, 0x1067,
+    0x1067, 0x1067, 0x1067, 0x1067, 0x1067, 0x1067, 0x1067, 0x1067,
+    0x1067, 0x0567, 0x1068, 0x1068, 0x1068, 0x1068, 0x1068, 0x1068,
+    0x1068, 0x1068, 0x1068, 0x1068, 0x0d68, 0x1069, 0x1069, 0x1069,
+    0x1069, 0x1069, 0x1069, 0x1069, 0x1069, 0x1069, 0x1069, 0x1069,
+    0x0869, 0x106a, 0x106a, 0x106a, 0x106a, 0x106a, 0x106a, 0x106a,
+    0x106a, 0x106a, 0x106a, 0x106a, 0x056a, 0x106b, 0x106b, 0x106b,
+    0x106b, 0x106b, 0x106b, 0x106b, 0x106b, 0x106b, 0x106b, 0x106b,
+    0x046b, 0x106c, 0x106c, 0x106c, 0x106c, 0x106c, 0x106c, 0x106c,
+    0x106c, 0x106c, 0x106c, 0x106c, 0x056c, 0x106d, 0x106d, 0x106d,
+    0x106d, 0x106d, 0x106d, 0x106d, 0x106d, 0x106d, 0x106d, 0x106d,
+    0x096d, 0x106e, 0x106e, 0x106e, 0x106e, 0x106e, 0x106e, 0x106e,
+    0x106e, 0x106e, 0x106e, 0x106e, 0x0f6e, 0x106f, 0x106f, 0x106f,
+    0x106f, 0x106f, 0x106f, 0x106f, 0x106f, 0x106f, 0x106f, 0x106f,
+    0x106f, 0x076f, 0x1070, 0x1070, 0x1070, 0x1070, 0x1070, 0x1070,
+    0x1070, 0x1070, 0x1070, 0x1070, 0x1070, 0x1070, 0x0170, 0x1071,
+    0x1071, 0x1071, 0x1071, 0x1071, 0x1071, 0x1071, 0x1071, 0x1071,
+    0x1071, 0x1071, 0x0d71, 0x1072, 0x1072, 0x1072, 0x1072, 0x1072,
+    0x1072, 0x1072, 0x1072, 0x1072, 0x1072, 0x1072, 0x1072, 0x0c72,
+    0x1073, 0x1073, 0x1073, 0x1073, 0x1073, 0x1073, 0x1073, 0x1073,
+    0x1073, 0x1073, 0x1073, 0x1073, 0x0d73, 0x1074, 0x1074, 0x1074,
+    0x1074, 0x1074, 0x1074, 0x1074, 0x1074, 0x1074, 0x1074, 0x1074,
+    0x1074, 0x1074, 0x1075, 0x1075, 0x1075, 0x1075, 0x1075, 0x1075,
+    0x1075, 0x1075, 0x1075, 0x1075, 0x1075, 0x1075, 0x1075, 0x0675,
+    0x1076, 0x1076, 0x1076, 0x1076, 0x1076, 0x1076, 0x1076, 0x1076,
+    0x1076, 0x1076, 0x1076, 0x1076, 0x0e76, 0x1077, 0x1077, 0x1077,
+    0x1077, 0x1077, 0x1077, 0x1077, 0x1077, 0x1077, 0x1077, 0x1077,
+    0x1077, 0x1077, 0x0877, 0x1078, 0x1078, 0x1078, 0x1078, 0x1078,
+    0x1078, 0x1078, 0x1078, 0x1078, 0x1078, 0x1078, 0x1078, 0x1078,
+    0x0478, 0x1079, 0x1079, 0x1079, 0x1079, 0x1079, 0x1079, 0x1079,
+    0x1079, 0x1079, 0x1079, 0x1079, 0x1079, 0x1079, 0x0379, 0x107a,
+    0x107a, 0x107a, 0x107a, 0x107a, 0x107a, 0x107a, 0x107a, 0x107a,
+    0x107a, 0x107a, 0x107a, 0x107a, 0x047a, 0x107b, 0x107b, 0x107b,
+    0x107b, 0x107b, 0x107b, 0x107b, 0x107b, 0x107b, 0x107b, 0x107b,
+    0x107b, 0x107b, 0x077b, 0x107c, 0x107c, 0x107c, 0x107c, 0x107c,
+    0x107c, 0x107c, 0x107c, 0x107c, 0x107c, 0x107c, 0x107c, 0x107c,
+    0x0d7c, 0x107d, 0x107d, 0x107d, 0x107d, 0x107d, 0x107d, 0x107d,
+    0x107d, 0x107d, 0x107d, 0x107d, 0x107d, 0x107d, 0x107d, 0x057d,
+    0x107e, 0x107e, 0x107e, 0x107e, 0x107e, 0x107e, 0x107e, 0x107e,
+    0x107e, 0x107e, 0x107e, 0x107e, 0x107e, 0x0f7e, 0x107f, 0x107f,
+    0x107f, 0x107f, 0x107f, 0x107f, 0x107f, 0x107f, 0x107f, 0x107f,
+    0x107f, 0x107f, 0x107f, 0x107f, 0x0c7f, 0x1080, 0x1080, 0x1080,
+    0x1080, 0x1080, 0x1080, 0x1080, 0x1080, 0x1080, 0x1080, 0x1080,
+    0x1080, 0x1080, 0x1080, 0x0b80, 0x1081, 0x1081, 0x1081, 0x1081,
+    0x1081, 0x1081, 0x1081, 0x1081, 0x1081, 0x1081, 0x1081, 0x1081,
+    0x1081, 0x1081, 0x0c81, 0x1082, 0x1082, 0x1082, 0x1082, 0x1082,
+    0x1082, 0x1082, 0x1082, 0x1082, 0x1082, 0x1082, 0x1082, 0x1082,
+    0x1082, 0x1082, 0x1083, 0x1083, 0x1083, 0x1083, 0x1083, 0x1083,
+    0x1083, 0x1083, 0x1083, 0x1083, 0x1083, 0x1083, 0x1083, 0x1083,
+    0x1083, 0x0683, 0x1084, 0x1084, 0x1084, 0x1084, 0x1084, 0x1084,
+    0x1084, 0x1084, 0x1084, 0x1084, 0x1084, 0x1084, 0x1084, 0x1084,
+    0x0f84, 0x1085, 0x1085, 0x1085, 0x1085, 0x1085, 0x1085, 0x1085,
+    0x1085, 0x1085, 0x1085, 0x1085, 0x1085, 0x1085, 0x1085, 0x1085,
+    0x0a85, 0x1086, 0x1086, 0x1086, 0x1086, 0x1086, 0x1086, 0x1086,
+    0x1086, 0x1086, 0x1086, 0x1086, 0x1086, 0x1086, 0x1086, 0x1086,
+    0x0786, 0x1087, 0x1087, 0x1087, 0x1087, 0x1087, 0x1087, 0x1087,
+    0x1087, 0x1087, 0x1087, 0x1087, 0x1087, 0x1087, 0x1087, 0x1087,
+    0x0787, 0x1088, 0x1088, 0x1088, 0x1088, 0x1088, 0x1088, 0x1088,
+    0x1088, 0x1088, 0x1088, 0x1088, 0x1088, 0x1088, 0x1088, 0x1088,
+    0x0988, 0x1089, 0x1089, 0x1089, 0x1089, 0x1089, 0x1089, 0x1089,
+    0x1089, 0x1089, 0x1089, 0x1089, 0x1089, 0x1089, 0x1089, 0x1089,
+    0x0d89, 0x108a, 0x108a, 0x108a, 0x108a, 0x108a, 0x108a, 0x108a,
+    0x108a, 0x108a, 0x108a, 0x108a, 0x108a, 0x108a, 0x108a, 0x108a,
+    0x108a, 0x048a, 0x108b, 0x108b, 0x108b, 0x108b, 0x108b, 0x108b,
+    0x108b, 0x108b, 0x108b, 0x108b, 0x108b, 0x108b, 0x108b, 0x108b,
+    0x108b, 0x0e8b, 0x108c, 0x108c, 0x108c, 0x108c, 0x108c, 0x108c,
+    0x108c, 0x108c, 0x108c, 0x108c, 0x108c, 0x108c, 0x108c, 0x108c,
+    0x108c, 0x108c, 0x0a8c, 0x108d, 0x108d, 0x108d, 0x108d, 0x108d,
+    0x108d, 0x108d, 0x108d, 0x108d, 0x108d, 0x108d, 0x108d, 0x108d,
+    0x108d, 0x108d, 0x108d, 0x088d, 0x108e, 0x108e, 0x108e, 0x108e,
+    0x108e, 0x108e, 0x108e, 0x108e, 0x108e, 0x108e, 0x108e, 0x108e,
+    0x108e, 0x108e, 0x108e, 0x108e, 0x098e, 0x108f, 0x108f, 0x108f,
+    0x108f, 0x108f, 0x108f, 0x108f, 0x108f, 0x108f, 0x108f, 0x108f,
+    0x108f, 0x108f, 0x108f, 0x108f, 0x108f, 0x0c8f, 0x1090, 0x1090,
+    0x1090, 0x1090, 0x1090, 0x1090, 0x1090, 0x1090, 0x1090, 0x1090,
+    0x1090, 0x1090, 0x1090, 0x1090, 0x1090, 0x1090, 0x1090, 0x0190,
+    0x1091, 0x1091, 0x1091, 0x1091, 0x1091, 0x1091, 0x1091, 0x1091,
+    0x1091, 0x1091, 0x1091, 0x1091, 0x1091, 0x1091, 0x1091, 0x1091,
+    0x0991, 0x1092, 0x1092, 0x1092, 0x1092, 0x1092, 0x1092, 0x1092,
+    0x1092, 0x1092, 0x1092, 0x1092, 0x1092, 0x1092, 0x1092, 0x1092,
+    0x1092, 0x1092, 0x0492, 0x1093, 0x1093, 0x1093, 0x1093, 0x1093,
+    0x1093, 0x1093, 0x1093, 0x1093, 0x1093, 0x1093, 0x1093, 0x1093,
+    0x1093, 0x1093, 0x1093, 0x1093, 0x0193, 0x1094, 0x1094, 0x1094,
+    0x1094, 0x1094, 0x1094, 0x1094, 0x1094, 0x1094, 0x1094, 0x1094,
+    0x1094, 0x1094, 0x1094, 0x1094, 0x1094, 0x1094, 0x1095, 0x1095,
+    0x1095, 0x1095, 0x1095, 0x1095, 0x1095, 0x1095, 0x1095, 0x1095,
+    0x1095, 0x1095, 0x1095, 0x1095, 0x1095, 0x1095, 0x1095, 0x1095,
+    0x0295, 0x1096, 0x1096, 0x1096, 0x1096, 0x1096, 0x1096, 0x1096,
+    0x1096, 0x1096, 0x1096, 0x1096, 0x1096, 0x1096, 0x1096, 0x1096,
+    0x1096, 0x1096, 0x0796, 0x1097, 0x1097, 0x1097, 0x1097, 0x1097,
+    0x1097, 0x1097, 0x1097, 0x1097, 0x1097, 0x1097, 0x1097, 0x1097,
+    0x1097, 0x1097, 0x1097, 0x1097, 0x0e97, 0x1098, 0x1098, 0x1098,
+    0x1098, 0x1098, 0x1098, 0x1098, 0x1098, 0x1098, 0x1098, 0x1098,
+    0x1098, 0x1098, 0x1098, 0x1098, 0x1098, 0x1098, 0x1098, 0x0798,
+    0x1099, 0x1099, 0x1099, 0x1099, 0x1099, 0x1099, 0x1099, 0x1099,
+    0x1099, 0x1099, 0x1099, 0x1099, 0x1099, 0x1099, 0x1099, 0x1099,
+    0x1099, 0x1099, 0x0399, 0x109a, 0x109a, 0x109a, 0x109a, 0x109a,
+    0x109a, 0x109a, 0x109a, 0x109a, 0x109a, 0x109a, 0x109a, 0x109a,
+    0x109a, 0x109a, 0x109a, 0x109a, 0x109a, 0x029a, 0x109b, 0x109b,
+    0x109b, 0x109b, 0x109b, 0x109b, 0x109b, 0x109b, 0x109b, 0x109b,
+    0x109b, 0x109b, 0x109b, 0x109b, 0x109b, 0x109b, 0x109b, 0x109b,
+    0x039b, 0x109c, 0x109c, 0x109c, 0x109c, 0x109c, 0x109c, 0x109c,
+    0x109c, 0x109c, 0x109c, 0x109c, 0x109c, 0x109c, 0x109c, 0x109c,
+    0x109c, 0x109c, 0x109c, 0x069c, 0x109d, 0x109d, 0x109d, 0x109d,
+    0x109d, 0x109d, 0x109d, 0x109d, 0x109d, 0x109d, 0x109d, 0x109d,
+    0x109d, 0x109d, 0x109d, 0x109d, 0x109d, 0x109d, 0x0c9d, 0x109e,
+    0x109e, 0x109e, 0x109e, 0x109e, 0x109e, 0x109e, 0x109e, 0x109e,
+    0x109e, 0x109e, 0x109e, 0x109e, 0x109e, 0x109e, 0x109e, 0x109e,
+    0x109e, 0x109e, 0x059e, 0x109f, 0x109f, 0x109f, 0x109f, 0x109f,
+    0x109f, 0x109f, 0x109f, 0x109f, 0x109f, 0x109f, 0x109f, 0x109f,
+    0x109f, 0x109f, 0x109f, 0x109f, 0x109f, 0x109f, 0x10a0, 0x10a0,
+    0x10a0, 0x10a0, 0x10a0, 0x10a0, 0x10a0, 0x10a0, 0x10a0, 0x10a0,
+    0x10a0, 0x10a0, 0x10a0, 0x10a0, 0x10a0, 0x10a0, 0x10a0, 0x10a0,
+    0x10a0, 0x0ea0, 0x10a1, 0x10a1, 0x10a1, 0x10a1, 0x10a1, 0x10a1,
+    0x10a1, 0x10a1, 0x10a1, 0x10a1, 0x10a1, 0x10a1, 0x10a1, 0x10a1,
+    0x10a1, 0x10a1, 0x10a1, 0x10a1, 0x10a1, 0x0ea1, 0x10a2, 0x10a2,
+    0x10a2, 0x10a2, 0x10a2, 0x10a2, 0x10a2, 0x10a2, 0x10a2, 0x10a2,
+    0x10a2, 0x10a2, 0x10a2, 0x10a2, 0x10a2, 0x10a2, 0x10a2, 0x10a2,
+    0x10a2, 0x10a2, 0x01a2, 0x10a3, 0x10a3, 0x10a3, 0x10a3, 0x10a3,
+    0x10a3, 0x10a3, 0x10a3, 0x10a3, 0x10a3, 0x10a3, 0x10a3, 0x10a3,
+    0x10a3, 0x10a3, 0x10a3, 0x10a3, 0x10a3, 0x10a3, 0x06a3, 0x10a4,
+    0x10a4, 0x10a4, 0x10a4, 0x10a4, 0x10a4, 0x10a4, 0x10a4, 0x10a4,
+    0x10a4, 0x10a4, 0x10a4, 0x10a4, 0x10a4, 0x10a4, 0x10a4, 0x10a4,
+    0x10a4, 0x10a4, 0x0ea4, 0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x10a5,
+    0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x10a5,
+    0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x10a5, 0x09a5,
+    0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x10a6,
+    0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x10a6,
+    0x10a6, 0x10a6, 0x10a6, 0x10a6, 0x06a6, 0x10a7, 0x10a7, 0x10a7,
+    0x10a7, 0x10a7, 0x10a7, 0x10a7, 0x10a7, 0x10a7, 0x10a7, 0x10a7,
+    0x10a7, 0x10a7, 0x10a7, 0x10a7, 0x10a7, 0x10a7, 0x10a7, 0x10a7,
+    0x10a7, 0x06a7, 0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x10a8,
+    0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x10a8,
+    0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x10a8, 0x08a8, 0x10a9,
+    0x10a9, 0x10a9, 0x10a9, 0x10a9, 0x10a9, 0x10a9, 0x10a9, 0x10a9,
+    0x10a9, 0x10a9, 0x10a9, 0x10a9, 0x10a9, 0x10a9, 0x10a9, 0x10a9,
+    0x10a9, 0x10a9, 0x10a9, 0x0da9, 0x10aa, 0x10aa, 0x10aa, 0x10aa,
+    0x10aa, 0x10aa, 0x10aa, 0x10aa, 0x10aa, 0x10aa, 0x10aa, 0x10aa,
+    0x10aa, 0x10aa, 0x10aa, 0x10aa, 0x10aa, 0x10aa, 0x10aa, 0x10aa,
+    0x10aa, 0x05aa, 0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x10ab,
+    0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x10ab,
+    0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x10ab, 0x0fab, 0x10ac,
+    0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x10ac,
+    0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x10ac,
+    0x10ac, 0x10ac, 0x10ac, 0x10ac, 0x0cac, 0x10ad, 0x10ad, 0x10ad,
+    0x10ad, 0x10ad, 0x10ad, 0x10ad, 0x10ad, 0x10ad, 0x10ad, 0x10ad,
+    0x10ad, 0x10ad, 0x10ad, 0x10ad, 0x10ad, 0x10ad, 0x10ad, 0x10ad,
+    0x10ad, 0x10ad, 0x0bad, 0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae,
+    0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae,
+    0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae, 0x10ae,
+    0x0dae, 0x10af, 0x10af, 0x10af, 0x10af, 0x10af, 0x10af, 0x10af,
+    0x10af, 0x10af, 0x10af, 0x10af, 0x10af, 0x10af, 0x10af, 0x10af,
+    0x10af, 0x10af, 0x10af, 0x10af, 0x10af, 0x10af, 0x10af, 0x02af,
+    0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0,
+    0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0,
+    0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x10b0, 0x09b0, 0x10b1, 0x10b1,
+    0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x10b1,
+    0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x10b1,
+    0x10b1, 0x10b1, 0x10b1, 0x10b1, 0x03b1, 0x10b2, 0x10b2, 0x10b2,
+    0x10b2, 0x10b2, 0x10b2, 0x10b2, 0x10b2, 0x10b2, 0x10b2, 0x10b2,
+    0x10b2, 0x10b2, 0x10b2, 0x10b2, 0x10b2, 0x10b2, 0x10b2, 0x10b2,
+    0x10b2, 0x10b2, 0x10b2, 0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3,
+    0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3,
+    0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3, 0x10b3,
+    0x10b3, 0x0fb3, 0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4,
+    0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4,
+    0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4, 0x10b4,
+    0x10b4, 0x01b4, 0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5,
+    0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5,
+    0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5, 0x10b5,
+    0x06b5, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6,
+    0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6,
+    0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x10b6, 0x0db6,
+    0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7,
+    0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7,
+    0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x10b7, 0x07b7,
+    0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8,
+    0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8,
+    0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x10b8, 0x04b8,
+    0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9,
+    0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9,
+    0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x10b9, 0x03b9,
+    0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba,
+    0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba,
+    0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x10ba, 0x05ba,
+    0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb,
+    0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb,
+    0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x10bb, 0x0abb,
+    0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc,
+    0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc,
+    0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc, 0x10bc,
+    0x02bc, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd,
+    0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd,
+    0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd, 0x10bd,
+    0x0cbd, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be,
+    0x10be, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be,
+    0x10be, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be, 0x10be,
+    0x10be, 0x09be, 0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf,
+    0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf,
+    0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf, 0x10bf,
+    0x10bf, 0x10bf, 0x08bf, 0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0,
+    0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0,
+    0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0, 0x10c0,
+    0x10c0, 0x10c0, 0x10c0, 0x0bc0, 0x10c1, 0x10c1, 0x10c1, 0x10c1,
+    0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1,
+    0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1,
+    0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c1, 0x10c2, 0x10c2, 0x10c2,
+    0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2,
+    0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2,
+    0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x10c2, 0x08c2, 0x10c3,
+    0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3,
+    0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3,
+    0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3, 0x10c3,
+    0x03c3, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4,
+    0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4,
+    0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4, 0x10c4,
+    0x10c4, 0x10c4, 0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5,
+    0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5,
+    0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c5,
+    0x10c5, 0x10c5, 0x10c5, 0x10c5, 0x10c6, 0x10c6, 0x10c6, 0x10c6,
+    0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6,
+    0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6,
+    0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x10c6, 0x03c6, 0x10c7,
+    0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7,
+    0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7,
+    0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7, 0x10c7,
+    0x09c7, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8,
+    0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8,
+    0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8, 0x10c8,
+    0x10c8, 0x10c8, 0x10c8, 0x01c8, 0x10c9, 0x10c9, 0x10c9, 0x10c9,
+    0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9,
+    0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9,
+    0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x10c9, 0x0cc9, 0x10ca, 0x10ca,
+    0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca,
+    0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca,
+    0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca, 0x10ca,
+    0x0aca, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb,
+    0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb,
+    0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb, 0x10cb,
+    0x10cb, 0x10cb, 0x10cb, 0x0bcb, 0x10cc, 0x10cc, 0x10cc, 0x10cc,
+    0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc,
+    0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc,
+    0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x10cc, 0x0fcc, 0x10cd,
+    0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd,
+    0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd,
+    0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd, 0x10cd,
+    0x10cd, 0x10cd, 0x05cd, 0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce,
+    0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce,
+    0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce,
+    0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x10ce, 0x0ece, 0x10cf, 0x10cf,
+    0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf,
+    0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf,
+    0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf, 0x10cf,
+    0x10cf, 0x0acf, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0,
+    0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0,
+    0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0,
+    0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x10d0, 0x09d0, 0x10d1, 0x10d1,
+    0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1,
+    0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1,
+    0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1, 0x10d1,
+    0x10d1, 0x0bd1, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2,
+    0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2,
+    0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2,
+    0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x10d2, 0x0fd2, 0x10d3, 0x10d3,
+    0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3,
+    0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3,
+    0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3, 0x10d3,
+    0x10d3, 0x10d3, 0x07d3, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4,
+    0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4,
+    0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4,
+    0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x10d4, 0x01d4,
+    0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5,
+    0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5,
+    0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5, 0x10d5,
+    0x10d5, 0x10d5, 0x10d5, 0x0ed5, 0x10d6, 0x10d6, 0x10d6, 0x10d6,
+    0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6,
+    0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6,
+    0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6, 0x10d6,
+    0x0ed6, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7,
+    0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7,
+    0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7,
+    0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d7, 0x10d8, 0x10d8,
+    0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8,
+    0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8,
+    0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8, 0x10d8,
+    0x10d8, 0x10d8, 0x10d8, 0x06d8, 0x10d9, 0x10d9, 0x10d9, 0x10d9,
+    0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9,
+    0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9,
+    0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9, 0x10d9,
+    0x0ed9, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da,
+    0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da,
+    0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da,
+    0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x10da, 0x0ada, 0x10db,
+    0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db,
+    0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db,
+    0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db, 0x10db,
+    0x10db, 0x10db, 0x10db, 0x10db, 0x08db, 0x10dc, 0x10dc, 0x10dc,
+    0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc,
+    0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc,
+    0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc, 0x10dc,
+    0x10dc, 0x10dc, 0x09dc, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd,
+    0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd,
+    0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd,
+    0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd, 0x10dd,
+    0x0ddd, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de,
+    0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de,
+    0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de,
+    0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x10de, 0x03de,
+    0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df,
+    0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df,
+    0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x10df,
+    0x10df, 0x10df, 0x10df, 0x10df, 0x10df, 0x0ddf, 0x10e0, 0x10e0,
+    0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0,
+    0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0,
+    0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x10e0,
+    0x10e0, 0x10e0, 0x10e0, 0x10e0, 0x0ae0, 0x10e1, 0x10e1, 0x10e1,
+    0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1,
+    0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1,
+    0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1, 0x10e1,
+    0x10e1, 0x10e1, 0x10e1, 0x09e1, 0x10e2, 0x10e2, 0x10e2, 0x10e2,
+    0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2,
+    0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2,
+    0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2, 0x10e2,
+    0x10e2, 0x10e2, 0x0be2, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3,
+    0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3,
+    0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3,
+    0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3, 0x10e3,
+    0x10e3, 0x10e3, 0x01e3, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4,
+    0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4,
+    0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4,
+    0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4, 0x10e4,
+    0x10e4, 0x09e4, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5,
+    0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5,
+    0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5,
+    0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5, 0x10e5,
+    0x10e5, 0x04e5, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6,
+    0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6,
+    0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6,
+    0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6, 0x10e6,
+    0x10e6, 0x02e6, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7,
+    0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7,
+    0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7,
+    0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7, 0x10e7,
+    0x10e7, 0x03e7, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8,
+    0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8,
+    0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8,
+    0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8, 0x10e8,
+    0x10e8, 0x07e8, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9,
+    0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9,
+    0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9,
+    0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9, 0x10e9,
+    0x10e9, 0x0ee9, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea,
+    0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea,
+    0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea,
+    0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea, 0x10ea,
+    0x10ea, 0x10ea, 0x07ea, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb,
+    0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb,
+    0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb,
+    0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb, 0x10eb,
+    0x10eb, 0x10eb, 0x10eb, 0x04eb, 0x10ec, 0x10ec, 0x10ec, 0x10ec,
+    0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec,
+    0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec,
+    0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x10ec,
+    0x10ec, 0x10ec, 0x10ec, 0x10ec, 0x04ec, 0x10ed, 0x10ed, 0x10ed,
+    0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed,
+    0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed,
+    0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed,
+    0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x10ed, 0x06ed, 0x10ee, 0x10ee,
+    0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee,
+    0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee,
+    0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee,
+    0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x10ee, 0x0cee, 0x10ef,
+    0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef,
+    0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef,
+    0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef,
+    0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef, 0x10ef,
+    0x05ef, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0,
+    0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0,
+    0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0,
+    0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0, 0x10f0,
+    0x10f0, 0x10f0, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1,
+    0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1,
+    0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1,
+    0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1, 0x10f1,
+    0x10f1, 0x10f1, 0x10f1, 0x0ff1, 0x10f2, 0x10f2, 0x10f2, 0x10f2,
+    0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2,
+    0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2,
+    0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2,
+    0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f2, 0x10f3, 0x10f3,
+    0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3,
+    0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3,
+    0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3,
+    0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3, 0x10f3,
+    0x04f3, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4,
+    0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4,
+    0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4,
+    0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4, 0x10f4,
+    0x10f4, 0x10f4, 0x0cf4, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5,
+    0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5,
+    0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5,
+    0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5,
+    0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x10f5, 0x06f5, 0x10f6, 0x10f6,
+    0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6,
+    0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6,
+    0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6,
+    0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6, 0x10f6,
+    0x04f6, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7,
+    0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7,
+    0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7,
+    0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7, 0x10f7,
+    0x10f7, 0x10f7, 0x10f7, 0x04f7, 0x10f8, 0x10f8, 0x10f8, 0x10f8,
+    0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8,
+    0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8,
+    0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8,
+    0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x10f8, 0x08f8, 0x10f9,
+    0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9,
+    0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9,
+    0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9,
+    0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9, 0x10f9,
+    0x10f9, 0x0ef9, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa,
+    0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa,
+    0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa,
+    0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa,
+    0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x10fa, 0x08fa, 0x10fb, 0x10fb,
+    0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb,
+    0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb,
+    0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb,
+    0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb, 0x10fb,
+    0x10fb, 0x04fb, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc,
+    0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc,
+    0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc,
+    0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc,
+    0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x10fc, 0x04fc, 0x10fd, 0x10fd,
+    0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd,
+    0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd,
+    0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd,
+    0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd, 0x10fd,
+    0x10fd, 0x06fd, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe,
+    0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe,
+    0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe,
+    0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe,
+    0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x10fe, 0x0cfe, 0x10ff, 0x10ff,
+    0x10ff, 0x10ff, 0x10ff, 0x10ff, 0x10ff, 0x10ff, 0x10ff, 0x10ff,
+    0x10ff, 0x10ff, 0x10ff, 0x10ff, 0x10ff, 0x10ff, 0x10ff, 0x10ff,
+    0x0000,
+};
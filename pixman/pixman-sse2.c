@@ -2371,6 +2371,1154 @@ sse2_combine_add_ca (pixman_implementation_t *imp,
     }
 }
 
+/* -------------------------------------------------------------------
+ * Float combiners
+ *
+ * These compute exactly what the combiners in pixman-combine-float.c
+ * compute, with the same operations in the same order, so the results
+ * are bit for bit identical.  Four pixels at a time are transposed into
+ * one register per channel.  Where the scalar code tests for a zero
+ * divisor, the divisor is replaced by one before dividing and the
+ * affected lanes are then overwritten with the special case result.
+ *
+ * The plain Porter/Duff operators are left to the C versions; the
+ * compiler already does as well as this for those.
+ */
+
+typedef __m128 (* sse2_combine_channel_t) (__m128 sa, __m128 s,
+					   __m128 da, __m128 d);
+
+static force_inline void
+sse2_combine_float_4 (pixman_bool_t          component,
+		      float                 *dest,
+		      const float           *src,
+		      const float           *mask,
+		      sse2_combine_channel_t combine_a,
+		      sse2_combine_channel_t combine_c)
+{
+    __m128 sa = _mm_loadu_ps (src + 0);
+    __m128 sr = _mm_loadu_ps (src + 4);
+    __m128 sg = _mm_loadu_ps (src + 8);
+    __m128 sb = _mm_loadu_ps (src + 12);
+    __m128 da = _mm_loadu_ps (dest + 0);
+    __m128 dr = _mm_loadu_ps (dest + 4);
+    __m128 dg = _mm_loadu_ps (dest + 8);
+    __m128 db = _mm_loadu_ps (dest + 12);
+    __m128 ma, mr, mg, mb;
+    __m128 ra, rr, rg, rb;
+
+    _MM_TRANSPOSE4_PS (sa, sr, sg, sb);
+    _MM_TRANSPOSE4_PS (da, dr, dg, db);
+
+    if (!mask)
+    {
+	ma = mr = mg = mb = sa;
+    }
+    else
+    {
+	ma = _mm_loadu_ps (mask + 0);
+	mr = _mm_loadu_ps (mask + 4);
+	mg = _mm_loadu_ps (mask + 8);
+	mb = _mm_loadu_ps (mask + 12);
+
+	_MM_TRANSPOSE4_PS (ma, mr, mg, mb);
+
+	if (component)
+	{
+	    sr = _mm_mul_ps (sr, mr);
+	    sg = _mm_mul_ps (sg, mg);
+	    sb = _mm_mul_ps (sb, mb);
+
+	    ma = _mm_mul_ps (ma, sa);
+	    mr = _mm_mul_ps (mr, sa);
+	    mg = _mm_mul_ps (mg, sa);
+	    mb = _mm_mul_ps (mb, sa);
+
+	    sa = ma;
+	}
+	else
+	{
+	    sa = _mm_mul_ps (sa, ma);
+	    sr = _mm_mul_ps (sr, ma);
+	    sg = _mm_mul_ps (sg, ma);
+	    sb = _mm_mul_ps (sb, ma);
+
+	    ma = mr = mg = mb = sa;
+	}
+    }
+
+    ra = combine_a (ma, sa, da, da);
+    rr = combine_c (mr, sr, da, dr);
+    rg = combine_c (mg, sg, da, dg);
+    rb = combine_c (mb, sb, da, db);
+
+    _MM_TRANSPOSE4_PS (ra, rr, rg, rb);
+
+    _mm_storeu_ps (dest + 0, ra);
+    _mm_storeu_ps (dest + 4, rr);
+    _mm_storeu_ps (dest + 8, rg);
+    _mm_storeu_ps (dest + 12, rb);
+}
+
+static force_inline void
+sse2_combine_float_inner (pixman_bool_t          component,
+			  float                 *dest,
+			  const float           *src,
+			  const float           *mask,
+			  int                    n_pixels,
+			  sse2_combine_channel_t combine_a,
+			  sse2_combine_channel_t combine_c)
+{
+    while (n_pixels >= 4)
+    {
+	sse2_combine_float_4 (component, dest, src, mask,
+			      combine_a, combine_c);
+
+	dest += 16;
+	src += 16;
+	if (mask)
+	    mask += 16;
+	n_pixels -= 4;
+    }
+
+    if (n_pixels)
+    {
+	float d[16] = { 0 }, s[16] = { 0 }, m[16] = { 0 };
+	size_t size = n_pixels * 4 * sizeof (float);
+
+	memcpy (d, dest, size);
+	memcpy (s, src, size);
+	if (mask)
+	    memcpy (m, mask, size);
+
+	sse2_combine_float_4 (component, d, s, mask ? m : NULL,
+			      combine_a, combine_c);
+
+	memcpy (dest, d, size);
+    }
+}
+
+#define SSE2_MAKE_FLOAT_COMBINER(name, component, combine_a, combine_c)	\
+    static void								\
+    sse2_combine_ ## name ## _float (pixman_implementation_t *imp,	\
+				     pixman_op_t              op,	\
+				     float                   *dest,	\
+				     const float             *src,	\
+				     const float             *mask,	\
+				     int                      n_pixels)	\
+    {									\
+	sse2_combine_float_inner (component, dest, src, mask, n_pixels,	\
+				  combine_a, combine_c);		\
+    }
+
+#define SSE2_MAKE_FLOAT_COMBINERS(name, combine_a, combine_c)		\
+    SSE2_MAKE_FLOAT_COMBINER (name ## _ca, TRUE, combine_a, combine_c)	\
+    SSE2_MAKE_FLOAT_COMBINER (name ## _u, FALSE, combine_a, combine_c)
+
+static force_inline __m128
+sse2_float_is_zero (__m128 f)
+{
+    return _mm_and_ps (_mm_cmpgt_ps (f, _mm_set1_ps (-FLT_MIN)),
+		       _mm_cmplt_ps (f, _mm_set1_ps (FLT_MIN)));
+}
+
+static force_inline __m128
+sse2_float_select (__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps (_mm_and_ps (mask, a), _mm_andnot_ps (mask, b));
+}
+
+/* a / b, where lanes with b == 0 divide by one instead */
+static force_inline __m128
+sse2_float_div (__m128 a, __m128 b, __m128 b_is_zero)
+{
+    return _mm_div_ps (a, sse2_float_select (b_is_zero, _mm_set1_ps (1.0f), b));
+}
+
+/* CLAMP (f) from pixman-combine-float.c; NaNs pass through unchanged */
+static force_inline __m128
+sse2_float_clamp (__m128 f)
+{
+    return _mm_max_ps (_mm_setzero_ps (), _mm_min_ps (_mm_set1_ps (1.0f), f));
+}
+
+static force_inline __m128
+sse2_get_factor (combine_factor_t factor, __m128 sa, __m128 da)
+{
+    __m128 zero = _mm_setzero_ps ();
+    __m128 one = _mm_set1_ps (1.0f);
+    __m128 sa_zero, da_zero;
+
+    switch (factor)
+    {
+    case ZERO:
+	return zero;
+
+    case ONE:
+	return one;
+
+    case SRC_ALPHA:
+	return sa;
+
+    case DEST_ALPHA:
+	return da;
+
+    case INV_SA:
+	return _mm_sub_ps (one, sa);
+
+    case INV_DA:
+	return _mm_sub_ps (one, da);
+
+    case SA_OVER_DA:
+	da_zero = sse2_float_is_zero (da);
+	return sse2_float_select (
+	    da_zero, one, sse2_float_clamp (sse2_float_div (sa, da, da_zero)));
+
+    case DA_OVER_SA:
+	sa_zero = sse2_float_is_zero (sa);
+	return sse2_float_select (
+	    sa_zero, one, sse2_float_clamp (sse2_float_div (da, sa, sa_zero)));
+
+    case INV_SA_OVER_DA:
+	da_zero = sse2_float_is_zero (da);
+	return sse2_float_select (
+	    da_zero, one, sse2_float_clamp (
+		sse2_float_div (_mm_sub_ps (one, sa), da, da_zero)));
+
+    case INV_DA_OVER_SA:
+	sa_zero = sse2_float_is_zero (sa);
+	return sse2_float_select (
+	    sa_zero, one, sse2_float_clamp (
+		sse2_float_div (_mm_sub_ps (one, da), sa, sa_zero)));
+
+    case ONE_MINUS_SA_OVER_DA:
+	da_zero = sse2_float_is_zero (da);
+	return sse2_float_select (
+	    da_zero, zero, sse2_float_clamp (
+		_mm_sub_ps (one, sse2_float_div (sa, da, da_zero))));
+
+    case ONE_MINUS_DA_OVER_SA:
+	sa_zero = sse2_float_is_zero (sa);
+	return sse2_float_select (
+	    sa_zero, zero, sse2_float_clamp (
+		_mm_sub_ps (one, sse2_float_div (da, sa, sa_zero))));
+
+    case ONE_MINUS_INV_DA_OVER_SA:
+	sa_zero = sse2_float_is_zero (sa);
+	return sse2_float_select (
+	    sa_zero, zero, sse2_float_clamp (
+		_mm_sub_ps (one, sse2_float_div (_mm_sub_ps (one, da),
+						 sa, sa_zero))));
+
+    case ONE_MINUS_INV_SA_OVER_DA:
+	da_zero = sse2_float_is_zero (da);
+	return sse2_float_select (
+	    da_zero, zero, sse2_float_clamp (
+		_mm_sub_ps (one, sse2_float_div (_mm_sub_ps (one, sa),
+						 da, da_zero))));
+    }
+
+    return zero;
+}
+
+#define SSE2_MAKE_PD_COMBINER(name, a, b)				\
+    static force_inline __m128						\
+    sse2_pd_combine_ ## name (__m128 sa, __m128 s, __m128 da, __m128 d)	\
+    {									\
+	const __m128 fa = sse2_get_factor (a, sa, da);			\
+	const __m128 fb = sse2_get_factor (b, sa, da);			\
+									\
+	return _mm_min_ps (_mm_set1_ps (1.0f),				\
+			   _mm_add_ps (_mm_mul_ps (s, fa),		\
+				       _mm_mul_ps (d, fb)));		\
+    }									\
+									\
+    SSE2_MAKE_FLOAT_COMBINERS (name,					\
+			       sse2_pd_combine_ ## name,		\
+			       sse2_pd_combine_ ## name)
+
+SSE2_MAKE_PD_COMBINER (saturate,		INV_DA_OVER_SA,			ONE)
+
+SSE2_MAKE_PD_COMBINER (disjoint_over,		ONE,				INV_SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (disjoint_over_reverse,	INV_DA_OVER_SA,			ONE)
+SSE2_MAKE_PD_COMBINER (disjoint_in,		ONE_MINUS_INV_DA_OVER_SA,	ZERO)
+SSE2_MAKE_PD_COMBINER (disjoint_in_reverse,	ZERO,				ONE_MINUS_INV_SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (disjoint_out,		INV_DA_OVER_SA,			ZERO)
+SSE2_MAKE_PD_COMBINER (disjoint_out_reverse,	ZERO,				INV_SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (disjoint_atop,		ONE_MINUS_INV_DA_OVER_SA,	INV_SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (disjoint_atop_reverse,	INV_DA_OVER_SA,			ONE_MINUS_INV_SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (disjoint_xor,		INV_DA_OVER_SA,			INV_SA_OVER_DA)
+
+SSE2_MAKE_PD_COMBINER (conjoint_over,		ONE,				ONE_MINUS_SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (conjoint_over_reverse,	ONE_MINUS_DA_OVER_SA,		ONE)
+SSE2_MAKE_PD_COMBINER (conjoint_in,		DA_OVER_SA,			ZERO)
+SSE2_MAKE_PD_COMBINER (conjoint_in_reverse,	ZERO,				SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (conjoint_out,		ONE_MINUS_DA_OVER_SA,		ZERO)
+SSE2_MAKE_PD_COMBINER (conjoint_out_reverse,	ZERO,				ONE_MINUS_SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (conjoint_atop,		DA_OVER_SA,			ONE_MINUS_SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (conjoint_atop_reverse,	ONE_MINUS_DA_OVER_SA,		SA_OVER_DA)
+SSE2_MAKE_PD_COMBINER (conjoint_xor,		ONE_MINUS_DA_OVER_SA,		ONE_MINUS_SA_OVER_DA)
+
+/* Separable PDF blend modes; see pixman-combine-float.c for the
+ * derivation of each formula.
+ */
+static force_inline __m128
+sse2_blend_multiply (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    return _mm_mul_ps (d, s);
+}
+
+static force_inline __m128
+sse2_blend_screen (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    return _mm_sub_ps (_mm_add_ps (_mm_mul_ps (d, sa), _mm_mul_ps (s, da)),
+		       _mm_mul_ps (s, d));
+}
+
+/* as * ad - 2 * (ad - d) * (as - s) */
+static force_inline __m128
+sse2_blend_screen_2x (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 two = _mm_set1_ps (2.0f);
+
+    return _mm_sub_ps (_mm_mul_ps (sa, da),
+		       _mm_mul_ps (_mm_mul_ps (two, _mm_sub_ps (da, d)),
+				   _mm_sub_ps (sa, s)));
+}
+
+static force_inline __m128
+sse2_blend_overlay (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 two = _mm_set1_ps (2.0f);
+
+    return sse2_float_select (_mm_cmplt_ps (_mm_mul_ps (two, d), da),
+			      _mm_mul_ps (_mm_mul_ps (two, s), d),
+			      sse2_blend_screen_2x (sa, s, da, d));
+}
+
+static force_inline __m128
+sse2_blend_darken (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    /* (s > d)? d : s */
+    return _mm_min_ps (_mm_mul_ps (d, sa), _mm_mul_ps (s, da));
+}
+
+static force_inline __m128
+sse2_blend_lighten (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    /* (s > d)? s : d */
+    return _mm_max_ps (_mm_mul_ps (s, da), _mm_mul_ps (d, sa));
+}
+
+static force_inline __m128
+sse2_blend_color_dodge (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 sada = _mm_mul_ps (sa, da);
+    __m128 sa_s = _mm_sub_ps (sa, s);
+    __m128 sa_s_zero = sse2_float_is_zero (sa_s);
+    __m128 r;
+
+    r = sse2_float_div (_mm_mul_ps (_mm_mul_ps (sa, sa), d), sa_s, sa_s_zero);
+    r = sse2_float_select (
+	_mm_or_ps (_mm_cmpge_ps (_mm_mul_ps (d, sa),
+				 _mm_sub_ps (sada, _mm_mul_ps (s, da))),
+		   sa_s_zero),
+	sada, r);
+
+    return _mm_andnot_ps (sse2_float_is_zero (d), r);
+}
+
+static force_inline __m128
+sse2_blend_color_burn (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 s_zero = sse2_float_is_zero (s);
+    __m128 sa_da_d = _mm_mul_ps (sa, _mm_sub_ps (da, d));
+    __m128 r;
+
+    r = _mm_mul_ps (sa, _mm_sub_ps (da, sse2_float_div (sa_da_d, s, s_zero)));
+    r = _mm_andnot_ps (
+	_mm_or_ps (_mm_cmpge_ps (sa_da_d, _mm_mul_ps (s, da)), s_zero), r);
+
+    return sse2_float_select (_mm_cmpge_ps (d, da), _mm_mul_ps (sa, da), r);
+}
+
+static force_inline __m128
+sse2_blend_hard_light (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 two_s = _mm_mul_ps (_mm_set1_ps (2.0f), s);
+
+    return sse2_float_select (_mm_cmplt_ps (two_s, sa),
+			      _mm_mul_ps (two_s, d),
+			      sse2_blend_screen_2x (sa, s, da, d));
+}
+
+static force_inline __m128
+sse2_blend_soft_light (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 da_zero = sse2_float_is_zero (da);
+    __m128 two_s = _mm_mul_ps (_mm_set1_ps (2.0f), s);
+    __m128 two_s_sa = _mm_sub_ps (two_s, sa);
+    __m128 dsa = _mm_mul_ps (d, sa);
+    __m128 r1, r2, r3, t;
+
+    /* d * sa - d * (da - d) * (sa - 2 * s) / da */
+    t = _mm_mul_ps (_mm_mul_ps (d, _mm_sub_ps (da, d)), _mm_sub_ps (sa, two_s));
+    r1 = _mm_sub_ps (dsa, sse2_float_div (t, da, da_zero));
+
+    /* d * sa + (2 * s - sa) * d * ((16 * d / da - 12) * d / da + 3) */
+    t = sse2_float_div (_mm_mul_ps (_mm_set1_ps (16.0f), d), da, da_zero);
+    t = _mm_mul_ps (_mm_sub_ps (t, _mm_set1_ps (12.0f)), d);
+    t = _mm_add_ps (sse2_float_div (t, da, da_zero), _mm_set1_ps (3.0f));
+    r2 = _mm_add_ps (dsa, _mm_mul_ps (_mm_mul_ps (two_s_sa, d), t));
+
+    /* d * sa + (sqrtf (d * da) - d) * (2 * s - sa) */
+    t = _mm_sub_ps (_mm_sqrt_ps (_mm_mul_ps (d, da)), d);
+    r3 = _mm_add_ps (dsa, _mm_mul_ps (t, two_s_sa));
+
+    r2 = sse2_float_select (
+	_mm_cmple_ps (_mm_mul_ps (_mm_set1_ps (4.0f), d), da), r2, r3);
+    r1 = sse2_float_select (_mm_cmple_ps (two_s, sa), r1, r2);
+
+    return sse2_float_select (da_zero, dsa, r1);
+}
+
+static force_inline __m128
+sse2_blend_difference (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 dsa = _mm_mul_ps (d, sa);
+    __m128 sda = _mm_mul_ps (s, da);
+
+    return sse2_float_select (_mm_cmplt_ps (sda, dsa),
+			      _mm_sub_ps (dsa, sda),
+			      _mm_sub_ps (sda, dsa));
+}
+
+static force_inline __m128
+sse2_blend_exclusion (__m128 sa, __m128 s, __m128 da, __m128 d)
+{
+    __m128 two = _mm_set1_ps (2.0f);
+
+    return _mm_sub_ps (_mm_add_ps (_mm_mul_ps (s, da), _mm_mul_ps (d, sa)),
+		       _mm_mul_ps (_mm_mul_ps (two, d), s));
+}
+
+#define SSE2_MAKE_SEPARABLE_PDF_COMBINER(name)				\
+    static force_inline __m128						\
+    sse2_combine_ ## name ## _a (__m128 sa, __m128 s, __m128 da, __m128 d) \
+    {									\
+	return _mm_sub_ps (_mm_add_ps (da, sa), _mm_mul_ps (da, sa));	\
+    }									\
+									\
+    static force_inline __m128						\
+    sse2_combine_ ## name ## _c (__m128 sa, __m128 s, __m128 da, __m128 d) \
+    {									\
+	__m128 one = _mm_set1_ps (1.0f);				\
+	__m128 f = _mm_add_ps (_mm_mul_ps (_mm_sub_ps (one, sa), d),	\
+			       _mm_mul_ps (_mm_sub_ps (one, da), s));	\
+									\
+	return _mm_add_ps (f, sse2_blend_ ## name (sa, s, da, d));	\
+    }									\
+									\
+    SSE2_MAKE_FLOAT_COMBINERS (name,					\
+			       sse2_combine_ ## name ## _a,		\
+			       sse2_combine_ ## name ## _c)
+
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (multiply)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (screen)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (overlay)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (darken)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (lighten)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (color_dodge)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (color_burn)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (hard_light)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (soft_light)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (difference)
+SSE2_MAKE_SEPARABLE_PDF_COMBINER (exclusion)
+
+/* Non-separable PDF blend modes.  These follow the rgb_t helpers in
+ * pixman-combine-float.c, with the branches in set_sat() and
+ * clip_color() turned into lane selects.
+ */
+typedef struct
+{
+    __m128 r, g, b;
+} sse2_rgb_t;
+
+typedef void (* sse2_blend_hsl_t) (sse2_rgb_t       *res,
+				   const sse2_rgb_t *dest, __m128 da,
+				   const sse2_rgb_t *src, __m128 sa);
+
+static force_inline __m128
+sse2_get_lum (const sse2_rgb_t *c)
+{
+    return _mm_add_ps (_mm_add_ps (_mm_mul_ps (c->r, _mm_set1_ps (0.3f)),
+				   _mm_mul_ps (c->g, _mm_set1_ps (0.59f))),
+		       _mm_mul_ps (c->b, _mm_set1_ps (0.11f)));
+}
+
+static force_inline __m128
+sse2_channel_min (const sse2_rgb_t *c)
+{
+    return _mm_min_ps (_mm_min_ps (c->r, c->g), c->b);
+}
+
+static force_inline __m128
+sse2_channel_max (const sse2_rgb_t *c)
+{
+    return _mm_max_ps (_mm_max_ps (c->r, c->g), c->b);
+}
+
+static force_inline __m128
+sse2_get_sat (const sse2_rgb_t *c)
+{
+    return _mm_sub_ps (sse2_channel_max (c), sse2_channel_min (c));
+}
+
+static force_inline void
+sse2_clip_color (sse2_rgb_t *c, __m128 a)
+{
+    __m128 l = sse2_get_lum (c);
+    __m128 n = sse2_channel_min (c);
+    __m128 x = sse2_channel_max (c);
+    __m128 t, t_zero, clip, f;
+
+    /* if (n < 0.0f) */
+    t = _mm_sub_ps (l, n);
+    t_zero = sse2_float_is_zero (t);
+    clip = _mm_cmplt_ps (n, _mm_setzero_ps ());
+
+#define CLIP_LOW(ch)							\
+    f = _mm_add_ps (l, sse2_float_div (_mm_mul_ps (_mm_sub_ps (c->ch, l), l), \
+				       t, t_zero));			\
+    c->ch = sse2_float_select (						\
+	clip, _mm_andnot_ps (t_zero, f), c->ch)
+
+    CLIP_LOW (r);
+    CLIP_LOW (g);
+    CLIP_LOW (b);
+
+#undef CLIP_LOW
+
+    /* if (x > a) */
+    t = _mm_sub_ps (x, l);
+    t_zero = sse2_float_is_zero (t);
+    clip = _mm_cmpgt_ps (x, a);
+
+#define CLIP_HIGH(ch)							\
+    f = _mm_add_ps (l, sse2_float_div (					\
+			_mm_mul_ps (_mm_sub_ps (c->ch, l), _mm_sub_ps (a, l)), \
+			t, t_zero));					\
+    c->ch = sse2_float_select (						\
+	clip, sse2_float_select (t_zero, a, f), c->ch)
+
+    CLIP_HIGH (r);
+    CLIP_HIGH (g);
+    CLIP_HIGH (b);
+
+#undef CLIP_HIGH
+}
+
+static force_inline void
+sse2_set_lum (sse2_rgb_t *c, __m128 sa, __m128 l)
+{
+    __m128 d = _mm_sub_ps (l, sse2_get_lum (c));
+
+    c->r = _mm_add_ps (c->r, d);
+    c->g = _mm_add_ps (c->g, d);
+    c->b = _mm_add_ps (c->b, d);
+
+    sse2_clip_color (c, sa);
+}
+
+/* The scalar set_sat() decides which channel is the maximum, the middle
+ * and the minimum with three comparisons; ties are resolved the same
+ * way here so the middle value is computed from the same channel.
+ */
+static force_inline void
+sse2_set_sat (sse2_rgb_t *c, __m128 sat)
+{
+    __m128 rg = _mm_cmpgt_ps (c->r, c->g);
+    __m128 rb = _mm_cmpgt_ps (c->r, c->b);
+    __m128 gb = _mm_cmpgt_ps (c->g, c->b);
+    __m128 all = _mm_cmpeq_ps (_mm_setzero_ps (), _mm_setzero_ps ());
+    __m128 max_r = _mm_and_ps (rg, rb);
+    __m128 max_g = _mm_andnot_ps (rg, _mm_or_ps (rb, gb));
+    __m128 min_r = _mm_xor_ps (_mm_or_ps (rg, rb), all);
+    __m128 min_g = _mm_andnot_ps (_mm_and_ps (rb, gb), rg);
+    __m128 max_b = _mm_xor_ps (_mm_or_ps (max_r, max_g), all);
+    __m128 min_b = _mm_xor_ps (_mm_or_ps (min_r, min_g), all);
+    __m128 max, min, t, t_zero;
+
+    max = sse2_float_select (max_r, c->r,
+			     sse2_float_select (max_g, c->g, c->b));
+    min = sse2_float_select (min_r, c->r,
+			     sse2_float_select (min_g, c->g, c->b));
+
+    t = _mm_sub_ps (max, min);
+    t_zero = sse2_float_is_zero (t);
+
+#define SET_SAT(ch)							\
+    c->ch = sse2_float_div (_mm_mul_ps (_mm_sub_ps (c->ch, min), sat),	\
+			    t, t_zero);					\
+    c->ch = sse2_float_select (max_ ## ch, sat, c->ch);			\
+    c->ch = _mm_andnot_ps (_mm_or_ps (min_ ## ch, t_zero), c->ch)
+
+    SET_SAT (r);
+    SET_SAT (g);
+    SET_SAT (b);
+
+#undef SET_SAT
+}
+
+static force_inline void
+sse2_blend_hsl_hue (sse2_rgb_t       *res,
+		    const sse2_rgb_t *dest, __m128 da,
+		    const sse2_rgb_t *src, __m128 sa)
+{
+    res->r = _mm_mul_ps (src->r, da);
+    res->g = _mm_mul_ps (src->g, da);
+    res->b = _mm_mul_ps (src->b, da);
+
+    sse2_set_sat (res, _mm_mul_ps (sse2_get_sat (dest), sa));
+    sse2_set_lum (res, _mm_mul_ps (sa, da),
+		  _mm_mul_ps (sse2_get_lum (dest), sa));
+}
+
+static force_inline void
+sse2_blend_hsl_saturation (sse2_rgb_t       *res,
+			   const sse2_rgb_t *dest, __m128 da,
+			   const sse2_rgb_t *src, __m128 sa)
+{
+    res->r = _mm_mul_ps (dest->r, sa);
+    res->g = _mm_mul_ps (dest->g, sa);
+    res->b = _mm_mul_ps (dest->b, sa);
+
+    sse2_set_sat (res, _mm_mul_ps (sse2_get_sat (src), da));
+    sse2_set_lum (res, _mm_mul_ps (sa, da),
+		  _mm_mul_ps (sse2_get_lum (dest), sa));
+}
+
+static force_inline void
+sse2_blend_hsl_color (sse2_rgb_t       *res,
+		      const sse2_rgb_t *dest, __m128 da,
+		      const sse2_rgb_t *src, __m128 sa)
+{
+    res->r = _mm_mul_ps (src->r, da);
+    res->g = _mm_mul_ps (src->g, da);
+    res->b = _mm_mul_ps (src->b, da);
+
+    sse2_set_lum (res, _mm_mul_ps (sa, da),
+		  _mm_mul_ps (sse2_get_lum (dest), sa));
+}
+
+static force_inline void
+sse2_blend_hsl_luminosity (sse2_rgb_t       *res,
+			   const sse2_rgb_t *dest, __m128 da,
+			   const sse2_rgb_t *src, __m128 sa)
+{
+    res->r = _mm_mul_ps (dest->r, sa);
+    res->g = _mm_mul_ps (dest->g, sa);
+    res->b = _mm_mul_ps (dest->b, sa);
+
+    sse2_set_lum (res, _mm_mul_ps (sa, da),
+		  _mm_mul_ps (sse2_get_lum (src), da));
+}
+
+static force_inline void
+sse2_combine_hsl_4 (float           *dest,
+		    const float     *src,
+		    const float     *mask,
+		    sse2_blend_hsl_t blend)
+{
+    __m128 one = _mm_set1_ps (1.0f);
+    __m128 sa = _mm_loadu_ps (src + 0);
+    __m128 da = _mm_loadu_ps (dest + 0);
+    sse2_rgb_t s, d, r;
+    __m128 ra, isa, ida;
+
+    s.r = _mm_loadu_ps (src + 4);
+    s.g = _mm_loadu_ps (src + 8);
+    s.b = _mm_loadu_ps (src + 12);
+    d.r = _mm_loadu_ps (dest + 4);
+    d.g = _mm_loadu_ps (dest + 8);
+    d.b = _mm_loadu_ps (dest + 12);
+
+    _MM_TRANSPOSE4_PS (sa, s.r, s.g, s.b);
+    _MM_TRANSPOSE4_PS (da, d.r, d.g, d.b);
+
+    if (mask)
+    {
+	/* Component alpha is not supported for HSL modes */
+	__m128 ma = _mm_loadu_ps (mask + 0);
+	__m128 mr = _mm_loadu_ps (mask + 4);
+	__m128 mg = _mm_loadu_ps (mask + 8);
+	__m128 mb = _mm_loadu_ps (mask + 12);
+
+	_MM_TRANSPOSE4_PS (ma, mr, mg, mb);
+
+	sa = _mm_mul_ps (sa, ma);
+	s.r = _mm_mul_ps (s.r, ma);
+	s.g = _mm_mul_ps (s.g, ma);
+	s.b = _mm_mul_ps (s.b, ma);
+    }
+
+    blend (&r, &d, da, &s, sa);
+
+    isa = _mm_sub_ps (one, sa);
+    ida = _mm_sub_ps (one, da);
+
+#define COMBINE(ch)							\
+    r.ch = _mm_add_ps (_mm_add_ps (_mm_mul_ps (isa, d.ch),		\
+				   _mm_mul_ps (ida, s.ch)), r.ch)
+
+    ra = _mm_sub_ps (_mm_add_ps (sa, da), _mm_mul_ps (sa, da));
+    COMBINE (r);
+    COMBINE (g);
+    COMBINE (b);
+
+#undef COMBINE
+
+    _MM_TRANSPOSE4_PS (ra, r.r, r.g, r.b);
+
+    _mm_storeu_ps (dest + 0, ra);
+    _mm_storeu_ps (dest + 4, r.r);
+    _mm_storeu_ps (dest + 8, r.g);
+    _mm_storeu_ps (dest + 12, r.b);
+}
+
+#define SSE2_MAKE_NON_SEPARABLE_PDF_COMBINER(name)			\
+    static void								\
+    sse2_combine_ ## name ## _u_float (pixman_implementation_t *imp,	\
+				       pixman_op_t              op,	\
+				       float                   *dest,	\
+				       const float             *src,	\
+				       const float             *mask,	\
+				       int                      n_pixels) \
+    {									\
+	while (n_pixels >= 4)						\
+	{								\
+	    sse2_combine_hsl_4 (dest, src, mask, sse2_blend_ ## name);	\
+									\
+	    dest += 16;							\
+	    src += 16;							\
+	    if (mask)							\
+		mask += 16;						\
+	    n_pixels -= 4;						\
+	}								\
+									\
+	if (n_pixels)							\
+	{								\
+	    float d[16] = { 0 }, s[16] = { 0 }, m[16] = { 0 };		\
+	    size_t size = n_pixels * 4 * sizeof (float);		\
+									\
+	    memcpy (d, dest, size);					\
+	    memcpy (s, src, size);					\
+	    if (mask)							\
+		memcpy (m, mask, size);					\
+									\
+	    sse2_combine_hsl_4 (d, s, mask ? m : NULL,			\
+				sse2_blend_ ## name);			\
+									\
+	    memcpy (dest, d, size);					\
+	}								\
+    }
+
+SSE2_MAKE_NON_SEPARABLE_PDF_COMBINER (hsl_hue)
+SSE2_MAKE_NON_SEPARABLE_PDF_COMBINER (hsl_saturation)
+SSE2_MAKE_NON_SEPARABLE_PDF_COMBINER (hsl_color)
+SSE2_MAKE_NON_SEPARABLE_PDF_COMBINER (hsl_luminosity)
+
+static void
+sse2_setup_combiner_functions_float (pixman_implementation_t *imp)
+{
+#define SSE2_SET_FLOAT_COMBINER(op, name)				\
+    imp->combine_float[PIXMAN_OP_ ## op] = sse2_combine_ ## name ## _u_float; \
+    imp->combine_float_ca[PIXMAN_OP_ ## op] = sse2_combine_ ## name ## _ca_float
+
+    SSE2_SET_FLOAT_COMBINER (SATURATE, saturate);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_OVER, disjoint_over);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_OVER_REVERSE, disjoint_over_reverse);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_IN, disjoint_in);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_IN_REVERSE, disjoint_in_reverse);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_OUT, disjoint_out);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_OUT_REVERSE, disjoint_out_reverse);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_ATOP, disjoint_atop);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_ATOP_REVERSE, disjoint_atop_reverse);
+    SSE2_SET_FLOAT_COMBINER (DISJOINT_XOR, disjoint_xor);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_OVER, conjoint_over);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_OVER_REVERSE, conjoint_over_reverse);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_IN, conjoint_in);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_IN_REVERSE, conjoint_in_reverse);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_OUT, conjoint_out);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_OUT_REVERSE, conjoint_out_reverse);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_ATOP, conjoint_atop);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_ATOP_REVERSE, conjoint_atop_reverse);
+    SSE2_SET_FLOAT_COMBINER (CONJOINT_XOR, conjoint_xor);
+    SSE2_SET_FLOAT_COMBINER (MULTIPLY, multiply);
+    SSE2_SET_FLOAT_COMBINER (SCREEN, screen);
+    SSE2_SET_FLOAT_COMBINER (OVERLAY, overlay);
+    SSE2_SET_FLOAT_COMBINER (DARKEN, darken);
+    SSE2_SET_FLOAT_COMBINER (LIGHTEN, lighten);
+    SSE2_SET_FLOAT_COMBINER (COLOR_DODGE, color_dodge);
+    SSE2_SET_FLOAT_COMBINER (COLOR_BURN, color_burn);
+    SSE2_SET_FLOAT_COMBINER (HARD_LIGHT, hard_light);
+    SSE2_SET_FLOAT_COMBINER (SOFT_LIGHT, soft_light);
+    SSE2_SET_FLOAT_COMBINER (DIFFERENCE, difference);
+    SSE2_SET_FLOAT_COMBINER (EXCLUSION, exclusion);
+
+    imp->combine_float[PIXMAN_OP_HSL_HUE] = sse2_combine_hsl_hue_u_float;
+    imp->combine_float[PIXMAN_OP_HSL_SATURATION] =
+	sse2_combine_hsl_saturation_u_float;
+    imp->combine_float[PIXMAN_OP_HSL_COLOR] = sse2_combine_hsl_color_u_float;
+    imp->combine_float[PIXMAN_OP_HSL_LUMINOSITY] =
+	sse2_combine_hsl_luminosity_u_float;
+
+#undef SSE2_SET_FLOAT_COMBINER
+}
+
+/*
+ * Separable PDF blend modes on the 8-bit path
+ *
+ * These compute exactly what the combiners in pixman-combine32.c
+ * compute.  Four pixels are split into one register per channel, with
+ * each channel value in its own 32-bit lane, so the 255 * 255 scaled
+ * intermediate results of the blend functions fit without any packing
+ * tricks.  Color dodge, color burn and soft light always take the float
+ * path (see operator_needs_division() in pixman-general.c), so they
+ * have no 8-bit versions here.
+ */
+
+typedef __m128i (* sse2_combine_un8_t) (__m128i d, __m128i da,
+					__m128i s, __m128i as);
+
+/* a * b for lanes holding values that fit in a signed 16-bit integer */
+static force_inline __m128i
+sse2_mul_s16 (__m128i a, __m128i b)
+{
+    return _mm_madd_epi16 (a, _mm_and_si128 (b, _mm_set1_epi32 (0xffff)));
+}
+
+/* MUL_UN8 from pixman-combine32.h */
+static force_inline __m128i
+sse2_mul_un8 (__m128i a, __m128i b)
+{
+    __m128i t = _mm_add_epi32 (_mm_madd_epi16 (a, b), _mm_set1_epi32 (0x80));
+
+    return _mm_srli_epi32 (_mm_add_epi32 (t, _mm_srli_epi32 (t, 8)), 8);
+}
+
+/* DIV_ONE_UN8 from pixman-combine32.h */
+static force_inline __m128i
+sse2_div_one_un8 (__m128i t)
+{
+    t = _mm_add_epi32 (t, _mm_set1_epi32 (0x80));
+
+    return _mm_srli_epi32 (_mm_add_epi32 (t, _mm_srli_epi32 (t, 8)), 8);
+}
+
+static force_inline __m128i
+sse2_select_epi32 (__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128 (_mm_and_si128 (mask, a), _mm_andnot_si128 (mask, b));
+}
+
+/* The 8-bit combiners clamp an unsigned sum, so a negative sum
+ * saturates to 255 * 255 rather than to zero.
+ */
+static force_inline __m128i
+sse2_clamp_un8x2 (__m128i t)
+{
+    __m128i max = _mm_set1_epi32 (255 * 255);
+
+    return sse2_select_epi32 (
+	_mm_or_si128 (_mm_cmplt_epi32 (t, _mm_setzero_si128 ()),
+		      _mm_cmpgt_epi32 (t, max)), max, t);
+}
+
+static force_inline __m128i
+sse2_inv_un8 (__m128i a)
+{
+    return _mm_sub_epi32 (_mm_set1_epi32 (0xff), a);
+}
+
+static force_inline void
+sse2_combine_un8_4 (pixman_bool_t      component,
+		    uint32_t          *pd,
+		    const uint32_t    *ps,
+		    const uint32_t    *pm,
+		    sse2_combine_un8_t combine_a,
+		    sse2_combine_un8_t combine_c)
+{
+    __m128i ff = _mm_set1_epi32 (0xff);
+    __m128i s = load_128_unaligned ((const __m128i *)ps);
+    __m128i d = load_128_unaligned ((const __m128i *)pd);
+    __m128i sa = _mm_srli_epi32 (s, 24);
+    __m128i sr = _mm_and_si128 (_mm_srli_epi32 (s, 16), ff);
+    __m128i sg = _mm_and_si128 (_mm_srli_epi32 (s, 8), ff);
+    __m128i sb = _mm_and_si128 (s, ff);
+    __m128i da = _mm_srli_epi32 (d, 24);
+    __m128i ma, mr, mg, mb;
+    __m128i ra, rr, rg, rb;
+
+    if (!pm)
+    {
+	ma = mr = mg = mb = sa;
+    }
+    else
+    {
+	__m128i m = load_128_unaligned ((const __m128i *)pm);
+
+	ma = _mm_srli_epi32 (m, 24);
+
+	if (component)
+	{
+	    mr = _mm_and_si128 (_mm_srli_epi32 (m, 16), ff);
+	    mg = _mm_and_si128 (_mm_srli_epi32 (m, 8), ff);
+	    mb = _mm_and_si128 (m, ff);
+
+	    sr = sse2_mul_un8 (sr, mr);
+	    sg = sse2_mul_un8 (sg, mg);
+	    sb = sse2_mul_un8 (sb, mb);
+
+	    mr = sse2_mul_un8 (mr, sa);
+	    mg = sse2_mul_un8 (mg, sa);
+	    mb = sse2_mul_un8 (mb, sa);
+
+	    sa = ma = sse2_mul_un8 (sa, ma);
+	}
+	else
+	{
+	    sa = sse2_mul_un8 (sa, ma);
+	    sr = sse2_mul_un8 (sr, ma);
+	    sg = sse2_mul_un8 (sg, ma);
+	    sb = sse2_mul_un8 (sb, ma);
+
+	    ma = mr = mg = mb = sa;
+	}
+    }
+
+    ra = combine_a (da, da, sa, ma);
+    rr = combine_c (_mm_and_si128 (_mm_srli_epi32 (d, 16), ff), da, sr, mr);
+    rg = combine_c (_mm_and_si128 (_mm_srli_epi32 (d, 8), ff), da, sg, mg);
+    rb = combine_c (_mm_and_si128 (d, ff), da, sb, mb);
+
+    d = _mm_or_si128 (_mm_or_si128 (_mm_slli_epi32 (ra, 24),
+				     _mm_slli_epi32 (rr, 16)),
+		      _mm_or_si128 (_mm_slli_epi32 (rg, 8), rb));
+
+    save_128_unaligned ((__m128i *)pd, d);
+}
+
+static force_inline void
+sse2_combine_un8_inner (pixman_bool_t      component,
+			uint32_t          *pd,
+			const uint32_t    *ps,
+			const uint32_t    *pm,
+			int                w,
+			sse2_combine_un8_t combine_a,
+			sse2_combine_un8_t combine_c)
+{
+    while (w >= 4)
+    {
+	sse2_combine_un8_4 (component, pd, ps, pm, combine_a, combine_c);
+
+	pd += 4;
+	ps += 4;
+	if (pm)
+	    pm += 4;
+	w -= 4;
+    }
+
+    if (w)
+    {
+	uint32_t d[4] = { 0 }, s[4] = { 0 }, m[4] = { 0 };
+
+	memcpy (d, pd, w * sizeof (uint32_t));
+	memcpy (s, ps, w * sizeof (uint32_t));
+	if (pm)
+	    memcpy (m, pm, w * sizeof (uint32_t));
+
+	sse2_combine_un8_4 (component, d, s, pm ? m : NULL,
+			    combine_a, combine_c);
+
+	memcpy (pd, d, w * sizeof (uint32_t));
+    }
+}
+
+#define SSE2_MAKE_UN8_COMBINERS(name, combine_a, combine_c)		\
+    static void								\
+    sse2_combine_ ## name ## _u (pixman_implementation_t *imp,		\
+				 pixman_op_t              op,		\
+				 uint32_t *               pd,		\
+				 const uint32_t *         ps,		\
+				 const uint32_t *         pm,		\
+				 int                      w)		\
+    {									\
+	sse2_combine_un8_inner (FALSE, pd, ps, pm, w,			\
+				combine_a, combine_c);			\
+    }									\
+									\
+    static void								\
+    sse2_combine_ ## name ## _ca (pixman_implementation_t *imp,	\
+				  pixman_op_t              op,		\
+				  uint32_t *               pd,		\
+				  const uint32_t *         ps,		\
+				  const uint32_t *         pm,		\
+				  int                      w)		\
+    {									\
+	sse2_combine_un8_inner (TRUE, pd, ps, pm, w,			\
+				combine_a, combine_c);			\
+    }
+
+/* Multiply is not written in terms of a blend function; every channel,
+ * alpha included, gets s * (1 - da) + d * (1 - as) + d * s with
+ * saturating additions.
+ */
+static force_inline __m128i
+sse2_combine_multiply_un8 (__m128i d, __m128i da, __m128i s, __m128i as)
+{
+    __m128i r;
+
+    r = _mm_add_epi32 (sse2_mul_un8 (s, sse2_inv_un8 (da)),
+		       sse2_mul_un8 (d, sse2_inv_un8 (as)));
+    r = _mm_add_epi32 (r, sse2_mul_un8 (d, s));
+
+    /* The high halves of the lanes are zero */
+    return _mm_min_epi16 (r, _mm_set1_epi32 (0xff));
+}
+
+SSE2_MAKE_UN8_COMBINERS (multiply,
+			 sse2_combine_multiply_un8, sse2_combine_multiply_un8)
+
+static force_inline __m128i
+sse2_blend_screen_un8 (__m128i d, __m128i ad, __m128i s, __m128i as)
+{
+    return _mm_sub_epi32 (_mm_add_epi32 (_mm_madd_epi16 (s, ad),
+					 _mm_madd_epi16 (d, as)),
+			  _mm_madd_epi16 (s, d));
+}
+
+/* as * ad - 2 * (ad - d) * (as - s) */
+static force_inline __m128i
+sse2_blend_screen_2x_un8 (__m128i d, __m128i ad, __m128i s, __m128i as)
+{
+    __m128i ad_d = _mm_sub_epi32 (ad, d);
+
+    return _mm_sub_epi32 (_mm_madd_epi16 (as, ad),
+			  sse2_mul_s16 (_mm_add_epi32 (ad_d, ad_d),
+					_mm_sub_epi32 (as, s)));
+}
+
+static force_inline __m128i
+sse2_blend_overlay_un8 (__m128i d, __m128i ad, __m128i s, __m128i as)
+{
+    return sse2_select_epi32 (_mm_cmplt_epi32 (_mm_add_epi32 (d, d), ad),
+			      _mm_madd_epi16 (_mm_add_epi32 (s, s), d),
+			      sse2_blend_screen_2x_un8 (d, ad, s, as));
+}
+
+static force_inline __m128i
+sse2_blend_darken_un8 (__m128i d, __m128i ad, __m128i s, __m128i as)
+{
+    __m128i sad = _mm_madd_epi16 (ad, s);
+    __m128i das = _mm_madd_epi16 (as, d);
+
+    return sse2_select_epi32 (_mm_cmpgt_epi32 (sad, das), das, sad);
+}
+
+static force_inline __m128i
+sse2_blend_lighten_un8 (__m128i d, __m128i ad, __m128i s, __m128i as)
+{
+    __m128i sad = _mm_madd_epi16 (ad, s);
+    __m128i das = _mm_madd_epi16 (as, d);
+
+    return sse2_select_epi32 (_mm_cmpgt_epi32 (sad, das), sad, das);
+}
+
+static force_inline __m128i
+sse2_blend_hard_light_un8 (__m128i d, __m128i ad, __m128i s, __m128i as)
+{
+    __m128i two_s = _mm_add_epi32 (s, s);
+
+    return sse2_select_epi32 (_mm_cmplt_epi32 (two_s, as),
+			      _mm_madd_epi16 (two_s, d),
+			      sse2_blend_screen_2x_un8 (d, ad, s, as));
+}
+
+static force_inline __m128i
+sse2_blend_difference_un8 (__m128i d, __m128i ad, __m128i s, __m128i as)
+{
+    __m128i r = _mm_sub_epi32 (_mm_madd_epi16 (d, as), _mm_madd_epi16 (s, ad));
+    __m128i sign = _mm_srai_epi32 (r, 31);
+
+    return _mm_sub_epi32 (_mm_xor_si128 (r, sign), sign);
+}
+
+static force_inline __m128i
+sse2_blend_exclusion_un8 (__m128i d, __m128i ad, __m128i s, __m128i as)
+{
+    __m128i r = _mm_add_epi32 (_mm_madd_epi16 (s, ad), _mm_madd_epi16 (d, as));
+
+    return _mm_sub_epi32 (r, _mm_madd_epi16 (_mm_add_epi32 (d, d), s));
+}
+
+/* da + sa - da * sa, which is also what every channel below gets with
+ * d * s as the blend function.
+ */
+static force_inline __m128i
+sse2_combine_pdf_alpha_un8 (__m128i d, __m128i da, __m128i s, __m128i as)
+{
+    __m128i r = _mm_madd_epi16 (_mm_add_epi32 (da, s), _mm_set1_epi32 (0xff));
+
+    r = _mm_sub_epi32 (r, _mm_madd_epi16 (da, s));
+
+    return sse2_div_one_un8 (sse2_clamp_un8x2 (r));
+}
+
+#define SSE2_MAKE_SEPARABLE_PDF_UN8_COMBINER(name)			\
+    static force_inline __m128i						\
+    sse2_combine_ ## name ## _un8 (__m128i d, __m128i da,		\
+				   __m128i s, __m128i as)		\
+    {									\
+	__m128i r = _mm_add_epi32 (_mm_madd_epi16 (sse2_inv_un8 (as), d), \
+				   _mm_madd_epi16 (sse2_inv_un8 (da), s)); \
+									\
+	r = _mm_add_epi32 (r, sse2_blend_ ## name ## _un8 (d, da, s, as)); \
+									\
+	return sse2_div_one_un8 (sse2_clamp_un8x2 (r));			\
+    }									\
+									\
+    SSE2_MAKE_UN8_COMBINERS (name,					\
+			     sse2_combine_pdf_alpha_un8,		\
+			     sse2_combine_ ## name ## _un8)
+
+SSE2_MAKE_SEPARABLE_PDF_UN8_COMBINER (screen)
+SSE2_MAKE_SEPARABLE_PDF_UN8_COMBINER (overlay)
+SSE2_MAKE_SEPARABLE_PDF_UN8_COMBINER (darken)
+SSE2_MAKE_SEPARABLE_PDF_UN8_COMBINER (lighten)
+SSE2_MAKE_SEPARABLE_PDF_UN8_COMBINER (hard_light)
+SSE2_MAKE_SEPARABLE_PDF_UN8_COMBINER (difference)
+SSE2_MAKE_SEPARABLE_PDF_UN8_COMBINER (exclusion)
+
+static void
+sse2_setup_combiner_functions_32 (pixman_implementation_t *imp)
+{
+#define SSE2_SET_COMBINER(op, name)					\
+    imp->combine_32[PIXMAN_OP_ ## op] = sse2_combine_ ## name ## _u;	\
+    imp->combine_32_ca[PIXMAN_OP_ ## op] = sse2_combine_ ## name ## _ca
+
+    SSE2_SET_COMBINER (MULTIPLY, multiply);
+    SSE2_SET_COMBINER (SCREEN, screen);
+    SSE2_SET_COMBINER (OVERLAY, overlay);
+    SSE2_SET_COMBINER (DARKEN, darken);
+    SSE2_SET_COMBINER (LIGHTEN, lighten);
+    SSE2_SET_COMBINER (HARD_LIGHT, hard_light);
+    SSE2_SET_COMBINER (DIFFERENCE, difference);
+    SSE2_SET_COMBINER (EXCLUSION, exclusion);
+
+#undef SSE2_SET_COMBINER
+}
+
 static force_inline __m128i
 create_mask_16_128 (uint16_t mask)
 {
@@ -3143,57 +4291,225 @@ sse2_composite_over_8888_0565 (pixman_implementation_t *imp,
 	/* It's a 8 pixel loop */
 	while (w >= 8)
 	{
-	    /* I'm loading unaligned because I'm not sure
-	     * about the address alignment.
-	     */
-	    xmm_src = load_128_unaligned ((__m128i*) src);
-	    xmm_dst = load_128_aligned ((__m128i*) dst);
+	    /* I'm loading unaligned because I'm not sure
+	     * about the address alignment.
+	     */
+	    xmm_src = load_128_unaligned ((__m128i*) src);
+	    xmm_dst = load_128_aligned ((__m128i*) dst);
+
+	    /* Unpacking */
+	    unpack_128_2x128 (xmm_src, &xmm_src_lo, &xmm_src_hi);
+	    unpack_565_128_4x128 (xmm_dst,
+				  &xmm_dst0, &xmm_dst1, &xmm_dst2, &xmm_dst3);
+	    expand_alpha_2x128 (xmm_src_lo, xmm_src_hi,
+				&xmm_alpha_lo, &xmm_alpha_hi);
+
+	    /* I'm loading next 4 pixels from memory
+	     * before to optimze the memory read.
+	     */
+	    xmm_src = load_128_unaligned ((__m128i*) (src + 4));
+
+	    over_2x128 (&xmm_src_lo, &xmm_src_hi,
+			&xmm_alpha_lo, &xmm_alpha_hi,
+			&xmm_dst0, &xmm_dst1);
+
+	    /* Unpacking */
+	    unpack_128_2x128 (xmm_src, &xmm_src_lo, &xmm_src_hi);
+	    expand_alpha_2x128 (xmm_src_lo, xmm_src_hi,
+				&xmm_alpha_lo, &xmm_alpha_hi);
+
+	    over_2x128 (&xmm_src_lo, &xmm_src_hi,
+			&xmm_alpha_lo, &xmm_alpha_hi,
+			&xmm_dst2, &xmm_dst3);
+
+	    save_128_aligned (
+		(__m128i*)dst, pack_565_4x128_128 (
+		    &xmm_dst0, &xmm_dst1, &xmm_dst2, &xmm_dst3));
+
+	    w -= 8;
+	    dst += 8;
+	    src += 8;
+	}
+
+	while (w--)
+	{
+	    s = *src++;
+	    d = *dst;
+
+	    *dst++ = composite_over_8888_0565pixel (s, d);
+	}
+    }
+
+}
+
+/* Ordered dithering of a8r8g8b8 to formats with fewer bits per channel.
+ * This is the float arithmetic of the general path in the same order,
+ * with one register per channel, so the results are the same: the
+ * channels are expanded like pixman_expand_to_float(), combined like
+ * the float OVER combiner, dithered like dither_apply_ordered() with
+ * the factors of _pixman_bits_image_dither_row() and then converted
+ * like float_to_unorm(). Formats of 16 bits are stored from 8 bits
+ * per channel, like the general path does.
+ */
+#define DITHER_ROW_LENGTH	(64 + 8)
+
+static force_inline __m128
+dither_unorm_to_float (__m128i p, int shift, int n_bits)
+{
+    __m128i u = _mm_and_si128 (_mm_srli_epi32 (p, shift),
+			       _mm_set1_epi32 ((1 << n_bits) - 1));
+
+    return _mm_mul_ps (_mm_cvtepi32_ps (u),
+		       _mm_set1_ps (1.f / (float)((1 << n_bits) - 1)));
+}
+
+static force_inline __m128i
+dither_channel (__m128 f, __m128 d, int n_bits)
+{
+    int u_bits = n_bits > 8 ? n_bits : 8;
+    __m128i u;
+
+    f = _mm_add_ps (f, _mm_mul_ps (_mm_sub_ps (d, f),
+				   _mm_set1_ps (1.f / (float)(1 << n_bits))));
+    f = _mm_min_ps (_mm_max_ps (f, _mm_setzero_ps ()), _mm_set1_ps (1.f));
+
+    u = _mm_cvttps_epi32 (_mm_mul_ps (f, _mm_set1_ps ((float)(1 << u_bits))));
+    u = _mm_sub_epi32 (u, _mm_srli_epi32 (u, u_bits));
+
+    return _mm_srli_epi32 (u, u_bits - n_bits);
+}
+
+static force_inline void
+sse2_composite_dither (pixman_composite_info_t *info,
+		       pixman_bool_t            over,
+		       pixman_format_code_t     format)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    float factors[DITHER_ROW_LENGTH];
+    int nr = PIXMAN_FORMAT_R (format);
+    int ng = PIXMAN_FORMAT_G (format);
+    int nb = PIXMAN_FORMAT_B (format);
+    int bpp = PIXMAN_FORMAT_BPP (format) / 8;
+    uint32_t *src_line, *src;
+    uint8_t *dst_line, *dst;
+    int dst_stride, src_stride;
+    int x, y, n;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint8_t, dst_stride, dst_line, bpp);
+    PIXMAN_IMAGE_GET_LINE (
+	src_image, src_x, src_y, uint32_t, src_stride, src_line, 1);
+
+    for (y = 0; y < height; ++y)
+    {
+	src = src_line;
+	dst = dst_line;
+	src_line += src_stride;
+	dst_line += dst_stride;
+
+	_pixman_bits_image_dither_row (&dest_image->bits, dest_x, dest_y + y,
+				       factors, DITHER_ROW_LENGTH);
+
+	for (x = 0; x < width; x += 4)
+	{
+	    uint32_t tmp[4];
+	    __m128i xmm_src, xmm_p;
+	    __m128 r, g, b, d;
 
-	    /* Unpacking */
-	    unpack_128_2x128 (xmm_src, &xmm_src_lo, &xmm_src_hi);
-	    unpack_565_128_4x128 (xmm_dst,
-				  &xmm_dst0, &xmm_dst1, &xmm_dst2, &xmm_dst3);
-	    expand_alpha_2x128 (xmm_src_lo, xmm_src_hi,
-				&xmm_alpha_lo, &xmm_alpha_hi);
+	    n = MIN (width - x, 4);
 
-	    /* I'm loading next 4 pixels from memory
-	     * before to optimze the memory read.
-	     */
-	    xmm_src = load_128_unaligned ((__m128i*) (src + 4));
+	    if (n == 4)
+	    {
+		xmm_src = load_128_unaligned ((__m128i *)(src + x));
+	    }
+	    else
+	    {
+		memcpy (tmp, src + x, n * 4);
+		xmm_src = load_128_unaligned ((__m128i *)tmp);
+	    }
 
-	    over_2x128 (&xmm_src_lo, &xmm_src_hi,
-			&xmm_alpha_lo, &xmm_alpha_hi,
-			&xmm_dst0, &xmm_dst1);
+	    r = dither_unorm_to_float (xmm_src, 16, 8);
+	    g = dither_unorm_to_float (xmm_src, 8, 8);
+	    b = dither_unorm_to_float (xmm_src, 0, 8);
 
-	    /* Unpacking */
-	    unpack_128_2x128 (xmm_src, &xmm_src_lo, &xmm_src_hi);
-	    expand_alpha_2x128 (xmm_src_lo, xmm_src_hi,
-				&xmm_alpha_lo, &xmm_alpha_hi);
+	    if (over)
+	    {
+		__m128i xmm_dst;
+		__m128 one = _mm_set1_ps (1.f);
+		__m128 inv_sa;
 
-	    over_2x128 (&xmm_src_lo, &xmm_src_hi,
-			&xmm_alpha_lo, &xmm_alpha_hi,
-			&xmm_dst2, &xmm_dst3);
+		if (n == 4)
+		{
+		    xmm_dst = _mm_loadl_epi64 ((__m128i *)(dst + 2 * x));
+		}
+		else
+		{
+		    memcpy (tmp, dst + 2 * x, n * 2);
+		    xmm_dst = _mm_loadl_epi64 ((__m128i *)tmp);
+		}
+		xmm_dst = _mm_unpacklo_epi16 (xmm_dst, _mm_setzero_si128 ());
 
-	    save_128_aligned (
-		(__m128i*)dst, pack_565_4x128_128 (
-		    &xmm_dst0, &xmm_dst1, &xmm_dst2, &xmm_dst3));
+		inv_sa = _mm_sub_ps (one, dither_unorm_to_float (xmm_src, 24, 8));
 
-	    w -= 8;
-	    dst += 8;
-	    src += 8;
-	}
+		r = _mm_min_ps (_mm_add_ps (r, _mm_mul_ps (
+		    dither_unorm_to_float (xmm_dst, nb + ng, nr), inv_sa)), one);
+		g = _mm_min_ps (_mm_add_ps (g, _mm_mul_ps (
+		    dither_unorm_to_float (xmm_dst, nb, ng), inv_sa)), one);
+		b = _mm_min_ps (_mm_add_ps (b, _mm_mul_ps (
+		    dither_unorm_to_float (xmm_dst, 0, nb), inv_sa)), one);
+	    }
 
-	while (w--)
-	{
-	    s = *src++;
-	    d = *dst;
+	    d = _mm_loadu_ps (factors + (x & 63));
 
-	    *dst++ = composite_over_8888_0565pixel (s, d);
+	    xmm_p = _mm_or_si128 (
+		_mm_or_si128 (_mm_slli_epi32 (dither_channel (r, d, nr), nb + ng),
+			      _mm_slli_epi32 (dither_channel (g, d, ng), nb)),
+		dither_channel (b, d, nb));
+
+	    if (bpp == 2)
+	    {
+		xmm_p = _mm_srai_epi32 (_mm_slli_epi32 (xmm_p, 16), 16);
+		xmm_p = _mm_packs_epi32 (xmm_p, xmm_p);
+
+		if (n == 4)
+		{
+		    _mm_storel_epi64 ((__m128i *)(dst + 2 * x), xmm_p);
+		}
+		else
+		{
+		    _mm_storel_epi64 ((__m128i *)tmp, xmm_p);
+		    memcpy (dst + 2 * x, tmp, n * 2);
+		}
+	    }
+	    else if (n == 4)
+	    {
+		save_128_unaligned ((__m128i *)(dst + 4 * x), xmm_p);
+	    }
+	    else
+	    {
+		save_128_unaligned ((__m128i *)tmp, xmm_p);
+		memcpy (dst + 4 * x, tmp, n * 4);
+	    }
 	}
     }
-
 }
 
+#define SSE2_DITHER_FAST_PATH(name, over, format)			\
+    static void								\
+    sse2_composite_ ## name (pixman_implementation_t *imp,		\
+			     pixman_composite_info_t *info)		\
+    {									\
+	sse2_composite_dither (info, over, PIXMAN_ ## format);		\
+    }
+
+SSE2_DITHER_FAST_PATH (src_x888_0565_dither, FALSE, r5g6b5)
+SSE2_DITHER_FAST_PATH (src_x888_0555_dither, FALSE, x1r5g5b5)
+SSE2_DITHER_FAST_PATH (src_x888_0444_dither, FALSE, x4r4g4b4)
+SSE2_DITHER_FAST_PATH (src_x888_2101010_dither, FALSE, x2r10g10b10)
+SSE2_DITHER_FAST_PATH (over_8888_0565_dither, TRUE, r5g6b5)
+SSE2_DITHER_FAST_PATH (over_8888_0555_dither, TRUE, x1r5g5b5)
+SSE2_DITHER_FAST_PATH (over_8888_0444_dither, TRUE, x4r4g4b4)
+
 static void
 sse2_composite_over_n_8_8888 (pixman_implementation_t *imp,
                               pixman_composite_info_t *info)
@@ -4828,6 +6144,199 @@ sse2_composite_copy_area (pixman_implementation_t *imp,
 	      src_x, src_y, dest_x, dest_y, width, height);
 }
 
+static force_inline void
+transpose_4x4_32 (__m128i r[4])
+{
+    __m128i t0 = _mm_unpacklo_epi32 (r[0], r[1]);
+    __m128i t1 = _mm_unpackhi_epi32 (r[0], r[1]);
+    __m128i t2 = _mm_unpacklo_epi32 (r[2], r[3]);
+    __m128i t3 = _mm_unpackhi_epi32 (r[2], r[3]);
+
+    r[0] = _mm_unpacklo_epi64 (t0, t2);
+    r[1] = _mm_unpackhi_epi64 (t0, t2);
+    r[2] = _mm_unpacklo_epi64 (t1, t3);
+    r[3] = _mm_unpackhi_epi64 (t1, t3);
+}
+
+static force_inline void
+transpose_8x8_16 (__m128i r[8])
+{
+    __m128i s0 = _mm_unpacklo_epi16 (r[0], r[1]);
+    __m128i s1 = _mm_unpackhi_epi16 (r[0], r[1]);
+    __m128i s2 = _mm_unpacklo_epi16 (r[2], r[3]);
+    __m128i s3 = _mm_unpackhi_epi16 (r[2], r[3]);
+    __m128i s4 = _mm_unpacklo_epi16 (r[4], r[5]);
+    __m128i s5 = _mm_unpackhi_epi16 (r[4], r[5]);
+    __m128i s6 = _mm_unpacklo_epi16 (r[6], r[7]);
+    __m128i s7 = _mm_unpackhi_epi16 (r[6], r[7]);
+
+    __m128i t0 = _mm_unpacklo_epi32 (s0, s2);
+    __m128i t1 = _mm_unpackhi_epi32 (s0, s2);
+    __m128i t2 = _mm_unpacklo_epi32 (s4, s6);
+    __m128i t3 = _mm_unpackhi_epi32 (s4, s6);
+    __m128i t4 = _mm_unpacklo_epi32 (s1, s3);
+    __m128i t5 = _mm_unpackhi_epi32 (s1, s3);
+    __m128i t6 = _mm_unpacklo_epi32 (s5, s7);
+    __m128i t7 = _mm_unpackhi_epi32 (s5, s7);
+
+    r[0] = _mm_unpacklo_epi64 (t0, t2);
+    r[1] = _mm_unpackhi_epi64 (t0, t2);
+    r[2] = _mm_unpacklo_epi64 (t1, t3);
+    r[3] = _mm_unpackhi_epi64 (t1, t3);
+    r[4] = _mm_unpacklo_epi64 (t4, t6);
+    r[5] = _mm_unpackhi_epi64 (t4, t6);
+    r[6] = _mm_unpacklo_epi64 (t5, t7);
+    r[7] = _mm_unpackhi_epi64 (t5, t7);
+}
+
+/* Rotating a block clockwise is a transpose with the columns taken from
+ * right to left; counterclockwise, the rows are reversed before the
+ * transpose.
+ */
+static force_inline void
+sse2_block_90_8888 (uint32_t *dst, int dst_stride,
+		    const uint32_t *src, int src_stride)
+{
+    __m128i r[4];
+
+    r[0] = load_128_unaligned ((const __m128i *)(src + src_stride * 0));
+    r[1] = load_128_unaligned ((const __m128i *)(src + src_stride * 1));
+    r[2] = load_128_unaligned ((const __m128i *)(src + src_stride * 2));
+    r[3] = load_128_unaligned ((const __m128i *)(src + src_stride * 3));
+
+    transpose_4x4_32 (r);
+
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 0), r[3]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 1), r[2]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 2), r[1]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 3), r[0]);
+}
+
+static force_inline void
+sse2_block_270_8888 (uint32_t *dst, int dst_stride,
+		     const uint32_t *src, int src_stride)
+{
+    __m128i r[4];
+
+    r[3] = load_128_unaligned ((const __m128i *)(src + src_stride * 0));
+    r[2] = load_128_unaligned ((const __m128i *)(src + src_stride * 1));
+    r[1] = load_128_unaligned ((const __m128i *)(src + src_stride * 2));
+    r[0] = load_128_unaligned ((const __m128i *)(src + src_stride * 3));
+
+    transpose_4x4_32 (r);
+
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 0), r[0]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 1), r[1]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 2), r[2]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 3), r[3]);
+}
+
+static force_inline void
+sse2_block_90_565 (uint16_t *dst, int dst_stride,
+		   const uint16_t *src, int src_stride)
+{
+    __m128i r[8];
+
+    r[0] = load_128_unaligned ((const __m128i *)(src + src_stride * 0));
+    r[1] = load_128_unaligned ((const __m128i *)(src + src_stride * 1));
+    r[2] = load_128_unaligned ((const __m128i *)(src + src_stride * 2));
+    r[3] = load_128_unaligned ((const __m128i *)(src + src_stride * 3));
+    r[4] = load_128_unaligned ((const __m128i *)(src + src_stride * 4));
+    r[5] = load_128_unaligned ((const __m128i *)(src + src_stride * 5));
+    r[6] = load_128_unaligned ((const __m128i *)(src + src_stride * 6));
+    r[7] = load_128_unaligned ((const __m128i *)(src + src_stride * 7));
+
+    transpose_8x8_16 (r);
+
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 0), r[7]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 1), r[6]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 2), r[5]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 3), r[4]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 4), r[3]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 5), r[2]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 6), r[1]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 7), r[0]);
+}
+
+static force_inline void
+sse2_block_270_565 (uint16_t *dst, int dst_stride,
+		    const uint16_t *src, int src_stride)
+{
+    __m128i r[8];
+
+    r[7] = load_128_unaligned ((const __m128i *)(src + src_stride * 0));
+    r[6] = load_128_unaligned ((const __m128i *)(src + src_stride * 1));
+    r[5] = load_128_unaligned ((const __m128i *)(src + src_stride * 2));
+    r[4] = load_128_unaligned ((const __m128i *)(src + src_stride * 3));
+    r[3] = load_128_unaligned ((const __m128i *)(src + src_stride * 4));
+    r[2] = load_128_unaligned ((const __m128i *)(src + src_stride * 5));
+    r[1] = load_128_unaligned ((const __m128i *)(src + src_stride * 6));
+    r[0] = load_128_unaligned ((const __m128i *)(src + src_stride * 7));
+
+    transpose_8x8_16 (r);
+
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 0), r[0]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 1), r[1]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 2), r[2]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 3), r[3]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 4), r[4]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 5), r[5]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 6), r[6]);
+    save_128_unaligned ((__m128i *)(dst + dst_stride * 7), r[7]);
+}
+
+FAST_SIMPLE_ROTATE_BLOCKS (sse2_8888, uint32_t, 4,
+			   sse2_block_90_8888, sse2_block_270_8888)
+FAST_SIMPLE_ROTATE_BLOCKS (sse2_565, uint16_t, 8,
+			   sse2_block_90_565, sse2_block_270_565)
+
+static force_inline void
+sse2_reverse_line_8888 (uint32_t *dst, const uint32_t *src, int w)
+{
+    src += w;
+
+    while (w >= 4)
+    {
+	__m128i s;
+
+	src -= 4;
+	s = load_128_unaligned ((const __m128i *)src);
+	save_128_unaligned ((__m128i *)dst,
+			    _mm_shuffle_epi32 (s, _MM_SHUFFLE (0, 1, 2, 3)));
+	dst += 4;
+	w -= 4;
+    }
+
+    while (w--)
+	*dst++ = *--src;
+}
+
+static force_inline void
+sse2_reverse_line_565 (uint16_t *dst, const uint16_t *src, int w)
+{
+    src += w;
+
+    while (w >= 8)
+    {
+	__m128i s;
+
+	src -= 8;
+	s = load_128_unaligned ((const __m128i *)src);
+	s = _mm_shufflelo_epi16 (s, _MM_SHUFFLE (0, 1, 2, 3));
+	s = _mm_shufflehi_epi16 (s, _MM_SHUFFLE (0, 1, 2, 3));
+	save_128_unaligned ((__m128i *)dst,
+			    _mm_shuffle_epi32 (s, _MM_SHUFFLE (1, 0, 3, 2)));
+	dst += 8;
+	w -= 8;
+    }
+
+    while (w--)
+	*dst++ = *--src;
+}
+
+FAST_SIMPLE_FLIP (sse2_8888, uint32_t, sse2_reverse_line_8888)
+FAST_SIMPLE_FLIP (sse2_565, uint16_t, sse2_reverse_line_565)
+
 static void
 sse2_composite_over_x888_8_8888 (pixman_implementation_t *imp,
                                  pixman_composite_info_t *info)
@@ -6142,47 +7651,351 @@ scaled_bilinear_scanline_sse2_8888_n_8888_OVER (uint32_t *       dst,
 		((__m128i*)dst, pack_2x128_128 (xmm_dst_lo, xmm_dst_hi));
 	}
 
-	dst += 4;
-	w -= 4;
+	dst += 4;
+	w -= 4;
+    }
+
+    while (w)
+    {
+	BILINEAR_INTERPOLATE_ONE_PIXEL (pix1);
+	if (pix1)
+	{
+		uint32_t d = *dst;
+
+		__m128i ms = unpack_32_1x128 (pix1);
+		__m128i alpha     = expand_alpha_1x128 (ms);
+		__m128i dest      = xmm_mask;
+		__m128i alpha_dst = unpack_32_1x128 (d);
+
+		*dst = pack_1x128_32
+			(in_over_1x128 (&ms, &alpha, &dest, &alpha_dst));
+	}
+
+	dst++;
+	w--;
+    }
+}
+
+FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_n_8888_cover_OVER,
+			       scaled_bilinear_scanline_sse2_8888_n_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       COVER, FLAG_HAVE_SOLID_MASK)
+FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_n_8888_pad_OVER,
+			       scaled_bilinear_scanline_sse2_8888_n_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       PAD, FLAG_HAVE_SOLID_MASK)
+FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_n_8888_none_OVER,
+			       scaled_bilinear_scanline_sse2_8888_n_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       NONE, FLAG_HAVE_SOLID_MASK)
+FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_n_8888_normal_OVER,
+			       scaled_bilinear_scanline_sse2_8888_n_8888_OVER,
+			       uint32_t, uint32_t, uint32_t,
+			       NORMAL, FLAG_HAVE_SOLID_MASK)
+
+/* YUV to RGB with the coefficients of fetch_scanline_yuy2() in
+ * pixman-access.c, which are 16.16 fixed point and too large for
+ * pmaddwd. Each product is computed from the high and the low byte of
+ * the coefficient, which gives the same results as the C code.
+ */
+typedef struct
+{
+    __m128i offset;
+    __m128i r_hi, r_lo;
+    __m128i g_hi, g_lo, gu;
+    __m128i b_hi, b_lo;
+} yuv_constants_t;
+
+/* Y coefficient in the low half, U or V coefficient in the high half */
+static force_inline __m128i
+yuv_pair (int32_t y, int32_t c)
+{
+    return _mm_set1_epi32 ((y & 0xffff) | (uint32_t)c << 16);
+}
+
+static force_inline void
+yuv_constants_init (yuv_constants_t *k, const pixman_yuv_coefficients_t *c)
+{
+    k->offset = yuv_pair (c->y_offset, 128);
+    k->r_hi = yuv_pair (c->y >> 8, c->rv >> 8);
+    k->r_lo = yuv_pair (c->y & 0xff, c->rv & 0xff);
+    k->g_hi = yuv_pair (c->y >> 8, c->gv >> 8);
+    k->g_lo = yuv_pair (c->y & 0xff, c->gv & 0xff);
+    k->gu = yuv_pair (0, c->gu);
+    k->b_hi = yuv_pair (c->y >> 8, c->bu >> 8);
+    k->b_lo = yuv_pair (c->y & 0xff, c->bu & 0xff);
+}
+
+/* w holds Y0 U0 Y1 V0 Y2 U1 Y3 V1 in 16-bit lanes, as in yuy2 */
+static force_inline __m128i
+yuv_to_8888_4 (const yuv_constants_t *k, __m128i w)
+{
+    __m128i yu, yv, r, g, b;
+
+    w = _mm_sub_epi16 (w, k->offset);
+
+    /* Y with U or V of each pixel */
+    yu = _mm_shufflehi_epi16 (
+	_mm_shufflelo_epi16 (w, _MM_SHUFFLE (1, 2, 1, 0)), _MM_SHUFFLE (1, 2, 1, 0));
+    yv = _mm_shufflehi_epi16 (
+	_mm_shufflelo_epi16 (w, _MM_SHUFFLE (3, 2, 3, 0)), _MM_SHUFFLE (3, 2, 3, 0));
+
+    /* R = Y + V, G = Y + V + U and B = Y + U, each with its coefficient */
+    r = _mm_add_epi32 (
+	_mm_slli_epi32 (_mm_madd_epi16 (yv, k->r_hi), 8),
+	_mm_madd_epi16 (yv, k->r_lo));
+    g = _mm_add_epi32 (
+	_mm_add_epi32 (
+	    _mm_slli_epi32 (_mm_madd_epi16 (yv, k->g_hi), 8),
+	    _mm_madd_epi16 (yv, k->g_lo)),
+	_mm_madd_epi16 (yu, k->gu));
+    b = _mm_add_epi32 (
+	_mm_slli_epi32 (_mm_madd_epi16 (yu, k->b_hi), 8),
+	_mm_madd_epi16 (yu, k->b_lo));
+
+    /* Saturating packs clamp to [0, 255]. The bytes end up as
+     * B0-3 R0-3 G0-3 A0-3, and are then interleaved.
+     */
+    b = _mm_packus_epi16 (
+	_mm_packs_epi32 (_mm_srai_epi32 (b, 16), _mm_srai_epi32 (r, 16)),
+	_mm_packs_epi32 (_mm_srai_epi32 (g, 16), _mm_set1_epi32 (0xff)));
+    b = _mm_unpacklo_epi8 (b, _mm_srli_si128 (b, 8));
+
+    return _mm_unpacklo_epi16 (b, _mm_srli_si128 (b, 8));
+}
+
+static force_inline void
+yuyv_to_8888_8 (const yuv_constants_t *k, __m128i yuyv, uint32_t *buffer)
+{
+    save_128_unaligned (
+	(__m128i *)buffer,
+	yuv_to_8888_4 (k, _mm_unpacklo_epi8 (yuyv, _mm_setzero_si128 ())));
+    save_128_unaligned (
+	(__m128i *)(buffer + 4),
+	yuv_to_8888_4 (k, _mm_unpackhi_epi8 (yuyv, _mm_setzero_si128 ())));
+}
+
+/* Converts 8 pixels at a time, starting at an even x so that pairs of
+ * pixels share their chroma. Partial blocks go through a yuy2 copy.
+ */
+static void
+sse2_convert_yuv (bits_image_t *image, int x, int y, int width, uint32_t *buffer)
+{
+    const uint8_t *yuyv = NULL, *y_line = NULL, *u_line = NULL, *v_line = NULL;
+    int step = YUV_CHROMA_STEP (image);
+    yuv_constants_t k;
+
+    yuv_constants_init (&k, YUV_COEFFICIENTS (image));
+
+    if (image->format == PIXMAN_yuy2)
+    {
+	yuyv = (const uint8_t *)(image->bits + image->rowstride * y);
+    }
+    else
+    {
+	y_line = YUV_Y_LINE (image, y);
+	u_line = YUV_U_LINE (image, y);
+	v_line = YUV_V_LINE (image, y);
+    }
+
+    while (width > 0)
+    {
+	int start = x & 1;
+	int p = x - start;
+	int n = MIN (8 - start, width);
+
+	if (n == 8)
+	{
+	    __m128i v;
+
+	    if (yuyv)
+	    {
+		v = load_128_unaligned ((const __m128i *)(yuyv + 2 * p));
+	    }
+	    else
+	    {
+		__m128i uv;
+
+		if (step == 2)
+		{
+		    uv = _mm_loadl_epi64 ((const __m128i *)(u_line + p));
+		}
+		else
+		{
+		    uv = _mm_unpacklo_epi8 (
+			_mm_cvtsi32_si128 (*(const uint32_t *)(u_line + p / 2)),
+			_mm_cvtsi32_si128 (*(const uint32_t *)(v_line + p / 2)));
+		}
+
+		v = _mm_unpacklo_epi8 (
+		    _mm_loadl_epi64 ((const __m128i *)(y_line + p)), uv);
+	    }
+
+	    yuyv_to_8888_8 (&k, v, buffer);
+	}
+	else
+	{
+	    uint8_t tmp[16] = { 0 };
+	    uint32_t out[8];
+	    int i;
+
+	    if (yuyv)
+	    {
+		memcpy (tmp, yuyv + 2 * p, 2 * ((start + n + 1) & ~1));
+	    }
+	    else
+	    {
+		for (i = 0; i < start + n; ++i)
+		{
+		    tmp[2 * i] = y_line[p + i];
+		    tmp[2 * i + 1] = (i & 1) ?
+			v_line[((p + i) >> 1) * step] : u_line[((p + i) >> 1) * step];
+		}
+		if (i & 1)
+		    tmp[2 * i + 1] = v_line[((p + i) >> 1) * step];
+	    }
+
+	    yuyv_to_8888_8 (&k, load_128_unaligned ((__m128i *)tmp), out);
+	    memcpy (buffer, out + start, n * sizeof (uint32_t));
+	}
+
+	buffer += n;
+	x += n;
+	width -= n;
+    }
+}
+
+/* RGB to YUV with the coefficients of yuv_from_8888() in
+ * pixman-bits-image.c. The green byte is paired with a 1, which adds
+ * the rounding term in the same pmaddwd.
+ */
+typedef struct
+{
+    __m128i y_rb, y_g1, y_offset;
+    __m128i u_rb, u_g1;
+    __m128i v_rb, v_g1;
+} yuv_store_constants_t;
+
+static force_inline void
+yuv_store_constants_init (yuv_store_constants_t *k,
+			  const pixman_yuv_coefficients_t *c)
+{
+    k->y_rb = _mm_set1_epi32 ((c->yb & 0xffff) | (uint32_t)c->yr << 16);
+    k->y_g1 = _mm_set1_epi32 ((c->yg & 0xffff) | (1 << 14) << 16);
+    k->y_offset = _mm_set1_epi16 (c->y_offset);
+    k->u_rb = _mm_set1_epi32 ((c->ub & 0xffff) | (uint32_t)c->ur << 16);
+    k->u_g1 = _mm_set1_epi32 ((c->ug & 0xffff) | (1 << 14) << 16);
+    k->v_rb = _mm_set1_epi32 ((c->vb & 0xffff) | (uint32_t)c->vr << 16);
+    k->v_g1 = _mm_set1_epi32 ((c->vg & 0xffff) | (1 << 14) << 16);
+}
+
+/* One of Y, U or V for 4 pixels, split in B R and G 1 pairs */
+static force_inline __m128i
+yuv_from_8888_4 (__m128i rb, __m128i g1, __m128i c_rb, __m128i c_g1)
+{
+    return _mm_srai_epi32 (
+	_mm_add_epi32 (_mm_madd_epi16 (rb, c_rb), _mm_madd_epi16 (g1, c_g1)), 15);
+}
+
+/* Writes the luma of 8 pixels and adds the sums of the U and V of each
+ * pair of them to chroma[0..7].
+ */
+static force_inline void
+yuv_store_8 (const yuv_store_constants_t *k,
+	     const uint32_t *pixels, uint8_t *luma, uint16_t *chroma)
+{
+    __m128i mask = _mm_set1_epi32 (0x00ff00ff);
+    __m128i one = _mm_set1_epi32 (0x10000);
+    __m128i p0 = load_128_unaligned ((const __m128i *)pixels);
+    __m128i p1 = load_128_unaligned ((const __m128i *)(pixels + 4));
+    __m128i rb0 = _mm_and_si128 (p0, mask);
+    __m128i rb1 = _mm_and_si128 (p1, mask);
+    __m128i g0 = _mm_or_si128 (
+	_mm_and_si128 (_mm_srli_epi32 (p0, 8), _mm_set1_epi32 (0xff)), one);
+    __m128i g1 = _mm_or_si128 (
+	_mm_and_si128 (_mm_srli_epi32 (p1, 8), _mm_set1_epi32 (0xff)), one);
+    __m128i y, u, v;
+
+    y = _mm_packs_epi32 (yuv_from_8888_4 (rb0, g0, k->y_rb, k->y_g1),
+			 yuv_from_8888_4 (rb1, g1, k->y_rb, k->y_g1));
+    y = _mm_add_epi16 (y, k->y_offset);
+    _mm_storel_epi64 ((__m128i *)luma, _mm_packus_epi16 (y, y));
+
+    u = _mm_packs_epi32 (yuv_from_8888_4 (rb0, g0, k->u_rb, k->u_g1),
+			 yuv_from_8888_4 (rb1, g1, k->u_rb, k->u_g1));
+    v = _mm_packs_epi32 (yuv_from_8888_4 (rb0, g0, k->v_rb, k->v_g1),
+			 yuv_from_8888_4 (rb1, g1, k->v_rb, k->v_g1));
+    u = _mm_max_epi16 (_mm_min_epi16 (_mm_add_epi16 (u, _mm_set1_epi16 (128)),
+				      _mm_set1_epi16 (255)),
+		       _mm_setzero_si128 ());
+    v = _mm_max_epi16 (_mm_min_epi16 (_mm_add_epi16 (v, _mm_set1_epi16 (128)),
+				      _mm_set1_epi16 (255)),
+		       _mm_setzero_si128 ());
+
+    /* Sums of pairs, interleaved as U V U V */
+    u = _mm_madd_epi16 (u, _mm_set1_epi16 (1));
+    v = _mm_madd_epi16 (v, _mm_set1_epi16 (1));
+    u = _mm_packs_epi32 (_mm_unpacklo_epi32 (u, v), _mm_unpackhi_epi32 (u, v));
+
+    save_128_unaligned (
+	(__m128i *)chroma,
+	_mm_add_epi16 (load_128_unaligned ((__m128i *)chroma), u));
+}
+
+static void
+sse2_store_yuv (bits_image_t   *image,
+		const uint32_t *pixels,
+		int             width,
+		uint8_t        *luma,
+		uint16_t       *chroma)
+{
+    yuv_store_constants_t k;
+
+    yuv_store_constants_init (&k, YUV_COEFFICIENTS (image));
+
+    while (width >= 8)
+    {
+	yuv_store_8 (&k, pixels, luma, chroma);
+
+	pixels += 8;
+	luma += 8;
+	chroma += 8;
+	width -= 8;
     }
 
-    while (w)
+    if (width)
     {
-	BILINEAR_INTERPOLATE_ONE_PIXEL (pix1);
-	if (pix1)
-	{
-		uint32_t d = *dst;
-
-		__m128i ms = unpack_32_1x128 (pix1);
-		__m128i alpha     = expand_alpha_1x128 (ms);
-		__m128i dest      = xmm_mask;
-		__m128i alpha_dst = unpack_32_1x128 (d);
+	uint32_t tmp[8] = { 0 };
+	uint8_t tmp_luma[8];
+	uint16_t tmp_chroma[8] = { 0 };
+	int i;
 
-		*dst = pack_1x128_32
-			(in_over_1x128 (&ms, &alpha, &dest, &alpha_dst));
-	}
+	memcpy (tmp, pixels, width * sizeof (uint32_t));
+	yuv_store_8 (&k, tmp, tmp_luma, tmp_chroma);
 
-	dst++;
-	w--;
+	memcpy (luma, tmp_luma, width);
+	for (i = 0; i < width; ++i)
+	    chroma[i] += tmp_chroma[i];
     }
 }
 
-FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_n_8888_cover_OVER,
-			       scaled_bilinear_scanline_sse2_8888_n_8888_OVER,
-			       uint32_t, uint32_t, uint32_t,
-			       COVER, FLAG_HAVE_SOLID_MASK)
-FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_n_8888_pad_OVER,
-			       scaled_bilinear_scanline_sse2_8888_n_8888_OVER,
-			       uint32_t, uint32_t, uint32_t,
-			       PAD, FLAG_HAVE_SOLID_MASK)
-FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_n_8888_none_OVER,
-			       scaled_bilinear_scanline_sse2_8888_n_8888_OVER,
-			       uint32_t, uint32_t, uint32_t,
-			       NONE, FLAG_HAVE_SOLID_MASK)
-FAST_BILINEAR_MAINLOOP_COMMON (sse2_8888_n_8888_normal_OVER,
-			       scaled_bilinear_scanline_sse2_8888_n_8888_OVER,
-			       uint32_t, uint32_t, uint32_t,
-			       NORMAL, FLAG_HAVE_SOLID_MASK)
+static void
+sse2_composite_src_yuv_8888 (pixman_implementation_t *imp,
+			     pixman_composite_info_t *info)
+{
+    PIXMAN_COMPOSITE_ARGS (info);
+    uint32_t *dst_line;
+    int dst_stride;
+
+    PIXMAN_IMAGE_GET_LINE (
+	dest_image, dest_x, dest_y, uint32_t, dst_stride, dst_line, 1);
+
+    while (height--)
+    {
+	sse2_convert_yuv (&src_image->bits, src_x, src_y++, width, dst_line);
+	dst_line += dst_stride;
+    }
+}
 
 static const pixman_fast_path_t sse2_fast_paths[] =
 {
@@ -6234,6 +8047,12 @@ static const pixman_fast_path_t sse2_fast_paths[] =
     PIXMAN_STD_FAST_PATH (OVER, rpixbuf, rpixbuf, b5g6r5, sse2_composite_over_pixbuf_0565),
     PIXMAN_STD_FAST_PATH (OVER, x8r8g8b8, null, x8r8g8b8, sse2_composite_copy_area),
     PIXMAN_STD_FAST_PATH (OVER, x8b8g8r8, null, x8b8g8r8, sse2_composite_copy_area),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8r8g8b8, r5g6b5, sse2_composite_over_8888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8b8g8r8, b5g6r5, sse2_composite_over_8888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8r8g8b8, x1r5g5b5, sse2_composite_over_8888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8b8g8r8, x1b5g5r5, sse2_composite_over_8888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8r8g8b8, x4r4g4b4, sse2_composite_over_8888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (OVER, a8b8g8r8, x4b4g4r4, sse2_composite_over_8888_0444_dither),
     
     /* PIXMAN_OP_OVER_REVERSE */
     PIXMAN_STD_FAST_PATH (OVER_REVERSE, solid, null, a8r8g8b8, sse2_composite_over_reverse_n_8888),
@@ -6275,6 +8094,48 @@ static const pixman_fast_path_t sse2_fast_paths[] =
     PIXMAN_STD_FAST_PATH (SRC, r5g6b5, null, r5g6b5, sse2_composite_copy_area),
     PIXMAN_STD_FAST_PATH (SRC, b5g6r5, null, b5g6r5, sse2_composite_copy_area),
 
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, sse2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, sse2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, sse2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, sse2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, sse2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, sse2_8888),
+    SIMPLE_ROTATE_FAST_PATH (SRC, r5g6b5, r5g6b5, sse2_565),
+    SIMPLE_ROTATE_FAST_PATH (SRC, b5g6r5, b5g6r5, sse2_565),
+
+    SIMPLE_FLIP_FAST_PATH (SRC, a8r8g8b8, a8r8g8b8, sse2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8r8g8b8, x8r8g8b8, sse2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, x8r8g8b8, x8r8g8b8, sse2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8b8g8r8, a8b8g8r8, sse2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, a8b8g8r8, x8b8g8r8, sse2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, x8b8g8r8, x8b8g8r8, sse2_8888),
+    SIMPLE_FLIP_FAST_PATH (SRC, r5g6b5, r5g6b5, sse2_565),
+    SIMPLE_FLIP_FAST_PATH (SRC, b5g6r5, b5g6r5, sse2_565),
+    PIXMAN_STD_FAST_PATH (SRC, yuy2, null, a8r8g8b8, sse2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, yuy2, null, x8r8g8b8, sse2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, yv12, null, a8r8g8b8, sse2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, yv12, null, x8r8g8b8, sse2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, nv12, null, a8r8g8b8, sse2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, nv12, null, x8r8g8b8, sse2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, i420, null, a8r8g8b8, sse2_composite_src_yuv_8888),
+    PIXMAN_STD_FAST_PATH (SRC, i420, null, x8r8g8b8, sse2_composite_src_yuv_8888),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, r5g6b5, sse2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, r5g6b5, sse2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, b5g6r5, sse2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, b5g6r5, sse2_composite_src_x888_0565_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, x1r5g5b5, sse2_composite_src_x888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, x1r5g5b5, sse2_composite_src_x888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, x1b5g5r5, sse2_composite_src_x888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, x1b5g5r5, sse2_composite_src_x888_0555_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, x4r4g4b4, sse2_composite_src_x888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, x4r4g4b4, sse2_composite_src_x888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, x4b4g4r4, sse2_composite_src_x888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, x4b4g4r4, sse2_composite_src_x888_0444_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8r8g8b8, x2r10g10b10, sse2_composite_src_x888_2101010_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8r8g8b8, x2r10g10b10, sse2_composite_src_x888_2101010_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, a8b8g8r8, x2b10g10r10, sse2_composite_src_x888_2101010_dither),
+    PIXMAN_DITHER_FAST_PATH (SRC, x8b8g8r8, x2b10g10r10, sse2_composite_src_x888_2101010_dither),
+
     /* PIXMAN_OP_IN */
     PIXMAN_STD_FAST_PATH (IN, a8, null, a8, sse2_composite_in_8_8),
     PIXMAN_STD_FAST_PATH (IN, solid, a8, a8, sse2_composite_in_n_8_8),
@@ -6450,10 +8311,603 @@ sse2_fetch_a8 (pixman_iter_t *iter, const uint32_t *mask)
     return iter->buffer;
 }
 
+static void
+sse2_convolve_row (int32_t         *dest,
+		   const uint32_t  *src,
+		   const int32_t   *offsets,
+		   const int16_t  **weights,
+		   int              n_taps,
+		   int              width)
+{
+    __m128i zero = _mm_setzero_si128 ();
+    int i, k;
+
+    for (k = 0; k < width; ++k)
+    {
+	const uint32_t *s = src + offsets[k];
+	const int16_t *w = weights[k];
+	__m128i hi = zero;
+	__m128i lo = zero;
+
+	for (i = 0; i < n_taps; i += 2)
+	{
+	    /* Interleave the channels of two pixels, so that one multiply-add
+	     * applies both of their weights
+	     */
+	    __m128i p = _mm_unpacklo_epi8 (
+		_mm_loadl_epi64 ((const __m128i *)(s + i)), zero);
+	    __m128i f = _mm_loadl_epi64 ((const __m128i *)(w + 2 * i));
+
+	    p = _mm_unpacklo_epi16 (p, _mm_srli_si128 (p, 8));
+	    hi = _mm_add_epi32 (
+		hi, _mm_madd_epi16 (p, _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0))));
+	    lo = _mm_add_epi32 (
+		lo, _mm_madd_epi16 (p, _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1))));
+	}
+
+	_mm_store_si128 ((__m128i *)(dest + 4 * k),
+			 _mm_add_epi32 (_mm_slli_epi32 (hi, 8), lo));
+    }
+}
+
+/* Sums two channels of a row times a y weight scaled by 2^-32 */
+static force_inline __m128d
+convolution_madd_pd (__m128d sum, __m128i r, __m128d w)
+{
+    return _mm_add_pd (sum, _mm_mul_pd (_mm_cvtepi32_pd (r), w));
+}
+
+static force_inline __m128i
+convolution_reduce_pd (__m128d lo, __m128d hi)
+{
+    __m128d zero = _mm_setzero_pd ();
+    __m128d max = _mm_set1_pd (255.);
+
+    lo = _mm_min_pd (_mm_max_pd (lo, zero), max);
+    hi = _mm_min_pd (_mm_max_pd (hi, zero), max);
+
+    return _mm_unpacklo_epi64 (_mm_cvttpd_epi32 (lo), _mm_cvttpd_epi32 (hi));
+}
+
+/* The products of rows and weights stay below 2^52, so sums of them in
+ * double precision are exact. Sums start at one half, so that truncating
+ * them rounds like separable_convolution_reduce().
+ */
+static void
+sse2_convolve_column (uint32_t              *dest,
+		      const int32_t        **rows,
+		      const pixman_fixed_t  *weights,
+		      int                    n_rows,
+		      int                    width)
+{
+    __m128d half = _mm_set1_pd (0.5);
+    int i, k;
+
+    for (k = 0; k < width; k += 2)
+    {
+	int k1 = k + 1 < width ? k + 1 : k;
+	__m128d lo0 = half, hi0 = half;
+	__m128d lo1 = half, hi1 = half;
+	__m128i d;
+
+	for (i = 0; i < n_rows; ++i)
+	{
+	    __m128i r0 = _mm_load_si128 ((const __m128i *)(rows[i] + 4 * k));
+	    __m128i r1 = _mm_load_si128 ((const __m128i *)(rows[i] + 4 * k1));
+	    __m128d w = _mm_set1_pd (weights[i] * (1. / 4294967296.));
+
+	    lo0 = convolution_madd_pd (lo0, r0, w);
+	    hi0 = convolution_madd_pd (hi0, _mm_srli_si128 (r0, 8), w);
+	    lo1 = convolution_madd_pd (lo1, r1, w);
+	    hi1 = convolution_madd_pd (hi1, _mm_srli_si128 (r1, 8), w);
+	}
+
+	d = _mm_packs_epi32 (convolution_reduce_pd (lo0, hi0),
+			     convolution_reduce_pd (lo1, hi1));
+	d = _mm_packus_epi16 (d, d);
+
+	if (k1 != k)
+	    _mm_storel_epi64 ((__m128i *)(dest + k), d);
+	else
+	    dest[k] = _mm_cvtsi128_si32 (d);
+    }
+}
+
+static void
+sse2_separable_convolution_iter_init (pixman_iter_t *iter,
+				      const pixman_iter_info_t *iter_info)
+{
+    _pixman_separable_convolution_iter_init (
+	iter, sse2_convolve_row, sse2_convolve_column);
+}
+
+/* Gradient kernels. Positions are computed in double precision, like
+ * in pixman-linear-gradient.c and pixman-radial-gradient.c, two pixels
+ * at a time.
+ */
+
+/* Rounds towards zero, exactly for magnitudes below 2^52 */
+static force_inline __m128d
+sse2_trunc_pd (__m128d x)
+{
+    const __m128d sign = _mm_set1_pd (-0.);
+    const __m128d magic = _mm_set1_pd (4503599627370496.); /* 2^52 */
+    __m128d a = _mm_andnot_pd (sign, x);
+    __m128d r = _mm_sub_pd (_mm_add_pd (a, magic), magic);
+
+    r = _mm_sub_pd (r, _mm_and_pd (_mm_cmpgt_pd (r, a), _mm_set1_pd (1.)));
+
+    return _mm_or_pd (r, _mm_and_pd (sign, x));
+}
+
+/* Truncates two positions to integers, as the gradient walker takes
+ * them, and reduces them as described in pixman-private.h. The result
+ * is in the low half.
+ */
+static force_inline __m128i
+sse2_gradient_fold (__m128d x, pixman_repeat_t repeat)
+{
+    if (repeat == PIXMAN_REPEAT_NORMAL || repeat == PIXMAN_REPEAT_REFLECT)
+    {
+	const __m128d period = _mm_set1_pd (2. * pixman_fixed_1);
+	__m128d q, n;
+
+	x = sse2_trunc_pd (x);
+	q = _mm_mul_pd (x, _mm_set1_pd (1. / (2 * pixman_fixed_1)));
+	n = sse2_trunc_pd (q);
+	n = _mm_sub_pd (n, _mm_and_pd (_mm_cmpgt_pd (n, q), _mm_set1_pd (1.)));
+
+	return _mm_cvttpd_epi32 (_mm_sub_pd (x, _mm_mul_pd (n, period)));
+    }
+
+    x = _mm_max_pd (x, _mm_set1_pd (-1.));
+    x = _mm_min_pd (x, _mm_set1_pd (pixman_fixed_1 + 1.));
+
+    return _mm_cvttpd_epi32 (x);
+}
+
+static void
+sse2_gradient_linear (int32_t         *positions,
+		      double           t,
+		      double           inc,
+		      pixman_repeat_t  repeat,
+		      int              width)
+{
+    __m128d vt = _mm_set1_pd (t);
+    __m128d vinc = _mm_set1_pd (inc);
+    __m128d vi = _mm_setr_pd (0., 1.);
+    __m128d two = _mm_set1_pd (2.);
+    int i;
+
+    for (i = 0; i < width; i += 2)
+    {
+	/* As in linear_get_scanline(), the increment is truncated */
+	__m128i p = sse2_gradient_fold (
+	    _mm_add_pd (vt, sse2_trunc_pd (_mm_mul_pd (vinc, vi))), repeat);
+
+	if (i + 1 < width)
+	    _mm_storel_epi64 ((__m128i *)(positions + i), p);
+	else
+	    positions[i] = _mm_cvtsi128_si32 (p);
+
+	vi = _mm_add_pd (vi, two);
+    }
+}
+
+static void
+sse2_gradient_radial (int32_t                 *positions,
+		      const radial_gradient_t *radial,
+		      pixman_repeat_t          repeat,
+		      radial_step_t           *step,
+		      int                      width)
+{
+    __m128d a = _mm_set1_pd (radial->a);
+    __m128d inva = _mm_set1_pd (radial->inva);
+    __m128d dr = _mm_set1_pd (radial->delta.radius);
+    __m128d mindr = _mm_set1_pd (radial->mindr);
+    __m128d zero = _mm_setzero_pd ();
+    __m128d one = _mm_set1_pd (pixman_fixed_1);
+    __m128i clear = _mm_set1_epi32 (PIXMAN_GRADIENT_CLEAR);
+    pixman_fixed_32_32_t sb = step->b, sc = step->c, sdc = step->dc;
+    pixman_fixed_32_32_t bs[2], cs[2];
+    int i, j;
+
+    for (i = 0; i < width; i += 2)
+    {
+	__m128d b, c, t, valid;
+	__m128i p;
+
+	/* B and C are stepped exactly, as in radial_get_scanline() */
+	for (j = 0; j < 2; ++j)
+	{
+	    bs[j] = sb;
+	    cs[j] = sc;
+
+	    sb += step->db;
+	    sc += sdc;
+	    sdc += step->ddc;
+	}
+
+	b = _mm_setr_pd (bs[0], bs[1]);
+	c = _mm_setr_pd (cs[0], cs[1]);
+
+	if (radial->a == 0)
+	{
+	    __m128d b_is_zero = _mm_cmpeq_pd (b, zero);
+
+	    t = _mm_div_pd (_mm_mul_pd (_mm_set1_pd (pixman_fixed_1 / 2), c),
+			    _mm_or_pd (_mm_andnot_pd (b_is_zero, b),
+				       _mm_and_pd (b_is_zero, one)));
+
+	    if (repeat == PIXMAN_REPEAT_NONE)
+	    {
+		valid = _mm_and_pd (_mm_cmpge_pd (t, zero),
+				    _mm_cmple_pd (t, one));
+	    }
+	    else
+	    {
+		valid = _mm_cmpge_pd (_mm_mul_pd (t, dr), mindr);
+	    }
+
+	    valid = _mm_andnot_pd (b_is_zero, valid);
+	}
+	else
+	{
+	    __m128d discr, sqrtdiscr, t0, t1, valid0, valid1;
+
+	    discr = _mm_sub_pd (_mm_mul_pd (b, b), _mm_mul_pd (a, c));
+	    sqrtdiscr = _mm_sqrt_pd (_mm_max_pd (discr, zero));
+
+	    t0 = _mm_mul_pd (_mm_add_pd (b, sqrtdiscr), inva);
+	    t1 = _mm_mul_pd (_mm_sub_pd (b, sqrtdiscr), inva);
+
+	    if (repeat == PIXMAN_REPEAT_NONE)
+	    {
+		valid0 = _mm_and_pd (_mm_cmpge_pd (t0, zero),
+				     _mm_cmple_pd (t0, one));
+		valid1 = _mm_and_pd (_mm_cmpge_pd (t1, zero),
+				     _mm_cmple_pd (t1, one));
+	    }
+	    else
+	    {
+		valid0 = _mm_cmpge_pd (_mm_mul_pd (t0, dr), mindr);
+		valid1 = _mm_cmpge_pd (_mm_mul_pd (t1, dr), mindr);
+	    }
+
+	    /* The bigger root wins when both are valid */
+	    t = _mm_or_pd (_mm_and_pd (valid0, t0),
+			   _mm_andnot_pd (valid0, t1));
+	    valid = _mm_and_pd (_mm_cmpge_pd (discr, zero),
+				_mm_or_pd (valid0, valid1));
+	}
+
+	p = sse2_gradient_fold (t, repeat);
+
+	/* Shrink the 64-bit lane masks to 32 bits, like the positions */
+	valid = _mm_castsi128_pd (
+	    _mm_shuffle_epi32 (_mm_castpd_si128 (valid), _MM_SHUFFLE (3, 1, 2, 0)));
+	p = _mm_or_si128 (_mm_and_si128 (_mm_castpd_si128 (valid), p),
+			  _mm_andnot_si128 (_mm_castpd_si128 (valid), clear));
+
+	if (i + 1 < width)
+	    _mm_storel_epi64 ((__m128i *)(positions + i), p);
+	else
+	    positions[i] = _mm_cvtsi128_si32 (p);
+    }
+
+    step->b = sb;
+    step->c = sc;
+    step->dc = sdc;
+}
+
+/* Polynomial approximation of atan2() for four pixels, good to about
+ * 2e-6 radians, which is way below a level of an 8-bit ramp. It returns
+ * the positions in the conical gradient, as conical_get_scanline() does.
+ */
+static force_inline __m128i
+sse2_conical_positions (__m128 x, __m128 y, __m128 angle)
+{
+    const __m128 sign = _mm_set1_ps (-0.f);
+    __m128 ax = _mm_andnot_ps (sign, x);
+    __m128 ay = _mm_andnot_ps (sign, y);
+    __m128 steep = _mm_cmpgt_ps (ay, ax);
+    __m128 z, z2, r, u, fu;
+
+    z = _mm_div_ps (_mm_min_ps (ax, ay),
+		    _mm_max_ps (_mm_max_ps (ax, ay), _mm_set1_ps (FLT_MIN)));
+    z2 = _mm_mul_ps (z, z);
+
+    r = _mm_set1_ps (-0.01172120f);
+    r = _mm_add_ps (_mm_mul_ps (r, z2), _mm_set1_ps (0.05265332f));
+    r = _mm_add_ps (_mm_mul_ps (r, z2), _mm_set1_ps (-0.11643287f));
+    r = _mm_add_ps (_mm_mul_ps (r, z2), _mm_set1_ps (0.19354346f));
+    r = _mm_add_ps (_mm_mul_ps (r, z2), _mm_set1_ps (-0.33262347f));
+    r = _mm_add_ps (_mm_mul_ps (r, z2), _mm_set1_ps (0.99997726f));
+    r = _mm_mul_ps (r, z);
+
+    /* Back from the first octant to the whole circle */
+    r = _mm_or_ps (_mm_andnot_ps (steep, r),
+		   _mm_and_ps (steep, _mm_sub_ps (_mm_set1_ps (M_PI / 2), r)));
+    r = _mm_xor_ps (r, _mm_and_ps (sign, x));
+    r = _mm_add_ps (r, _mm_and_ps (_mm_cmplt_ps (x, _mm_setzero_ps ()),
+				   _mm_set1_ps (M_PI)));
+    r = _mm_xor_ps (r, _mm_and_ps (sign, y));
+
+    /* Scale to turns in [0, 1), counterclockwise */
+    u = _mm_mul_ps (_mm_add_ps (r, angle), _mm_set1_ps (1 / (2 * M_PI)));
+    fu = _mm_cvtepi32_ps (_mm_cvttps_epi32 (u));
+    fu = _mm_sub_ps (fu, _mm_and_ps (_mm_cmpgt_ps (fu, u), _mm_set1_ps (1.f)));
+    u = _mm_sub_ps (_mm_set1_ps (1.f), _mm_sub_ps (u, fu));
+
+    return _mm_cvttps_epi32 (_mm_mul_ps (u, _mm_set1_ps (pixman_fixed_1)));
+}
+
+static void
+sse2_gradient_conical (int32_t *positions,
+		       double   x,
+		       double   y,
+		       double   dx,
+		       double   dy,
+		       double   angle,
+		       int      width)
+{
+    __m128d vx = _mm_set1_pd (x);
+    __m128d vy = _mm_set1_pd (y);
+    __m128d vdx = _mm_set1_pd (dx);
+    __m128d vdy = _mm_set1_pd (dy);
+    __m128d vi = _mm_setr_pd (0., 1.);
+    __m128d two = _mm_set1_pd (2.);
+    __m128 vangle = _mm_set1_ps (angle);
+    int32_t tmp[4];
+    int i, j;
+
+    for (i = 0; i < width; i += 4)
+    {
+	__m128d vj = _mm_add_pd (vi, two);
+	__m128 fx, fy;
+	__m128i p;
+
+	fx = _mm_movelh_ps (
+	    _mm_cvtpd_ps (_mm_add_pd (vx, _mm_mul_pd (vdx, vi))),
+	    _mm_cvtpd_ps (_mm_add_pd (vx, _mm_mul_pd (vdx, vj))));
+	fy = _mm_movelh_ps (
+	    _mm_cvtpd_ps (_mm_add_pd (vy, _mm_mul_pd (vdy, vi))),
+	    _mm_cvtpd_ps (_mm_add_pd (vy, _mm_mul_pd (vdy, vj))));
+
+	p = sse2_conical_positions (fx, fy, vangle);
+
+	if (i + 4 <= width)
+	{
+	    _mm_storeu_si128 ((__m128i *)(positions + i), p);
+	}
+	else
+	{
+	    _mm_storeu_si128 ((__m128i *)tmp, p);
+
+	    for (j = 0; i + j < width; ++j)
+		positions[i + j] = tmp[j];
+	}
+
+	vi = _mm_add_pd (vj, two);
+    }
+}
+
+/* Returns the ramp entries of four positions, with the lanes that are
+ * transparent cleared in *valid
+ */
+static force_inline __m128i
+sse2_gradient_index (pixman_gradient_walker_t *walker,
+		     __m128i                   p,
+		     __m128i                  *valid)
+{
+    __m128i shift = _mm_cvtsi32_si128 (walker->lut_shift);
+    __m128i low = _mm_set1_epi32 (0xffff);
+    __m128i m;
+
+    *valid = _mm_xor_si128 (
+	_mm_cmpeq_epi32 (p, _mm_set1_epi32 (PIXMAN_GRADIENT_CLEAR)),
+	_mm_set1_epi32 (-1));
+
+    switch (walker->repeat)
+    {
+    case PIXMAN_REPEAT_NORMAL:
+	break;
+
+    case PIXMAN_REPEAT_REFLECT:
+	m = _mm_srai_epi32 (_mm_slli_epi32 (p, 15), 31);
+	p = _mm_xor_si128 (p, m);
+	break;
+
+    case PIXMAN_REPEAT_PAD:
+	p = _mm_andnot_si128 (_mm_srai_epi32 (p, 31), p);
+	m = _mm_cmpgt_epi32 (p, low);
+	p = _mm_or_si128 (_mm_andnot_si128 (m, p), _mm_and_si128 (m, low));
+	break;
+
+    default:
+    case PIXMAN_REPEAT_NONE:
+	*valid = _mm_andnot_si128 (
+	    _mm_cmplt_epi32 (p, _mm_set1_epi32 (walker->stops[0].x)),
+	    _mm_cmplt_epi32 (
+		p, _mm_set1_epi32 (walker->stops[walker->num_stops - 1].x)));
+	break;
+    }
+
+    return _mm_srl_epi32 (_mm_and_si128 (p, low), shift);
+}
+
+static void
+sse2_gradient_write_narrow (pixman_gradient_walker_t *walker,
+			    uint32_t                 *buffer,
+			    const int32_t            *positions,
+			    int                       width)
+{
+    const uint32_t *lut = walker->lut;
+    int32_t tmp[4];
+    int i, j, n;
+
+    for (i = 0; i < width; i += 4)
+    {
+	__m128i p, valid, c;
+
+	n = MIN (width - i, 4);
+
+	if (n == 4)
+	{
+	    p = _mm_loadu_si128 ((const __m128i *)(positions + i));
+	}
+	else
+	{
+	    for (j = 0; j < 4; ++j)
+		tmp[j] = j < n ? positions[i + j] : PIXMAN_GRADIENT_CLEAR;
+
+	    p = _mm_loadu_si128 ((const __m128i *)tmp);
+	}
+
+	_mm_storeu_si128 ((__m128i *)tmp, sse2_gradient_index (walker, p, &valid));
+
+	c = _mm_and_si128 (
+	    _mm_setr_epi32 (lut[tmp[0]], lut[tmp[1]], lut[tmp[2]], lut[tmp[3]]),
+	    valid);
+
+	if (n == 4)
+	{
+	    _mm_storeu_si128 ((__m128i *)(buffer + i), c);
+	}
+	else
+	{
+	    _mm_storeu_si128 ((__m128i *)tmp, c);
+
+	    for (j = 0; j < n; ++j)
+		buffer[i + j] = tmp[j];
+	}
+    }
+}
+
+/* Evaluates the gradient walker for one pixel per iteration, with the
+ * four channels in one register
+ */
+static void
+sse2_gradient_write_wide (pixman_gradient_walker_t *walker,
+			  uint32_t                 *buffer,
+			  const int32_t            *positions,
+			  int                       width)
+{
+    float *dest = (float *)buffer;
+    __m128 one = _mm_setr_ps (1.f, 0.f, 0.f, 0.f);
+    __m128 s = _mm_setzero_ps ();
+    __m128 b = _mm_setzero_ps ();
+    int i;
+
+    for (i = 0; i < width; ++i)
+    {
+	int32_t x = positions[i];
+	__m128 f, a;
+
+	if (x == PIXMAN_GRADIENT_CLEAR)
+	{
+	    _mm_storeu_ps (dest + 4 * i, _mm_setzero_ps ());
+	    continue;
+	}
+
+	if (walker->need_reset || x < walker->left_x || x >= walker->right_x)
+	{
+	    _pixman_gradient_walker_reset (walker, x);
+
+	    s = _mm_setr_ps (walker->a_s, walker->r_s, walker->g_s, walker->b_s);
+	    b = _mm_setr_ps (walker->a_b, walker->r_b, walker->g_b, walker->b_b);
+	}
+
+	f = _mm_add_ps (_mm_mul_ps (s, _mm_set1_ps (x * (1.0f / 65536.0f))), b);
+
+	/* Premultiply, with 1 for the alpha channel itself */
+	a = _mm_move_ss (_mm_shuffle_ps (f, f, 0), one);
+
+	_mm_storeu_ps (dest + 4 * i, _mm_mul_ps (f, a));
+    }
+}
+
+static const pixman_gradient_kernels_t sse2_gradient_kernels =
+{
+    sse2_gradient_linear,
+    sse2_gradient_radial,
+    sse2_gradient_conical,
+    sse2_gradient_write_narrow,
+    sse2_gradient_write_wide,
+};
+
+static void
+sse2_gradient_iter_init (pixman_iter_t *iter,
+			 const pixman_iter_info_t *iter_info)
+{
+    _pixman_gradient_iter_init (iter, &sse2_gradient_kernels);
+}
+
+static void
+sse2_yuv_bilinear (uint32_t       *buffer,
+		   const uint32_t *top,
+		   const uint32_t *bottom,
+		   int             width,
+		   int             wt,
+		   int             wb,
+		   pixman_fixed_t  vx,
+		   pixman_fixed_t  unit_x)
+{
+    scaled_bilinear_scanline_sse2_8888_8888_SRC (
+	buffer, NULL, top, bottom, width, wt, wb, vx, unit_x, 0, FALSE);
+}
+
+static const pixman_yuv_kernels_t sse2_yuv_kernels =
+{
+    sse2_convert_yuv,
+    sse2_yuv_bilinear,
+    sse2_store_yuv,
+};
+
+static void
+sse2_yuv_iter_init (pixman_iter_t *iter,
+		    const pixman_iter_info_t *iter_info)
+{
+    _pixman_yuv_iter_init (iter, iter_info, &sse2_yuv_kernels);
+}
+
+static void
+sse2_yuv_dest_iter_init (pixman_iter_t *iter,
+			 const pixman_iter_info_t *iter_info)
+{
+    _pixman_yuv_dest_iter_init (iter, &sse2_yuv_kernels);
+}
+
 #define IMAGE_FLAGS							\
     (FAST_PATH_STANDARD_FLAGS | FAST_PATH_ID_TRANSFORM |		\
      FAST_PATH_BITS_IMAGE | FAST_PATH_SAMPLES_COVER_CLIP_NEAREST)
 
+#define YUV_NEAREST_FLAGS						\
+    (FAST_PATH_STANDARD_FLAGS | FAST_PATH_SCALE_TRANSFORM |		\
+     FAST_PATH_NEAREST_FILTER | FAST_PATH_X_UNIT_POSITIVE |		\
+     FAST_PATH_SAMPLES_COVER_CLIP_NEAREST)
+
+#define YUV_BILINEAR_FLAGS						\
+    (FAST_PATH_STANDARD_FLAGS | FAST_PATH_SCALE_TRANSFORM |		\
+     FAST_PATH_BILINEAR_FILTER | FAST_PATH_X_UNIT_POSITIVE |		\
+     FAST_PATH_SAMPLES_COVER_CLIP_BILINEAR)
+
+#define YUV_ITERS(format)						\
+    { PIXMAN_ ## format, IMAGE_FLAGS, ITER_NARROW | ITER_SRC,		\
+      sse2_yuv_iter_init, NULL, NULL					\
+    },									\
+    { PIXMAN_ ## format, YUV_NEAREST_FLAGS, ITER_NARROW | ITER_SRC,	\
+      sse2_yuv_iter_init, NULL, NULL					\
+    },									\
+    { PIXMAN_ ## format, YUV_BILINEAR_FLAGS, ITER_NARROW | ITER_SRC,	\
+      sse2_yuv_iter_init, NULL, NULL					\
+    }
+
+#define YUV_DEST_ITER(format)						\
+    { PIXMAN_ ## format, FAST_PATH_NO_ACCESSORS, ITER_DEST,		\
+      sse2_yuv_dest_iter_init, NULL, NULL				\
+    }
+
 static const pixman_iter_info_t sse2_iters[] = 
 {
     { PIXMAN_x8r8g8b8, IMAGE_FLAGS, ITER_NARROW,
@@ -6465,6 +8919,19 @@ static const pixman_iter_info_t sse2_iters[] =
     { PIXMAN_a8, IMAGE_FLAGS, ITER_NARROW,
       _pixman_iter_init_bits_stride, sse2_fetch_a8, NULL
     },
+    YUV_ITERS (yuy2),
+    YUV_ITERS (yv12),
+    YUV_ITERS (nv12),
+    YUV_ITERS (i420),
+    YUV_DEST_ITER (yv12),
+    YUV_DEST_ITER (nv12),
+    YUV_DEST_ITER (i420),
+    { PIXMAN_any, SEPARABLE_CONVOLUTION_SCALE_FLAGS, ITER_NARROW | ITER_SRC,
+      sse2_separable_convolution_iter_init, NULL, NULL
+    },
+    { PIXMAN_unknown, 0, ITER_SRC,
+      sse2_gradient_iter_init, NULL, NULL
+    },
     { PIXMAN_null },
 };
 
@@ -6476,6 +8943,8 @@ _pixman_implementation_create_sse2 (pixman_implementation_t *fallback)
 {
     pixman_implementation_t *imp = _pixman_implementation_create (fallback, sse2_fast_paths);
 
+    imp->name = "sse2";
+
     /* SSE2 constants */
     mask_565_r  = create_mask_2x32_128 (0x00f80000, 0x00f80000);
     mask_565_g1 = create_mask_2x32_128 (0x00070000, 0x00070000);
@@ -6521,6 +8990,9 @@ _pixman_implementation_create_sse2 (pixman_implementation_t *fallback)
     imp->combine_32_ca[PIXMAN_OP_XOR] = sse2_combine_xor_ca;
     imp->combine_32_ca[PIXMAN_OP_ADD] = sse2_combine_add_ca;
 
+    sse2_setup_combiner_functions_32 (imp);
+    sse2_setup_combiner_functions_float (imp);
+
     imp->blt = sse2_blt;
     imp->fill = sse2_fill;
 
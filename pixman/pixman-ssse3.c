@@ -267,7 +267,7 @@ ssse3_fetch_bilinear_cover (pixman_iter_t *iter, const uint32_t *mask)
 static void
 ssse3_bilinear_cover_iter_fini (pixman_iter_t *iter)
 {
-    free (iter->data);
+    _pixman_scratch_free (iter->data);
 }
 
 static void
@@ -285,7 +285,8 @@ ssse3_bilinear_cover_iter_init (pixman_iter_t *iter, const pixman_iter_info_t *i
     if (!pixman_transform_point_3d (iter->image->common.transform, &v))
 	goto fail;
 
-    info = malloc (sizeof (*info) + (2 * width - 1) * sizeof (uint64_t) + 64);
+    info = _pixman_scratch_alloc (
+	sizeof (*info) + (2 * width - 1) * sizeof (uint64_t) + 64);
     if (!info)
 	goto fail;
 
@@ -347,6 +348,8 @@ _pixman_implementation_create_ssse3 (pixman_implementation_t *fallback)
     pixman_implementation_t *imp =
 	_pixman_implementation_create (fallback, ssse3_fast_paths);
 
+    imp->name = "ssse3";
+
     imp->iter_info = ssse3_iters;
 
     return imp;
@@ -0,0 +1,547 @@
+/*
+ * Copyright © 2024 Pixman contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#elif defined (_MSC_VER)
+#include <config_msc.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "pixman-private.h"
+
+#ifdef HAVE_PTHREADS
+# include <pthread.h>
+
+static pthread_mutex_t tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+# define tables_lock()		pthread_mutex_lock (&tables_mutex)
+# define tables_unlock()	pthread_mutex_unlock (&tables_mutex)
+
+#elif defined (_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+
+static SRWLOCK tables_mutex = SRWLOCK_INIT;
+
+# define tables_lock()		AcquireSRWLockExclusive (&tables_mutex)
+# define tables_unlock()	ReleaseSRWLockExclusive (&tables_mutex)
+
+#else
+# define tables_lock()
+# define tables_unlock()
+#endif
+
+/* Each thread counts into its own table so that recording needs no
+ * locking. The tables are kept in a global list, so that the counts of
+ * threads that have exited can still be reported. With pthreads, the
+ * table of a thread that exits is handed to the next thread that starts
+ * recording, which adds to the counts already in it, so there are never
+ * more tables than threads recording at once. Without pthreads, the
+ * tables of exited threads are kept but not reused.
+ *
+ * A table has a fixed number of slots. Signatures that do not fit are
+ * only counted in n_dropped.
+ */
+#define N_SLOTS		512
+
+typedef struct stats_table_t stats_table_t;
+
+typedef struct
+{
+    pixman_implementation_t *	imp;
+    pixman_composite_func_t	func;
+    pixman_op_t			op;
+    pixman_format_code_t	src_format;
+    pixman_format_code_t	mask_format;
+    pixman_format_code_t	dest_format;
+    uint32_t			src_flags;
+    uint32_t			mask_flags;
+    uint32_t			dest_flags;
+
+    uint64_t			n_calls;
+    uint64_t			n_boxes;
+    uint64_t			n_pixels;
+} stats_slot_t;
+
+struct stats_table_t
+{
+    stats_table_t *		next;
+    pixman_bool_t		in_use;
+    uint64_t			n_dropped;
+    uint64_t			n_cache_hits;
+    uint64_t			n_cache_misses;
+    stats_slot_t		slots[N_SLOTS];
+};
+
+typedef struct
+{
+    stats_table_t *		table;
+} thread_stats_t;
+
+PIXMAN_DEFINE_THREAD_LOCAL (thread_stats_t, thread_stats)
+
+int _pixman_statistics_enabled;
+
+static stats_table_t *tables;
+
+#ifdef HAVE_PTHREADS
+
+/* The thread local above may not have a destructor, so a key is used
+ * to give the table back when its thread exits.
+ */
+static pthread_once_t stats_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t stats_key;
+
+static void
+stats_table_release (void *table)
+{
+    PIXMAN_GET_THREAD_LOCAL (thread_stats)->table = NULL;
+
+    tables_lock ();
+    ((stats_table_t *)table)->in_use = FALSE;
+    tables_unlock ();
+}
+
+static void
+stats_make_key (void)
+{
+    pthread_key_create (&stats_key, stats_table_release);
+}
+#endif
+
+static stats_table_t *
+get_table (void)
+{
+    thread_stats_t *stats = PIXMAN_GET_THREAD_LOCAL (thread_stats);
+
+    if (!stats->table)
+    {
+	stats_table_t *table;
+
+	tables_lock ();
+
+	for (table = tables; table != NULL; table = table->next)
+	{
+	    if (!table->in_use)
+		break;
+	}
+
+	if (!table && (table = calloc (1, sizeof (stats_table_t))))
+	{
+	    table->next = tables;
+	    tables = table;
+	}
+
+	if (table)
+	    table->in_use = TRUE;
+
+	tables_unlock ();
+
+	if (!table)
+	    return NULL;
+
+#ifdef HAVE_PTHREADS
+	pthread_once (&stats_key_once, stats_make_key);
+	pthread_setspecific (stats_key, table);
+#endif
+
+	stats->table = table;
+    }
+
+    return stats->table;
+}
+
+static force_inline uint32_t
+hash_signature (pixman_implementation_t *      imp,
+		pixman_composite_func_t        func,
+		const pixman_composite_info_t *info,
+		pixman_format_code_t           src_format,
+		pixman_format_code_t           mask_format)
+{
+    uint32_t h = (uint32_t)(uintptr_t)func * 0x9e3779b1u;
+
+    h = (h ^ info->op) * 0x85ebca6bu;
+    h = (h ^ src_format) * 0xc2b2ae35u;
+    h = (h ^ mask_format) * 0x27d4eb2fu;
+    h = (h ^ info->dest_image->common.extended_format_code) * 0x9e3779b1u;
+    h = (h ^ info->src_flags ^ (info->mask_flags << 7)) * 0x85ebca6bu;
+    h = (h ^ info->dest_flags ^ (uint32_t)(uintptr_t)imp) * 0xc2b2ae35u;
+
+    return h ^ (h >> 16);
+}
+
+void
+_pixman_statistics_record (pixman_implementation_t *      imp,
+			   pixman_composite_func_t        func,
+			   const pixman_composite_info_t *info,
+			   pixman_format_code_t           src_format,
+			   pixman_format_code_t           mask_format,
+			   const pixman_box32_t *         boxes,
+			   int                            n_boxes)
+{
+    pixman_format_code_t dest_format =
+	info->dest_image->common.extended_format_code;
+    stats_table_t *table;
+    stats_slot_t *slot;
+    uint64_t n_pixels;
+    uint32_t i, n;
+
+    if (!(table = get_table ()))
+	return;
+
+    i = hash_signature (imp, func, info, src_format, mask_format);
+
+    for (n = 0; n < N_SLOTS; ++n, ++i)
+    {
+	slot = &table->slots[i & (N_SLOTS - 1)];
+
+	if (!slot->func)
+	{
+	    slot->imp = imp;
+	    slot->op = info->op;
+	    slot->src_format = src_format;
+	    slot->mask_format = mask_format;
+	    slot->dest_format = dest_format;
+	    slot->src_flags = info->src_flags;
+	    slot->mask_flags = info->mask_flags;
+	    slot->dest_flags = info->dest_flags;
+	    slot->func = func;
+	    break;
+	}
+
+	if (slot->func == func				&&
+	    slot->imp == imp				&&
+	    slot->op == info->op			&&
+	    slot->src_format == src_format		&&
+	    slot->mask_format == mask_format		&&
+	    slot->dest_format == dest_format		&&
+	    slot->src_flags == info->src_flags		&&
+	    slot->mask_flags == info->mask_flags	&&
+	    slot->dest_flags == info->dest_flags)
+	{
+	    break;
+	}
+    }
+
+    if (n == N_SLOTS)
+    {
+	table->n_dropped++;
+	return;
+    }
+
+    n_pixels = 0;
+    for (n = 0; n < (uint32_t)n_boxes; ++n)
+    {
+	n_pixels += (uint64_t)(boxes[n].x2 - boxes[n].x1) *
+	    (boxes[n].y2 - boxes[n].y1);
+    }
+
+    slot->n_calls++;
+    slot->n_boxes += n_boxes;
+    slot->n_pixels += n_pixels;
+}
+
+void
+_pixman_statistics_count_lookup (pixman_bool_t hit)
+{
+    stats_table_t *table;
+
+    if (!(table = get_table ()))
+	return;
+
+    if (hit)
+	table->n_cache_hits++;
+    else
+	table->n_cache_misses++;
+}
+
+static void
+collect_cache_statistics (uint64_t *n_hits, uint64_t *n_misses)
+{
+    stats_table_t *table;
+
+    *n_hits = *n_misses = 0;
+
+    tables_lock ();
+
+    for (table = tables; table != NULL; table = table->next)
+    {
+	*n_hits += table->n_cache_hits;
+	*n_misses += table->n_cache_misses;
+    }
+
+    tables_unlock ();
+}
+
+static pixman_bool_t
+same_signature (const pixman_composite_statistics_t *stat,
+		const stats_slot_t                  *slot)
+{
+    return stat->function == (const void *)slot->func		&&
+	   stat->implementation == slot->imp->name		&&
+	   stat->op == slot->op					&&
+	   stat->src_format == slot->src_format			&&
+	   stat->mask_format == slot->mask_format		&&
+	   stat->dest_format == slot->dest_format		&&
+	   stat->src_flags == slot->src_flags			&&
+	   stat->mask_flags == slot->mask_flags			&&
+	   stat->dest_flags == slot->dest_flags;
+}
+
+static int
+compare_pixels (const void *a, const void *b)
+{
+    const pixman_composite_statistics_t *sa = a;
+    const pixman_composite_statistics_t *sb = b;
+
+    if (sa->n_pixels != sb->n_pixels)
+	return sa->n_pixels < sb->n_pixels ? 1 : -1;
+
+    if (sa->n_calls != sb->n_calls)
+	return sa->n_calls < sb->n_calls ? 1 : -1;
+
+    return 0;
+}
+
+/* Sums the tables of all threads into a newly allocated array sorted by
+ * decreasing pixel count. The counts of other threads are read while
+ * they may be updating them, so they can be slightly out of date.
+ */
+static pixman_composite_statistics_t *
+collect_statistics (int *n_stats, uint64_t *n_dropped)
+{
+    pixman_composite_statistics_t *stats;
+    stats_table_t *table;
+    int n_tables = 0;
+    int n = 0;
+    int i, j;
+
+    tables_lock ();
+
+    for (table = tables; table != NULL; table = table->next)
+	n_tables++;
+
+    stats = pixman_malloc_ab (n_tables * N_SLOTS + 1,
+			      sizeof (pixman_composite_statistics_t));
+
+    *n_dropped = 0;
+
+    for (table = tables; stats && table != NULL; table = table->next)
+    {
+	*n_dropped += table->n_dropped;
+
+	for (i = 0; i < N_SLOTS; ++i)
+	{
+	    const stats_slot_t *slot = &table->slots[i];
+	    pixman_composite_statistics_t *stat;
+
+	    if (!slot->func || !slot->n_calls)
+		continue;
+
+	    for (j = 0; j < n; ++j)
+	    {
+		if (same_signature (&stats[j], slot))
+		    break;
+	    }
+
+	    stat = &stats[j];
+
+	    if (j == n)
+	    {
+		stat->op = slot->op;
+		stat->src_format = slot->src_format;
+		stat->mask_format = slot->mask_format;
+		stat->dest_format = slot->dest_format;
+		stat->src_flags = slot->src_flags;
+		stat->mask_flags = slot->mask_flags;
+		stat->dest_flags = slot->dest_flags;
+		stat->implementation = slot->imp->name;
+		stat->function = (const void *)slot->func;
+		stat->n_calls = 0;
+		stat->n_boxes = 0;
+		stat->n_pixels = 0;
+		n++;
+	    }
+
+	    stat->n_calls += slot->n_calls;
+	    stat->n_boxes += slot->n_boxes;
+	    stat->n_pixels += slot->n_pixels;
+	}
+    }
+
+    tables_unlock ();
+
+    if (stats)
+	qsort (stats, n, sizeof (pixman_composite_statistics_t), compare_pixels);
+
+    *n_stats = n;
+    return stats;
+}
+
+static const char *
+format_name (pixman_format_code_t format, char *buf)
+{
+    static const char *const types[] =
+    {
+	"other", "a", "argb", "abgr", "color", "gray", "yuy2", "yv12",
+	"bgra", "rgba", "argb_srgb", "rgba_float", "nv12", "i420"
+    };
+    int type = PIXMAN_FORMAT_TYPE (format);
+
+    if (format == PIXMAN_null)
+	return "null";
+    if (format == PIXMAN_solid)
+	return "solid";
+    if (format == PIXMAN_pixbuf)
+	return "pixbuf";
+    if (format == PIXMAN_rpixbuf)
+	return "rpixbuf";
+
+    sprintf (buf, "%s%d:%d%d%d%d",
+	     type < (int)(sizeof (types) / sizeof (types[0])) ? types[type] : "?",
+	     PIXMAN_FORMAT_BPP (format),
+	     PIXMAN_FORMAT_A (format), PIXMAN_FORMAT_R (format),
+	     PIXMAN_FORMAT_G (format), PIXMAN_FORMAT_B (format));
+
+    return buf;
+}
+
+static void
+dump_statistics (void)
+{
+    pixman_composite_statistics_t *stats;
+    uint64_t n_dropped, n_hits, n_misses;
+    int n_stats, i;
+
+    if (!(stats = collect_statistics (&n_stats, &n_dropped)))
+	return;
+
+    fprintf (stderr, "pixman: %-10s %4s %-14s %-14s %-14s %12s %10s %14s\n",
+	     "impl", "op", "src", "mask", "dest", "calls", "boxes", "pixels");
+
+    for (i = 0; i < n_stats; ++i)
+    {
+	const pixman_composite_statistics_t *stat = &stats[i];
+	char src[32], mask[32], dest[32];
+
+	fprintf (stderr, "pixman: %-10s %4d %-14s %-14s %-14s %12llu %10llu %14llu\n",
+		 stat->implementation ? stat->implementation : "?",
+		 stat->op,
+		 format_name (stat->src_format, src),
+		 format_name (stat->mask_format, mask),
+		 format_name (stat->dest_format, dest),
+		 (unsigned long long)stat->n_calls,
+		 (unsigned long long)stat->n_boxes,
+		 (unsigned long long)stat->n_pixels);
+    }
+
+    if (n_dropped)
+    {
+	fprintf (stderr, "pixman: %llu composites not counted, too many signatures\n",
+		 (unsigned long long)n_dropped);
+    }
+
+    collect_cache_statistics (&n_hits, &n_misses);
+
+    fprintf (stderr, "pixman: fast path cache: %llu hits, %llu misses\n",
+	     (unsigned long long)n_hits, (unsigned long long)n_misses);
+
+    free (stats);
+}
+
+void
+_pixman_statistics_init (void)
+{
+    if (getenv ("PIXMAN_STATISTICS"))
+    {
+	_pixman_statistics_enabled = TRUE;
+	atexit (dump_statistics);
+    }
+}
+
+PIXMAN_EXPORT void
+pixman_enable_statistics (pixman_bool_t enable)
+{
+    _pixman_statistics_enabled = enable;
+}
+
+PIXMAN_EXPORT int
+pixman_get_statistics (pixman_composite_statistics_t *stats,
+		       int                            n_stats)
+{
+    pixman_composite_statistics_t *all;
+    uint64_t n_dropped;
+    int n_all;
+
+    if (!(all = collect_statistics (&n_all, &n_dropped)))
+	return 0;
+
+    if (n_stats > n_all)
+	n_stats = n_all;
+
+    if (stats && n_stats > 0)
+	memcpy (stats, all, n_stats * sizeof (pixman_composite_statistics_t));
+
+    free (all);
+
+    return n_all;
+}
+
+PIXMAN_EXPORT void
+pixman_get_cache_statistics (uint64_t *n_hits,
+			     uint64_t *n_misses)
+{
+    collect_cache_statistics (n_hits, n_misses);
+}
+
+PIXMAN_EXPORT void
+pixman_reset_statistics (void)
+{
+    stats_table_t *table;
+    int i;
+
+    /* Only the counts are cleared. Signatures stay in their slots, so a
+     * thread that is recording at the same time never sees a slot
+     * change under it.
+     */
+    tables_lock ();
+
+    for (table = tables; table != NULL; table = table->next)
+    {
+	table->n_dropped = 0;
+	table->n_cache_hits = 0;
+	table->n_cache_misses = 0;
+
+	for (i = 0; i < N_SLOTS; ++i)
+	{
+	    table->slots[i].n_calls = 0;
+	    table->slots[i].n_boxes = 0;
+	    table->slots[i].n_pixels = 0;
+	}
+    }
+
+    tables_unlock ();
+}
@@ -0,0 +1,449 @@
+/*
+ * Copyright © 2024 Pixman contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#elif defined (_MSC_VER)
+#include <config_msc.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "pixman-private.h"
+
+#ifdef HAVE_PTHREADS
+# include <pthread.h>
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+# define trace_lock()		pthread_mutex_lock (&trace_mutex)
+# define trace_unlock()		pthread_mutex_unlock (&trace_mutex)
+
+#elif defined (_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+
+static SRWLOCK trace_mutex = SRWLOCK_INIT;
+
+# define trace_lock()		AcquireSRWLockExclusive (&trace_mutex)
+# define trace_unlock()		ReleaseSRWLockExclusive (&trace_mutex)
+
+#else
+# define trace_lock()
+# define trace_unlock()
+#endif
+
+int _pixman_trace_enabled;
+
+static FILE *trace_file;
+
+/* A record is built in memory and then written with a single fwrite()
+ * under the lock, so records from different threads never interleave.
+ */
+typedef struct
+{
+    uint32_t *	words;
+    int		n_words;
+    int		size;
+    uint32_t	stack_words[256];
+} record_t;
+
+static void
+record_init (record_t *record, pixman_trace_record_t type)
+{
+    record->words = record->stack_words;
+    record->size = sizeof (record->stack_words) / sizeof (uint32_t);
+    record->words[0] = type;
+    record->words[1] = 0;
+    record->n_words = 2;
+}
+
+static void
+put (record_t *record, uint32_t word)
+{
+    if (record->n_words == record->size)
+    {
+	uint32_t *words;
+
+	if (!record->words)
+	    return;
+
+	words = pixman_malloc_ab (2 * record->size, sizeof (uint32_t));
+	if (words)
+	    memcpy (words, record->words, record->size * sizeof (uint32_t));
+
+	if (record->words != record->stack_words)
+	    free (record->words);
+
+	/* The record is dropped if it cannot grow */
+	if (!(record->words = words))
+	    return;
+
+	record->size *= 2;
+    }
+
+    record->words[record->n_words++] = word;
+}
+
+static void
+put_color (record_t *record, const pixman_color_t *color)
+{
+    put (record, (color->red << 16) | color->green);
+    put (record, (color->blue << 16) | color->alpha);
+}
+
+static void
+put_box (record_t *record, const pixman_box32_t *box)
+{
+    put (record, box->x1);
+    put (record, box->y1);
+    put (record, box->x2);
+    put (record, box->y2);
+}
+
+/* Image descriptor:
+ *
+ *   type (0 for no image)
+ *   bits:     format, width, height, dither, mipmap
+ *   solid:    color
+ *   linear:   p1, p2, stops
+ *   radial:   c1, c2, stops
+ *   conical:  center, angle in degrees, stops
+ *   repeat, filter, filter parameters, transform, component alpha,
+ *   source clipping and clip boxes
+ */
+static void
+put_image (record_t *record, pixman_image_t *image)
+{
+    image_common_t *common;
+    int i;
+
+    if (!image)
+    {
+	put (record, 0);
+	return;
+    }
+
+    common = &image->common;
+
+    put (record, common->type + 1);
+
+    switch (common->type)
+    {
+    case BITS:
+	put (record, image->bits.format);
+	put (record, image->bits.width);
+	put (record, image->bits.height);
+	put (record, image->bits.dither);
+	put (record, image->bits.mipmap ?
+	     image->bits.mipmap->mode : PIXMAN_MIPMAP_NONE);
+	break;
+
+    case SOLID:
+	put_color (record, &image->solid.color);
+	break;
+
+    case LINEAR:
+	put (record, image->linear.p1.x);
+	put (record, image->linear.p1.y);
+	put (record, image->linear.p2.x);
+	put (record, image->linear.p2.y);
+	break;
+
+    case RADIAL:
+	put (record, image->radial.c1.x);
+	put (record, image->radial.c1.y);
+	put (record, image->radial.c1.radius);
+	put (record, image->radial.c2.x);
+	put (record, image->radial.c2.y);
+	put (record, image->radial.c2.radius);
+	break;
+
+    case CONICAL:
+	put (record, image->conical.center.x);
+	put (record, image->conical.center.y);
+	put (record, pixman_double_to_fixed (
+		 image->conical.angle * 180.0 / M_PI));
+	break;
+    }
+
+    if (common->type == LINEAR	||
+	common->type == RADIAL	||
+	common->type == CONICAL)
+    {
+	put (record, image->gradient.n_stops);
+
+	for (i = 0; i < image->gradient.n_stops; ++i)
+	{
+	    put (record, image->gradient.stops[i].x);
+	    put_color (record, &image->gradient.stops[i].color);
+	}
+    }
+
+    put (record, common->repeat);
+    put (record, common->filter);
+
+    put (record, common->n_filter_params);
+    for (i = 0; i < common->n_filter_params; ++i)
+	put (record, common->filter_params[i]);
+
+    put (record, common->transform != NULL);
+    if (common->transform)
+    {
+	for (i = 0; i < 9; ++i)
+	    put (record, common->transform->matrix[i / 3][i % 3]);
+    }
+
+    put (record, common->component_alpha);
+    put (record, common->clip_sources);
+
+    if (common->have_clip_region)
+    {
+	const pixman_box32_t *boxes;
+	int n_boxes;
+
+	boxes = pixman_region32_rectangles (&common->clip_region, &n_boxes);
+
+	put (record, n_boxes + 1);
+	for (i = 0; i < n_boxes; ++i)
+	    put_box (record, &boxes[i]);
+    }
+    else
+    {
+	put (record, 0);
+    }
+}
+
+static void
+record_write (record_t *record)
+{
+    if (record->words)
+    {
+	record->words[1] = record->n_words - 2;
+
+	trace_lock ();
+	if (trace_file)
+	    fwrite (record->words, sizeof (uint32_t), record->n_words, trace_file);
+	trace_unlock ();
+
+	if (record->words != record->stack_words)
+	    free (record->words);
+    }
+}
+
+void
+_pixman_trace_composite (pixman_op_t      op,
+			 pixman_image_t * src,
+			 pixman_image_t * mask,
+			 pixman_image_t * dest,
+			 int32_t          src_x,
+			 int32_t          src_y,
+			 int32_t          mask_x,
+			 int32_t          mask_y,
+			 int32_t          dest_x,
+			 int32_t          dest_y,
+			 int32_t          width,
+			 int32_t          height)
+{
+    record_t record;
+
+    record_init (&record, PIXMAN_TRACE_COMPOSITE);
+
+    put (&record, op);
+    put_image (&record, src);
+    put_image (&record, mask);
+    put_image (&record, dest);
+    put (&record, src_x);
+    put (&record, src_y);
+    put (&record, mask_x);
+    put (&record, mask_y);
+    put (&record, dest_x);
+    put (&record, dest_y);
+    put (&record, width);
+    put (&record, height);
+
+    record_write (&record);
+}
+
+void
+_pixman_trace_fill_boxes (pixman_op_t           op,
+			  pixman_image_t *      dest,
+			  const pixman_color_t *color,
+			  int                   n_boxes,
+			  const pixman_box32_t *boxes)
+{
+    record_t record;
+    int i;
+
+    record_init (&record, PIXMAN_TRACE_FILL_BOXES);
+
+    put (&record, op);
+    put_image (&record, dest);
+    put_color (&record, color);
+
+    put (&record, n_boxes);
+    for (i = 0; i < n_boxes; ++i)
+	put_box (&record, &boxes[i]);
+
+    record_write (&record);
+}
+
+void
+_pixman_trace_trapezoids (pixman_op_t               op,
+			  pixman_image_t *          src,
+			  pixman_image_t *          dst,
+			  pixman_format_code_t      mask_format,
+			  int                       x_src,
+			  int                       y_src,
+			  int                       x_dst,
+			  int                       y_dst,
+			  int                       n_traps,
+			  const pixman_trapezoid_t *traps)
+{
+    record_t record;
+    int i;
+
+    record_init (&record, PIXMAN_TRACE_TRAPEZOIDS);
+
+    put (&record, op);
+    put_image (&record, src);
+    put_image (&record, dst);
+    put (&record, mask_format);
+    put (&record, x_src);
+    put (&record, y_src);
+    put (&record, x_dst);
+    put (&record, y_dst);
+
+    put (&record, n_traps);
+    for (i = 0; i < n_traps; ++i)
+    {
+	const pixman_trapezoid_t *trap = &traps[i];
+
+	put (&record, trap->top);
+	put (&record, trap->bottom);
+	put (&record, trap->left.p1.x);
+	put (&record, trap->left.p1.y);
+	put (&record, trap->left.p2.x);
+	put (&record, trap->left.p2.y);
+	put (&record, trap->right.p1.x);
+	put (&record, trap->right.p1.y);
+	put (&record, trap->right.p2.x);
+	put (&record, trap->right.p2.y);
+    }
+
+    record_write (&record);
+}
+
+/* Glyph records have PIXMAN_null as the mask format when the glyphs
+ * were composited without a mask.
+ */
+void
+_pixman_trace_glyphs (pixman_op_t            op,
+		      pixman_image_t *       src,
+		      pixman_image_t *       dest,
+		      pixman_format_code_t   mask_format,
+		      int32_t                src_x,
+		      int32_t                src_y,
+		      int32_t                mask_x,
+		      int32_t                mask_y,
+		      int32_t                dest_x,
+		      int32_t                dest_y,
+		      int32_t                width,
+		      int32_t                height,
+		      int                    n_glyphs,
+		      const pixman_glyph_t * glyphs)
+{
+    record_t record;
+    int i;
+
+    record_init (&record, PIXMAN_TRACE_GLYPHS);
+
+    put (&record, op);
+    put_image (&record, src);
+    put_image (&record, dest);
+    put (&record, mask_format);
+    put (&record, src_x);
+    put (&record, src_y);
+    put (&record, mask_x);
+    put (&record, mask_y);
+    put (&record, dest_x);
+    put (&record, dest_y);
+    put (&record, width);
+    put (&record, height);
+
+    put (&record, n_glyphs);
+    for (i = 0; i < n_glyphs; ++i)
+    {
+	pixman_image_t *image;
+	int origin_x, origin_y;
+
+	image = _pixman_glyph_get_image (glyphs[i].glyph, &origin_x, &origin_y);
+
+	put (&record, glyphs[i].x);
+	put (&record, glyphs[i].y);
+	put (&record, origin_x);
+	put (&record, origin_y);
+	put (&record, image->bits.format);
+	put (&record, image->bits.width);
+	put (&record, image->bits.height);
+    }
+
+    record_write (&record);
+}
+
+static void
+close_trace (void)
+{
+    _pixman_trace_enabled = FALSE;
+
+    trace_lock ();
+    fclose (trace_file);
+    trace_file = NULL;
+    trace_unlock ();
+}
+
+void
+_pixman_trace_init (void)
+{
+    const char *filename;
+    uint32_t header[2];
+
+    if (!(filename = getenv ("PIXMAN_TRACE")))
+	return;
+
+    if (!(trace_file = fopen (filename, "wb")))
+    {
+	_pixman_log_error (FUNC, "Could not open the trace file\n");
+	return;
+    }
+
+    header[0] = PIXMAN_TRACE_MAGIC;
+    header[1] = PIXMAN_TRACE_VERSION;
+    fwrite (header, sizeof (uint32_t), 2, trace_file);
+
+    atexit (close_trace);
+
+    _pixman_trace_enabled = TRUE;
+}
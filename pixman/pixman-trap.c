@@ -247,6 +247,7 @@ pixman_add_traps (pixman_image_t *     image,
     pixman_fixed_t t, b;
 
     _pixman_image_validate (image);
+    pixman_image_mark_dirty (image);
     
     height = image->bits.height;
     bpp = PIXMAN_FORMAT_BPP (image->bits.format);
@@ -364,6 +365,8 @@ pixman_rasterize_trapezoid (pixman_image_t *          image,
     if (!pixman_trapezoid_valid (trap))
 	return;
 
+    pixman_image_mark_dirty (image);
+
     height = image->bits.height;
     bpp = PIXMAN_FORMAT_BPP (image->bits.format);
 
@@ -498,6 +501,12 @@ pixman_composite_trapezoids (pixman_op_t		op,
     if (n_traps <= 0)
 	return;
 
+    if (_pixman_trace_enabled)
+    {
+	_pixman_trace_trapezoids (op, src, dst, mask_format,
+				  x_src, y_src, x_dst, y_dst, n_traps, traps);
+    }
+
     _pixman_image_validate (src);
     _pixman_image_validate (dst);
 
@@ -525,8 +534,8 @@ pixman_composite_trapezoids (pixman_op_t		op,
 	if (!get_trap_extents (op, dst, traps, n_traps, &box))
 	    return;
 	
-	if (!(tmp = pixman_image_create_bits (
-		  mask_format, box.x2 - box.x1, box.y2 - box.y1, NULL, -1)))
+	if (!(tmp = _pixman_image_create_scratch_bits (
+		  mask_format, box.x2 - box.x1, box.y2 - box.y1)))
 	    return;
 	
 	for (i = 0; i < n_traps; ++i)
@@ -539,11 +548,11 @@ pixman_composite_trapezoids (pixman_op_t		op,
 	    pixman_rasterize_trapezoid (tmp, trap, - box.x1, - box.y1);
 	}
 	
-	pixman_image_composite (op, src, tmp, dst,
-				x_src + box.x1, y_src + box.y1,
-				0, 0,
-				x_dst + box.x1, y_dst + box.y1,
-				box.x2 - box.x1, box.y2 - box.y1);
+	_pixman_image_composite32 (op, src, tmp, dst,
+				   x_src + box.x1, y_src + box.y1,
+				   0, 0,
+				   x_dst + box.x1, y_dst + box.y1,
+				   box.x2 - box.x1, box.y2 - box.y1);
 	
 	pixman_image_unref (tmp);
     }
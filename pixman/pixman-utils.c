@@ -83,6 +83,229 @@ pixman_malloc_abc (unsigned int a,
 	return malloc (a * b * c);
 }
 
+/*
+ * Scratch memory
+ *
+ * Buffers that only live for the duration of a call are carved out of a
+ * per-thread arena. Each block has a header pointing to the previous
+ * block, so blocks can be freed in any order; the top of the arena
+ * moves back over freed blocks as soon as the block above them is
+ * freed.
+ *
+ * When a request does not fit, it is served by malloc() and the arena
+ * is grown to the size that was needed the next time it is empty. Every
+ * SCRATCH_TRIM_PERIOD times the arena becomes empty, it is freed if it
+ * is larger than SCRATCH_KEEP_SIZE and more than twice as large as what
+ * was used since the previous check.
+ */
+#define SCRATCH_ALIGN		16
+#define SCRATCH_MIN_SIZE	(64 * 1024)
+#define SCRATCH_KEEP_SIZE	(1024 * 1024)
+#define SCRATCH_TRIM_PERIOD	256
+#define SCRATCH_NONE		((size_t)-1)
+
+typedef union
+{
+    struct
+    {
+	size_t		prev;
+	pixman_bool_t	freed;
+    } b;
+    uint8_t		align[SCRATCH_ALIGN];
+} scratch_header_t;
+
+typedef struct
+{
+    uint8_t *	data;
+    size_t	size;
+    size_t	top;
+    size_t	last;	    /* Offset of the header of the top block */
+    size_t	peak;
+    int		n_empty;
+} scratch_arena_t;
+
+typedef struct
+{
+    scratch_arena_t *	arena;
+} scratch_t;
+
+PIXMAN_DEFINE_THREAD_LOCAL (scratch_t, scratch_state)
+
+#ifdef HAVE_PTHREADS
+#include <pthread.h>
+
+/* The thread local above may not have a destructor, so a key is used
+ * to free the arena when its thread exits.
+ */
+static pthread_once_t scratch_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t scratch_key;
+
+static void
+scratch_arena_destroy (void *arena)
+{
+    /* A composite made by a later destructor of the same thread then
+     * sets up a new arena instead of using this one.
+     */
+    PIXMAN_GET_THREAD_LOCAL (scratch_state)->arena = NULL;
+
+    free (((scratch_arena_t *)arena)->data);
+    free (arena);
+}
+
+static void
+scratch_make_key (void)
+{
+    pthread_key_create (&scratch_key, scratch_arena_destroy);
+}
+#endif
+
+static scratch_arena_t *
+get_scratch_arena (void)
+{
+    scratch_t *scratch = PIXMAN_GET_THREAD_LOCAL (scratch_state);
+
+    if (!scratch->arena)
+    {
+	scratch_arena_t *arena;
+
+	if (!(arena = calloc (1, sizeof (scratch_arena_t))))
+	    return NULL;
+
+	arena->last = SCRATCH_NONE;
+
+#ifdef HAVE_PTHREADS
+	pthread_once (&scratch_key_once, scratch_make_key);
+	pthread_setspecific (scratch_key, arena);
+#endif
+
+	scratch->arena = arena;
+    }
+
+    return scratch->arena;
+}
+
+void *
+_pixman_scratch_alloc (size_t size)
+{
+    scratch_arena_t *arena = get_scratch_arena ();
+    scratch_header_t *header;
+    size_t need;
+
+    if (size > SIZE_MAX / 2)
+	return NULL;
+
+    need = sizeof (scratch_header_t) +
+	((size + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1));
+
+    if (!arena)
+	return malloc (size);
+
+    if (arena->top + need > arena->peak)
+	arena->peak = arena->top + need;
+
+    if (arena->top + need > arena->size)
+    {
+	size_t new_size;
+
+	/* Blocks are still in use, so the arena cannot move */
+	if (arena->top != 0)
+	    return malloc (size);
+
+	new_size = arena->peak;
+	if (new_size < SCRATCH_MIN_SIZE)
+	    new_size = SCRATCH_MIN_SIZE;
+
+	free (arena->data);
+	arena->size = 0;
+
+	if (!(arena->data = malloc (new_size)))
+	    return malloc (size);
+
+	arena->size = new_size;
+    }
+
+    header = (scratch_header_t *)(arena->data + arena->top);
+    header->b.prev = arena->last;
+    header->b.freed = FALSE;
+
+    arena->last = arena->top;
+    arena->top += need;
+
+    return header + 1;
+}
+
+static void
+scratch_arena_trim (scratch_arena_t *arena)
+{
+    if (++arena->n_empty < SCRATCH_TRIM_PERIOD)
+	return;
+
+    if (arena->size > SCRATCH_KEEP_SIZE && arena->size > 2 * arena->peak)
+    {
+	free (arena->data);
+	arena->data = NULL;
+	arena->size = 0;
+    }
+
+    arena->peak = 0;
+    arena->n_empty = 0;
+}
+
+void
+_pixman_scratch_free (void *ptr)
+{
+    scratch_arena_t *arena;
+    scratch_header_t *header;
+
+    if (!ptr)
+	return;
+
+    arena = PIXMAN_GET_THREAD_LOCAL (scratch_state)->arena;
+
+    if (!arena					||
+	(uint8_t *)ptr < arena->data			||
+	(uint8_t *)ptr >= arena->data + arena->size)
+    {
+	free (ptr);
+	return;
+    }
+
+    header = (scratch_header_t *)ptr - 1;
+    header->b.freed = TRUE;
+
+    while (arena->last != SCRATCH_NONE)
+    {
+	header = (scratch_header_t *)(arena->data + arena->last);
+
+	if (!header->b.freed)
+	    break;
+
+	arena->top = arena->last;
+	arena->last = header->b.prev;
+    }
+
+    if (arena->top == 0)
+	scratch_arena_trim (arena);
+}
+
+PIXMAN_EXPORT void
+pixman_release_scratch_memory (void)
+{
+    scratch_t *scratch = PIXMAN_GET_THREAD_LOCAL (scratch_state);
+    scratch_arena_t *arena = scratch->arena;
+
+    if (arena && arena->top == 0)
+    {
+#ifdef HAVE_PTHREADS
+	pthread_setspecific (scratch_key, NULL);
+#endif
+	free (arena->data);
+	free (arena);
+
+	scratch->arena = NULL;
+    }
+}
+
 static force_inline uint16_t
 float_to_unorm (float f, int n_bits)
 {
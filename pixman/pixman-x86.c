@@ -27,7 +27,12 @@
 
 #include "pixman-private.h"
 
-#if defined(USE_X86_MMX) || defined (USE_SSE2) || defined (USE_SSSE3)
+#if defined (_MSC_VER)
+#include <intrin.h> /* for __cpuidex and _xgetbv */
+#endif
+
+#if defined(USE_X86_MMX) || defined (USE_SSE2) || defined (USE_SSSE3) || \
+    defined (USE_AVX2) || defined (USE_AVX512)
 
 /* The CPU detection code needs to be in a file not compiled with
  * "-mmmx -msse", as gcc would generate CMOV instructions otherwise
@@ -42,7 +47,9 @@ typedef enum
     X86_SSE			= (1 << 2) | X86_MMX_EXTENSIONS,
     X86_SSE2			= (1 << 3),
     X86_CMOV			= (1 << 4),
-    X86_SSSE3			= (1 << 5)
+    X86_SSSE3			= (1 << 5),
+    X86_AVX2			= (1 << 6),
+    X86_AVX512			= (1 << 7)
 } cpu_features_t;
 
 #ifdef HAVE_GETISAX
@@ -69,6 +76,19 @@ detect_cpu_features (void)
 	    features |= X86_SSE2;
 	if (result & AV_386_SSSE3)
 	    features |= X86_SSSE3;
+#ifdef AV_386_2_AVX2
+	if (getisax (&result, 2) == 2 && (result & AV_386_2_AVX2))
+	    features |= X86_AVX2;
+#endif
+#if defined (AV_386_2_AVX512F) && defined (AV_386_2_AVX512BW) && \
+    defined (AV_386_2_AVX512VL)
+	if (getisax (&result, 2) == 2 &&
+	    (result & AV_386_2_AVX512F) && (result & AV_386_2_AVX512BW) &&
+	    (result & AV_386_2_AVX512VL))
+	{
+	    features |= X86_AVX512;
+	}
+#endif
     }
 
     return features;
@@ -111,6 +131,9 @@ have_cpuid (void)
 #endif
 }
 
+/* The subleaf in %ecx is always 0, which is what leaf 7 needs and is
+ * ignored by the other leaves.
+ */
 static void
 pixman_cpuid (uint32_t feature,
 	      uint32_t *a, uint32_t *b, uint32_t *c, uint32_t *d)
@@ -121,7 +144,7 @@ pixman_cpuid (uint32_t feature,
     __asm__ volatile (
         "cpuid"				"\n\t"
 	: "=a" (*a), "=b" (*b), "=c" (*c), "=d" (*d)
-	: "a" (feature));
+	: "a" (feature), "c" (0));
 #else
     /* On x86-32 we need to be careful about the handling of %ebx
      * and %esp. We can't declare either one as clobbered
@@ -136,13 +159,13 @@ pixman_cpuid (uint32_t feature,
 	"cpuid"				"\n\t"
 	"xchg %%ebx, %1"		"\n\t"
 	: "=a" (*a), "=r" (*b), "=c" (*c), "=d" (*d)
-	: "a" (feature));
+	: "a" (feature), "c" (0));
 #endif
 
 #elif defined (_MSC_VER)
     int info[4];
 
-    __cpuid (info, feature);
+    __cpuidex (info, feature, 0);
 
     *a = info[0];
     *b = info[1];
@@ -153,15 +176,40 @@ pixman_cpuid (uint32_t feature,
 #endif
 }
 
+/* Returns the OS-enabled state components from XCR0. Only call this
+ * when CPUID reports OSXSAVE.
+ */
+static uint32_t
+pixman_xgetbv (void)
+{
+#if defined (__GNUC__)
+    uint32_t eax, edx;
+
+    __asm__ volatile (
+	".byte 0x0f, 0x01, 0xd0"	"\n\t" /* xgetbv */
+	: "=a" (eax), "=d" (edx)
+	: "c" (0));
+
+    return eax;
+#elif defined (_MSC_VER)
+    return (uint32_t)_xgetbv (0);
+#else
+#error Unknown compiler
+#endif
+}
+
 static cpu_features_t
 detect_cpu_features (void)
 {
     uint32_t a, b, c, d;
+    uint32_t max_leaf;
     cpu_features_t features = 0;
 
     if (!have_cpuid())
 	return features;
 
+    pixman_cpuid (0x00, &max_leaf, &b, &c, &d);
+
     /* Get feature bits */
     pixman_cpuid (0x01, &a, &b, &c, &d);
     if (d & (1 << 15))
@@ -175,6 +223,29 @@ detect_cpu_features (void)
     if (c & (1 << 9))
 	features |= X86_SSSE3;
 
+    /* AVX2 needs OSXSAVE (bit 27) and AVX (bit 28), and the OS must
+     * save the SSE and AVX register state on context switches.
+     */
+    if ((c & (1 << 27)) && (c & (1 << 28)) && max_leaf >= 7 &&
+	(pixman_xgetbv () & 0x6) == 0x6)
+    {
+	/* AVX-512 additionally needs the opmask and ZMM state (XCR0
+	 * bits 5-7) to be enabled.
+	 */
+	pixman_bool_t have_zmm_state = (pixman_xgetbv () & 0xe0) == 0xe0;
+
+	pixman_cpuid (0x07, &a, &b, &c, &d);
+	if (b & (1 << 5))
+	    features |= X86_AVX2;
+
+	/* AVX512F (bit 16), AVX512BW (bit 30) and AVX512VL (bit 31) */
+	if (have_zmm_state &&
+	    (b & (1 << 16)) && (b & (1 << 30)) && (b & (1u << 31)))
+	{
+	    features |= X86_AVX512;
+	}
+    }
+
     /* Check for AMD specific features */
     if ((features & X86_MMX) && !(features & X86_SSE))
     {
@@ -231,6 +302,8 @@ _pixman_x86_get_implementations (pixman_implementation_t *imp)
 #define MMX_BITS  (X86_MMX | X86_MMX_EXTENSIONS)
 #define SSE2_BITS (X86_MMX | X86_MMX_EXTENSIONS | X86_SSE | X86_SSE2)
 #define SSSE3_BITS (X86_SSE | X86_SSE2 | X86_SSSE3)
+#define AVX2_BITS (X86_SSE | X86_SSE2 | X86_SSSE3 | X86_AVX2)
+#define AVX512_BITS (AVX2_BITS | X86_AVX512)
 
 #ifdef USE_X86_MMX
     if (!_pixman_disabled ("mmx") && have_feature (MMX_BITS))
@@ -247,5 +320,15 @@ _pixman_x86_get_implementations (pixman_implementation_t *imp)
 	imp = _pixman_implementation_create_ssse3 (imp);
 #endif
 
+#ifdef USE_AVX2
+    if (!_pixman_disabled ("avx2") && have_feature (AVX2_BITS))
+	imp = _pixman_implementation_create_avx2 (imp);
+#endif
+
+#ifdef USE_AVX512
+    if (!_pixman_disabled ("avx512") && have_feature (AVX512_BITS))
+	imp = _pixman_implementation_create_avx512 (imp);
+#endif
+
     return imp;
 }
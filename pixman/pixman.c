@@ -544,108 +544,82 @@ analyze_extent (pixman_image_t       *image,
 }
 
 /*
- * Work around GCC bug causing crashes in Mozilla with SSE2
- *
- * When using -msse, gcc generates movdqa instructions assuming that
- * the stack is 16 byte aligned. Unfortunately some applications, such
- * as Mozilla and Mono, end up aligning the stack to 4 bytes, which
- * causes the movdqa instructions to fail.
- *
- * The __force_align_arg_pointer__ makes gcc generate a prologue that
- * realigns the stack pointer to 16 bytes.
- *
- * On x86-64 this is not necessary because the standard ABI already
- * calls for a 16 byte aligned stack.
- *
- * See https://bugs.freedesktop.org/show_bug.cgi?id=15693
+ * Computes the composite region and the formats and flags used to look
+ * up the composite function. The images must have been validated.
+ * Returns FALSE if there is nothing to composite.
  */
-#if defined (USE_SSE2) && defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
-__attribute__((__force_align_arg_pointer__))
-#endif
-PIXMAN_EXPORT void
-pixman_image_composite32 (pixman_op_t      op,
-                          pixman_image_t * src,
-                          pixman_image_t * mask,
-                          pixman_image_t * dest,
-                          int32_t          src_x,
-                          int32_t          src_y,
-                          int32_t          mask_x,
-                          int32_t          mask_y,
-                          int32_t          dest_x,
-                          int32_t          dest_y,
-                          int32_t          width,
-                          int32_t          height)
+static pixman_bool_t
+prepare_composite (pixman_image_t *        src,
+		   pixman_image_t *        mask,
+		   pixman_image_t *        dest,
+		   int32_t                 src_x,
+		   int32_t                 src_y,
+		   int32_t                 mask_x,
+		   int32_t                 mask_y,
+		   int32_t                 dest_x,
+		   int32_t                 dest_y,
+		   int32_t                 width,
+		   int32_t                 height,
+		   pixman_region32_t *     region,
+		   pixman_composite_info_t *info,
+		   pixman_format_code_t *  src_format,
+		   pixman_format_code_t *  mask_format)
 {
-    pixman_format_code_t src_format, mask_format, dest_format;
-    pixman_region32_t region;
     pixman_box32_t extents;
-    pixman_implementation_t *imp;
-    pixman_composite_func_t func;
-    pixman_composite_info_t info;
-    const pixman_box32_t *pbox;
-    int n;
-
-    _pixman_image_validate (src);
-    if (mask)
-	_pixman_image_validate (mask);
-    _pixman_image_validate (dest);
 
-    src_format = src->common.extended_format_code;
-    info.src_flags = src->common.flags;
+    *src_format = src->common.extended_format_code;
+    info->src_flags = src->common.flags;
 
     if (mask && !(mask->common.flags & FAST_PATH_IS_OPAQUE))
     {
-	mask_format = mask->common.extended_format_code;
-	info.mask_flags = mask->common.flags;
+	*mask_format = mask->common.extended_format_code;
+	info->mask_flags = mask->common.flags;
     }
     else
     {
-	mask_format = PIXMAN_null;
-	info.mask_flags = FAST_PATH_IS_OPAQUE | FAST_PATH_NO_ALPHA_MAP;
+	*mask_format = PIXMAN_null;
+	info->mask_flags = FAST_PATH_IS_OPAQUE | FAST_PATH_NO_ALPHA_MAP;
     }
 
-    dest_format = dest->common.extended_format_code;
-    info.dest_flags = dest->common.flags;
+    info->dest_flags = DEST_FLAGS (dest);
 
     /* Check for pixbufs */
-    if ((mask_format == PIXMAN_a8r8g8b8 || mask_format == PIXMAN_a8b8g8r8) &&
-	(src->type == BITS && src->bits.bits == mask->bits.bits)	   &&
-	(src->common.repeat == mask->common.repeat)			   &&
-	(info.src_flags & info.mask_flags & FAST_PATH_ID_TRANSFORM)	   &&
+    if ((*mask_format == PIXMAN_a8r8g8b8 || *mask_format == PIXMAN_a8b8g8r8) &&
+	(src->type == BITS && src->bits.bits == mask->bits.bits)	     &&
+	(src->common.repeat == mask->common.repeat)			     &&
+	(info->src_flags & info->mask_flags & FAST_PATH_ID_TRANSFORM)	     &&
 	(src_x == mask_x && src_y == mask_y))
     {
-	if (src_format == PIXMAN_x8b8g8r8)
-	    src_format = mask_format = PIXMAN_pixbuf;
-	else if (src_format == PIXMAN_x8r8g8b8)
-	    src_format = mask_format = PIXMAN_rpixbuf;
+	if (*src_format == PIXMAN_x8b8g8r8)
+	    *src_format = *mask_format = PIXMAN_pixbuf;
+	else if (*src_format == PIXMAN_x8r8g8b8)
+	    *src_format = *mask_format = PIXMAN_rpixbuf;
     }
 
-    pixman_region32_init (&region);
-
     if (!_pixman_compute_composite_region32 (
-	    &region, src, mask, dest,
+	    region, src, mask, dest,
 	    src_x, src_y, mask_x, mask_y, dest_x, dest_y, width, height))
     {
-	goto out;
+	return FALSE;
     }
 
-    extents = *pixman_region32_extents (&region);
+    extents = *pixman_region32_extents (region);
 
     extents.x1 -= dest_x - src_x;
     extents.y1 -= dest_y - src_y;
     extents.x2 -= dest_x - src_x;
     extents.y2 -= dest_y - src_y;
 
-    if (!analyze_extent (src, &extents, &info.src_flags))
-	goto out;
+    if (!analyze_extent (src, &extents, &info->src_flags))
+	return FALSE;
 
     extents.x1 -= src_x - mask_x;
     extents.y1 -= src_y - mask_y;
     extents.x2 -= src_x - mask_x;
     extents.y2 -= src_y - mask_y;
 
-    if (!analyze_extent (mask, &extents, &info.mask_flags))
-	goto out;
+    if (!analyze_extent (mask, &extents, &info->mask_flags))
+	return FALSE;
 
     /* If the clip is within the source samples, and the samples are
      * opaque, then the source is effectively opaque.
@@ -657,16 +631,160 @@ pixman_image_composite32 (pixman_op_t      op,
 			 FAST_PATH_BILINEAR_FILTER |			\
 			 FAST_PATH_SAMPLES_COVER_CLIP_BILINEAR)
 
-    if ((info.src_flags & NEAREST_OPAQUE) == NEAREST_OPAQUE ||
-	(info.src_flags & BILINEAR_OPAQUE) == BILINEAR_OPAQUE)
+    if ((info->src_flags & NEAREST_OPAQUE) == NEAREST_OPAQUE ||
+	(info->src_flags & BILINEAR_OPAQUE) == BILINEAR_OPAQUE)
+    {
+	info->src_flags |= FAST_PATH_IS_OPAQUE;
+    }
+
+    if ((info->mask_flags & NEAREST_OPAQUE) == NEAREST_OPAQUE ||
+	(info->mask_flags & BILINEAR_OPAQUE) == BILINEAR_OPAQUE)
+    {
+	info->mask_flags |= FAST_PATH_IS_OPAQUE;
+    }
+
+    info->src_image = src;
+    info->mask_image = mask;
+    info->dest_image = dest;
+
+    return TRUE;
+}
+
+static void
+update_gradient_lut (pixman_image_t *image)
+{
+    if (image->type == LINEAR ||
+	image->type == RADIAL ||
+	image->type == CONICAL)
+    {
+	_pixman_gradient_update_lut (&image->gradient);
+    }
+}
+
+/*
+ * Runs func on every box of the composite region.
+ */
+static void
+composite_boxes (pixman_implementation_t *imp,
+		 pixman_composite_func_t  func,
+		 pixman_composite_info_t *info,
+		 pixman_format_code_t     src_format,
+		 pixman_format_code_t     mask_format,
+		 pixman_region32_t *      region,
+		 int32_t                  src_dx,
+		 int32_t                  src_dy,
+		 int32_t                  mask_dx,
+		 int32_t                  mask_dy)
+{
+    const pixman_box32_t *pbox;
+    int n;
+
+    pbox = pixman_region32_rectangles (region, &n);
+
+    if (_pixman_statistics_enabled)
+    {
+	_pixman_statistics_record (imp, func, info,
+				   src_format, mask_format, pbox, n);
+    }
+
+    /* Mipmap levels are built here, before the work can be split
+     * between threads.
+     */
+    if (info->src_image->common.flags & FAST_PATH_MIPMAP)
+	_pixman_bits_image_update_mipmap (&info->src_image->bits);
+
+    if (info->mask_image &&
+	(info->mask_image->common.flags & FAST_PATH_MIPMAP))
+    {
+	_pixman_bits_image_update_mipmap (&info->mask_image->bits);
+    }
+
+    /* And so are the color ramps of gradients. Only narrow composites
+     * use them, and those always have one, so a gradient renders the
+     * same whatever was composited with it before.
+     */
+    if (info->dest_flags & FAST_PATH_NARROW_FORMAT)
+    {
+	update_gradient_lut (info->src_image);
+	if (info->mask_image)
+	    update_gradient_lut (info->mask_image);
+    }
+
+    if (!_pixman_composite_parallel (imp, func, info, pbox, n,
+				     src_dx, src_dy, mask_dx, mask_dy))
     {
-	info.src_flags |= FAST_PATH_IS_OPAQUE;
+	while (n--)
+	{
+	    info->src_x = pbox->x1 + src_dx;
+	    info->src_y = pbox->y1 + src_dy;
+	    info->mask_x = pbox->x1 + mask_dx;
+	    info->mask_y = pbox->y1 + mask_dy;
+	    info->dest_x = pbox->x1;
+	    info->dest_y = pbox->y1;
+	    info->width = pbox->x2 - pbox->x1;
+	    info->height = pbox->y2 - pbox->y1;
+
+	    func (imp, info);
+
+	    pbox++;
+	}
     }
 
-    if ((info.mask_flags & NEAREST_OPAQUE) == NEAREST_OPAQUE ||
-	(info.mask_flags & BILINEAR_OPAQUE) == BILINEAR_OPAQUE)
+    pixman_image_mark_dirty (info->dest_image);
+}
+
+/*
+ * Work around GCC bug causing crashes in Mozilla with SSE2
+ *
+ * When using -msse, gcc generates movdqa instructions assuming that
+ * the stack is 16 byte aligned. Unfortunately some applications, such
+ * as Mozilla and Mono, end up aligning the stack to 4 bytes, which
+ * causes the movdqa instructions to fail.
+ *
+ * The __force_align_arg_pointer__ makes gcc generate a prologue that
+ * realigns the stack pointer to 16 bytes.
+ *
+ * On x86-64 this is not necessary because the standard ABI already
+ * calls for a 16 byte aligned stack.
+ *
+ * See https://bugs.freedesktop.org/show_bug.cgi?id=15693
+ */
+#if defined (USE_SSE2) && defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+void
+_pixman_image_composite32 (pixman_op_t      op,
+                           pixman_image_t * src,
+                           pixman_image_t * mask,
+                           pixman_image_t * dest,
+                           int32_t          src_x,
+                           int32_t          src_y,
+                           int32_t          mask_x,
+                           int32_t          mask_y,
+                           int32_t          dest_x,
+                           int32_t          dest_y,
+                           int32_t          width,
+                           int32_t          height)
+{
+    pixman_format_code_t src_format, mask_format;
+    pixman_region32_t region;
+    pixman_implementation_t *imp;
+    pixman_composite_func_t func;
+    pixman_composite_info_t info;
+
+    _pixman_image_validate (src);
+    if (mask)
+	_pixman_image_validate (mask);
+    _pixman_image_validate (dest);
+
+    pixman_region32_init (&region);
+
+    if (!prepare_composite (src, mask, dest,
+			    src_x, src_y, mask_x, mask_y,
+			    dest_x, dest_y, width, height,
+			    &region, &info, &src_format, &mask_format))
     {
-	info.mask_flags |= FAST_PATH_IS_OPAQUE;
+	goto out;
     }
 
     /*
@@ -680,33 +798,428 @@ pixman_image_composite32 (pixman_op_t      op,
 	get_implementation (), info.op,
 	src_format, info.src_flags,
 	mask_format, info.mask_flags,
-	dest_format, info.dest_flags,
+	dest->common.extended_format_code, info.dest_flags,
 	&imp, &func);
 
-    info.src_image = src;
-    info.mask_image = mask;
-    info.dest_image = dest;
+    composite_boxes (imp, func, &info, src_format, mask_format, &region,
+		     src_x - dest_x, src_y - dest_y,
+		     mask_x - dest_x, mask_y - dest_y);
+
+out:
+    pixman_region32_fini (&region);
+}
+
+#if defined (USE_SSE2) && defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+PIXMAN_EXPORT void
+pixman_image_composite32 (pixman_op_t      op,
+                          pixman_image_t * src,
+                          pixman_image_t * mask,
+                          pixman_image_t * dest,
+                          int32_t          src_x,
+                          int32_t          src_y,
+                          int32_t          mask_x,
+                          int32_t          mask_y,
+                          int32_t          dest_x,
+                          int32_t          dest_y,
+                          int32_t          width,
+                          int32_t          height)
+{
+    if (_pixman_trace_enabled)
+    {
+	_pixman_trace_composite (op, src, mask, dest,
+				 src_x, src_y, mask_x, mask_y,
+				 dest_x, dest_y, width, height);
+    }
+
+    _pixman_image_composite32 (op, src, mask, dest,
+			       src_x, src_y, mask_x, mask_y,
+			       dest_x, dest_y, width, height);
+}
+
+/*
+ * Whether a batch item can be clipped with a single box and can take
+ * the flags of the previous item with the same images. That holds for
+ * untransformed bits images without clip regions or alpha maps, whose
+ * flags then only depend on whether their samples cover the box.
+ */
+static pixman_bool_t
+batch_image_is_simple (pixman_image_t *image)
+{
+    return
+	image->type == BITS						&&
+	(image->common.flags & FAST_PATH_ID_TRANSFORM) ==
+	FAST_PATH_ID_TRANSFORM						&&
+	!image->common.have_clip_region					&&
+	!image->common.alpha_map					&&
+	image->bits.width < 0x7fff					&&
+	image->bits.height < 0x7fff;
+}
+
+/* The same test as analyze_extent() makes for untransformed images */
+static pixman_bool_t
+batch_samples_cover (pixman_image_t       *image,
+		     const pixman_box32_t *box,
+		     int32_t               dx,
+		     int32_t               dy)
+{
+    return
+	box->x1 + dx >= 0			&&
+	box->y1 + dy >= 0			&&
+	box->x2 + dx <= image->bits.width	&&
+	box->y2 + dy <= image->bits.height;
+}
+
+#if defined (USE_SSE2) && defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+PIXMAN_EXPORT void
+pixman_composite_batch (pixman_op_t                    op,
+			pixman_image_t *               dest,
+			int                            n_items,
+			const pixman_composite_item_t *items)
+{
+    pixman_image_t *last_src = NULL, *last_mask = NULL;
+    pixman_format_code_t src_format = PIXMAN_null;
+    pixman_format_code_t mask_format = PIXMAN_null;
+    pixman_format_code_t last_src_format = PIXMAN_null;
+    pixman_format_code_t last_mask_format = PIXMAN_null;
+    uint32_t last_src_flags = 0, last_mask_flags = 0;
+    pixman_op_t last_op = PIXMAN_OP_NONE;
+    pixman_implementation_t *imp = NULL;
+    pixman_composite_func_t func = NULL;
+    pixman_composite_info_t info;
+    pixman_bool_t dest_is_simple, simple = FALSE, reusable = FALSE;
+    int i;
+
+    _pixman_image_validate (dest);
+
+    dest_is_simple =
+	!dest->common.have_clip_region && !dest->common.alpha_map;
+
+    for (i = 0; i < n_items; ++i)
+    {
+	const pixman_composite_item_t *item = &items[i];
+	int32_t src_dx = item->src_x - item->dest_x;
+	int32_t src_dy = item->src_y - item->dest_y;
+	int32_t mask_dx = item->mask_x - item->dest_x;
+	int32_t mask_dy = item->mask_y - item->dest_y;
+	pixman_region32_t region;
+	pixman_box32_t *box;
+
+	if (_pixman_trace_enabled)
+	{
+	    _pixman_trace_composite (op, item->src, item->mask, dest,
+				     item->src_x, item->src_y,
+				     item->mask_x, item->mask_y,
+				     item->dest_x, item->dest_y,
+				     item->width, item->height);
+	}
+
+	/* Validating an image that has not changed is a no-op, so only
+	 * do it when the image is different from the previous item's.
+	 */
+	if (item->src != last_src || item->mask != last_mask)
+	{
+	    if (item->src != last_src)
+		_pixman_image_validate (item->src);
+	    if (item->mask && item->mask != last_mask)
+		_pixman_image_validate (item->mask);
+
+	    last_src = item->src;
+	    last_mask = item->mask;
+
+	    /* A mask with the bits of the source may turn both into a
+	     * pixbuf format depending on the offsets, so it is left to
+	     * prepare_composite().
+	     */
+	    simple =
+		dest_is_simple					&&
+		batch_image_is_simple (item->src)		&&
+		(!item->mask					||
+		 (batch_image_is_simple (item->mask)		&&
+		  item->mask->bits.bits != item->src->bits.bits));
+	    reusable = FALSE;
+	}
+
+	if (simple)
+	{
+	    /* Without clip regions the composite region is the item's
+	     * rectangle clipped to the destination.
+	     */
+	    box = &region.extents;
+	    box->x1 = MAX (item->dest_x, 0);
+	    box->y1 = MAX (item->dest_y, 0);
+	    box->x2 = MIN (item->dest_x + item->width, dest->bits.width);
+	    box->y2 = MIN (item->dest_y + item->height, dest->bits.height);
+	    region.data = NULL;
+
+	    if (box->x1 >= box->x2 || box->y1 >= box->y2)
+		continue;
+
+	    /* An earlier item with the same images whose samples covered
+	     * its box got the same flags, operator and composite function
+	     * as this one will.
+	     */
+	    if (reusable						&&
+		batch_samples_cover (item->src, box, src_dx, src_dy)	&&
+		(!item->mask						||
+		 batch_samples_cover (item->mask, box, mask_dx, mask_dy)))
+	    {
+		composite_boxes (imp, func, &info, src_format, mask_format,
+				 &region, src_dx, src_dy, mask_dx, mask_dy);
+		continue;
+	    }
+	}
+
+	pixman_region32_init (&region);
+
+	if (prepare_composite (item->src, item->mask, dest,
+			       item->src_x, item->src_y,
+			       item->mask_x, item->mask_y,
+			       item->dest_x, item->dest_y,
+			       item->width, item->height,
+			       &region, &info, &src_format, &mask_format))
+	{
+	    info.op = optimize_operator (
+		op, info.src_flags, info.mask_flags, info.dest_flags);
+
+	    /* Consecutive items with the same signature share a lookup */
+	    if (!func				||
+		info.op != last_op		||
+		src_format != last_src_format	||
+		mask_format != last_mask_format	||
+		info.src_flags != last_src_flags	||
+		info.mask_flags != last_mask_flags)
+	    {
+		_pixman_implementation_lookup_composite (
+		    get_implementation (), info.op,
+		    src_format, info.src_flags,
+		    mask_format, info.mask_flags,
+		    dest->common.extended_format_code, info.dest_flags,
+		    &imp, &func);
+
+		last_op = info.op;
+		last_src_format = src_format;
+		last_mask_format = mask_format;
+		last_src_flags = info.src_flags;
+		last_mask_flags = info.mask_flags;
+	    }
+
+	    if (simple)
+	    {
+		box = pixman_region32_extents (&region);
+
+		reusable =
+		    batch_samples_cover (item->src, box, src_dx, src_dy) &&
+		    (!item->mask ||
+		     batch_samples_cover (item->mask, box, mask_dx, mask_dy));
+	    }
+
+	    composite_boxes (imp, func, &info, src_format, mask_format,
+			     &region, src_dx, src_dy, mask_dx, mask_dy);
+	}
+	else
+	{
+	    /* info may be left half prepared */
+	    reusable = FALSE;
+	}
+
+	pixman_region32_fini (&region);
+    }
+}
+
+struct pixman_composite_plan
+{
+    pixman_op_t			op;
+    pixman_image_t *		src;
+    pixman_image_t *		mask;
+    pixman_image_t *		dest;
+    int32_t			src_x;
+    int32_t			src_y;
+    int32_t			mask_x;
+    int32_t			mask_y;
+    int32_t			dest_x;
+    int32_t			dest_y;
+    int32_t			width;
+    int32_t			height;
+
+    /* Image generations the prepared state below was computed for.
+     * Changing an alpha map does not bump the generations of the images
+     * that use it, so those are kept too.
+     */
+    uint32_t			src_generation;
+    uint32_t			mask_generation;
+    uint32_t			dest_generation;
+    uint32_t			src_alpha_generation;
+    uint32_t			mask_alpha_generation;
+    uint32_t			dest_alpha_generation;
+
+    pixman_bool_t		empty;
+    pixman_region32_t		region;
+    pixman_composite_info_t	info;
+    pixman_format_code_t	src_format;
+    pixman_format_code_t	mask_format;
+    pixman_implementation_t *	imp;
+    pixman_composite_func_t	func;
+};
+
+static uint32_t
+alpha_map_generation (pixman_image_t *image)
+{
+    if (image && image->common.alpha_map)
+	return image->common.alpha_map->common.generation;
+
+    return 0;
+}
+
+static pixman_bool_t
+plan_is_stale (pixman_composite_plan_t *plan)
+{
+    pixman_image_t *mask = plan->mask;
+
+    return
+	plan->src->common.generation != plan->src_generation		||
+	(mask && mask->common.generation != plan->mask_generation)	||
+	plan->dest->common.generation != plan->dest_generation		||
+	alpha_map_generation (plan->src) != plan->src_alpha_generation	||
+	alpha_map_generation (mask) != plan->mask_alpha_generation	||
+	alpha_map_generation (plan->dest) != plan->dest_alpha_generation;
+}
+
+static void
+plan_prepare (pixman_composite_plan_t *plan)
+{
+    pixman_image_t *mask = plan->mask;
+
+    plan->src_generation = plan->src->common.generation;
+    plan->mask_generation = mask ? mask->common.generation : 0;
+    plan->dest_generation = plan->dest->common.generation;
+    plan->src_alpha_generation = alpha_map_generation (plan->src);
+    plan->mask_alpha_generation = alpha_map_generation (mask);
+    plan->dest_alpha_generation = alpha_map_generation (plan->dest);
+
+    pixman_region32_fini (&plan->region);
+    pixman_region32_init (&plan->region);
+
+    plan->empty = !prepare_composite (
+	plan->src, mask, plan->dest,
+	plan->src_x, plan->src_y, plan->mask_x, plan->mask_y,
+	plan->dest_x, plan->dest_y, plan->width, plan->height,
+	&plan->region, &plan->info, &plan->src_format, &plan->mask_format);
+
+    if (plan->empty)
+	return;
+
+    plan->info.op = optimize_operator (plan->op, plan->info.src_flags,
+				       plan->info.mask_flags,
+				       plan->info.dest_flags);
+
+    _pixman_implementation_lookup_composite (
+	get_implementation (), plan->info.op,
+	plan->src_format, plan->info.src_flags,
+	plan->mask_format, plan->info.mask_flags,
+	plan->dest->common.extended_format_code, plan->info.dest_flags,
+	&plan->imp, &plan->func);
+}
+
+PIXMAN_EXPORT pixman_composite_plan_t *
+pixman_composite_plan_create (pixman_op_t      op,
+			      pixman_image_t * src,
+			      pixman_image_t * mask,
+			      pixman_image_t * dest,
+			      int32_t          src_x,
+			      int32_t          src_y,
+			      int32_t          mask_x,
+			      int32_t          mask_y,
+			      int32_t          dest_x,
+			      int32_t          dest_y,
+			      int32_t          width,
+			      int32_t          height)
+{
+    pixman_composite_plan_t *plan;
+
+    if (!(plan = malloc (sizeof (pixman_composite_plan_t))))
+	return NULL;
+
+    plan->op = op;
+    plan->src = pixman_image_ref (src);
+    plan->mask = mask ? pixman_image_ref (mask) : NULL;
+    plan->dest = pixman_image_ref (dest);
+    plan->src_x = src_x;
+    plan->src_y = src_y;
+    plan->mask_x = mask_x;
+    plan->mask_y = mask_y;
+    plan->dest_x = dest_x;
+    plan->dest_y = dest_y;
+    plan->width = width;
+    plan->height = height;
+
+    pixman_region32_init (&plan->region);
+
+    _pixman_image_validate (src);
+    if (mask)
+	_pixman_image_validate (mask);
+    _pixman_image_validate (dest);
+
+    plan_prepare (plan);
 
-    pbox = pixman_region32_rectangles (&region, &n);
+    return plan;
+}
+
+#if defined (USE_SSE2) && defined(__GNUC__) && !defined(__x86_64__) && !defined(__amd64__)
+__attribute__((__force_align_arg_pointer__))
+#endif
+PIXMAN_EXPORT void
+pixman_composite_plan_execute (pixman_composite_plan_t *plan)
+{
+    pixman_image_t *mask = plan->mask;
+    pixman_composite_info_t info;
 
-    while (n--)
+    if (_pixman_trace_enabled)
     {
-	info.src_x = pbox->x1 + src_x - dest_x;
-	info.src_y = pbox->y1 + src_y - dest_y;
-	info.mask_x = pbox->x1 + mask_x - dest_x;
-	info.mask_y = pbox->y1 + mask_y - dest_y;
-	info.dest_x = pbox->x1;
-	info.dest_y = pbox->y1;
-	info.width = pbox->x2 - pbox->x1;
-	info.height = pbox->y2 - pbox->y1;
-
-	func (imp, &info);
-
-	pbox++;
+	_pixman_trace_composite (plan->op, plan->src, mask, plan->dest,
+				 plan->src_x, plan->src_y,
+				 plan->mask_x, plan->mask_y,
+				 plan->dest_x, plan->dest_y,
+				 plan->width, plan->height);
     }
 
-out:
-    pixman_region32_fini (&region);
+    /* Setting a property bumps the generation of the image, so
+     * validation only has work to do when the plan is stale.
+     */
+    _pixman_image_validate (plan->src);
+    if (mask)
+	_pixman_image_validate (mask);
+    _pixman_image_validate (plan->dest);
+
+    if (plan_is_stale (plan))
+	plan_prepare (plan);
+
+    if (plan->empty)
+	return;
+
+    /* composite_boxes() overwrites the coordinates in info */
+    info = plan->info;
+
+    composite_boxes (plan->imp, plan->func, &info,
+		     plan->src_format, plan->mask_format, &plan->region,
+		     plan->src_x - plan->dest_x, plan->src_y - plan->dest_y,
+		     plan->mask_x - plan->dest_x, plan->mask_y - plan->dest_y);
+}
+
+PIXMAN_EXPORT void
+pixman_composite_plan_destroy (pixman_composite_plan_t *plan)
+{
+    pixman_region32_fini (&plan->region);
+
+    pixman_image_unref (plan->src);
+    if (plan->mask)
+	pixman_image_unref (plan->mask);
+    pixman_image_unref (plan->dest);
+
+    free (plan);
 }
 
 PIXMAN_EXPORT void
@@ -885,7 +1398,11 @@ pixman_image_fill_boxes (pixman_op_t           op,
     pixman_color_t c;
     int i;
 
+    if (_pixman_trace_enabled)
+	_pixman_trace_fill_boxes (op, dest, color, n_boxes, boxes);
+
     _pixman_image_validate (dest);
+    pixman_image_mark_dirty (dest);
     
     if (color->alpha == 0xffff)
     {
@@ -948,10 +1465,10 @@ pixman_image_fill_boxes (pixman_op_t           op,
     {
         const pixman_box32_t *box = &(boxes[i]);
 
-        pixman_image_composite32 (op, solid, NULL, dest,
-                                  0, 0, 0, 0,
-                                  box->x1, box->y1,
-                                  box->x2 - box->x1, box->y2 - box->y1);
+        _pixman_image_composite32 (op, solid, NULL, dest,
+                                   0, 0, 0, 0,
+                                   box->x1, box->y1,
+                                   box->x2 - box->x1, box->y2 - box->y1);
     }
 
     pixman_image_unref (solid);
@@ -1073,6 +1590,8 @@ pixman_format_supported_source (pixman_format_code_t format)
     /* YUV formats */
     case PIXMAN_yuy2:
     case PIXMAN_yv12:
+    case PIXMAN_nv12:
+    case PIXMAN_i420:
 	return TRUE;
 
     default:
@@ -1089,13 +1608,13 @@ pixman_format_supported_source (pixman_format_code_t format)
  * rendering.
  *
  * Currently, all pixman_format_code_t values are supported
- * except for the YUV formats.
+ * except for the packed YUV format yuy2.
  **/
 PIXMAN_EXPORT pixman_bool_t
 pixman_format_supported_destination (pixman_format_code_t format)
 {
-    /* YUV formats cannot be written to at the moment */
-    if (format == PIXMAN_yuy2 || format == PIXMAN_yv12)
+    /* Packed YUV cannot be written to at the moment */
+    if (format == PIXMAN_yuy2)
 	return FALSE;
 
     return pixman_format_supported_source (format);
@@ -0,0 +1,144 @@
+/*
+ * Compares pixman_composite_batch() against a loop of
+ * pixman_image_composite32() calls for many small sprites.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include "utils.h"
+
+#define DEST_WIDTH	1024
+#define DEST_HEIGHT	768
+#define N_SPRITES	4096
+#define N_SOURCES	4
+#define TEST_REPEATS	5
+
+typedef struct
+{
+    const char *	name;
+    pixman_op_t		op;
+    pixman_format_code_t src_format;
+    pixman_format_code_t mask_format;
+} bench_t;
+
+static const bench_t benches[] =
+{
+    { "over_8888_8888",	PIXMAN_OP_OVER, PIXMAN_a8r8g8b8, PIXMAN_null },
+    { "src_8888_8888",	PIXMAN_OP_SRC,  PIXMAN_a8r8g8b8, PIXMAN_null },
+    { "over_8888_8_8888",	PIXMAN_OP_OVER, PIXMAN_a8r8g8b8, PIXMAN_a8 },
+    { "add_8_8",		PIXMAN_OP_ADD,  PIXMAN_a8,       PIXMAN_null },
+};
+
+static const int sizes[] = { 4, 8, 16, 32, 64 };
+
+static pixman_image_t *
+make_image (pixman_format_code_t format, int width, int height)
+{
+    int stride = ((width * PIXMAN_FORMAT_BPP (format) + 31) / 32) * 4;
+    uint32_t *bits = aligned_malloc (64, stride * height);
+
+    prng_randmemset (bits, stride * height, 0);
+
+    return pixman_image_create_bits (format, width, height, bits, stride);
+}
+
+static void
+free_image (pixman_image_t *image)
+{
+    free (pixman_image_get_data (image));
+    pixman_image_unref (image);
+}
+
+int
+main (int argc, char *argv[])
+{
+    pixman_composite_item_t *items;
+    pixman_image_t *dest;
+    pixman_image_t *srcs[N_SOURCES], *masks[N_SOURCES];
+    unsigned int b, s;
+    int i, r;
+
+    prng_srand (0);
+
+    items = malloc (N_SPRITES * sizeof (pixman_composite_item_t));
+
+    printf ("# %-18s %-6s %-14s %-14s %s\n",
+	    "operation", "size", "loop / Mops", "batch / Mops", "speedup");
+
+    for (b = 0; b < ARRAY_LENGTH (benches); ++b)
+    {
+	const bench_t *bench = &benches[b];
+
+	dest = make_image (bench->src_format == PIXMAN_a8 ?
+			   PIXMAN_a8 : PIXMAN_a8r8g8b8,
+			   DEST_WIDTH, DEST_HEIGHT);
+
+	for (i = 0; i < N_SOURCES; ++i)
+	{
+	    srcs[i] = make_image (bench->src_format, 64, 64);
+	    masks[i] = bench->mask_format == PIXMAN_null ? NULL :
+		make_image (bench->mask_format, 64, 64);
+	}
+
+	for (s = 0; s < ARRAY_LENGTH (sizes); ++s)
+	{
+	    double t_loop = 1e30, t_batch = 1e30, t;
+
+	    for (i = 0; i < N_SPRITES; ++i)
+	    {
+		int k = prng_rand_n (N_SOURCES);
+
+		items[i].src = srcs[k];
+		items[i].mask = masks[k];
+		items[i].src_x = prng_rand_n (64 - sizes[s] + 1);
+		items[i].src_y = prng_rand_n (64 - sizes[s] + 1);
+		items[i].mask_x = items[i].src_x;
+		items[i].mask_y = items[i].src_y;
+		items[i].dest_x = prng_rand_n (DEST_WIDTH - sizes[s] + 1);
+		items[i].dest_y = prng_rand_n (DEST_HEIGHT - sizes[s] + 1);
+		items[i].width = sizes[s];
+		items[i].height = sizes[s];
+	    }
+
+	    for (r = 0; r < TEST_REPEATS; ++r)
+	    {
+		t = gettime ();
+		for (i = 0; i < N_SPRITES; ++i)
+		{
+		    pixman_image_composite32 (
+			bench->op, items[i].src, items[i].mask, dest,
+			items[i].src_x, items[i].src_y,
+			items[i].mask_x, items[i].mask_y,
+			items[i].dest_x, items[i].dest_y,
+			items[i].width, items[i].height);
+		}
+		t = gettime () - t;
+		if (t < t_loop)
+		    t_loop = t;
+
+		t = gettime ();
+		pixman_composite_batch (bench->op, dest, N_SPRITES, items);
+		t = gettime () - t;
+		if (t < t_batch)
+		    t_batch = t;
+	    }
+
+	    printf ("  %-18s %-6d %-14.3f %-14.3f %.2fx\n",
+		    bench->name, sizes[s],
+		    N_SPRITES / t_loop / 1000000.,
+		    N_SPRITES / t_batch / 1000000.,
+		    t_loop / t_batch);
+	}
+
+	for (i = 0; i < N_SOURCES; ++i)
+	{
+	    free_image (srcs[i]);
+	    if (masks[i])
+		free_image (masks[i]);
+	}
+	free_image (dest);
+    }
+
+    free (items);
+
+    return 0;
+}
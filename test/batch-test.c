@@ -0,0 +1,175 @@
+/*
+ * Checks that pixman_composite_batch() gives the same result as calling
+ * pixman_image_composite32() for each item in turn.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_TESTS 2000
+#define MAX_ITEMS 40
+#define N_IMAGES 4
+
+static const pixman_op_t operators[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+    PIXMAN_OP_IN,
+    PIXMAN_OP_ATOP,
+    PIXMAN_OP_SCREEN,
+};
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static void
+free_bits (pixman_image_t *image, void *data)
+{
+    free (data);
+}
+
+static pixman_image_t *
+create_random_image (pixman_format_code_t format, int width, int height)
+{
+    int stride = ((width * PIXMAN_FORMAT_BPP (format) + 31) / 32) * 4;
+    uint32_t *bits = malloc (stride * height);
+    pixman_image_t *image;
+
+    prng_randmemset (bits, stride * height, 0);
+
+    image = pixman_image_create_bits (format, width, height, bits, stride);
+    pixman_image_set_destroy_function (image, free_bits, bits);
+
+    image_endian_swap (image);
+
+    return image;
+}
+
+static uint32_t
+test_batch (int testnum, pixman_bool_t batch)
+{
+    pixman_composite_item_t items[MAX_ITEMS];
+    pixman_image_t *srcs[N_IMAGES], *masks[N_IMAGES];
+    pixman_image_t *dest;
+    pixman_op_t op;
+    uint32_t crc32;
+    int n_items, i;
+
+    prng_srand (testnum);
+
+    dest = create_random_image (RANDOM_ELT (formats),
+				1 + prng_rand_n (100), 1 + prng_rand_n (100));
+
+    for (i = 0; i < N_IMAGES; ++i)
+    {
+	srcs[i] = create_random_image (RANDOM_ELT (formats),
+				       1 + prng_rand_n (40),
+				       1 + prng_rand_n (40));
+
+	if (prng_rand_n (2))
+	    pixman_image_set_repeat (srcs[i], PIXMAN_REPEAT_NORMAL);
+
+	/* Transformed sources take the full clipping path */
+	if (prng_rand_n (4) == 0)
+	{
+	    pixman_transform_t transform;
+
+	    pixman_transform_init_scale (&transform,
+					 pixman_fixed_1 / 2, pixman_fixed_1 / 2);
+	    pixman_image_set_transform (srcs[i], &transform);
+	}
+
+	masks[i] = NULL;
+	if (prng_rand_n (3) == 0)
+	    masks[i] = create_random_image (PIXMAN_a8, 40, 40);
+    }
+
+    if (prng_rand_n (4) == 0)
+    {
+	pixman_region32_t clip;
+
+	pixman_region32_init_rect (&clip, prng_rand_n (50), prng_rand_n (50),
+				   1 + prng_rand_n (50), 1 + prng_rand_n (50));
+	pixman_image_set_clip_region32 (dest, &clip);
+	pixman_region32_fini (&clip);
+    }
+
+    op = RANDOM_ELT (operators);
+    n_items = 1 + prng_rand_n (MAX_ITEMS);
+
+    for (i = 0; i < n_items; ++i)
+    {
+	/* Runs of the same images exercise the shared lookup */
+	int k = prng_rand_n (2) ? 0 : prng_rand_n (N_IMAGES);
+
+	items[i].src = srcs[k];
+	items[i].mask = masks[k];
+	items[i].src_x = prng_rand_n (40) - 10;
+	items[i].src_y = prng_rand_n (40) - 10;
+	items[i].mask_x = prng_rand_n (20);
+	items[i].mask_y = prng_rand_n (20);
+	items[i].dest_x = prng_rand_n (100) - 10;
+	items[i].dest_y = prng_rand_n (100) - 10;
+	items[i].width = prng_rand_n (40);
+	items[i].height = prng_rand_n (40);
+    }
+
+    if (batch)
+    {
+	pixman_composite_batch (op, dest, n_items, items);
+    }
+    else
+    {
+	for (i = 0; i < n_items; ++i)
+	{
+	    pixman_image_composite32 (op, items[i].src, items[i].mask, dest,
+				      items[i].src_x, items[i].src_y,
+				      items[i].mask_x, items[i].mask_y,
+				      items[i].dest_x, items[i].dest_y,
+				      items[i].width, items[i].height);
+	}
+    }
+
+    pixman_image_set_clip_region32 (dest, NULL);
+    crc32 = compute_crc32_for_image (0, dest);
+
+    for (i = 0; i < N_IMAGES; ++i)
+    {
+	pixman_image_unref (srcs[i]);
+	if (masks[i])
+	    pixman_image_unref (masks[i]);
+    }
+    pixman_image_unref (dest);
+
+    return crc32;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	uint32_t expected = test_batch (i, FALSE);
+	uint32_t crc32 = test_batch (i, TRUE);
+
+	if (crc32 != expected)
+	{
+	    printf ("batch-test: test %d failed: got 0x%08x, expected 0x%08x\n",
+		    i, crc32, expected);
+	    return 1;
+	}
+    }
+
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <float.h>
 #include "utils.h"
 #include <sys/types.h>
 #include "pixman-private.h"
@@ -88,6 +90,55 @@ random_floats (argb_t *argb, int width)
     }
 }
 
+static const pixman_op_t op_list_32[] =
+{
+    PIXMAN_OP_MULTIPLY,
+    PIXMAN_OP_SCREEN,
+    PIXMAN_OP_OVERLAY,
+    PIXMAN_OP_DARKEN,
+    PIXMAN_OP_LIGHTEN,
+    PIXMAN_OP_HARD_LIGHT,
+    PIXMAN_OP_DIFFERENCE,
+    PIXMAN_OP_EXCLUSION,
+};
+
+/* Random pixels, with transparent and opaque white ones mixed in since
+ * the mask handling has special cases for those.
+ */
+static void
+random_pixels (uint32_t *pixels, int width)
+{
+    int i;
+
+    for (i = 0; i < width; ++i)
+    {
+	switch (prng_rand_n (8))
+	{
+	case 0:
+	    pixels[i] = 0;
+	    break;
+
+	case 1:
+	    pixels[i] = 0xffffffff;
+	    break;
+
+	default:
+	    pixels[i] = prng_rand ();
+	    break;
+	}
+    }
+}
+
+/* The SIMD combiners round every intermediate result to single
+ * precision, so they can only be expected to match the C code bit for
+ * bit when the compiler does the same there.
+ */
+#if defined (FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+#define FLOAT_IS_EXACT FALSE
+#else
+#define FLOAT_IS_EXACT TRUE
+#endif
+
 #define WIDTH	512
 
 static pixman_combine_float_func_t
@@ -110,42 +161,156 @@ lookup_combiner (pixman_implementation_t *imp, pixman_op_t op,
     return f;
 }
 
+static pixman_combine_32_func_t
+lookup_combiner_32 (pixman_implementation_t *imp, pixman_op_t op,
+		    pixman_bool_t component_alpha)
+{
+    pixman_combine_32_func_t f;
+
+    do
+    {
+	if (component_alpha)
+	    f = imp->combine_32_ca[op];
+	else
+	    f = imp->combine_32[op];
+
+	imp = imp->fallback;
+    }
+    while (!f);
+
+    return f;
+}
+
+static pixman_bool_t
+floats_equal (const float *a, const float *b, int n)
+{
+    int i;
+
+    for (i = 0; i < n; ++i)
+    {
+	if (a[i] != a[i] && b[i] != b[i])
+	    continue;
+
+	if (memcmp (&a[i], &b[i], sizeof (float)) != 0)
+	    return FALSE;
+    }
+
+    return TRUE;
+}
+
 int
 main ()
 {
-    pixman_implementation_t *impl;
+    static const int widths[] = { WIDTH, 1, 3, 7, 13 };
+    pixman_implementation_t *impl, *general;
     argb_t *src_bytes = malloc (WIDTH * sizeof (argb_t));
     argb_t *mask_bytes = malloc (WIDTH * sizeof (argb_t));
     argb_t *dest_bytes = malloc (WIDTH * sizeof (argb_t));
-    int i;
+    argb_t *ref_bytes = malloc (WIDTH * sizeof (argb_t));
+    int i, j;
+    int result = 0;
 
     enable_divbyzero_exceptions();
     
     impl = _pixman_internal_only_get_implementation();
+
+    /* The general implementation has only the C combiners */
+    general = impl;
+    while (general->fallback)
+	general = general->fallback;
     
     prng_srand (0);
 
-    for (i = 0; i < ARRAY_LENGTH (op_list); ++i)
+    for (i = 0; FLOAT_IS_EXACT && i < ARRAY_LENGTH (op_list); ++i)
     {
 	pixman_op_t op = op_list[i];
-	pixman_combine_float_func_t combiner;
+	pixman_combine_float_func_t combiner, reference;
 	int ca;
 
 	for (ca = 0; ca < 2; ++ca)
 	{
 	    combiner = lookup_combiner (impl, op, ca);
+	    reference = lookup_combiner (general, op, ca);
 
-	    random_floats (src_bytes, WIDTH);
-	    random_floats (mask_bytes, WIDTH);
-	    random_floats (dest_bytes, WIDTH);
+	    for (j = 0; j < ARRAY_LENGTH (widths); ++j)
+	    {
+		int width = widths[j];
 
-	    combiner (impl, op,
-		      (float *)dest_bytes,
-		      (float *)mask_bytes,
-		      (float *)src_bytes,
-		      WIDTH);
+		random_floats (src_bytes, width);
+		random_floats (mask_bytes, width);
+		random_floats (dest_bytes, width);
+		memcpy (ref_bytes, dest_bytes, width * sizeof (argb_t));
+
+		combiner (impl, op,
+			  (float *)dest_bytes,
+			  (float *)mask_bytes,
+			  (float *)src_bytes,
+			  width);
+		reference (general, op,
+			   (float *)ref_bytes,
+			   (float *)mask_bytes,
+			   (float *)src_bytes,
+			   width);
+
+		if (!floats_equal ((float *)dest_bytes, (float *)ref_bytes,
+				   4 * width))
+		{
+		    printf ("%s %s combiner differs from the C version "
+			    "(width %d)\n", operator_name (op),
+			    ca ? "component alpha" : "unified", width);
+		    result = 1;
+		}
+	    }
 	}
     }	
 
-    return 0;
+    for (i = 0; i < ARRAY_LENGTH (op_list_32); ++i)
+    {
+	pixman_op_t op = op_list_32[i];
+	pixman_combine_32_func_t combiner, reference;
+	uint32_t *src = (uint32_t *)src_bytes;
+	uint32_t *mask = (uint32_t *)mask_bytes;
+	uint32_t *dest = (uint32_t *)dest_bytes;
+	uint32_t *ref = (uint32_t *)ref_bytes;
+	int ca;
+
+	for (ca = 0; ca < 2; ++ca)
+	{
+	    combiner = lookup_combiner_32 (impl, op, ca);
+	    reference = lookup_combiner_32 (general, op, ca);
+
+	    for (j = 0; j < 2 * ARRAY_LENGTH (widths); ++j)
+	    {
+		int width = widths[j / 2];
+		uint32_t *m = (j & 1) ? mask : NULL;
+
+		if (ca && !m)
+		    continue;
+
+		random_pixels (src, width);
+		random_pixels (mask, width);
+		random_pixels (dest, width);
+		memcpy (ref, dest, width * sizeof (uint32_t));
+
+		combiner (impl, op, dest, src, m, width);
+		reference (general, op, ref, src, m, width);
+
+		if (memcmp (dest, ref, width * sizeof (uint32_t)) != 0)
+		{
+		    printf ("%s %s 8-bit combiner differs from the C version "
+			    "(width %d%s)\n", operator_name (op),
+			    ca ? "component alpha" : "unified", width,
+			    m ? "" : ", no mask");
+		    result = 1;
+		}
+	    }
+	}
+    }
+
+    free (src_bytes);
+    free (mask_bytes);
+    free (dest_bytes);
+    free (ref_bytes);
+
+    return result;
 }
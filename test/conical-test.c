@@ -0,0 +1,150 @@
+/*
+ * Checks that conical gradients stay within one level of the exact
+ * angle of each pixel, whichever way atan2() is evaluated.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#define N_TESTS 400
+#define SIZE 128
+
+static const pixman_repeat_t repeats[] =
+{
+    PIXMAN_REPEAT_NONE,
+    PIXMAN_REPEAT_NORMAL,
+    PIXMAN_REPEAT_PAD,
+    PIXMAN_REPEAT_REFLECT,
+};
+
+/* A ramp from black to white, so that each channel is 255 times the
+ * position in the gradient
+ */
+static const pixman_gradient_stop_t stops[] =
+{
+    { 0x00000, { 0x0000, 0x0000, 0x0000, 0xffff } },
+    { 0x10000, { 0xffff, 0xffff, 0xffff, 0xffff } },
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static double
+exact_parameter (const pixman_transform_t *transform,
+		 pixman_point_fixed_t      center,
+		 double                    angle,
+		 int                       x,
+		 int                       y)
+{
+    pixman_vector_t v;
+    double t;
+
+    v.vector[0] = pixman_int_to_fixed (x) + pixman_fixed_1 / 2;
+    v.vector[1] = pixman_int_to_fixed (y) + pixman_fixed_1 / 2;
+    v.vector[2] = pixman_fixed_1;
+
+    pixman_transform_point_3d (transform, &v);
+
+    t = atan2 (pixman_fixed_to_double (v.vector[1] - center.y),
+	       pixman_fixed_to_double (v.vector[0] - center.x)) + angle;
+    t = fmod (t, 2 * M_PI);
+    if (t < 0)
+	t += 2 * M_PI;
+
+    return 1 - t / (2 * M_PI);
+}
+
+static pixman_bool_t
+test_conical (int testnum)
+{
+    pixman_transform_t transform;
+    pixman_point_fixed_t center;
+    pixman_fixed_t angle;
+    pixman_repeat_t repeat;
+    pixman_image_t *src, *dest;
+    uint32_t *bits;
+    pixman_bool_t ok = TRUE;
+    int x, y;
+
+    prng_srand (testnum);
+
+    center.x = pixman_int_to_fixed (prng_rand_n (2 * SIZE) - SIZE / 2) +
+	prng_rand_n (pixman_fixed_1);
+    center.y = pixman_int_to_fixed (prng_rand_n (2 * SIZE) - SIZE / 2) +
+	prng_rand_n (pixman_fixed_1);
+    angle = prng_rand_n (pixman_int_to_fixed (360));
+    repeat = RANDOM_ELT (repeats);
+
+    pixman_transform_init_identity (&transform);
+    if (prng_rand_n (2))
+    {
+	double a = prng_rand_n (360) * M_PI / 180;
+	double scale = 0.25 + prng_rand_n (16) / 4.0;
+
+	pixman_transform_rotate (&transform, NULL,
+				 pixman_double_to_fixed (cos (a)),
+				 pixman_double_to_fixed (sin (a)));
+	pixman_transform_scale (&transform, NULL,
+				pixman_double_to_fixed (scale),
+				pixman_double_to_fixed (scale));
+    }
+
+    src = pixman_image_create_conical_gradient (
+	&center, angle, stops, ARRAY_LENGTH (stops));
+    pixman_image_set_transform (src, &transform);
+    pixman_image_set_repeat (src, repeat);
+
+    dest = pixman_image_create_bits (PIXMAN_a8r8g8b8, SIZE, SIZE, NULL, 0);
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, dest,
+			      0, 0, 0, 0, 0, 0, SIZE, SIZE);
+
+    bits = pixman_image_get_data (dest);
+
+    for (y = 0; y < SIZE && ok; ++y)
+    {
+	for (x = 0; x < SIZE && ok; ++x)
+	{
+	    double t = exact_parameter (
+		&transform, center,
+		pixman_fixed_to_double (angle) / 180.0 * M_PI, x, y);
+	    uint32_t pixel = bits[y * SIZE + x];
+	    double d;
+
+	    /* Skip the seam, where the ramp jumps from white to black */
+	    if (t < 1e-4 || t > 1 - 1e-4)
+		continue;
+
+	    d = (pixel & 0xff) - 255 * t;
+
+	    if (fabs (d) > 1 ||
+		(pixel >> 24) != 0xff ||
+		((pixel >> 16) & 0xff) != (pixel & 0xff) ||
+		((pixel >> 8) & 0xff) != (pixel & 0xff))
+	    {
+		printf ("test %d: pixel (%d, %d) is 0x%08x, expected %f\n",
+			testnum, x, y, pixel, 255 * t);
+		ok = FALSE;
+	    }
+	}
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_conical (i))
+	    return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * Checks that composites to a dithered destination give the same
+ * results as the general path. The reference destination has an alpha
+ * map, which keeps it off the fast paths. Also checks that dithering a
+ * source image does not change the results, since only destinations are
+ * dithered.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_TESTS 2000
+#define MAX_WIDTH 100
+#define MAX_HEIGHT 8
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+};
+
+static const pixman_format_code_t src_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_a8b8g8r8,
+    PIXMAN_x8b8g8r8,
+};
+
+static const pixman_format_code_t dest_formats[] =
+{
+    PIXMAN_r5g6b5,
+    PIXMAN_b5g6r5,
+    PIXMAN_x1r5g5b5,
+    PIXMAN_x1b5g5r5,
+    PIXMAN_x4r4g4b4,
+    PIXMAN_x4b4g4r4,
+    PIXMAN_x2r10g10b10,
+    PIXMAN_x2b10g10r10,
+};
+
+static const pixman_dither_t dithers[] =
+{
+    PIXMAN_DITHER_FAST,
+    PIXMAN_DITHER_GOOD,
+    PIXMAN_DITHER_BEST,
+    PIXMAN_DITHER_ORDERED_BAYER_8,
+    PIXMAN_DITHER_ORDERED_BLUE_NOISE_64,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static uint32_t
+get_pixel (pixman_image_t *image, int x, int y)
+{
+    uint8_t *line = (uint8_t *)pixman_image_get_data (image) +
+	y * pixman_image_get_stride (image);
+
+    if (PIXMAN_FORMAT_BPP (image->bits.format) == 16)
+	return ((uint16_t *)line)[x];
+    else
+	return ((uint32_t *)line)[x];
+}
+
+static pixman_bool_t
+compare (int testnum, pixman_image_t *result, pixman_image_t *ref)
+{
+    int x, y;
+
+    for (y = 0; y < MAX_HEIGHT + 4; ++y)
+    {
+	for (x = 0; x < MAX_WIDTH + 4; ++x)
+	{
+	    uint32_t r = get_pixel (result, x, y);
+	    uint32_t e = get_pixel (ref, x, y);
+
+	    if (r != e)
+	    {
+		printf ("test %d: pixel (%d, %d) is 0x%08x, expected 0x%08x\n",
+			testnum, x, y, r, e);
+		return FALSE;
+	    }
+	}
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+test_dither (int testnum)
+{
+    pixman_image_t *src, *result, *ref, *alpha;
+    pixman_format_code_t src_format, dest_format;
+    pixman_dither_t dither;
+    pixman_op_t op;
+    uint32_t *src_bits, *result_bits, *ref_bits;
+    int width, height, stride, src_x, dest_x, dest_y;
+    int off_x, off_y;
+    pixman_bool_t ok;
+
+    prng_srand (testnum);
+
+    op = RANDOM_ELT (ops);
+    src_format = RANDOM_ELT (src_formats);
+    dest_format = RANDOM_ELT (dest_formats);
+    dither = RANDOM_ELT (dithers);
+    width = 1 + prng_rand_n (MAX_WIDTH);
+    height = 1 + prng_rand_n (MAX_HEIGHT);
+    src_x = prng_rand_n (4);
+    dest_x = prng_rand_n (4);
+    dest_y = prng_rand_n (4);
+    off_x = prng_rand_n (128) - 64;
+    off_y = prng_rand_n (128) - 64;
+
+    stride = (MAX_WIDTH + 4) * 4;
+
+    src_bits = aligned_malloc (64, stride * MAX_HEIGHT);
+    result_bits = aligned_malloc (64, stride * (MAX_HEIGHT + 4));
+    ref_bits = aligned_malloc (64, stride * (MAX_HEIGHT + 4));
+
+    prng_randmemset (src_bits, stride * MAX_HEIGHT, 0);
+    prng_randmemset (result_bits, stride * (MAX_HEIGHT + 4), 0);
+    memcpy (ref_bits, result_bits, stride * (MAX_HEIGHT + 4));
+
+    src = pixman_image_create_bits (
+	src_format, MAX_WIDTH + 4, MAX_HEIGHT, src_bits, stride);
+    result = pixman_image_create_bits (
+	dest_format, MAX_WIDTH + 4, MAX_HEIGHT + 4, result_bits, stride);
+    ref = pixman_image_create_bits (
+	dest_format, MAX_WIDTH + 4, MAX_HEIGHT + 4, ref_bits, stride);
+    alpha = pixman_image_create_bits (
+	PIXMAN_a8, MAX_WIDTH + 4, MAX_HEIGHT + 4, NULL, 0);
+
+    pixman_image_set_dither (result, dither);
+    pixman_image_set_dither_offset (result, off_x, off_y);
+    pixman_image_set_dither (ref, dither);
+    pixman_image_set_dither_offset (ref, off_x, off_y);
+    pixman_image_set_alpha_map (ref, alpha, 0, 0);
+
+    pixman_image_composite32 (op, src, NULL, result,
+			      src_x, 0, 0, 0, dest_x, dest_y, width, height);
+    pixman_image_composite32 (op, src, NULL, ref,
+			      src_x, 0, 0, 0, dest_x, dest_y, width, height);
+
+    ok = compare (testnum, result, ref);
+
+    if (!ok)
+    {
+	printf ("op %s, src %s, dest %s, dither %d, %dx%d\n",
+		operator_name (op), format_name (src_format),
+		format_name (dest_format), dither, width, height);
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (result);
+    pixman_image_unref (ref);
+    pixman_image_unref (alpha);
+
+    free (src_bits);
+    free (result_bits);
+    free (ref_bits);
+
+    return ok;
+}
+
+static pixman_bool_t
+test_dithered_source (int testnum)
+{
+    pixman_image_t *src, *dithered, *result, *ref;
+    pixman_format_code_t src_format, dest_format;
+    pixman_dither_t dither;
+    pixman_op_t op;
+    uint32_t *src_bits, *result_bits, *ref_bits;
+    int width, height, stride;
+    pixman_bool_t ok;
+
+    prng_srand (testnum);
+
+    op = RANDOM_ELT (ops);
+    src_format = RANDOM_ELT (src_formats);
+    dest_format = RANDOM_ELT (dest_formats);
+    dither = RANDOM_ELT (dithers);
+    width = 1 + prng_rand_n (MAX_WIDTH);
+    height = 1 + prng_rand_n (MAX_HEIGHT);
+
+    stride = (MAX_WIDTH + 4) * 4;
+
+    src_bits = aligned_malloc (64, stride * MAX_HEIGHT);
+    result_bits = aligned_malloc (64, stride * (MAX_HEIGHT + 4));
+    ref_bits = aligned_malloc (64, stride * (MAX_HEIGHT + 4));
+
+    prng_randmemset (src_bits, stride * MAX_HEIGHT, 0);
+    prng_randmemset (result_bits, stride * (MAX_HEIGHT + 4), 0);
+    memcpy (ref_bits, result_bits, stride * (MAX_HEIGHT + 4));
+
+    src = pixman_image_create_bits (
+	src_format, MAX_WIDTH + 4, MAX_HEIGHT, src_bits, stride);
+    dithered = pixman_image_create_bits (
+	src_format, MAX_WIDTH + 4, MAX_HEIGHT, src_bits, stride);
+    result = pixman_image_create_bits (
+	dest_format, MAX_WIDTH + 4, MAX_HEIGHT + 4, result_bits, stride);
+    ref = pixman_image_create_bits (
+	dest_format, MAX_WIDTH + 4, MAX_HEIGHT + 4, ref_bits, stride);
+
+    pixman_image_set_dither (dithered, dither);
+
+    pixman_image_composite32 (op, dithered, NULL, result,
+			      0, 0, 0, 0, 2, 2, width, height);
+    pixman_image_composite32 (op, src, NULL, ref,
+			      0, 0, 0, 0, 2, 2, width, height);
+
+    ok = compare (testnum, result, ref);
+
+    if (!ok)
+    {
+	printf ("dithered source: op %s, src %s, dest %s, dither %d, %dx%d\n",
+		operator_name (op), format_name (src_format),
+		format_name (dest_format), dither, width, height);
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (dithered);
+    pixman_image_unref (result);
+    pixman_image_unref (ref);
+
+    free (src_bits);
+    free (result_bits);
+    free (ref_bits);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_dither (i) || !test_dithered_source (i))
+	    return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,322 @@
+/*
+ * Checks that gradients fetched through their color ramp stay within
+ * one level of the gradient walker, and within two when dithered.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#define N_TESTS 2000
+#define SIZE 64
+
+static const pixman_repeat_t repeats[] =
+{
+    PIXMAN_REPEAT_NONE,
+    PIXMAN_REPEAT_NORMAL,
+    PIXMAN_REPEAT_PAD,
+    PIXMAN_REPEAT_REFLECT,
+};
+
+static const pixman_dither_t dithers[] =
+{
+    PIXMAN_DITHER_NONE,
+    PIXMAN_DITHER_ORDERED_BAYER_8,
+    PIXMAN_DITHER_ORDERED_BLUE_NOISE_64,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+typedef struct
+{
+    int				type;
+    pixman_point_fixed_t	p1, p2;
+    pixman_fixed_t		r1, r2;
+    pixman_fixed_t		angle;
+    pixman_gradient_stop_t	stops[5];
+    int				n_stops;
+    pixman_transform_t		transform;
+    pixman_repeat_t		repeat;
+} gradient_params_t;
+
+static pixman_fixed_t
+random_coord (void)
+{
+    return pixman_int_to_fixed (prng_rand_n (3 * SIZE) - SIZE) +
+	prng_rand_n (pixman_fixed_1);
+}
+
+/* The stops are at least 1/8 apart, so that the ramp is fine enough */
+static void
+random_stops (gradient_params_t *params)
+{
+    int i, pos = -1;
+
+    params->n_stops = 2 + prng_rand_n (4);
+
+    for (i = 0; i < params->n_stops; ++i)
+    {
+	int last = 8 - (params->n_stops - 1 - i);
+
+	pos += 1 + prng_rand_n (last - pos);
+
+	params->stops[i].x = pos * (pixman_fixed_1 / 8);
+	params->stops[i].color.alpha = prng_rand_n (0x10000);
+	params->stops[i].color.red = prng_rand_n (0x10000);
+	params->stops[i].color.green = prng_rand_n (0x10000);
+	params->stops[i].color.blue = prng_rand_n (0x10000);
+    }
+}
+
+static void
+random_params (gradient_params_t *params)
+{
+    double angle = prng_rand_n (360) * 3.14159265 / 180;
+    double scale = 0.25 + prng_rand_n (16) / 4.0;
+
+    params->type = prng_rand_n (3);
+    params->p1.x = random_coord ();
+    params->p1.y = random_coord ();
+    params->p2.x = random_coord ();
+    params->p2.y = random_coord ();
+    params->r1 = prng_rand_n (pixman_int_to_fixed (SIZE / 2));
+    params->r2 = prng_rand_n (pixman_int_to_fixed (SIZE));
+    params->angle = prng_rand_n (pixman_int_to_fixed (360));
+    params->repeat = RANDOM_ELT (repeats);
+
+    random_stops (params);
+
+    pixman_transform_init_identity (&params->transform);
+    if (prng_rand_n (2))
+    {
+	pixman_transform_rotate (&params->transform, NULL,
+				 pixman_double_to_fixed (cos (angle)),
+				 pixman_double_to_fixed (sin (angle)));
+	pixman_transform_scale (&params->transform, NULL,
+				pixman_double_to_fixed (scale),
+				pixman_double_to_fixed (scale));
+    }
+}
+
+static pixman_image_t *
+create_gradient (const gradient_params_t *params)
+{
+    pixman_image_t *image;
+
+    switch (params->type)
+    {
+    case 0:
+	image = pixman_image_create_linear_gradient (
+	    &params->p1, &params->p2, params->stops, params->n_stops);
+	break;
+
+    case 1:
+	image = pixman_image_create_radial_gradient (
+	    &params->p1, &params->p2, params->r1, params->r2,
+	    params->stops, params->n_stops);
+	break;
+
+    default:
+	image = pixman_image_create_conical_gradient (
+	    &params->p1, params->angle, params->stops, params->n_stops);
+	break;
+    }
+
+    pixman_image_set_transform (image, &params->transform);
+    pixman_image_set_repeat (image, params->repeat);
+
+    return image;
+}
+
+/* The reference is fetched as floating point, which never uses the
+ * ramp, and with the whole transform scaled. That keeps the mapping
+ * but makes it projective, which the SIMD fetchers do not handle, so
+ * the reference comes from the gradient walker.
+ */
+static void
+set_walker_transform (pixman_image_t           *image,
+		      const pixman_transform_t *transform)
+{
+    pixman_transform_t t = *transform;
+    int i, j;
+
+    for (i = 0; i < 3; ++i)
+    {
+	for (j = 0; j < 3; ++j)
+	    t.matrix[i][j] *= 2;
+    }
+
+    pixman_image_set_transform (image, &t);
+}
+
+/* The float format is r, g, b, a */
+static pixman_bool_t
+compare (int testnum, pixman_image_t *result, pixman_image_t *ref,
+	 int tolerance)
+{
+    static const int shifts[4] = { 16, 8, 0, 24 };
+    uint32_t *r = pixman_image_get_data (result);
+    float *e = (float *)pixman_image_get_data (ref);
+    int i, j;
+
+    for (i = 0; i < SIZE * SIZE; ++i)
+    {
+	for (j = 0; j < 4; ++j)
+	{
+	    int c = (r[i] >> shifts[j]) & 0xff;
+
+	    if (fabs (c - e[4 * i + j] * 255) > tolerance)
+	    {
+		printf ("test %d: pixel (%d, %d) is 0x%08x, expected "
+			"%f %f %f %f\n", testnum, i % SIZE, i / SIZE, r[i],
+			e[4 * i + 3], e[4 * i + 0], e[4 * i + 1], e[4 * i + 2]);
+		return FALSE;
+	    }
+	}
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+test_gradient (int testnum)
+{
+    gradient_params_t params;
+    pixman_dither_t dither;
+    pixman_image_t *src, *ref_src, *result, *ref;
+    pixman_bool_t ok, wide;
+
+    prng_srand (testnum);
+
+    random_params (&params);
+    dither = RANDOM_ELT (dithers);
+    wide = dither != PIXMAN_DITHER_NONE && prng_rand_n (2);
+
+    result = pixman_image_create_bits (PIXMAN_a8r8g8b8, SIZE, SIZE, NULL, 0);
+    ref = pixman_image_create_bits (PIXMAN_rgba_float, SIZE, SIZE, NULL, 0);
+
+    ref_src = create_gradient (&params);
+    set_walker_transform (ref_src, &params.transform);
+    pixman_image_composite32 (PIXMAN_OP_SRC, ref_src, NULL, ref,
+			      0, 0, 0, 0, 0, 0, SIZE, SIZE);
+
+    /* Dithering the destination makes the gradient go through the
+     * floating point path instead.
+     */
+    src = create_gradient (&params);
+    if (wide)
+    {
+	pixman_image_set_dither (result, dither);
+    }
+    else
+    {
+	pixman_image_set_dither (src, dither);
+	pixman_image_set_dither_offset (src, prng_rand_n (64), prng_rand_n (64));
+    }
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, result,
+			      0, 0, 0, 0, 0, 0, SIZE, SIZE);
+
+    ok = compare (testnum, result, ref, dither == PIXMAN_DITHER_NONE ? 1 : 2);
+
+    if (!ok)
+    {
+	printf ("type %d, repeat %d, dither %d%s, %d stops\n",
+		params.type, params.repeat, dither, wide ? " (wide)" : "",
+		params.n_stops);
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (ref_src);
+    pixman_image_unref (result);
+    pixman_image_unref (ref);
+
+    return ok;
+}
+
+/* The SIMD fetchers clamp positions before looking them up, which is
+ * wrong for PAD and NONE when the stops are outside of [0, 1]. This
+ * checks such a gradient on the wide path.
+ */
+static pixman_bool_t
+test_stops_outside (void)
+{
+    static const pixman_gradient_stop_t stops[] =
+    {
+	{ -pixman_fixed_1 / 2, { 0xffff, 0x0000, 0x0000, 0xffff } },
+	{ pixman_fixed_1 * 3 / 2, { 0x0000, 0x0000, 0xffff, 0xffff } },
+    };
+    pixman_point_fixed_t p1 = { 0, 0 };
+    pixman_point_fixed_t p2 = { pixman_int_to_fixed (400), pixman_fixed_1 };
+    pixman_transform_t transform;
+    pixman_image_t *src, *ref_src, *result, *ref;
+    uint32_t *r;
+    float *e;
+    int i, j;
+
+    src = pixman_image_create_linear_gradient (&p1, &p2, stops, 2);
+    ref_src = pixman_image_create_linear_gradient (&p1, &p2, stops, 2);
+    pixman_image_set_repeat (src, PIXMAN_REPEAT_PAD);
+    pixman_image_set_repeat (ref_src, PIXMAN_REPEAT_PAD);
+
+    pixman_transform_init_identity (&transform);
+    set_walker_transform (ref_src, &transform);
+
+    result = pixman_image_create_bits (PIXMAN_a2r10g10b10, 800, 4, NULL, 0);
+    ref = pixman_image_create_bits (PIXMAN_rgba_float, 800, 4, NULL, 0);
+
+    /* More than one row, or the scanline is fetched once through the
+     * walker.
+     */
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, result,
+			      -200, 0, 0, 0, 0, 0, 800, 4);
+    pixman_image_composite32 (PIXMAN_OP_SRC, ref_src, NULL, ref,
+			      -200, 0, 0, 0, 0, 0, 800, 4);
+
+    r = pixman_image_get_data (result);
+    e = (float *)pixman_image_get_data (ref);
+
+    for (i = 0; i < 800 * 4; ++i)
+    {
+	/* The float format is r, g, b, a */
+	for (j = 0; j < 3; ++j)
+	{
+	    int c = (r[i] >> (20 - 10 * j)) & 0x3ff;
+
+	    if (fabs (c - e[4 * i + j] * 1023) > 2)
+	    {
+		printf ("stops outside: pixel (%d, %d) is 0x%08x, expected "
+			"%f %f %f\n", i % 800, i / 800, r[i],
+			e[4 * i + 0], e[4 * i + 1], e[4 * i + 2]);
+		break;
+	    }
+	}
+
+	if (j < 3)
+	    break;
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (ref_src);
+    pixman_image_unref (result);
+    pixman_image_unref (ref);
+
+    return i == 800 * 4;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    if (!test_stops_outside ())
+	return 1;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_gradient (i))
+	    return 1;
+    }
+
+    return 0;
+}
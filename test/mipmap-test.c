@@ -0,0 +1,394 @@
+/*
+ * Checks that a mipmapped image gives the same result as sampling
+ * mipmap levels built here, and that the levels are rebuilt after the
+ * bits of the image change.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define N_TESTS 1000
+#define DEST_SIZE 48
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static void
+free_bits (pixman_image_t *image, void *data)
+{
+    free (data);
+}
+
+static pixman_image_t *
+create_image (pixman_format_code_t format, int width, int height)
+{
+    int stride = ((width * PIXMAN_FORMAT_BPP (format) + 31) / 32) * 4;
+    uint32_t *bits = malloc (stride * height);
+    pixman_image_t *image;
+
+    memset (bits, 0, stride * height);
+
+    image = pixman_image_create_bits (format, width, height, bits, stride);
+    pixman_image_set_destroy_function (image, free_bits, bits);
+
+    return image;
+}
+
+static void
+randomize_image (pixman_image_t *image)
+{
+    prng_randmemset (pixman_image_get_data (image),
+		     pixman_image_get_stride (image) *
+		     pixman_image_get_height (image), 0);
+}
+
+static pixman_image_t *
+copy_image (pixman_image_t *image)
+{
+    pixman_image_t *copy = create_image (
+	pixman_image_get_format (image),
+	pixman_image_get_width (image), pixman_image_get_height (image));
+
+    memcpy (pixman_image_get_data (copy), pixman_image_get_data (image),
+	    pixman_image_get_stride (image) * pixman_image_get_height (image));
+
+    return copy;
+}
+
+/* Halves an a8r8g8b8 image, averaging 2x2 pixels, or 3 rows or columns
+ * at the end of odd sized images.
+ */
+static pixman_image_t *
+reduce (pixman_image_t *src)
+{
+    int src_width = pixman_image_get_width (src);
+    int src_height = pixman_image_get_height (src);
+    int src_stride = pixman_image_get_stride (src) / 4;
+    uint32_t *s = pixman_image_get_data (src);
+    int width = src_width > 1 ? src_width / 2 : 1;
+    int height = src_height > 1 ? src_height / 2 : 1;
+    pixman_image_t *dest = create_image (PIXMAN_a8r8g8b8, width, height);
+    uint32_t *d = pixman_image_get_data (dest);
+    int x, y, i, j, c;
+
+    for (y = 0; y < height; ++y)
+    {
+	int n_rows = (y == height - 1) ? src_height - 2 * y : 2;
+
+	for (x = 0; x < width; ++x)
+	{
+	    int n_cols = (x == width - 1) ? src_width - 2 * x : 2;
+	    int n = n_rows * n_cols;
+	    uint32_t pixel = 0;
+
+	    for (c = 0; c < 32; c += 8)
+	    {
+		uint32_t sum = 0;
+
+		for (j = 0; j < n_rows; ++j)
+		{
+		    for (i = 0; i < n_cols; ++i)
+			sum += (s[(2 * y + j) * src_stride + 2 * x + i] >> c) & 0xff;
+		}
+
+		pixel |= ((sum + n / 2) / n) << c;
+	    }
+
+	    d[y * width + x] = pixel;
+	}
+    }
+
+    return dest;
+}
+
+/* Samples level 'level' of src with the given transform and repeat, by
+ * compositing the level built by reduce().
+ */
+static void
+composite_level (pixman_image_t     *src,
+		 pixman_transform_t *src_transform,
+		 pixman_repeat_t     repeat,
+		 int                 level,
+		 pixman_image_t     *dest)
+{
+    pixman_image_t *plain, *image;
+    pixman_transform_t scale, transform;
+    int width = pixman_image_get_width (src);
+    int height = pixman_image_get_height (src);
+
+    /* Level 0 is the untransformed src, converted to a8r8g8b8 */
+    plain = pixman_image_create_bits (
+	pixman_image_get_format (src), width, height,
+	pixman_image_get_data (src), pixman_image_get_stride (src));
+    image = create_image (PIXMAN_a8r8g8b8, width, height);
+    pixman_image_composite32 (PIXMAN_OP_SRC, plain, NULL, image,
+			      0, 0, 0, 0, 0, 0, width, height);
+    pixman_image_unref (plain);
+
+    while (level--)
+    {
+	pixman_image_t *next = reduce (image);
+
+	pixman_image_unref (image);
+	image = next;
+    }
+
+    pixman_transform_init_scale (
+	&scale,
+	pixman_double_to_fixed (
+	    (double)pixman_image_get_width (image) / width),
+	pixman_double_to_fixed (
+	    (double)pixman_image_get_height (image) / height));
+    pixman_transform_multiply (&transform, &scale, src_transform);
+
+    pixman_image_set_transform (image, &transform);
+    pixman_image_set_filter (image, PIXMAN_FILTER_BILINEAR, NULL, 0);
+    pixman_image_set_repeat (image, repeat);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, image, NULL, dest,
+			      0, 0, 0, 0, 0, 0, DEST_SIZE, DEST_SIZE);
+
+    pixman_image_unref (image);
+}
+
+/* The level whose reduction is below two, and the reduction left */
+static int
+compute_level (pixman_image_t *src, pixman_transform_t *transform, double *rho)
+{
+    pixman_fixed_t (*t)[3] = transform->matrix;
+    int width = pixman_image_get_width (src);
+    int height = pixman_image_get_height (src);
+    double dx, dy;
+    int level = 0;
+
+    dx = pixman_fixed_to_double (t[0][0]) * pixman_fixed_to_double (t[0][0]) +
+	 pixman_fixed_to_double (t[1][0]) * pixman_fixed_to_double (t[1][0]);
+    dy = pixman_fixed_to_double (t[0][1]) * pixman_fixed_to_double (t[0][1]) +
+	 pixman_fixed_to_double (t[1][1]) * pixman_fixed_to_double (t[1][1]);
+
+    *rho = sqrt (dx > dy ? dx : dy);
+
+    while (*rho >= 2.0 && (width > 1 || height > 1))
+    {
+	width = width > 1 ? width / 2 : 1;
+	height = height > 1 ? height / 2 : 1;
+	*rho /= 2.0;
+	level++;
+    }
+
+    if (width == 1 && height == 1)
+	*rho = 1.0;
+
+    return level;
+}
+
+static pixman_bool_t
+within (uint32_t pixel, uint32_t a, uint32_t b)
+{
+    int c;
+
+    for (c = 0; c < 32; c += 8)
+    {
+	int p = (pixel >> c) & 0xff;
+	int lo = (a >> c) & 0xff;
+	int hi = (b >> c) & 0xff;
+
+	if (lo > hi)
+	{
+	    int tmp = lo;
+	    lo = hi;
+	    hi = tmp;
+	}
+
+	if (p < lo - 1 || p > hi + 1)
+	    return FALSE;
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+compare (int testnum, const char *what,
+	 pixman_image_t *result, pixman_image_t *lo, pixman_image_t *hi)
+{
+    uint32_t *r = pixman_image_get_data (result);
+    uint32_t *a = pixman_image_get_data (lo);
+    uint32_t *b = hi ? pixman_image_get_data (hi) : NULL;
+    int i;
+
+    for (i = 0; i < DEST_SIZE * DEST_SIZE; ++i)
+    {
+	if ((hi && !within (r[i], a[i], b[i])) || (!hi && r[i] != a[i]))
+	{
+	    printf ("test %d (%s): pixel (%d, %d) is 0x%08x, expected 0x%08x",
+		    testnum, what, i % DEST_SIZE, i / DEST_SIZE, r[i], a[i]);
+	    if (hi)
+		printf (" to 0x%08x", b[i]);
+	    printf ("\n");
+	    return FALSE;
+	}
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+test_mipmap (int testnum)
+{
+    pixman_format_code_t format = RANDOM_ELT (formats);
+    int width = 1 + prng_rand_n (300);
+    int height = 1 + prng_rand_n (300);
+    pixman_mipmap_t mode = 1 + prng_rand_n (2);
+    pixman_repeat_t repeat = prng_rand_n (4);
+    pixman_transform_t transform;
+    pixman_image_t *src, *copy, *result, *ref, *next;
+    pixman_bool_t ok = TRUE;
+    double sx, sy, rho;
+    int level;
+
+    src = create_image (format, width, height);
+    randomize_image (src);
+
+    /* Powers of two make some levels untransformed */
+    if (prng_rand_n (4) == 0)
+	sx = 1 << prng_rand_n (6);
+    else
+	sx = 1.0 + prng_rand_n (4000) / 100.0;
+    sy = prng_rand_n (2) ? sx : 1.0 + prng_rand_n (4000) / 100.0;
+
+    pixman_transform_init_scale (&transform,
+				 pixman_double_to_fixed (sx),
+				 pixman_double_to_fixed (sy));
+    if (prng_rand_n (3) == 0)
+    {
+	pixman_transform_rotate (NULL, &transform,
+				 pixman_double_to_fixed (0.6),
+				 pixman_double_to_fixed (0.8));
+    }
+    pixman_transform_translate (NULL, &transform,
+				prng_rand_n (0x400000) - 0x200000,
+				prng_rand_n (0x400000) - 0x200000);
+
+    pixman_image_set_transform (src, &transform);
+    pixman_image_set_repeat (src, repeat);
+    pixman_image_set_filter (src, prng_rand_n (2) ?
+			     PIXMAN_FILTER_BILINEAR : PIXMAN_FILTER_GOOD,
+			     NULL, 0);
+    pixman_image_set_mipmap (src, mode);
+
+    result = create_image (PIXMAN_a8r8g8b8, DEST_SIZE, DEST_SIZE);
+    ref = create_image (PIXMAN_a8r8g8b8, DEST_SIZE, DEST_SIZE);
+    next = create_image (PIXMAN_a8r8g8b8, DEST_SIZE, DEST_SIZE);
+
+    level = compute_level (src, &transform, &rho);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, result,
+			      0, 0, 0, 0, 0, 0, DEST_SIZE, DEST_SIZE);
+
+    composite_level (src, &transform, repeat, level, ref);
+
+    if (mode == PIXMAN_MIPMAP_BILINEAR || rho == 1.0)
+    {
+	ok = compare (testnum, "levels", result, ref, NULL);
+    }
+    else
+    {
+	composite_level (src, &transform, repeat, level + 1, next);
+	ok = compare (testnum, "trilinear", result, ref, next);
+    }
+
+    /* Bits changed behind pixman's back */
+    if (ok)
+    {
+	randomize_image (src);
+	pixman_image_mark_dirty (src);
+
+	copy = copy_image (src);
+	pixman_image_set_transform (copy, &transform);
+	pixman_image_set_repeat (copy, repeat);
+	pixman_image_set_filter (copy, PIXMAN_FILTER_BILINEAR, NULL, 0);
+	pixman_image_set_mipmap (copy, mode);
+
+	pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, result,
+				  0, 0, 0, 0, 0, 0, DEST_SIZE, DEST_SIZE);
+	pixman_image_composite32 (PIXMAN_OP_SRC, copy, NULL, ref,
+				  0, 0, 0, 0, 0, 0, DEST_SIZE, DEST_SIZE);
+
+	ok = compare (testnum, "marked dirty", result, ref, NULL);
+
+	pixman_image_unref (copy);
+    }
+
+    /* Bits changed by compositing into the image */
+    if (ok)
+    {
+	pixman_image_t *solid;
+	pixman_color_t color;
+
+	color.red = prng_rand_n (0x10000);
+	color.green = prng_rand_n (0x10000);
+	color.blue = prng_rand_n (0x10000);
+	color.alpha = prng_rand_n (0x10000);
+	solid = pixman_image_create_solid_fill (&color);
+
+	pixman_image_composite32 (PIXMAN_OP_OVER, solid, NULL, src,
+				  0, 0, 0, 0,
+				  prng_rand_n (width), prng_rand_n (height),
+				  width, height);
+	pixman_image_unref (solid);
+
+	copy = copy_image (src);
+	pixman_image_set_transform (copy, &transform);
+	pixman_image_set_repeat (copy, repeat);
+	pixman_image_set_filter (copy, PIXMAN_FILTER_BILINEAR, NULL, 0);
+	pixman_image_set_mipmap (copy, mode);
+
+	pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, result,
+				  0, 0, 0, 0, 0, 0, DEST_SIZE, DEST_SIZE);
+	pixman_image_composite32 (PIXMAN_OP_SRC, copy, NULL, ref,
+				  0, 0, 0, 0, 0, 0, DEST_SIZE, DEST_SIZE);
+
+	ok = compare (testnum, "composited into", result, ref, NULL);
+
+	pixman_image_unref (copy);
+    }
+
+    if (!ok)
+    {
+	printf ("format %s, %d x %d, scale %g x %g, mode %d, level %d\n",
+		format_name (format), width, height, sx, sy, mode, level);
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (result);
+    pixman_image_unref (ref);
+    pixman_image_unref (next);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    prng_srand (0);
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_mipmap (i))
+	    return 1;
+    }
+
+    return 0;
+}
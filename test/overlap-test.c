@@ -0,0 +1,121 @@
+/*
+ * Checks composites whose source is a view of the destination memory,
+ * shifted along the rows. As long as a source row only overlaps the
+ * destination row it is composited to, the result must be the same as
+ * with a copy of the source. The operators take the general path, in
+ * narrow and in wide mode, with rows long enough to be split if the
+ * general path ever composited them in pieces. The format is fetched
+ * and written through scanline buffers, not accessed in place.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_TESTS 400
+#define MAX_WIDTH 1500
+#define MAX_HEIGHT 4
+#define MAX_SHIFT 16
+
+static const pixman_op_t operators[] =
+{
+    PIXMAN_OP_HARD_LIGHT,
+    PIXMAN_OP_COLOR_DODGE,
+    PIXMAN_OP_DISJOINT_OVER,
+    PIXMAN_OP_CONJOINT_ATOP,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static pixman_bool_t
+test_overlap (int testnum)
+{
+    pixman_image_t *src, *dest, *ref_src, *ref_dest, *mask = NULL;
+    uint32_t *bits, *ref_bits, *copy, *mask_bits = NULL;
+    int width, height, stride, mask_stride, shift, src_offset, dest_offset;
+    pixman_op_t op;
+    pixman_bool_t ok;
+
+    prng_srand (testnum);
+
+    op = RANDOM_ELT (operators);
+    width = 1 + prng_rand_n (MAX_WIDTH);
+    height = 1 + prng_rand_n (MAX_HEIGHT);
+    shift = 1 + prng_rand_n (MAX_SHIFT);
+    stride = width + MAX_SHIFT;
+
+    /* The source is either to the right or to the left of the
+     * destination in the same rows.
+     */
+    src_offset = prng_rand_n (2) ? shift : 0;
+    dest_offset = shift - src_offset;
+
+    bits = aligned_malloc (64, stride * height * 4);
+    ref_bits = aligned_malloc (64, stride * height * 4);
+    copy = aligned_malloc (64, stride * height * 4);
+
+    prng_randmemset (bits, stride * height * 4, 0);
+    memcpy (ref_bits, bits, stride * height * 4);
+    memcpy (copy, bits, stride * height * 4);
+
+    src = pixman_image_create_bits (
+	PIXMAN_a8b8g8r8, width, height, bits + src_offset, stride * 4);
+    dest = pixman_image_create_bits (
+	PIXMAN_a8b8g8r8, width, height, bits + dest_offset, stride * 4);
+    ref_src = pixman_image_create_bits (
+	PIXMAN_a8b8g8r8, width, height, copy + src_offset, stride * 4);
+    ref_dest = pixman_image_create_bits (
+	PIXMAN_a8b8g8r8, width, height, ref_bits + dest_offset, stride * 4);
+
+    if (prng_rand_n (2))
+    {
+	mask_stride = (width + 3) & ~3;
+	mask_bits = aligned_malloc (64, mask_stride * height);
+	prng_randmemset (mask_bits, mask_stride * height, 0);
+	mask = pixman_image_create_bits (
+	    PIXMAN_a8, width, height, mask_bits, mask_stride);
+    }
+
+    pixman_image_composite32 (op, src, mask, dest,
+			      0, 0, 0, 0, 0, 0, width, height);
+    pixman_image_composite32 (op, ref_src, mask, ref_dest,
+			      0, 0, 0, 0, 0, 0, width, height);
+
+    ok = memcmp (bits, ref_bits, stride * height * 4) == 0;
+
+    if (!ok)
+    {
+	printf ("test %d failed: op %s, %dx%d, shift %d%s%s\n", testnum,
+		operator_name (op), width, height, shift,
+		src_offset ? ", source on the right" : "",
+		mask ? ", with mask" : "");
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+    pixman_image_unref (ref_src);
+    pixman_image_unref (ref_dest);
+    if (mask)
+	pixman_image_unref (mask);
+
+    free (bits);
+    free (ref_bits);
+    free (copy);
+    free (mask_bits);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_overlap (i))
+	    return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * Checks that compositing through a thread pool gives exactly the same
+ * result as compositing serially.
+ *
+ * Each test case is composited three times: without a pool, with an
+ * application pool that runs the bands in reverse order, and with the
+ * built-in pool when pixman has thread support. Some sources overlap
+ * the destination, which has to keep them serial.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_TESTS 400
+#define MAX_SIZE 320
+
+static const pixman_op_t operators[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+    PIXMAN_OP_IN,
+    PIXMAN_OP_OUT_REVERSE,
+    PIXMAN_OP_ATOP,
+    PIXMAN_OP_XOR,
+    PIXMAN_OP_MULTIPLY,
+    PIXMAN_OP_DARKEN,
+};
+
+static const pixman_format_code_t src_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+static const pixman_format_code_t dest_formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+    PIXMAN_a1,
+};
+
+static const pixman_filter_t filters[] =
+{
+    PIXMAN_FILTER_NEAREST,
+    PIXMAN_FILTER_BILINEAR,
+};
+
+static const pixman_repeat_t repeats[] =
+{
+    PIXMAN_REPEAT_NONE,
+    PIXMAN_REPEAT_NORMAL,
+    PIXMAN_REPEAT_PAD,
+    PIXMAN_REPEAT_REFLECT,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static void
+free_bits (pixman_image_t *image, void *data)
+{
+    free (data);
+}
+
+static pixman_image_t *
+create_random_image (pixman_format_code_t format, int width, int height)
+{
+    int stride = ((width * PIXMAN_FORMAT_BPP (format) + 31) / 32) * 4;
+    uint32_t *bits = malloc (stride * height);
+    pixman_image_t *image;
+
+    prng_randmemset (bits, stride * height, 0);
+
+    image = pixman_image_create_bits (format, width, height, bits, stride);
+    pixman_image_set_destroy_function (image, free_bits, bits);
+
+    image_endian_swap (image);
+
+    return image;
+}
+
+static uint32_t
+test_composite (int testnum)
+{
+    pixman_image_t *src, *mask = NULL, *dest;
+    int dest_width, dest_height;
+    int src_x, src_y, mask_x, mask_y, dest_x, dest_y, w, h;
+    pixman_op_t op;
+    uint32_t crc32;
+
+    prng_srand (testnum);
+
+    dest_width = 128 + prng_rand_n (MAX_SIZE - 128);
+    dest_height = 128 + prng_rand_n (MAX_SIZE - 128);
+
+    dest = create_random_image (RANDOM_ELT (dest_formats),
+				dest_width, dest_height);
+    src = create_random_image (RANDOM_ELT (src_formats),
+			       1 + prng_rand_n (MAX_SIZE),
+			       1 + prng_rand_n (MAX_SIZE));
+
+    /* The source is the destination itself, or a view of its memory
+     * one row further down, which has other bits.
+     */
+    switch (prng_rand_n (8))
+    {
+    case 0:
+	pixman_image_unref (src);
+	src = pixman_image_ref (dest);
+	break;
+
+    case 1:
+	pixman_image_unref (src);
+	src = pixman_image_create_bits (
+	    pixman_image_get_format (dest), dest_width, dest_height - 1,
+	    (uint32_t *)((uint8_t *)pixman_image_get_data (dest) +
+			 pixman_image_get_stride (dest)),
+	    pixman_image_get_stride (dest));
+	break;
+    }
+
+    pixman_image_set_repeat (src, RANDOM_ELT (repeats));
+
+    if (prng_rand_n (3) == 0)
+    {
+	pixman_transform_t transform;
+	pixman_fixed_t sx = pixman_double_to_fixed (0.25 + prng_rand_n (400) / 100.0);
+	pixman_fixed_t sy = pixman_double_to_fixed (0.25 + prng_rand_n (400) / 100.0);
+
+	pixman_transform_init_scale (&transform, sx, sy);
+	pixman_image_set_transform (src, &transform);
+	pixman_image_set_filter (src, RANDOM_ELT (filters), NULL, 0);
+    }
+
+    if (prng_rand_n (2))
+    {
+	mask = create_random_image (PIXMAN_a8, dest_width, dest_height);
+
+	if (prng_rand_n (4) == 0)
+	{
+	    pixman_image_unref (mask);
+	    mask = create_random_image (PIXMAN_a8r8g8b8,
+					dest_width, dest_height);
+	    pixman_image_set_component_alpha (mask, TRUE);
+	}
+    }
+
+    if (prng_rand_n (3) == 0)
+    {
+	pixman_region32_t clip;
+	pixman_box32_t boxes[3];
+	int i;
+
+	for (i = 0; i < 3; ++i)
+	{
+	    boxes[i].x1 = prng_rand_n (dest_width);
+	    boxes[i].y1 = prng_rand_n (dest_height);
+	    boxes[i].x2 = boxes[i].x1 + 1 + prng_rand_n (dest_width);
+	    boxes[i].y2 = boxes[i].y1 + 1 + prng_rand_n (dest_height);
+	}
+
+	pixman_region32_init_rects (&clip, boxes, 3);
+	pixman_image_set_clip_region32 (dest, &clip);
+	pixman_region32_fini (&clip);
+    }
+
+    op = RANDOM_ELT (operators);
+    src_x = prng_rand_n (64) - 32;
+    src_y = prng_rand_n (64) - 32;
+    mask_x = prng_rand_n (16);
+    mask_y = prng_rand_n (16);
+    dest_x = prng_rand_n (32);
+    dest_y = prng_rand_n (32);
+    w = dest_width / 2 + prng_rand_n (dest_width);
+    h = dest_height / 2 + prng_rand_n (dest_height);
+
+    pixman_image_composite32 (op, src, mask, dest,
+			      src_x, src_y, mask_x, mask_y,
+			      dest_x, dest_y, w, h);
+
+    pixman_image_set_clip_region32 (dest, NULL);
+    crc32 = compute_crc32_for_image (0, dest);
+
+    pixman_image_unref (src);
+    if (mask)
+	pixman_image_unref (mask);
+    pixman_image_unref (dest);
+
+    return crc32;
+}
+
+static void
+reverse_pool_run (void                   *pool_data,
+		  pixman_parallel_task_t  task,
+		  void                   *task_data,
+		  int                     n_tasks)
+{
+    int *n_runs = pool_data;
+
+    while (n_tasks--)
+	task (task_data, n_tasks);
+
+    (*n_runs)++;
+}
+
+static int
+check_against (const uint32_t *expected, const char *pool_name)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	uint32_t crc32 = test_composite (i);
+
+	if (crc32 != expected[i])
+	{
+	    printf ("%s pool: test %d failed: got 0x%08x, expected 0x%08x\n",
+		    pool_name, i, crc32, expected[i]);
+	    return 1;
+	}
+    }
+
+    return 0;
+}
+
+int
+main (int argc, char **argv)
+{
+    uint32_t expected[N_TESTS];
+    int n_runs = 0;
+    int result = 0;
+    int i;
+
+    pixman_set_thread_pool (NULL, NULL, 1);
+
+    for (i = 0; i < N_TESTS; ++i)
+	expected[i] = test_composite (i);
+
+    pixman_set_thread_pool (reverse_pool_run, &n_runs, 3);
+    result |= check_against (expected, "application");
+
+    if (n_runs == 0)
+    {
+	printf ("application pool was never used\n");
+	result = 1;
+    }
+
+    if (pixman_set_threads (4))
+	result |= check_against (expected, "built-in");
+    else
+	printf ("built-in pool not available, skipping\n");
+
+    pixman_set_threads (1);
+
+    return result;
+}
@@ -0,0 +1,229 @@
+/*
+ * Checks that executing a composite plan gives the same result as
+ * calling pixman_image_composite32(), also when properties of the
+ * images or of the alpha map of the destination change between
+ * executions.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_TESTS 2000
+#define N_ROUNDS 4
+
+static const pixman_op_t operators[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+    PIXMAN_OP_IN,
+    PIXMAN_OP_ATOP,
+    PIXMAN_OP_SCREEN,
+};
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static void
+free_bits (pixman_image_t *image, void *data)
+{
+    free (data);
+}
+
+static pixman_image_t *
+create_random_image (pixman_format_code_t format, int width, int height)
+{
+    int stride = ((width * PIXMAN_FORMAT_BPP (format) + 31) / 32) * 4;
+    uint32_t *bits = malloc (stride * height);
+    pixman_image_t *image;
+
+    prng_randmemset (bits, stride * height, 0);
+
+    image = pixman_image_create_bits (format, width, height, bits, stride);
+    pixman_image_set_destroy_function (image, free_bits, bits);
+
+    image_endian_swap (image);
+
+    return image;
+}
+
+/* Changes one property of one of the images, or only their pixels */
+static void
+change_images (pixman_image_t *src, pixman_image_t *mask, pixman_image_t *dest,
+	       pixman_image_t *alpha)
+{
+    pixman_image_t *image;
+    pixman_region32_t clip;
+    pixman_transform_t transform;
+
+    switch (prng_rand_n (3))
+    {
+    case 0:
+	image = src;
+	break;
+    case 1:
+	image = mask ? mask : src;
+	break;
+    default:
+	image = dest;
+	break;
+    }
+
+    switch (prng_rand_n (7))
+    {
+    case 0:
+	pixman_image_set_repeat (image, prng_rand_n (4));
+	break;
+
+    case 1:
+	pixman_region32_init_rect (&clip, prng_rand_n (30), prng_rand_n (30),
+				   1 + prng_rand_n (60), 1 + prng_rand_n (60));
+	pixman_image_set_clip_region32 (image, &clip);
+	pixman_region32_fini (&clip);
+	break;
+
+    case 2:
+	pixman_image_set_clip_region32 (image, NULL);
+	break;
+
+    case 3:
+	pixman_transform_init_scale (
+	    &transform,
+	    pixman_double_to_fixed (0.5 + prng_rand_n (4) / 2.0),
+	    pixman_double_to_fixed (0.5 + prng_rand_n (4) / 2.0));
+	pixman_image_set_transform (image, &transform);
+	pixman_image_set_filter (image, prng_rand_n (2) ?
+				 PIXMAN_FILTER_NEAREST : PIXMAN_FILTER_BILINEAR,
+				 NULL, 0);
+	break;
+
+    case 4:
+	pixman_image_set_transform (image, NULL);
+	break;
+
+    case 5:
+	if (alpha)
+	{
+	    pixman_region32_init_rect (&clip, prng_rand_n (30), prng_rand_n (30),
+				       1 + prng_rand_n (60), 1 + prng_rand_n (60));
+	    pixman_image_set_clip_region32 (alpha, &clip);
+	    pixman_region32_fini (&clip);
+	    break;
+	}
+	/* fall through */
+
+    default:
+	prng_randmemset (pixman_image_get_data (src),
+			 pixman_image_get_stride (src) *
+			 pixman_image_get_height (src), 0);
+	break;
+    }
+}
+
+static uint32_t
+test_plan (int testnum, pixman_bool_t use_plan)
+{
+    pixman_composite_plan_t *plan = NULL;
+    pixman_image_t *src, *mask = NULL, *dest, *alpha = NULL;
+    int src_x, src_y, mask_x, mask_y, dest_x, dest_y, w, h;
+    pixman_op_t op;
+    uint32_t crc32;
+    int r;
+
+    prng_srand (testnum);
+
+    dest = create_random_image (RANDOM_ELT (formats),
+				1 + prng_rand_n (100), 1 + prng_rand_n (100));
+    src = create_random_image (RANDOM_ELT (formats),
+			       1 + prng_rand_n (60), 1 + prng_rand_n (60));
+
+    if (prng_rand_n (2))
+	pixman_image_set_repeat (src, PIXMAN_REPEAT_NORMAL);
+
+    if (prng_rand_n (3) == 0)
+	mask = create_random_image (PIXMAN_a8, 60, 60);
+
+    if (prng_rand_n (3) == 0)
+    {
+	alpha = create_random_image (PIXMAN_a8, 100, 100);
+	pixman_image_set_alpha_map (dest, alpha, 0, 0);
+    }
+
+    op = RANDOM_ELT (operators);
+    src_x = prng_rand_n (40) - 10;
+    src_y = prng_rand_n (40) - 10;
+    mask_x = prng_rand_n (20);
+    mask_y = prng_rand_n (20);
+    dest_x = prng_rand_n (60) - 10;
+    dest_y = prng_rand_n (60) - 10;
+    w = prng_rand_n (80);
+    h = prng_rand_n (80);
+
+    if (use_plan)
+    {
+	plan = pixman_composite_plan_create (op, src, mask, dest,
+					     src_x, src_y, mask_x, mask_y,
+					     dest_x, dest_y, w, h);
+    }
+
+    for (r = 0; r < N_ROUNDS; ++r)
+    {
+	if (use_plan)
+	{
+	    pixman_composite_plan_execute (plan);
+	}
+	else
+	{
+	    pixman_image_composite32 (op, src, mask, dest,
+				      src_x, src_y, mask_x, mask_y,
+				      dest_x, dest_y, w, h);
+	}
+
+	if (prng_rand_n (2))
+	    change_images (src, mask, dest, alpha);
+    }
+
+    if (use_plan)
+	pixman_composite_plan_destroy (plan);
+
+    pixman_image_set_clip_region32 (dest, NULL);
+    crc32 = compute_crc32_for_image (0, dest);
+
+    pixman_image_unref (src);
+    if (mask)
+	pixman_image_unref (mask);
+    if (alpha)
+	pixman_image_unref (alpha);
+    pixman_image_unref (dest);
+
+    return crc32;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	uint32_t expected = test_plan (i, FALSE);
+	uint32_t crc32 = test_plan (i, TRUE);
+
+	if (crc32 != expected)
+	{
+	    printf ("plan-test: test %d failed: got 0x%08x, expected 0x%08x\n",
+		    i, crc32, expected);
+	    return 1;
+	}
+    }
+
+    return 0;
+}
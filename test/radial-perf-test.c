@@ -1,17 +1,11 @@
 #include "utils.h"
 #include <stdio.h>
 
-int
-main ()
+#define N_COMPOSITE	500
+
+static void
+time_gradient (const char *name, pixman_image_t *gradient)
 {
-    static const pixman_point_fixed_t inner = { 0x0000, 0x0000 };
-    static const pixman_point_fixed_t outer = { 0x0000, 0x0000 };
-    static const pixman_fixed_t r_inner = 0;
-    static const pixman_fixed_t r_outer = 64 << 16;
-    static const pixman_gradient_stop_t stops[] = {
-	{ 0x00000, { 0x6666, 0x6666, 0x6666, 0xffff } },
-	{ 0x10000, { 0x0000, 0x0000, 0x0000, 0xffff } }
-    };
     static const pixman_transform_t transform = {
 	{ { 0x0,        0x26ee, 0x0}, 
 	  { 0xffffeeef, 0x0,    0x0}, 
@@ -19,19 +13,16 @@ main ()
 	}
     };
     static const pixman_color_t z = { 0x0000, 0x0000, 0x0000, 0x0000 };
-    pixman_image_t *dest, *radial, *zero;
+    pixman_image_t *dest, *zero;
+    char filename[32];
     int i;
     double before, after;
 
     dest = pixman_image_create_bits (
 	PIXMAN_x8r8g8b8, 640, 429, NULL, -1);
     zero = pixman_image_create_solid_fill (&z);
-    radial = pixman_image_create_radial_gradient (
-	&inner, &outer, r_inner, r_outer, stops, ARRAY_LENGTH (stops));
-    pixman_image_set_transform (radial, &transform);
-    pixman_image_set_repeat (radial, PIXMAN_REPEAT_PAD);
-
-#define N_COMPOSITE	500
+    pixman_image_set_transform (gradient, &transform);
+    pixman_image_set_repeat (gradient, PIXMAN_REPEAT_PAD);
 
     before = gettime();
     for (i = 0; i < N_COMPOSITE; ++i)
@@ -45,14 +36,44 @@ main ()
 	before += gettime();
 
 	pixman_image_composite32 (
-	    PIXMAN_OP_OVER, radial, NULL, dest,
+	    PIXMAN_OP_OVER, gradient, NULL, dest,
 	    - 150, -158, 0, 0, 0, 0, 640, 361);
     }
 
     after = gettime();
 
-    write_png (dest, "radial.png");
+    snprintf (filename, sizeof (filename), "%s.png", name);
+    write_png (dest, filename);
+
+    printf ("Average time to composite %s: %f\n",
+	    name, (after - before) / N_COMPOSITE);
+
+    pixman_image_unref (gradient);
+    pixman_image_unref (zero);
+    pixman_image_unref (dest);
+}
+
+int
+main ()
+{
+    static const pixman_point_fixed_t inner = { 0x0000, 0x0000 };
+    static const pixman_point_fixed_t outer = { 0x0000, 0x0000 };
+    static const pixman_point_fixed_t p1 = { -64 << 16, 0x0000 };
+    static const pixman_point_fixed_t p2 = { 64 << 16, 32 << 16 };
+    static const pixman_fixed_t r_inner = 0;
+    static const pixman_fixed_t r_outer = 64 << 16;
+    static const pixman_gradient_stop_t stops[] = {
+	{ 0x00000, { 0x6666, 0x6666, 0x6666, 0xffff } },
+	{ 0x10000, { 0x0000, 0x0000, 0x0000, 0xffff } }
+    };
+
+    time_gradient ("linear", pixman_image_create_linear_gradient (
+		       &p1, &p2, stops, ARRAY_LENGTH (stops)));
+    time_gradient ("radial", pixman_image_create_radial_gradient (
+		       &inner, &outer, r_inner, r_outer,
+		       stops, ARRAY_LENGTH (stops)));
+    time_gradient ("conical", pixman_image_create_conical_gradient (
+		       &inner, 0, stops, ARRAY_LENGTH (stops)));
 
-    printf ("Average time to composite: %f\n", (after - before) / N_COMPOSITE);
     return 0;
 }
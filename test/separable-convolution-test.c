@@ -0,0 +1,177 @@
+/*
+ * Checks that the separable convolution iterators for scaled images, and
+ * the affine fetchers for rotated ones, give exactly the same results as
+ * the general code, which is used when the source has accessors.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N_TESTS 3000
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_a8b8g8r8,
+    PIXMAN_r5g6b5,
+    PIXMAN_a8,
+};
+
+static const double scales[] =
+{
+    0.125, 0.3, 0.5, 0.75, 1.0, 1.5, 2.0, 3.7, 8.0,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static uint32_t
+read_func (const void *src, int size)
+{
+    switch (size)
+    {
+    case 1:
+	return *(const uint8_t *)src;
+    case 2:
+	return *(const uint16_t *)src;
+    default:
+	return *(const uint32_t *)src;
+    }
+}
+
+static void
+write_func (void *dst, uint32_t value, int size)
+{
+    switch (size)
+    {
+    case 1:
+	*(uint8_t *)dst = value;
+	break;
+    case 2:
+	*(uint16_t *)dst = value;
+	break;
+    default:
+	*(uint32_t *)dst = value;
+	break;
+    }
+}
+
+static pixman_bool_t
+test_convolution (int testnum)
+{
+    pixman_format_code_t format = RANDOM_ELT (formats);
+    int src_width = 1 + prng_rand_n (40);
+    int src_height = 1 + prng_rand_n (40);
+    int dest_width = 1 + prng_rand_n (300);
+    int dest_height = 1 + prng_rand_n (40);
+    int src_stride = ((src_width * PIXMAN_FORMAT_BPP (format) + 31) / 32) * 4;
+    pixman_repeat_t repeat = prng_rand_n (4);
+    double scale_x = RANDOM_ELT (scales);
+    double scale_y = RANDOM_ELT (scales);
+    uint32_t *src_bits, *dest_bits, *ref_bits;
+    pixman_image_t *src, *dest, *ref;
+    pixman_transform_t transform;
+    pixman_fixed_t *params;
+    int n_params, i;
+    pixman_bool_t ok;
+
+    src_bits = malloc (src_stride * src_height);
+    dest_bits = malloc (dest_width * dest_height * 4);
+    ref_bits = malloc (dest_width * dest_height * 4);
+
+    prng_randmemset (src_bits, src_stride * src_height, 0);
+    memset (dest_bits, 0, dest_width * dest_height * 4);
+    memset (ref_bits, 0, dest_width * dest_height * 4);
+
+    src = pixman_image_create_bits (
+	format, src_width, src_height, src_bits, src_stride);
+    dest = pixman_image_create_bits (
+	PIXMAN_a8r8g8b8, dest_width, dest_height, dest_bits, dest_width * 4);
+    ref = pixman_image_create_bits (
+	PIXMAN_a8r8g8b8, dest_width, dest_height, ref_bits, dest_width * 4);
+
+    if (prng_rand_n (4) == 0)
+	scale_x = -scale_x;
+    if (prng_rand_n (4) == 0)
+	scale_y = -scale_y;
+
+    pixman_transform_init_scale (&transform,
+				 pixman_double_to_fixed (1 / scale_x),
+				 pixman_double_to_fixed (1 / scale_y));
+    if (prng_rand_n (4) == 0)
+    {
+	pixman_transform_rotate (NULL, &transform,
+				 pixman_double_to_fixed (0.6),
+				 pixman_double_to_fixed (0.8));
+    }
+    pixman_transform_translate (NULL, &transform,
+				prng_rand_n (0x40000) - 0x20000,
+				prng_rand_n (0x40000) - 0x20000);
+
+    params = pixman_filter_create_separable_convolution (
+	&n_params,
+	pixman_double_to_fixed (1 / (scale_x < 0 ? -scale_x : scale_x)),
+	pixman_double_to_fixed (1 / (scale_y < 0 ? -scale_y : scale_y)),
+	prng_rand_n (PIXMAN_KERNEL_LANCZOS3_STRETCHED + 1),
+	prng_rand_n (PIXMAN_KERNEL_LANCZOS3_STRETCHED + 1),
+	prng_rand_n (PIXMAN_KERNEL_LANCZOS3_STRETCHED + 1),
+	prng_rand_n (PIXMAN_KERNEL_LANCZOS3_STRETCHED + 1),
+	prng_rand_n (5), prng_rand_n (5));
+
+    pixman_image_set_transform (src, &transform);
+    pixman_image_set_repeat (src, repeat);
+    pixman_image_set_filter (
+	src, PIXMAN_FILTER_SEPARABLE_CONVOLUTION, params, n_params);
+    free (params);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, dest,
+			      0, 0, 0, 0, 0, 0, dest_width, dest_height);
+
+    pixman_image_set_accessors (src, read_func, write_func);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, ref,
+			      0, 0, 0, 0, 0, 0, dest_width, dest_height);
+
+    ok = TRUE;
+    for (i = 0; i < dest_width * dest_height; ++i)
+    {
+	if (dest_bits[i] != ref_bits[i])
+	{
+	    printf ("test %d: pixel (%d, %d) is 0x%08x, expected 0x%08x "
+		    "(format %s, scale %g x %g, repeat %d)\n",
+		    testnum, i % dest_width, i / dest_width,
+		    dest_bits[i], ref_bits[i], format_name (format),
+		    scale_x, scale_y, repeat);
+	    ok = FALSE;
+	    break;
+	}
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+    pixman_image_unref (ref);
+
+    free (src_bits);
+    free (dest_bits);
+    free (ref_bits);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    prng_srand (0);
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_convolution (i))
+	    return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,256 @@
+/*
+ * Checks that the fast paths for rotations by multiples of 90 degrees
+ * and for mirrored sources give exactly the same results as the general
+ * code, which is used when the source has accessors.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N_TESTS 4000
+
+static const pixman_format_code_t formats[][2] =
+{
+    { PIXMAN_a8r8g8b8, PIXMAN_a8r8g8b8 },
+    { PIXMAN_a8r8g8b8, PIXMAN_x8r8g8b8 },
+    { PIXMAN_x8r8g8b8, PIXMAN_x8r8g8b8 },
+    { PIXMAN_a8b8g8r8, PIXMAN_a8b8g8r8 },
+    { PIXMAN_a8b8g8r8, PIXMAN_x8b8g8r8 },
+    { PIXMAN_x8b8g8r8, PIXMAN_x8b8g8r8 },
+    { PIXMAN_r5g6b5, PIXMAN_r5g6b5 },
+    { PIXMAN_b5g6r5, PIXMAN_b5g6r5 },
+    { PIXMAN_a8, PIXMAN_a8 },
+};
+
+/* The 2x2 part of the transforms */
+static const struct
+{
+    int m00, m01, m10, m11;
+    const char *name;
+} transforms[] =
+{
+    {  0, -1,  1,  0, "90" },
+    { -1,  0,  0, -1, "180" },
+    {  0,  1, -1,  0, "270" },
+    { -1,  0,  0,  1, "flip x" },
+    {  1,  0,  0, -1, "flip y" },
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static uint32_t
+read_func (const void *src, int size)
+{
+    switch (size)
+    {
+    case 1:
+	return *(const uint8_t *)src;
+    case 2:
+	return *(const uint16_t *)src;
+    default:
+	return *(const uint32_t *)src;
+    }
+}
+
+static void
+write_func (void *dst, uint32_t value, int size)
+{
+    switch (size)
+    {
+    case 1:
+	*(uint8_t *)dst = value;
+	break;
+    case 2:
+	*(uint16_t *)dst = value;
+	break;
+    default:
+	*(uint32_t *)dst = value;
+	break;
+    }
+}
+
+/* A translation that keeps the samples for 'extent' destination pixels
+ * inside 'size' source pixels, for a unit that is either 1 or -1.
+ */
+static pixman_fixed_t
+random_translation (int unit, int extent, int size)
+{
+    pixman_fixed_t t;
+
+    if (unit > 0)
+	t = pixman_int_to_fixed (prng_rand_n (size - extent + 1));
+    else
+	t = pixman_int_to_fixed (extent + prng_rand_n (size - extent + 1));
+
+    /* Fractions that still round to the same pixels */
+    if (prng_rand_n (4) == 0)
+	t += prng_rand_n (pixman_fixed_1) - pixman_fixed_1 / 2 + 1;
+
+    return t;
+}
+
+static uint32_t
+get_pixel (pixman_image_t *image, int x, int y)
+{
+    uint8_t *row = (uint8_t *)pixman_image_get_data (image) +
+	y * pixman_image_get_stride (image);
+
+    switch (PIXMAN_FORMAT_BPP (pixman_image_get_format (image)))
+    {
+    case 8:
+	return row[x];
+    case 16:
+	return ((uint16_t *)row)[x];
+    default:
+	return ((uint32_t *)row)[x];
+    }
+}
+
+static pixman_image_t *
+create_image (pixman_format_code_t format, int width, int height,
+	      uint8_t **bits)
+{
+    int stride = ((width * PIXMAN_FORMAT_BPP (format) + 31) / 32) * 4;
+    pixman_image_t *image;
+
+    /* Sometimes leave room at the end of the rows */
+    if (prng_rand_n (2))
+	stride += 4 * prng_rand_n (4);
+
+    *bits = malloc (stride * height);
+    prng_randmemset (*bits, stride * height, 0);
+
+    if (prng_rand_n (4) == 0)
+    {
+	image = pixman_image_create_bits (
+	    format, width, height,
+	    (uint32_t *)(*bits + stride * (height - 1)), -stride);
+    }
+    else
+    {
+	image = pixman_image_create_bits (
+	    format, width, height, (uint32_t *)*bits, stride);
+    }
+
+    return image;
+}
+
+static pixman_bool_t
+test_transform (int testnum)
+{
+    const pixman_format_code_t *fmt = RANDOM_ELT (formats);
+    int t = prng_rand_n (ARRAY_LENGTH (transforms));
+    int width = 1 + prng_rand_n (100);
+    int height = 1 + prng_rand_n (100);
+    int src_width, src_height, dest_width, dest_height;
+    int dest_x, dest_y, bpp, x, y;
+    pixman_image_t *src, *dest, *ref;
+    uint8_t *src_bits, *dest_bits, *ref_bits;
+    pixman_transform_t transform;
+    pixman_bool_t ok;
+
+    /* The source rectangle read for a width x height destination */
+    if (transforms[t].m00)
+    {
+	src_width = width + prng_rand_n (20);
+	src_height = height + prng_rand_n (20);
+    }
+    else
+    {
+	src_width = height + prng_rand_n (20);
+	src_height = width + prng_rand_n (20);
+    }
+    dest_width = width + prng_rand_n (20);
+    dest_height = height + prng_rand_n (20);
+    dest_x = prng_rand_n (dest_width - width + 1);
+    dest_y = prng_rand_n (dest_height - height + 1);
+
+    src = create_image (fmt[0], src_width, src_height, &src_bits);
+    dest = create_image (fmt[1], dest_width, dest_height, &dest_bits);
+    ref = create_image (fmt[1], dest_width, dest_height, &ref_bits);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, dest, NULL, ref,
+			      0, 0, 0, 0, 0, 0, dest_width, dest_height);
+
+    pixman_transform_init_identity (&transform);
+    transform.matrix[0][0] = transforms[t].m00 * pixman_fixed_1;
+    transform.matrix[0][1] = transforms[t].m01 * pixman_fixed_1;
+    transform.matrix[1][0] = transforms[t].m10 * pixman_fixed_1;
+    transform.matrix[1][1] = transforms[t].m11 * pixman_fixed_1;
+    transform.matrix[0][2] = random_translation (
+	transforms[t].m00 + transforms[t].m01,
+	transforms[t].m00 ? width : height, src_width);
+    transform.matrix[1][2] = random_translation (
+	transforms[t].m10 + transforms[t].m11,
+	transforms[t].m10 ? width : height, src_height);
+
+    pixman_image_set_transform (src, &transform);
+    pixman_image_set_filter (
+	src, prng_rand_n (2) ? PIXMAN_FILTER_NEAREST : PIXMAN_FILTER_BILINEAR,
+	NULL, 0);
+    pixman_image_set_repeat (src, prng_rand_n (4));
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, dest,
+			      0, 0, 0, 0, dest_x, dest_y, width, height);
+
+    pixman_image_set_accessors (src, read_func, write_func);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, ref,
+			      0, 0, 0, 0, dest_x, dest_y, width, height);
+
+    ok = TRUE;
+    bpp = PIXMAN_FORMAT_BPP (fmt[1]);
+    for (y = 0; y < dest_height && ok; ++y)
+    {
+	for (x = 0; x < dest_width; ++x)
+	{
+	    uint32_t pixel = get_pixel (dest, x, y);
+	    uint32_t expected = get_pixel (ref, x, y);
+
+	    if (PIXMAN_FORMAT_A (fmt[1]) == 0 && bpp == 32)
+	    {
+		pixel &= 0xffffff;
+		expected &= 0xffffff;
+	    }
+
+	    if (pixel != expected)
+	    {
+		printf ("test %d: pixel (%d, %d) is 0x%08x, expected 0x%08x "
+			"(%s -> %s, %s, %d x %d)\n",
+			testnum, x, y, pixel, expected,
+			format_name (fmt[0]), format_name (fmt[1]),
+			transforms[t].name, width, height);
+		ok = FALSE;
+		break;
+	    }
+	}
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+    pixman_image_unref (ref);
+
+    free (src_bits);
+    free (dest_bits);
+    free (ref_bits);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    prng_srand (0);
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_transform (i))
+	    return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * Checks that SRC and OVER between sRGB and 8888 images stay within one
+ * level of the general path, and that few channels are off at all. The
+ * reference destination has accessors, which keep it on the general
+ * path.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_TESTS 2000
+#define MAX_WIDTH 100
+#define MAX_HEIGHT 8
+
+static int n_channels, n_off;
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+};
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_a8r8g8b8,
+    PIXMAN_x8r8g8b8,
+    PIXMAN_a8r8g8b8_sRGB,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static uint32_t
+reader (const void *src, int size)
+{
+    return *(uint32_t *)src;
+}
+
+static void
+writer (void *src, uint32_t value, int size)
+{
+    *(uint32_t *)src = value;
+}
+
+/* Mostly valid premultiplied pixels, with many transparent and opaque
+ * ones for the shortcuts of the fast paths.
+ */
+static uint32_t
+random_pixel (void)
+{
+    uint32_t a, p;
+    int shift;
+
+    switch (prng_rand_n (4))
+    {
+    case 0:
+	return 0;
+
+    case 1:
+	a = 0xff;
+	break;
+
+    case 2:
+	return prng_rand ();
+
+    default:
+	a = prng_rand_n (256);
+	break;
+    }
+
+    p = a << 24;
+    for (shift = 0; shift < 24; shift += 8)
+	p |= prng_rand_n (a + 1) << shift;
+
+    return p;
+}
+
+static pixman_bool_t
+compare (int testnum, uint32_t *result, uint32_t *ref, int stride,
+	 pixman_format_code_t format, int dest_x, int dest_y,
+	 int width, int height)
+{
+    int n = PIXMAN_FORMAT_A (format) ? 4 : 3;
+    int x, y, i;
+
+    for (y = 0; y < MAX_HEIGHT + 4; ++y)
+    {
+	for (x = 0; x < MAX_WIDTH + 4; ++x)
+	{
+	    uint32_t r = result[y * stride + x];
+	    uint32_t e = ref[y * stride + x];
+	    int inside = x >= dest_x && x < dest_x + width &&
+			 y >= dest_y && y < dest_y + height;
+
+	    for (i = 0; i < n; ++i)
+	    {
+		int d = (int)((r >> (8 * i)) & 0xff) - (int)((e >> (8 * i)) & 0xff);
+
+		if (inside)
+		{
+		    n_channels++;
+		    if (d)
+			n_off++;
+		}
+
+		if (abs (d) > 1 || (!inside && d))
+		{
+		    printf ("test %d: pixel (%d, %d) is 0x%08x, expected 0x%08x\n",
+			    testnum, x, y, r, e);
+		    return FALSE;
+		}
+	    }
+	}
+    }
+
+    return TRUE;
+}
+
+static pixman_bool_t
+test_srgb (int testnum)
+{
+    pixman_image_t *src, *result, *ref;
+    pixman_format_code_t src_format, dest_format;
+    pixman_op_t op;
+    uint32_t *src_bits, *result_bits, *ref_bits;
+    int width, height, stride, src_x, dest_x, dest_y, i;
+    pixman_bool_t ok;
+
+    prng_srand (testnum);
+
+    op = RANDOM_ELT (ops);
+    do
+    {
+	src_format = RANDOM_ELT (formats);
+	dest_format = RANDOM_ELT (formats);
+    }
+    while (src_format != PIXMAN_a8r8g8b8_sRGB &&
+	   dest_format != PIXMAN_a8r8g8b8_sRGB);
+
+    width = 1 + prng_rand_n (MAX_WIDTH);
+    height = 1 + prng_rand_n (MAX_HEIGHT);
+    src_x = prng_rand_n (4);
+    dest_x = prng_rand_n (4);
+    dest_y = prng_rand_n (4);
+
+    stride = MAX_WIDTH + 4;
+
+    src_bits = aligned_malloc (64, stride * MAX_HEIGHT * 4);
+    result_bits = aligned_malloc (64, stride * (MAX_HEIGHT + 4) * 4);
+    ref_bits = aligned_malloc (64, stride * (MAX_HEIGHT + 4) * 4);
+
+    for (i = 0; i < stride * MAX_HEIGHT; ++i)
+	src_bits[i] = random_pixel ();
+    for (i = 0; i < stride * (MAX_HEIGHT + 4); ++i)
+	result_bits[i] = random_pixel ();
+    memcpy (ref_bits, result_bits, stride * (MAX_HEIGHT + 4) * 4);
+
+    src = pixman_image_create_bits (
+	src_format, MAX_WIDTH + 4, MAX_HEIGHT, src_bits, stride * 4);
+    result = pixman_image_create_bits (
+	dest_format, MAX_WIDTH + 4, MAX_HEIGHT + 4, result_bits, stride * 4);
+    ref = pixman_image_create_bits (
+	dest_format, MAX_WIDTH + 4, MAX_HEIGHT + 4, ref_bits, stride * 4);
+
+    pixman_image_set_accessors (ref, reader, writer);
+
+    pixman_image_composite32 (op, src, NULL, result,
+			      src_x, 0, 0, 0, dest_x, dest_y, width, height);
+    pixman_image_composite32 (op, src, NULL, ref,
+			      src_x, 0, 0, 0, dest_x, dest_y, width, height);
+
+    ok = compare (testnum, result_bits, ref_bits, stride, dest_format,
+		  dest_x, dest_y, width, height);
+
+    if (!ok)
+    {
+	printf ("op %s, src %s, dest %s, %dx%d\n",
+		operator_name (op), format_name (src_format),
+		format_name (dest_format), width, height);
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (result);
+    pixman_image_unref (ref);
+
+    free (src_bits);
+    free (result_bits);
+    free (ref_bits);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_srgb (i))
+	    return 1;
+    }
+
+    /* Rounding differs from the general path at the boundaries of
+     * the levels only.
+     */
+    if (n_off > n_channels / 100)
+    {
+	printf ("%d of %d channels are off by one\n", n_off, n_channels);
+	return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * Checks that composite statistics count calls, boxes and pixels per
+ * signature, count the hits and misses of the fast path cache, are
+ * summed over threads, and can be reset.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef HAVE_PTHREADS
+# include <pthread.h>
+#endif
+
+#define N_STATS 64
+#define N_THREADS 32
+
+static pixman_image_t *
+create_image (pixman_format_code_t format, int width, int height)
+{
+    return pixman_image_create_bits (format, width, height, NULL, 0);
+}
+
+static const pixman_composite_statistics_t *
+find_stat (const pixman_composite_statistics_t *stats, int n_stats,
+	   pixman_op_t op, pixman_format_code_t src_format,
+	   pixman_format_code_t dest_format)
+{
+    int i;
+
+    for (i = 0; i < n_stats; ++i)
+    {
+	if (stats[i].op == op				&&
+	    stats[i].src_format == src_format		&&
+	    stats[i].mask_format == PIXMAN_null		&&
+	    stats[i].dest_format == dest_format)
+	{
+	    return &stats[i];
+	}
+    }
+
+    return NULL;
+}
+
+#ifdef HAVE_PTHREADS
+static pixman_image_t *thread_src, *thread_dest;
+
+static void *
+thread_composite (void *data)
+{
+    pixman_image_composite32 (PIXMAN_OP_ADD, thread_src, NULL, thread_dest,
+			      0, 0, 0, 0, 0, 0, 10, 10);
+
+    return NULL;
+}
+
+/* Threads that have exited hand their counts on to later threads */
+static pixman_bool_t
+test_exited_threads (pixman_image_t *src, pixman_image_t *dest)
+{
+    pixman_composite_statistics_t stats[N_STATS];
+    const pixman_composite_statistics_t *stat;
+    pthread_t thread;
+    int n_stats, i;
+
+    thread_src = src;
+    thread_dest = dest;
+
+    pixman_reset_statistics ();
+
+    for (i = 0; i < N_THREADS; ++i)
+    {
+	if (pthread_create (&thread, NULL, thread_composite, NULL) != 0)
+	    return FALSE;
+	pthread_join (thread, NULL);
+    }
+
+    n_stats = pixman_get_statistics (stats, N_STATS);
+    stat = find_stat (stats, n_stats, PIXMAN_OP_ADD,
+		      PIXMAN_a8r8g8b8, PIXMAN_a8r8g8b8);
+
+    if (!stat || stat->n_calls != N_THREADS)
+    {
+	printf ("%d composites counted for %d threads\n",
+		stat ? (int)stat->n_calls : 0, N_THREADS);
+	return FALSE;
+    }
+
+    return TRUE;
+}
+#endif
+
+int
+main (int argc, char **argv)
+{
+    pixman_composite_statistics_t stats[N_STATS];
+    const pixman_composite_statistics_t *stat;
+    pixman_image_t *src, *dest;
+    pixman_region32_t clip;
+    uint64_t n_hits, n_misses;
+    int n_stats, i;
+
+    src = create_image (PIXMAN_a8r8g8b8, 64, 64);
+    dest = create_image (PIXMAN_a8r8g8b8, 64, 64);
+
+    pixman_enable_statistics (TRUE);
+    pixman_reset_statistics ();
+
+    /* Three composites of 10x10 pixels */
+    for (i = 0; i < 3; ++i)
+    {
+	pixman_image_composite32 (PIXMAN_OP_ADD, src, NULL, dest,
+				  0, 0, 0, 0, i, i, 10, 10);
+    }
+
+    /* One composite clipped to two boxes of 4x4 and 2x2 pixels */
+    pixman_region32_init_rect (&clip, 0, 0, 4, 4);
+    pixman_region32_union_rect (&clip, &clip, 30, 30, 2, 2);
+    pixman_image_set_clip_region32 (dest, &clip);
+    pixman_region32_fini (&clip);
+
+    pixman_image_composite32 (PIXMAN_OP_ADD, src, NULL, dest,
+			      0, 0, 0, 0, 0, 0, 64, 64);
+
+    pixman_image_set_clip_region32 (dest, NULL);
+
+    n_stats = pixman_get_statistics (stats, N_STATS);
+    stat = find_stat (stats, n_stats, PIXMAN_OP_ADD,
+		      PIXMAN_a8r8g8b8, PIXMAN_a8r8g8b8);
+
+    if (!stat)
+    {
+	printf ("no statistics recorded for add_8888_8888\n");
+	return 1;
+    }
+
+    if (stat->n_calls != 4 || stat->n_boxes != 5 ||
+	stat->n_pixels != 3 * 100 + 16 + 4)
+    {
+	printf ("wrong counts: %d calls, %d boxes, %d pixels\n",
+		(int)stat->n_calls, (int)stat->n_boxes, (int)stat->n_pixels);
+	return 1;
+    }
+
+    if (!stat->implementation || !stat->function)
+    {
+	printf ("implementation or function not recorded\n");
+	return 1;
+    }
+
+    /* Entries are sorted by decreasing pixel count */
+    for (i = 1; i < n_stats && i < N_STATS; ++i)
+    {
+	if (stats[i].n_pixels > stats[i - 1].n_pixels)
+	{
+	    printf ("statistics are not sorted\n");
+	    return 1;
+	}
+    }
+
+    /* Only the first lookup of a signature can miss the cache */
+    pixman_reset_statistics ();
+
+    for (i = 0; i < 10; ++i)
+    {
+	pixman_image_composite32 (PIXMAN_OP_ADD, src, NULL, dest,
+				  0, 0, 0, 0, i, i, 10, 10);
+    }
+
+    pixman_get_cache_statistics (&n_hits, &n_misses);
+
+    if (n_hits + n_misses != 10 || n_misses > 1)
+    {
+	printf ("wrong cache counts: %d hits, %d misses\n",
+		(int)n_hits, (int)n_misses);
+	return 1;
+    }
+
+    pixman_reset_statistics ();
+
+    n_stats = pixman_get_statistics (stats, N_STATS);
+    pixman_get_cache_statistics (&n_hits, &n_misses);
+    if (n_stats != 0 || n_hits || n_misses)
+    {
+	printf ("%d entries left after reset\n", n_stats);
+	return 1;
+    }
+
+#ifdef HAVE_PTHREADS
+    if (!test_exited_threads (src, dest))
+	return 1;
+
+    pixman_reset_statistics ();
+#endif
+
+    pixman_enable_statistics (FALSE);
+
+    pixman_image_composite32 (PIXMAN_OP_ADD, src, NULL, dest,
+			      0, 0, 0, 0, 0, 0, 10, 10);
+
+    if (pixman_get_statistics (NULL, 0) != 0)
+    {
+	printf ("composite counted while statistics were disabled\n");
+	return 1;
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (dest);
+
+    return 0;
+}
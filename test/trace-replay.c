@@ -0,0 +1,770 @@
+/*
+ * Replays a composite trace and reports the time spent in each class of
+ * call.
+ *
+ * A trace is recorded by running an application with the environment
+ * variable PIXMAN_TRACE set to the name of the trace file. Traces hold
+ * no pixels, so the calls are replayed against images of the same
+ * formats and sizes filled with random data.
+ *
+ * Usage: trace-replay <trace file> [repeats]
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "utils.h"
+
+#define MAX_CLASSES	1024
+#define MAX_BITS_IMAGES	256
+
+typedef struct
+{
+    const uint32_t *	words;
+    int			n_words;
+    int			pos;
+    pixman_bool_t	error;
+} reader_t;
+
+typedef struct
+{
+    char		name[128];
+    int			n_calls;
+    double		time;
+} call_class_t;
+
+/* Bits images are created once for each format, size and use, and then
+ * reused, so that replaying does not measure image creation.
+ */
+typedef struct
+{
+    pixman_format_code_t format;
+    int			width;
+    int			height;
+    int			role;
+    pixman_image_t *	image;
+} bits_image_entry_t;
+
+static call_class_t	classes[MAX_CLASSES];
+static int		n_classes;
+
+static bits_image_entry_t	bits_images[MAX_BITS_IMAGES];
+static int			n_bits_images;
+
+static pixman_indexed_t	indexed;
+
+static uint32_t
+get (reader_t *reader)
+{
+    if (reader->pos >= reader->n_words)
+    {
+	reader->error = TRUE;
+	return 0;
+    }
+
+    return reader->words[reader->pos++];
+}
+
+static void
+get_color (reader_t *reader, pixman_color_t *color)
+{
+    uint32_t rg = get (reader);
+    uint32_t ba = get (reader);
+
+    color->red = rg >> 16;
+    color->green = rg & 0xffff;
+    color->blue = ba >> 16;
+    color->alpha = ba & 0xffff;
+}
+
+static void
+get_box (reader_t *reader, pixman_box32_t *box)
+{
+    box->x1 = get (reader);
+    box->y1 = get (reader);
+    box->x2 = get (reader);
+    box->y2 = get (reader);
+}
+
+static pixman_image_t *
+create_random_bits (pixman_format_code_t format, int width, int height)
+{
+    pixman_image_t *image;
+
+    image = pixman_image_create_bits (format, width, height, NULL, 0);
+    if (!image)
+	return NULL;
+
+    prng_randmemset (pixman_image_get_data (image),
+		     pixman_image_get_stride (image) * height, 0);
+
+    if (PIXMAN_FORMAT_TYPE (format) == PIXMAN_TYPE_COLOR ||
+	PIXMAN_FORMAT_TYPE (format) == PIXMAN_TYPE_GRAY)
+    {
+	pixman_image_set_indexed (image, &indexed);
+    }
+
+    return image;
+}
+
+static pixman_image_t *
+get_bits_image (pixman_format_code_t format, int width, int height, int role)
+{
+    bits_image_entry_t *entry;
+    int i;
+
+    for (i = 0; i < n_bits_images; ++i)
+    {
+	entry = &bits_images[i];
+
+	if (entry->format == format	&&
+	    entry->width == width	&&
+	    entry->height == height	&&
+	    entry->role == role)
+	{
+	    return pixman_image_ref (entry->image);
+	}
+    }
+
+    if (n_bits_images == MAX_BITS_IMAGES)
+	return create_random_bits (format, width, height);
+
+    entry = &bits_images[n_bits_images];
+    if (!(entry->image = create_random_bits (format, width, height)))
+	return NULL;
+
+    entry->format = format;
+    entry->width = width;
+    entry->height = height;
+    entry->role = role;
+    n_bits_images++;
+
+    return pixman_image_ref (entry->image);
+}
+
+static const char *
+image_name (pixman_image_t *image)
+{
+    if (!image)
+	return "null";
+
+    switch (image->type)
+    {
+    case BITS:
+	return format_name (image->bits.format);
+    case SOLID:
+	return "solid";
+    case LINEAR:
+	return "linear";
+    case RADIAL:
+	return "radial";
+    case CONICAL:
+	return "conical";
+    }
+
+    return "?";
+}
+
+/* Reads an image descriptor written by pixman-trace.c. The role keeps
+ * the source, mask and destination of a call apart when they have the
+ * same format and size.
+ */
+static pixman_image_t *
+read_image (reader_t *reader, int role)
+{
+    pixman_image_t *image = NULL;
+    pixman_gradient_stop_t *stops = NULL;
+    pixman_fixed_t geometry[6];
+    pixman_fixed_t *params = NULL;
+    pixman_transform_t transform;
+    pixman_color_t color;
+    uint32_t type;
+    int n_stops = 0;
+    int i, j, n;
+
+    if (!(type = get (reader)))
+	return NULL;
+
+    switch (type - 1)
+    {
+    case BITS:
+	{
+	    pixman_format_code_t format = get (reader);
+	    int width = get (reader);
+	    int height = get (reader);
+	    pixman_dither_t dither = get (reader);
+	    pixman_mipmap_t mipmap = get (reader);
+
+	    if (reader->error)
+		return NULL;
+
+	    image = get_bits_image (format, width, height, role);
+	    if (image)
+	    {
+		pixman_image_set_dither (image, dither);
+		pixman_image_set_mipmap (image, mipmap);
+	    }
+	}
+	break;
+
+    case SOLID:
+	get_color (reader, &color);
+	image = pixman_image_create_solid_fill (&color);
+	break;
+
+    case LINEAR:
+    case RADIAL:
+    case CONICAL:
+	n = type - 1 == LINEAR ? 4 : type - 1 == RADIAL ? 6 : 3;
+	for (i = 0; i < n; ++i)
+	    geometry[i] = get (reader);
+
+	n_stops = get (reader);
+	if (reader->error || n_stops < 0 ||
+	    n_stops > (reader->n_words - reader->pos) / 3)
+	{
+	    reader->error = TRUE;
+	    return NULL;
+	}
+
+	stops = malloc ((n_stops + 1) * sizeof (pixman_gradient_stop_t));
+	for (i = 0; i < n_stops; ++i)
+	{
+	    stops[i].x = get (reader);
+	    get_color (reader, &stops[i].color);
+	}
+
+	if (type - 1 == LINEAR)
+	{
+	    pixman_point_fixed_t p1 = { geometry[0], geometry[1] };
+	    pixman_point_fixed_t p2 = { geometry[2], geometry[3] };
+
+	    image = pixman_image_create_linear_gradient (
+		&p1, &p2, stops, n_stops);
+	}
+	else if (type - 1 == RADIAL)
+	{
+	    pixman_point_fixed_t c1 = { geometry[0], geometry[1] };
+	    pixman_point_fixed_t c2 = { geometry[3], geometry[4] };
+
+	    image = pixman_image_create_radial_gradient (
+		&c1, &c2, geometry[2], geometry[5], stops, n_stops);
+	}
+	else
+	{
+	    pixman_point_fixed_t center = { geometry[0], geometry[1] };
+
+	    image = pixman_image_create_conical_gradient (
+		&center, geometry[2], stops, n_stops);
+	}
+
+	free (stops);
+	break;
+
+    default:
+	reader->error = TRUE;
+	return NULL;
+    }
+
+    if (!image)
+    {
+	reader->error = TRUE;
+	return NULL;
+    }
+
+    pixman_image_set_repeat (image, get (reader));
+
+    i = get (reader);
+    n = get (reader);
+    if (n < 0 || n > reader->n_words - reader->pos)
+    {
+	reader->error = TRUE;
+    }
+    else
+    {
+	params = malloc ((n + 1) * sizeof (pixman_fixed_t));
+	for (j = 0; j < n; ++j)
+	    params[j] = get (reader);
+
+	pixman_image_set_filter (image, i, params, n);
+	free (params);
+    }
+
+    if (get (reader))
+    {
+	for (i = 0; i < 9; ++i)
+	    transform.matrix[i / 3][i % 3] = get (reader);
+
+	pixman_image_set_transform (image, &transform);
+    }
+    else
+    {
+	pixman_image_set_transform (image, NULL);
+    }
+
+    pixman_image_set_component_alpha (image, get (reader));
+    pixman_image_set_source_clipping (image, get (reader));
+
+    if ((n = get (reader)))
+    {
+	pixman_region32_t clip;
+	pixman_box32_t *boxes;
+
+	n--;
+	if (n > (reader->n_words - reader->pos) / 4)
+	{
+	    reader->error = TRUE;
+	    return image;
+	}
+
+	boxes = malloc ((n + 1) * sizeof (pixman_box32_t));
+	for (i = 0; i < n; ++i)
+	    get_box (reader, &boxes[i]);
+
+	pixman_region32_init_rects (&clip, boxes, n);
+	pixman_image_set_clip_region32 (image, &clip);
+	pixman_region32_fini (&clip);
+
+	free (boxes);
+    }
+    else
+    {
+	pixman_image_set_clip_region32 (image, NULL);
+    }
+
+    return image;
+}
+
+static void
+add_time (const char *name, double time)
+{
+    int i;
+
+    for (i = 0; i < n_classes; ++i)
+    {
+	if (strcmp (classes[i].name, name) == 0)
+	    break;
+    }
+
+    if (i == n_classes)
+    {
+	if (n_classes == MAX_CLASSES)
+	    return;
+
+	snprintf (classes[i].name, sizeof (classes[i].name), "%s", name);
+	n_classes++;
+    }
+
+    classes[i].n_calls++;
+    classes[i].time += time;
+}
+
+static void
+unref_image (pixman_image_t *image)
+{
+    if (image)
+	pixman_image_unref (image);
+}
+
+static void
+replay_composite (reader_t *reader)
+{
+    pixman_op_t op = get (reader);
+    pixman_image_t *src = read_image (reader, 0);
+    pixman_image_t *mask = read_image (reader, 1);
+    pixman_image_t *dest = read_image (reader, 2);
+    int32_t args[8];
+    char name[128];
+    double t;
+    int i;
+
+    for (i = 0; i < 8; ++i)
+	args[i] = get (reader);
+
+    if (!reader->error && src && dest)
+    {
+	snprintf (name, sizeof (name), "composite %s %s%s %s %s",
+		  operator_name (op),
+		  image_name (src), src->common.transform ? "*" : "",
+		  image_name (mask), image_name (dest));
+
+	t = gettime ();
+	pixman_image_composite32 (op, src, mask, dest,
+				  args[0], args[1], args[2], args[3],
+				  args[4], args[5], args[6], args[7]);
+	add_time (name, gettime () - t);
+    }
+
+    unref_image (src);
+    unref_image (mask);
+    unref_image (dest);
+}
+
+static void
+replay_fill_boxes (reader_t *reader)
+{
+    pixman_op_t op = get (reader);
+    pixman_image_t *dest = read_image (reader, 2);
+    pixman_box32_t *boxes;
+    pixman_color_t color;
+    char name[128];
+    int i, n_boxes;
+    double t;
+
+    get_color (reader, &color);
+
+    n_boxes = get (reader);
+    if (reader->error || n_boxes < 0 ||
+	n_boxes > (reader->n_words - reader->pos) / 4)
+    {
+	reader->error = TRUE;
+	unref_image (dest);
+	return;
+    }
+
+    boxes = malloc ((n_boxes + 1) * sizeof (pixman_box32_t));
+    for (i = 0; i < n_boxes; ++i)
+	get_box (reader, &boxes[i]);
+
+    if (dest)
+    {
+	snprintf (name, sizeof (name), "fill_boxes %s %s",
+		  operator_name (op), image_name (dest));
+
+	t = gettime ();
+	pixman_image_fill_boxes (op, dest, &color, n_boxes, boxes);
+	add_time (name, gettime () - t);
+    }
+
+    free (boxes);
+    unref_image (dest);
+}
+
+static void
+replay_trapezoids (reader_t *reader)
+{
+    pixman_op_t op = get (reader);
+    pixman_image_t *src = read_image (reader, 0);
+    pixman_image_t *dst = read_image (reader, 2);
+    pixman_format_code_t mask_format = get (reader);
+    pixman_trapezoid_t *traps;
+    int32_t args[4];
+    char name[128];
+    int i, n_traps;
+    double t;
+
+    for (i = 0; i < 4; ++i)
+	args[i] = get (reader);
+
+    n_traps = get (reader);
+    if (reader->error || n_traps < 0 ||
+	n_traps > (reader->n_words - reader->pos) / 10)
+    {
+	reader->error = TRUE;
+	unref_image (src);
+	unref_image (dst);
+	return;
+    }
+
+    traps = malloc ((n_traps + 1) * sizeof (pixman_trapezoid_t));
+    for (i = 0; i < n_traps; ++i)
+    {
+	traps[i].top = get (reader);
+	traps[i].bottom = get (reader);
+	traps[i].left.p1.x = get (reader);
+	traps[i].left.p1.y = get (reader);
+	traps[i].left.p2.x = get (reader);
+	traps[i].left.p2.y = get (reader);
+	traps[i].right.p1.x = get (reader);
+	traps[i].right.p1.y = get (reader);
+	traps[i].right.p2.x = get (reader);
+	traps[i].right.p2.y = get (reader);
+    }
+
+    if (src && dst)
+    {
+	snprintf (name, sizeof (name), "trapezoids %s %s %s %s",
+		  operator_name (op), image_name (src),
+		  format_name (mask_format), image_name (dst));
+
+	t = gettime ();
+	pixman_composite_trapezoids (op, src, dst, mask_format,
+				     args[0], args[1], args[2], args[3],
+				     n_traps, traps);
+	add_time (name, gettime () - t);
+    }
+
+    free (traps);
+    unref_image (src);
+    unref_image (dst);
+}
+
+static const void *
+get_glyph (pixman_glyph_cache_t *cache,
+	   pixman_format_code_t  format,
+	   int                   width,
+	   int                   height,
+	   int                   origin_x,
+	   int                   origin_y)
+{
+    void *font_key = (void *)(uintptr_t)format;
+    void *glyph_key = (void *)(uintptr_t)(
+	(width & 0xff) | ((height & 0xff) << 8) |
+	((origin_x & 0xff) << 16) | ((uint32_t)(origin_y & 0xff) << 24));
+    const void *glyph;
+    pixman_image_t *image;
+
+    if ((glyph = pixman_glyph_cache_lookup (cache, font_key, glyph_key)))
+	return glyph;
+
+    if (!(image = create_random_bits (format, width, height)))
+	return NULL;
+
+    glyph = pixman_glyph_cache_insert (cache, font_key, glyph_key,
+				       origin_x, origin_y, image);
+    pixman_image_unref (image);
+
+    return glyph;
+}
+
+static void
+replay_glyphs (reader_t *reader, pixman_glyph_cache_t *cache)
+{
+    pixman_op_t op = get (reader);
+    pixman_image_t *src = read_image (reader, 0);
+    pixman_image_t *dest = read_image (reader, 2);
+    pixman_format_code_t mask_format = get (reader);
+    pixman_glyph_t *glyphs;
+    int32_t args[8];
+    char name[128];
+    int i, n_glyphs;
+    double t;
+
+    for (i = 0; i < 8; ++i)
+	args[i] = get (reader);
+
+    n_glyphs = get (reader);
+    if (reader->error || n_glyphs < 0 ||
+	n_glyphs > (reader->n_words - reader->pos) / 7)
+    {
+	reader->error = TRUE;
+	unref_image (src);
+	unref_image (dest);
+	return;
+    }
+
+    glyphs = malloc ((n_glyphs + 1) * sizeof (pixman_glyph_t));
+
+    pixman_glyph_cache_freeze (cache);
+
+    for (i = 0; i < n_glyphs; ++i)
+    {
+	int origin_x, origin_y, width, height;
+	pixman_format_code_t format;
+
+	glyphs[i].x = get (reader);
+	glyphs[i].y = get (reader);
+	origin_x = get (reader);
+	origin_y = get (reader);
+	format = get (reader);
+	width = get (reader);
+	height = get (reader);
+
+	glyphs[i].glyph = get_glyph (cache, format, width, height,
+				     origin_x, origin_y);
+	if (!glyphs[i].glyph)
+	    reader->error = TRUE;
+    }
+
+    if (!reader->error && src && dest)
+    {
+	snprintf (name, sizeof (name), "glyphs %s %s %s %s",
+		  operator_name (op), image_name (src),
+		  mask_format == PIXMAN_null ? "no-mask" : format_name (mask_format),
+		  image_name (dest));
+
+	t = gettime ();
+	if (mask_format == PIXMAN_null)
+	{
+	    pixman_composite_glyphs_no_mask (op, src, dest,
+					     args[0], args[1], args[4], args[5],
+					     cache, n_glyphs, glyphs);
+	}
+	else
+	{
+	    pixman_composite_glyphs (op, src, dest, mask_format,
+				     args[0], args[1], args[2], args[3],
+				     args[4], args[5], args[6], args[7],
+				     cache, n_glyphs, glyphs);
+	}
+	add_time (name, gettime () - t);
+    }
+
+    pixman_glyph_cache_thaw (cache);
+
+    free (glyphs);
+    unref_image (src);
+    unref_image (dest);
+}
+
+static uint32_t *
+read_file (const char *filename, int *n_words)
+{
+    uint32_t *words;
+    FILE *f;
+    long size;
+
+    if (!(f = fopen (filename, "rb")))
+	return NULL;
+
+    fseek (f, 0, SEEK_END);
+    size = ftell (f);
+    fseek (f, 0, SEEK_SET);
+
+    words = malloc (size + sizeof (uint32_t));
+    if (words)
+	*n_words = fread (words, sizeof (uint32_t), size / 4, f);
+
+    fclose (f);
+
+    return words;
+}
+
+static int
+compare_time (const void *a, const void *b)
+{
+    const call_class_t *ca = a;
+    const call_class_t *cb = b;
+
+    if (ca->time != cb->time)
+	return ca->time < cb->time ? 1 : -1;
+
+    return 0;
+}
+
+int
+main (int argc, char **argv)
+{
+    pixman_glyph_cache_t *cache;
+    uint32_t *words;
+    int n_words, n_records = 0;
+    int repeats = 1;
+    double total = 0;
+    reader_t reader;
+    int r, i;
+
+    if (argc < 2)
+    {
+	printf ("Usage: %s <trace file> [repeats]\n", argv[0]);
+	return 1;
+    }
+
+    if (argc > 2)
+	repeats = atoi (argv[2]);
+
+    if (!(words = read_file (argv[1], &n_words)))
+    {
+	printf ("Could not read %s\n", argv[1]);
+	return 1;
+    }
+
+    if (n_words < 2 || words[0] != PIXMAN_TRACE_MAGIC)
+    {
+	printf ("%s is not a pixman trace, or was recorded with a "
+		"different byte order\n", argv[1]);
+	return 1;
+    }
+
+    if (words[1] != PIXMAN_TRACE_VERSION)
+    {
+	printf ("Unsupported trace version %u\n", words[1]);
+	return 1;
+    }
+
+    prng_srand (0);
+    for (i = 0; i < 256; ++i)
+    {
+	indexed.rgba[i] = prng_rand ();
+	indexed.ent[i] = i;
+    }
+
+    cache = pixman_glyph_cache_create ();
+
+    for (r = 0; r < repeats; ++r)
+    {
+	int pos = 2;
+
+	while (pos + 2 <= n_words)
+	{
+	    uint32_t type = words[pos];
+	    int size = words[pos + 1];
+
+	    if (size < 0 || size > n_words - pos - 2)
+	    {
+		printf ("Truncated record at word %d\n", pos);
+		break;
+	    }
+
+	    reader.words = words + pos + 2;
+	    reader.n_words = size;
+	    reader.pos = 0;
+	    reader.error = FALSE;
+
+	    switch (type)
+	    {
+	    case PIXMAN_TRACE_COMPOSITE:
+		replay_composite (&reader);
+		break;
+	    case PIXMAN_TRACE_FILL_BOXES:
+		replay_fill_boxes (&reader);
+		break;
+	    case PIXMAN_TRACE_TRAPEZOIDS:
+		replay_trapezoids (&reader);
+		break;
+	    case PIXMAN_TRACE_GLYPHS:
+		replay_glyphs (&reader, cache);
+		break;
+	    default:
+		reader.error = TRUE;
+		break;
+	    }
+
+	    if (reader.error)
+		printf ("Skipped malformed record at word %d\n", pos);
+
+	    if (r == 0)
+		n_records++;
+
+	    pos += 2 + size;
+	}
+    }
+
+    qsort (classes, n_classes, sizeof (call_class_t), compare_time);
+
+    for (i = 0; i < n_classes; ++i)
+	total += classes[i].time;
+
+    printf ("%d records, %d repeats, %.3f ms\n\n",
+	    n_records, repeats, total * 1000.);
+
+    printf ("%10s %10s %10s %6s  %s\n",
+	    "calls", "ms", "us/call", "%", "class");
+
+    for (i = 0; i < n_classes; ++i)
+    {
+	const call_class_t *c = &classes[i];
+
+	printf ("%10d %10.3f %10.3f %6.2f  %s\n",
+		c->n_calls, c->time * 1000.,
+		c->time * 1000000. / c->n_calls,
+		total > 0 ? 100. * c->time / total : 0.,
+		c->name);
+    }
+
+    for (i = 0; i < n_bits_images; ++i)
+	pixman_image_unref (bits_images[i].image);
+
+    pixman_glyph_cache_destroy (cache);
+    free (words);
+
+    return 0;
+}
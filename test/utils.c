@@ -1318,6 +1318,10 @@ static const format_entry_t format_list[] =
     /* ENTRY (yuy2), */
     ALIAS (yv12,		"yv12"),
     /* ENTRY (yv12), */
+    ALIAS (nv12,		"nv12"),
+    /* ENTRY (nv12), */
+    ALIAS (i420,		"i420"),
+    /* ENTRY (i420), */
 
 /* Fake formats, not in pixman_format_code_t enum */
     ALIAS (null,		"null"),
@@ -0,0 +1,248 @@
+/*
+ * Checks that composites to planar YUV destinations write the same
+ * planes as through accessors, which keep the destination on the C
+ * iterator, and that an image of 2x2 blocks of one color reads back
+ * close to what was written.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_TESTS 2000
+#define MAX_SIZE 67
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_yv12,
+    PIXMAN_nv12,
+    PIXMAN_i420,
+};
+
+static const pixman_yuv_matrix_t matrices[] =
+{
+    PIXMAN_YUV_BT601,
+    PIXMAN_YUV_BT601_FULL_RANGE,
+    PIXMAN_YUV_BT709,
+    PIXMAN_YUV_BT709_FULL_RANGE,
+};
+
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_OVER,
+    PIXMAN_OP_ADD,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static uint32_t
+reader (const void *src, int size)
+{
+    switch (size)
+    {
+    case 1:
+	return *(uint8_t *)src;
+    case 2:
+	return *(uint16_t *)src;
+    default:
+	return *(uint32_t *)src;
+    }
+}
+
+static void
+writer (void *src, uint32_t value, int size)
+{
+    switch (size)
+    {
+    case 1:
+	*(uint8_t *)src = value;
+	break;
+    case 2:
+	*(uint16_t *)src = value;
+	break;
+    default:
+	*(uint32_t *)src = value;
+	break;
+    }
+}
+
+static int
+planes_size (int width, int height)
+{
+    return ((width + 7) & ~7) * (height + (height + 1) / 2);
+}
+
+static pixman_bool_t
+test_yuv_dest (int testnum)
+{
+    pixman_format_code_t format;
+    pixman_yuv_matrix_t matrix;
+    pixman_image_t *src, *result, *ref;
+    pixman_op_t op;
+    uint32_t *src_bits, *result_bits, *ref_bits;
+    int width, height, size, stride;
+    int dest_x, dest_y, w, h, i;
+
+    prng_srand (testnum);
+
+    op = RANDOM_ELT (ops);
+    format = RANDOM_ELT (formats);
+    matrix = RANDOM_ELT (matrices);
+    width = 1 + prng_rand_n (MAX_SIZE);
+    height = 1 + prng_rand_n (MAX_SIZE);
+    w = 1 + prng_rand_n (width);
+    h = 1 + prng_rand_n (height);
+    dest_x = prng_rand_n (width - w + 1);
+    dest_y = prng_rand_n (height - h + 1);
+
+    size = planes_size (width, height);
+    stride = (width + 7) & ~7;
+
+    src_bits = aligned_malloc (64, width * height * 4);
+    result_bits = aligned_malloc (64, size);
+    ref_bits = aligned_malloc (64, size);
+
+    prng_randmemset (src_bits, width * height * 4, 0);
+    prng_randmemset (result_bits, size, 0);
+    memcpy (ref_bits, result_bits, size);
+
+    src = pixman_image_create_bits (
+	PIXMAN_a8r8g8b8, width, height, src_bits, width * 4);
+    result = pixman_image_create_bits (
+	format, width, height, result_bits, stride);
+    ref = pixman_image_create_bits (
+	format, width, height, ref_bits, stride);
+
+    pixman_image_set_yuv_matrix (result, matrix);
+    pixman_image_set_yuv_matrix (ref, matrix);
+    pixman_image_set_accessors (ref, reader, writer);
+
+    pixman_image_composite32 (op, src, NULL, result,
+			      0, 0, 0, 0, dest_x, dest_y, w, h);
+    pixman_image_composite32 (op, src, NULL, ref,
+			      0, 0, 0, 0, dest_x, dest_y, w, h);
+
+    for (i = 0; i < size; ++i)
+    {
+	uint8_t r = ((uint8_t *)result_bits)[i];
+	uint8_t e = ((uint8_t *)ref_bits)[i];
+
+	if (r != e)
+	{
+	    printf ("test %d: byte %d is 0x%02x, expected 0x%02x\n",
+		    testnum, i, r, e);
+	    printf ("op %s, dest %s %dx%d, matrix %d, %dx%d at (%d, %d)\n",
+		    operator_name (op), format_name (format), width, height,
+		    matrix, w, h, dest_x, dest_y);
+	    break;
+	}
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (result);
+    pixman_image_unref (ref);
+
+    free (src_bits);
+    free (result_bits);
+    free (ref_bits);
+
+    return i == size;
+}
+
+/* The chroma of a 2x2 block of one color is that color's, so reading it
+ * back loses no more than the rounding of Y, U and V.
+ */
+static pixman_bool_t
+test_roundtrip (int testnum)
+{
+    pixman_format_code_t format;
+    pixman_yuv_matrix_t matrix;
+    pixman_image_t *src, *yuv, *back;
+    uint32_t *src_bits, *back_bits;
+    int width, height, x, y, i;
+    pixman_bool_t ok = TRUE;
+
+    prng_srand (testnum);
+
+    format = RANDOM_ELT (formats);
+    matrix = RANDOM_ELT (matrices);
+    width = 1 + prng_rand_n (MAX_SIZE);
+    height = 1 + prng_rand_n (MAX_SIZE);
+
+    /* The chroma planes of yv12 overlap when the height is odd */
+    if (format == PIXMAN_yv12)
+	height = (height + 1) & ~1;
+
+    src_bits = aligned_malloc (64, width * height * 4);
+    back_bits = aligned_malloc (64, width * height * 4);
+
+    for (y = 0; y < height; ++y)
+    {
+	for (x = 0; x < width; ++x)
+	{
+	    if ((x | y) & 1)
+		src_bits[y * width + x] = src_bits[(y & ~1) * width + (x & ~1)];
+	    else
+		src_bits[y * width + x] = prng_rand () | 0xff000000;
+	}
+    }
+
+    src = pixman_image_create_bits (
+	PIXMAN_a8r8g8b8, width, height, src_bits, width * 4);
+    yuv = pixman_image_create_bits (format, width, height, NULL, 0);
+    back = pixman_image_create_bits (
+	PIXMAN_a8r8g8b8, width, height, back_bits, width * 4);
+
+    pixman_image_set_yuv_matrix (yuv, matrix);
+
+    pixman_image_composite32 (PIXMAN_OP_SRC, src, NULL, yuv,
+			      0, 0, 0, 0, 0, 0, width, height);
+    pixman_image_composite32 (PIXMAN_OP_SRC, yuv, NULL, back,
+			      0, 0, 0, 0, 0, 0, width, height);
+
+    for (i = 0; i < width * height && ok; ++i)
+    {
+	uint32_t r = back_bits[i];
+	uint32_t e = src_bits[i];
+	int shift;
+
+	for (shift = 0; shift < 24; shift += 8)
+	{
+	    int d = (int)((r >> shift) & 0xff) - (int)((e >> shift) & 0xff);
+
+	    if (abs (d) > 3)
+	    {
+		printf ("test %d: pixel (%d, %d) reads back as 0x%08x, "
+			"expected 0x%08x\n", testnum, i % width, i / width, r, e);
+		printf ("dest %s %dx%d, matrix %d\n",
+			format_name (format), width, height, matrix);
+		ok = FALSE;
+		break;
+	    }
+	}
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (yuv);
+    pixman_image_unref (back);
+
+    free (src_bits);
+    free (back_bits);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_yuv_dest (i) || !test_roundtrip (i))
+	    return 1;
+    }
+
+    return 0;
+}
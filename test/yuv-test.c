@@ -0,0 +1,235 @@
+/*
+ * Checks that YUV images, untransformed or scaled and in any of the
+ * color spaces, are composited the same as through accessors, which
+ * keep them on the C fetchers of the general path. Planar images have
+ * either contiguous planes or planes of their own, with random strides.
+ */
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#define N_TESTS 2000
+#define MAX_SIZE 67
+
+static const pixman_format_code_t formats[] =
+{
+    PIXMAN_yuy2,
+    PIXMAN_yv12,
+    PIXMAN_nv12,
+    PIXMAN_i420,
+};
+
+/* ADD goes through the general path, with the iterators */
+static const pixman_op_t ops[] =
+{
+    PIXMAN_OP_SRC,
+    PIXMAN_OP_ADD,
+};
+
+static const pixman_yuv_matrix_t matrices[] =
+{
+    PIXMAN_YUV_BT601,
+    PIXMAN_YUV_BT601_FULL_RANGE,
+    PIXMAN_YUV_BT709,
+    PIXMAN_YUV_BT709_FULL_RANGE,
+};
+
+static const pixman_filter_t filters[] =
+{
+    PIXMAN_FILTER_NEAREST,
+    PIXMAN_FILTER_BILINEAR,
+};
+
+#define RANDOM_ELT(arr)							\
+    arr[prng_rand_n (ARRAY_LENGTH (arr))]
+
+static uint32_t
+reader (const void *src, int size)
+{
+    switch (size)
+    {
+    case 1:
+	return *(uint8_t *)src;
+    case 2:
+	return *(uint16_t *)src;
+    default:
+	return *(uint32_t *)src;
+    }
+}
+
+static void
+writer (void *src, uint32_t value, int size)
+{
+    switch (size)
+    {
+    case 1:
+	*(uint8_t *)src = value;
+	break;
+    case 2:
+	*(uint16_t *)src = value;
+	break;
+    default:
+	*(uint32_t *)src = value;
+	break;
+    }
+}
+
+static pixman_bool_t
+test_yuv (int testnum)
+{
+    pixman_format_code_t format;
+    pixman_yuv_matrix_t matrix;
+    pixman_image_t *src, *ref_src, *result, *ref;
+    pixman_transform_t transform;
+    pixman_filter_t filter;
+    pixman_op_t op;
+    uint32_t *bits = NULL;
+    uint8_t *planes[3] = { NULL, NULL, NULL };
+    int strides[3];
+    int src_width, src_height, width, height, stride, size, scaled;
+    int src_x, src_y, i;
+    pixman_bool_t ok = TRUE;
+
+    prng_srand (testnum);
+
+    op = RANDOM_ELT (ops);
+    format = RANDOM_ELT (formats);
+    filter = RANDOM_ELT (filters);
+    matrix = RANDOM_ELT (matrices);
+    src_width = 1 + prng_rand_n (MAX_SIZE);
+    src_height = 1 + prng_rand_n (MAX_SIZE);
+    width = 1 + prng_rand_n (MAX_SIZE);
+    height = 1 + prng_rand_n (MAX_SIZE);
+    scaled = prng_rand_n (2);
+
+    if (format != PIXMAN_yuy2 && prng_rand_n (2))
+    {
+	int n_planes = format == PIXMAN_nv12 ? 2 : 3;
+	int chroma_width = (src_width + 1) / 2;
+
+	for (i = 0; i < n_planes; ++i)
+	{
+	    int rows = i ? (src_height + 1) / 2 : src_height;
+
+	    strides[i] = (i ? chroma_width : src_width) + prng_rand_n (8);
+	    if (format == PIXMAN_nv12 && i)
+		strides[i] += chroma_width;
+
+	    planes[i] = aligned_malloc (64, strides[i] * rows);
+	    prng_randmemset (planes[i], strides[i] * rows, 0);
+	}
+
+	src = pixman_image_create_planar (
+	    format, src_width, src_height, planes, strides);
+	ref_src = pixman_image_create_planar (
+	    format, src_width, src_height, planes, strides);
+    }
+    else
+    {
+	/* Rows of 4-byte units, with the chroma planes after the luma
+	 * plane
+	 */
+	if (format == PIXMAN_yuy2)
+	{
+	    stride = (src_width * 2 + 3) & ~3;
+	    size = stride * src_height;
+	}
+	else
+	{
+	    stride = (src_width + 7) & ~7;
+	    size = stride * (src_height + (src_height + 1) / 2);
+	}
+
+	bits = aligned_malloc (64, size);
+	prng_randmemset (bits, size, 0);
+
+	src = pixman_image_create_bits (
+	    format, src_width, src_height, bits, stride);
+	ref_src = pixman_image_create_bits (
+	    format, src_width, src_height, bits, stride);
+    }
+
+    pixman_image_set_accessors (ref_src, reader, writer);
+    pixman_image_set_yuv_matrix (src, matrix);
+    pixman_image_set_yuv_matrix (ref_src, matrix);
+
+    if (scaled)
+    {
+	/* Samples stay inside the image, with room for the filter */
+	pixman_transform_init_identity (&transform);
+	transform.matrix[0][0] = MAX (
+	    1, pixman_int_to_fixed (src_width - 1) / width - prng_rand_n (64));
+	transform.matrix[1][1] = MAX (
+	    1, pixman_int_to_fixed (src_height - 1) / height - prng_rand_n (64));
+	transform.matrix[0][2] = pixman_fixed_1 / 2;
+	transform.matrix[1][2] = pixman_fixed_1 / 2;
+
+	pixman_image_set_transform (src, &transform);
+	pixman_image_set_transform (ref_src, &transform);
+	pixman_image_set_filter (src, filter, NULL, 0);
+	pixman_image_set_filter (ref_src, filter, NULL, 0);
+
+	src_x = src_y = 0;
+    }
+    else
+    {
+	width = MIN (width, src_width);
+	height = MIN (height, src_height);
+	src_x = prng_rand_n (src_width - width + 1);
+	src_y = prng_rand_n (src_height - height + 1);
+    }
+
+    result = pixman_image_create_bits (PIXMAN_a8r8g8b8, width, height, NULL, 0);
+    ref = pixman_image_create_bits (PIXMAN_a8r8g8b8, width, height, NULL, 0);
+
+    prng_randmemset (pixman_image_get_data (result), width * height * 4, 0);
+    memcpy (pixman_image_get_data (ref), pixman_image_get_data (result),
+	    width * height * 4);
+
+    pixman_image_composite32 (op, src, NULL, result,
+			      src_x, src_y, 0, 0, 0, 0, width, height);
+    pixman_image_composite32 (op, ref_src, NULL, ref,
+			      src_x, src_y, 0, 0, 0, 0, width, height);
+
+    for (i = 0; i < width * height; ++i)
+    {
+	uint32_t r = pixman_image_get_data (result)[i];
+	uint32_t e = pixman_image_get_data (ref)[i];
+
+	if (r != e)
+	{
+	    printf ("test %d: pixel (%d, %d) is 0x%08x, expected 0x%08x\n",
+		    testnum, i % width, i / width, r, e);
+	    printf ("op %s, src %s %dx%d, matrix %d, %s, filter %d, %dx%d\n",
+		    operator_name (op), format_name (format), src_width, src_height,
+		    matrix, scaled ? "scaled" : "untransformed", filter,
+		    width, height);
+	    ok = FALSE;
+	    break;
+	}
+    }
+
+    pixman_image_unref (src);
+    pixman_image_unref (ref_src);
+    pixman_image_unref (result);
+    pixman_image_unref (ref);
+    free (bits);
+    for (i = 0; i < 3; ++i)
+	free (planes[i]);
+
+    return ok;
+}
+
+int
+main (int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; i < N_TESTS; ++i)
+    {
+	if (!test_yuv (i))
+	    return 1;
+    }
+
+    return 0;
+}